@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sys/mman.h>
+
+// view of n contiguous objects owned by an Arena
+template <typename T>
+class Span {
+public:
+  T* data = nullptr;
+  size_t length = 0;
+
+  Span() = default;
+
+  Span(T* d, size_t n) : data(d), length(n) {}
+
+  size_t size() const { return length; }
+
+  bool empty() const { return length == 0; }
+
+  T& operator [] (size_t i) const { return data[i]; }
+
+  T* begin() const { return data; }
+
+  T* end() const { return data + length; }
+};
+
+
+// bump allocator for the netlist
+//
+// memory comes from a few large anonymous mappings, optionally backed by
+// 2MB transparent huge pages, and is only given back when the arena is
+// destroyed or reset, one munmap per mapping; objects placed in an arena
+// must therefore be trivially destructible
+//
+// clear forgets every object but keeps the mappings, so an arena that
+// reads one netlist after another stops mapping memory once it has 
+// seen the largest
+class Arena {
+public:
+  Arena() = default;
+
+  Arena(const Arena&) = delete;
+
+  Arena& operator = (const Arena&) = delete;
+
+  ~Arena();
+
+  // request transparent huge pages for mappings made from now on
+  bool huge_pages = false;
+
+  // make sure the next n bytes come from a single mapping
+  void reserve(size_t);
+
+  // raw storage for n objects of T, left uninitialized
+  template <typename T>
+  T* allocate(size_t);
+
+  // storage for n objects of T, value-initialized
+  template <typename T>
+  T* construct(size_t);
+
+  // release every mapping
+  void reset();
+
+  // forget every allocation, the mappings are handed out again
+  void clear();
+
+  // bytes handed out so far
+  size_t bytes_allocated() const;
+
+  // bytes mapped so far
+  size_t bytes_mapped() const;
+
+private:
+  struct Chunk {
+    char* base = nullptr;
+    size_t size = 0;
+  };
+
+  static constexpr size_t huge_page_size = size_t(2) << 20;
+
+  static constexpr size_t min_chunk_size = size_t(1) << 20;
+
+  // no request may come near the size of the address space
+  static constexpr size_t max_bytes = SIZE_MAX / 4;
+
+  std::vector<Chunk> chunks;
+
+  // mapping ptr points into
+  size_t current = 0;
+
+  char* ptr = nullptr;
+
+  char* end = nullptr;
+
+  size_t allocated = 0;
+
+  void map_chunk(size_t);
+
+  void next_chunk(size_t);
+};
+
+
+inline Arena::~Arena() {
+  reset();
+}
+
+inline void Arena::map_chunk(size_t bytes) {
+  if (bytes > max_bytes) {
+    throw std::runtime_error(
+      "Arena cannot map " + std::to_string(bytes) + " bytes");
+  }
+
+  size_t alignment = huge_pages ? huge_page_size : 4096;
+  size_t size = std::max(bytes, min_chunk_size);
+  size = (size + alignment - 1) / alignment * alignment;
+
+  void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if (base == MAP_FAILED) {
+    throw std::runtime_error(
+      "Arena could not map " + std::to_string(size) + " bytes");
+  }
+
+#ifdef MADV_HUGEPAGE
+  if (huge_pages) {
+    madvise(base, size, MADV_HUGEPAGE);
+  }
+#endif
+
+  chunks.push_back({static_cast<char*>(base), size});
+  current = chunks.size()-1;
+  ptr = static_cast<char*>(base);
+  end = ptr + size;
+}
+
+// move on to the first mapping left over from before clear that holds
+// bytes, or map a new one
+inline void Arena::next_chunk(size_t bytes) {
+  while (current+1 < chunks.size()) {
+    ++current;
+    if (chunks[current].size >= bytes) {
+      ptr = chunks[current].base;
+      end = ptr + chunks[current].size;
+      return;
+    }
+  }
+  map_chunk(bytes);
+}
+
+inline void Arena::reserve(size_t bytes) {
+  if (static_cast<size_t>(end - ptr) < bytes) {
+    next_chunk(bytes);
+  }
+}
+
+template <typename T>
+T* Arena::allocate(size_t n) {
+  if (n > max_bytes / sizeof(T)) {
+    throw std::runtime_error(
+      "Arena cannot hold " + std::to_string(n) + " objects of " + 
+      std::to_string(sizeof(T)) + " bytes");
+  }
+
+  // keep every object aligned to its own requirement
+  size_t align = alignof(T);
+  uintptr_t p = (reinterpret_cast<uintptr_t>(ptr) + align - 1) & ~(align - 1);
+  size_t bytes = n * sizeof(T);
+
+  if (ptr == nullptr || p + bytes > reinterpret_cast<uintptr_t>(end)) {
+    next_chunk(bytes + align);
+    p = (reinterpret_cast<uintptr_t>(ptr) + align - 1) & ~(align - 1);
+  }
+
+  allocated += bytes;
+  ptr = reinterpret_cast<char*>(p + bytes);
+  return reinterpret_cast<T*>(p);
+}
+
+template <typename T>
+T* Arena::construct(size_t n) {
+  T* objects = allocate<T>(n);
+  for (size_t i = 0; i < n; ++i) {
+    new (objects + i) T();
+  }
+  return objects;
+}
+
+inline void Arena::reset() {
+  for (auto& chunk : chunks) {
+    munmap(chunk.base, chunk.size);
+  }
+  chunks.clear();
+  current = 0;
+  ptr = nullptr;
+  end = nullptr;
+  allocated = 0;
+}
+
+inline void Arena::clear() {
+  current = 0;
+  allocated = 0;
+  if (chunks.empty()) {
+    return;
+  }
+  ptr = chunks[0].base;
+  end = ptr + chunks[0].size;
+}
+
+inline size_t Arena::bytes_allocated() const {
+  return allocated;
+}
+
+inline size_t Arena::bytes_mapped() const {
+  size_t bytes = 0;
+  for (auto& chunk : chunks) {
+    bytes += chunk.size;
+  }
+  return bytes;
+}
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "json.hpp"
+#include "graph.hpp"
+#include "vcycle.hpp"
+
+// one netlist of a batch and, once run, how it went
+struct BatchJob {
+  std::string input;
+  std::string output;
+
+  // balance factor for .hgr inputs, .dat inputs carry their own
+  double r_factor = 0.1;
+
+  // filled in by BatchRunner
+  bool done = false;
+  uint64_t seed = 0;
+  std::string error;
+  size_t num_cells = 0;
+  size_t num_nets = 0;
+  size_t cutsize = 0;
+  double read_ms = 0.0;
+  double fm_ms = 0.0;
+  double write_ms = 0.0;
+};
+
+
+// partition many netlists in one process
+//
+// a manifest lists the jobs as JSON, either an array or an object
+// holding one under "jobs", with the batch-wide balance factor for
+// .hgr inputs under "balance_factor"
+//   { "balance_factor" : 0.1,
+//     "jobs" : [ { "input" : "a.dat", "output" : "a.out" },
+//                { "input" : "b.hgr", "output" : "b.part",
+//                  "balance_factor" : 0.05 } ] }
+//
+// every worker thread owns one Hypergraph and reloads it job after job,
+// so the arena mappings and the bucket and per-cell vectors are only
+// grown, never given back, until the batch is over
+class BatchRunner {
+public:
+  BatchRunner(std::vector<BatchJob>&);
+
+  // at most this many workers, set to the number used by run
+  size_t num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  bool huge_pages = false;
+
+  BucketPolicy policy = BucketPolicy::FIFO;
+
+  PinKernel pin_kernel = best_pin_kernel();
+
+  // see Hypergraph::boundary_only, applied to the V-cycles only
+  bool boundary_only = false;
+
+  size_t halo = 0;
+
+  // V-cycle budget of every job
+  double vcycle_seconds = 0.0;
+
+  // job i is seeded with seed+i, so its partition does not depend
+  // on the worker that runs it
+  uint64_t seed = 0;
+
+  // wall time of the whole batch
+  double wall_ms = 0.0;
+
+  void run();
+
+  // jobs that could not be run
+  size_t num_failed() const;
+
+  static std::vector<BatchJob> read_manifest(const std::string&);
+
+  // per job cutsize and runtime as JSON
+  void write_summary(const std::string&) const;
+
+  // the same as a table
+  void print_summary(std::ostream&) const;
+
+private:
+  std::vector<BatchJob>& jobs;
+
+  std::atomic<size_t> next_job{0};
+
+  void work();
+
+  void run_job(Hypergraph&, BatchJob&) const;
+};
+
+
+inline BatchRunner::BatchRunner(std::vector<BatchJob>& j) : jobs(j) {
+}
+
+inline std::vector<BatchJob> BatchRunner::read_manifest(
+  const std::string& manifest_file) {
+
+  std::ifstream inFile(manifest_file);
+  if (!inFile) {
+    std::cerr << "Manifest could not be opened or does not exist\n";
+    exit(1);
+  }
+
+  nlohmann::json manifest = nlohmann::json::parse(inFile, nullptr, false);
+  if (manifest.is_discarded()) {
+    std::cerr << "Manifest " << manifest_file << " is not valid JSON\n";
+    exit(1);
+  }
+
+  double r_factor = 0.1;
+  nlohmann::json list = manifest;
+  if (manifest.is_object()) {
+    r_factor = manifest.value("balance_factor", r_factor);
+    list = manifest.value("jobs", nlohmann::json::array());
+  }
+  if (!list.is_array()) {
+    std::cerr << "Manifest " << manifest_file << " holds no job array\n";
+    exit(1);
+  }
+
+  std::vector<BatchJob> jobs;
+  jobs.reserve(list.size());
+  for (auto& entry : list) {
+    if (!entry.is_object() || !entry.contains("input") ||
+        !entry.contains("output") || !entry["input"].is_string() ||
+        !entry["output"].is_string()) {
+      std::cerr << "Manifest job " << jobs.size()
+                << " needs an input and an output\n";
+      exit(1);
+    }
+    BatchJob job;
+    job.input = entry["input"].get<std::string>();
+    job.output = entry["output"].get<std::string>();
+    job.r_factor = entry.value("balance_factor", r_factor);
+    jobs.emplace_back(std::move(job));
+  }
+  return jobs;
+}
+
+inline void BatchRunner::run() {
+  auto start = std::chrono::steady_clock::now();
+
+  next_job = 0;
+  num_threads = std::max<size_t>(1, std::min(num_threads, jobs.size()));
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < num_threads; ++i) {
+    workers.emplace_back(&BatchRunner::work, this);
+  }
+  work();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  wall_ms = std::chrono::duration<double, std::milli>(
+    std::chrono::steady_clock::now() - start).count();
+}
+
+// take jobs until none is left
+inline void BatchRunner::work() {
+  Hypergraph hypergraph;
+  hypergraph.arena.huge_pages = huge_pages;
+  hypergraph.policy = policy;
+  hypergraph.pin_kernel = pin_kernel;
+  hypergraph.verbose = false;
+
+  size_t i;
+  while ((i = next_job.fetch_add(1, std::memory_order_relaxed)) <
+         jobs.size()) {
+    jobs[i].seed = seed + i;
+    run_job(hypergraph, jobs[i]);
+  }
+}
+
+inline void BatchRunner::run_job(Hypergraph& hypergraph,
+                                 BatchJob& job) const {
+  // an input that cannot be read fails the job, not the batch
+  auto t0 = std::chrono::steady_clock::now();
+  hypergraph.rng.seed(job.seed);
+  hypergraph.boundary_only = false;
+  try {
+    hypergraph.load(job.input, job.output, job.r_factor);
+  }
+  catch (const std::runtime_error& e) {
+    job.error = e.what();
+    return;
+  }
+
+  auto t1 = std::chrono::steady_clock::now();
+  hypergraph.run_fm();
+  if (vcycle_seconds > 0) {
+    hypergraph.boundary_only = boundary_only;
+    hypergraph.halo = halo;
+    VCycle vcycle(hypergraph);
+    vcycle.run(vcycle_seconds);
+  }
+
+  auto t2 = std::chrono::steady_clock::now();
+  const std::string suffix = ".part";
+  try {
+    if (job.output.size() >= suffix.size() &&
+        job.output.compare(job.output.size()-suffix.size(),
+                           suffix.size(), suffix) == 0) {
+      hypergraph.output_part();
+    }
+    else {
+      hypergraph.output_answer();
+    }
+  }
+  catch (const std::runtime_error& e) {
+    job.error = e.what();
+    return;
+  }
+
+  auto t3 = std::chrono::steady_clock::now();
+  using ms = std::chrono::duration<double, std::milli>;
+  job.read_ms = ms(t1 - t0).count();
+  job.fm_ms = ms(t2 - t1).count();
+  job.write_ms = ms(t3 - t2).count();
+  job.num_cells = hypergraph.num_cells();
+  job.num_nets = hypergraph.num_nets();
+  job.cutsize = hypergraph.cutsize;
+  job.done = true;
+}
+
+inline size_t BatchRunner::num_failed() const {
+  return std::count_if(jobs.begin(), jobs.end(), [](const BatchJob& job) {
+    return !job.done;
+  });
+}
+
+inline void BatchRunner::write_summary(const std::string& summary_file) const {
+  nlohmann::json summary;
+  summary["threads"] = num_threads;
+  summary["seed"] = seed;
+  summary["wall_ms"] = wall_ms;
+  summary["failed"] = num_failed();
+  summary["jobs"] = nlohmann::json::array();
+
+  for (auto& job : jobs) {
+    nlohmann::json entry;
+    entry["input"] = job.input;
+    entry["output"] = job.output;
+    entry["seed"] = job.seed;
+    if (!job.done) {
+      entry["error"] = job.error;
+    }
+    else {
+      entry["cells"] = job.num_cells;
+      entry["nets"] = job.num_nets;
+      entry["cutsize"] = job.cutsize;
+      entry["read_ms"] = job.read_ms;
+      entry["fm_ms"] = job.fm_ms;
+      entry["write_ms"] = job.write_ms;
+    }
+    summary["jobs"].push_back(entry);
+  }
+
+  std::ofstream outFile(summary_file);
+  if (!outFile) {
+    std::cerr << "Summary file could not be opened.\n";
+    exit(1);
+  }
+  outFile << summary.dump(2) << '\n';
+}
+
+inline void BatchRunner::print_summary(std::ostream& os) const {
+  for (auto& job : jobs) {
+    os << "  " << job.input << " : ";
+    if (!job.done) {
+      os << job.error << '\n';
+      continue;
+    }
+    os << "cutsize = " << job.cutsize
+       << ", " << job.read_ms + job.fm_ms + job.write_ms << " ms\n";
+  }
+  os << "  " << jobs.size() - num_failed() << " of " << jobs.size()
+     << " jobs done on " << num_threads << " threads in "
+     << wall_ms << " ms, seed = " << seed << '\n';
+}
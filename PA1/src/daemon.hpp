@@ -0,0 +1,305 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "json.hpp"
+#include "graph.hpp"
+#include "vcycle.hpp"
+
+// serve partitions of one netlist over a local UNIX socket
+//
+// a client writes one JSON request per line and reads one JSON reply
+// per line; every field of a request is optional
+//   { "balance_factor" : 0.1, "seed" : 7, "time_limit" : 2.0,
+//     "fixed" : { "c1" : 0, "c42" : 1 } }
+//   { "cutsize" : 123, "seed" : 7, "ms" : 12.5, "partition" : "0110..." }
+// where partition holds the side of every cell in ID order and
+// time_limit is the V-cycle budget in seconds;
+// { "command" : "cells" } returns the cell names in ID order and
+// { "command" : "shutdown" } stops the daemon from taking connections,
+// a bad request gets { "error" : "..." }; a line longer than max_line
+// gets one too and its connection is closed
+//
+// the netlist is parsed once; every worker thread copies it into a
+// Hypergraph of its own and restarts that copy for every request,
+// so requests on different connections run at the same time
+class PartitionDaemon {
+public:
+  PartitionDaemon(const Hypergraph&, const std::string&);
+
+  // at most this many connections are served at once
+  size_t num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  BucketPolicy policy = BucketPolicy::FIFO;
+
+  PinKernel pin_kernel = best_pin_kernel();
+
+  // see Hypergraph::boundary_only, applied to the V-cycles only
+  bool boundary_only = false;
+
+  size_t halo = 0;
+
+  // requests without a seed are seeded with seed+k, k counting requests
+  uint64_t seed = 0;
+
+  // longest request line in bytes a connection may hold unanswered
+  size_t max_line = 1 << 20;
+
+  // listen on the socket and serve until a shutdown request,
+  // false with the reason on std::cerr if the socket cannot be set up
+  bool run();
+
+  // stop taking connections, the open ones are served until closed
+  void stop();
+
+  // a Hypergraph to serve requests with
+  void prepare(Hypergraph&) const;
+
+  // the reply to one request line, without the newline
+  std::string serve(Hypergraph&, const std::string&);
+
+private:
+  const Hypergraph& netlist;
+
+  std::string socket_path;
+
+  int listen_fd = -1;
+
+  std::atomic<bool> stopping{false};
+
+  std::atomic<uint64_t> num_requests{0};
+
+  void work();
+
+  void handle(Hypergraph&, int);
+
+  std::string partition(Hypergraph&, const nlohmann::json&);
+};
+
+
+inline PartitionDaemon::PartitionDaemon(const Hypergraph& n,
+                                        const std::string& path)
+  : netlist(n), socket_path(path) {
+}
+
+inline bool PartitionDaemon::run() {
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(address.sun_path)) {
+    std::cerr << "Socket path " << socket_path << " is too long\n";
+    return false;
+  }
+  std::strcpy(address.sun_path, socket_path.c_str());
+
+  listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd < 0) {
+    std::cerr << "Socket could not be created\n";
+    return false;
+  }
+
+  // a socket left behind by an earlier daemon would fail the bind
+  unlink(socket_path.c_str());
+  if (bind(listen_fd, reinterpret_cast<sockaddr*>(&address),
+           sizeof(address)) != 0 || listen(listen_fd, SOMAXCONN) != 0) {
+    std::cerr << "Socket " << socket_path << " could not be bound: "
+              << std::strerror(errno) << '\n';
+    close(listen_fd);
+    listen_fd = -1;
+    return false;
+  }
+
+  stopping = false;
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < num_threads; ++i) {
+    workers.emplace_back(&PartitionDaemon::work, this);
+  }
+  work();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  close(listen_fd);
+  listen_fd = -1;
+  unlink(socket_path.c_str());
+  return true;
+}
+
+inline void PartitionDaemon::stop() {
+  stopping = true;
+  // wakes up every worker blocked in accept
+  shutdown(listen_fd, SHUT_RDWR);
+}
+
+inline void PartitionDaemon::prepare(Hypergraph& graph) const {
+  graph.copy_netlist(netlist);
+  graph.policy = policy;
+  graph.pin_kernel = pin_kernel;
+  graph.verbose = false;
+}
+
+// take connections until the daemon stops
+inline void PartitionDaemon::work() {
+  Hypergraph graph;
+  prepare(graph);
+
+  while (!stopping) {
+    int fd = accept(listen_fd, nullptr, nullptr);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      break;
+    }
+    handle(graph, fd);
+    close(fd);
+  }
+}
+
+// answer the requests of one connection line by line
+inline void PartitionDaemon::handle(Hypergraph& graph, int fd) {
+  auto send_line = [&](std::string reply) {
+    reply += '\n';
+    for (size_t sent = 0; sent < reply.size();) {
+      ssize_t n = send(fd, reply.data() + sent, reply.size() - sent,
+                       MSG_NOSIGNAL);
+      if (n <= 0) {
+        return false;
+      }
+      sent += n;
+    }
+    return true;
+  };
+
+  std::string buffer;
+  char chunk[4096];
+  ssize_t size;
+  while ((size = recv(fd, chunk, sizeof(chunk), 0)) > 0) {
+    buffer.append(chunk, size);
+
+    size_t begin = 0;
+    size_t end;
+    while ((end = buffer.find('\n', begin)) != std::string::npos &&
+           end-begin <= max_line) {
+      if (!send_line(serve(graph, buffer.substr(begin, end-begin)))) {
+        return;
+      }
+      begin = end+1;
+    }
+
+    // a line longer than max_line, ended or not, is not served
+    if (buffer.size()-begin > max_line) {
+      nlohmann::json reply;
+      reply["error"] = "a request line must be at most " + 
+                       std::to_string(max_line) + " bytes";
+      send_line(reply.dump());
+      return;
+    }
+    buffer.erase(0, begin);
+  }
+}
+
+inline std::string PartitionDaemon::serve(Hypergraph& graph,
+                                          const std::string& line) {
+  nlohmann::json request = nlohmann::json::parse(line, nullptr, false);
+  nlohmann::json reply;
+  if (request.is_discarded() || !request.is_object()) {
+    reply["error"] = "a request must be a JSON object";
+    return reply.dump();
+  }
+
+  // a field of the wrong type throws from nlohmann::json
+  try {
+    std::string command = request.value("command", "partition");
+    if (command == "partition") {
+      return partition(graph, request);
+    }
+    else if (command == "cells") {
+      reply["cells"] = nlohmann::json::array();
+      for (size_t c = 0; c < graph.num_cells(); ++c) {
+        reply["cells"].push_back(std::string(graph.cells[c].name));
+      }
+    }
+    else if (command == "shutdown") {
+      stop();
+      reply["shutdown"] = true;
+    }
+    else {
+      reply["error"] = "unknown command " + command;
+    }
+  }
+  catch (const nlohmann::json::exception& e) {
+    reply = nlohmann::json();
+    reply["error"] = e.what();
+  }
+  // fixed cells that leave no balanced partition
+  catch (const std::runtime_error& e) {
+    reply = nlohmann::json();
+    reply["error"] = e.what();
+  }
+  return reply.dump();
+}
+
+inline std::string PartitionDaemon::partition(Hypergraph& graph,
+                                              const nlohmann::json& request) {
+  auto start = std::chrono::steady_clock::now();
+  nlohmann::json reply;
+
+  uint64_t k = num_requests.fetch_add(1, std::memory_order_relaxed);
+  uint64_t request_seed = request.value("seed", seed + k);
+  double r_factor = request.value("balance_factor", netlist.r_factor);
+  double time_limit = request.value("time_limit", 0.0);
+
+  graph.fixed.clear();
+  if (request.contains("fixed")) {
+    const nlohmann::json& fixed = request["fixed"];
+    if (!fixed.is_object()) {
+      reply["error"] = "fixed must map cell names to 0 or 1";
+      return reply.dump();
+    }
+    graph.fixed.assign(graph.num_cells(), -1);
+    for (auto it = fixed.begin(); it != fixed.end(); ++it) {
+      Cell* cell = graph.find_cell(it.key());
+      int side = it.value().get<int>();
+      if (cell == nullptr || (side != 0 && side != 1)) {
+        reply["error"] = "cell " + it.key() + " cannot be fixed";
+        return reply.dump();
+      }
+      graph.fixed[graph.cell_id(cell)] = static_cast<int8_t>(side);
+    }
+  }
+
+  graph.rng.seed(request_seed);
+  graph.boundary_only = false;
+  graph.restart(r_factor);
+  graph.run_fm();
+  if (time_limit > 0) {
+    graph.boundary_only = boundary_only;
+    graph.halo = halo;
+    VCycle vcycle(graph);
+    vcycle.run(time_limit);
+  }
+
+  std::string sides(graph.num_cells(), '0');
+  for (uint32_t c = 0; c < graph.num_cells(); ++c) {
+    sides[c] += graph.states[c].partition;
+  }
+
+  reply["cutsize"] = graph.cutsize;
+  reply["seed"] = request_seed;
+  reply["ms"] = std::chrono::duration<double, std::milli>(
+    std::chrono::steady_clock::now() - start).count();
+  reply["partition"] = sides;
+  return reply.dump();
+}
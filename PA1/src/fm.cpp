@@ -5,24 +5,345 @@
 #include <iomanip>
 #include <cstdlib>
 #include "graph.hpp"
+#include "vcycle.hpp"
+#include "batch.hpp"
+#include "daemon.hpp"
 #include <set>
 #include <map>
 #include <ctime>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+// count every heap allocation, once --memory turns counting on;
+// every form of new and delete is replaced so that none of them 
+// mixes the library allocator with this one
+namespace {
+
+void* heap_allocate(size_t size, size_t alignment) {
+  if (count_heap.load(std::memory_order_relaxed)) {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    heap_bytes.fetch_add(size, std::memory_order_relaxed);
+  }
+  size = size ? size : 1;
+  if (alignment <= alignof(std::max_align_t)) {
+    return std::malloc(size);
+  }
+  // aligned_alloc takes a multiple of the alignment
+  return std::aligned_alloc(alignment, 
+                            (size + alignment - 1) / alignment * alignment);
+}
+
+void* heap_allocate_or_throw(size_t size, size_t alignment) {
+  if (void* p = heap_allocate(size, alignment)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+// kept out of line, gcc would otherwise see free called on what new
+// returned wherever a delete is inlined
+__attribute__((noinline)) void heap_free(void* p) noexcept {
+  std::free(p);
+}
+
+}
+
+void* operator new(size_t size) {
+  return heap_allocate_or_throw(size, 0);
+}
+
+void* operator new[](size_t size) {
+  return heap_allocate_or_throw(size, 0);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+  return heap_allocate_or_throw(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+  return heap_allocate_or_throw(size, static_cast<size_t>(alignment));
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return heap_allocate(size, 0);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return heap_allocate(size, 0);
+}
+
+void* operator new(size_t size, std::align_val_t alignment,
+                   const std::nothrow_t&) noexcept {
+  return heap_allocate(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept {
+  return heap_allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept {
+  heap_free(p);
+}
+
+void operator delete[](void* p) noexcept {
+  heap_free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  heap_free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+  heap_free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+  heap_free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+  heap_free(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+  heap_free(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept {
+  heap_free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+  heap_free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+  heap_free(p);
+}
+
+void operator delete(void* p, std::align_val_t, 
+                     const std::nothrow_t&) noexcept {
+  heap_free(p);
+}
+
+void operator delete[](void* p, std::align_val_t, 
+                       const std::nothrow_t&) noexcept {
+  heap_free(p);
+}
 
 int main(int argc, char** argv) {
 
-  if (argc != 3) {
+  // split the options from the positional arguments
+  std::vector<std::string> args;
+  std::string trace_file;
+  bool huge_pages = false;
+  BucketPolicy policy = BucketPolicy::FIFO;
+  double vcycle_seconds = 0.0;
+  std::string manifest_file;
+  std::string summary_file;
+  std::string socket_path;
+  std::string fixed_file;
+  size_t num_threads = 0;
+  bool report_memory = false;
+  uint64_t seed = std::time(nullptr);
+  PinKernel pin_kernel = best_pin_kernel();
+  bool boundary_only = false;
+  size_t halo = 0;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg(argv[i]);
+    if (arg == "--trace" && i+1 < argc) {
+      trace_file = argv[++i];
+    }
+    else if (arg == "--huge-pages") {
+      huge_pages = true;
+    }
+    else if (arg == "--seed" && i+1 < argc) {
+      seed = std::strtoull(argv[++i], nullptr, 10);
+    }
+    else if (arg == "--pin-kernel" && i+1 < argc) {
+      std::string name(argv[++i]);
+      if (name == "scalar") {
+        pin_kernel = PinKernel::SCALAR;
+      }
+      else if (name == "avx2") {
+        pin_kernel = PinKernel::AVX2;
+      }
+      else if (name == "avx512") {
+        pin_kernel = PinKernel::AVX512;
+      }
+      else {
+        std::cerr << "Unknown pin kernel " << name << '\n';
+        return 1;
+      }
+      if (!supports_pin_kernel(pin_kernel)) {
+        std::cerr << "This CPU does not support " << name << '\n';
+        return 1;
+      }
+    }
+    else if (arg == "--boundary" && i+1 < argc) {
+      boundary_only = true;
+      halo = std::atoi(argv[++i]);
+    }
+    else if (arg == "--memory") {
+      report_memory = true;
+      count_heap = true;
+    }
+    else if (arg == "--policy" && i+1 < argc) {
+      std::string name(argv[++i]);
+      if (name == "fifo") {
+        policy = BucketPolicy::FIFO;
+      }
+      else if (name == "lifo") {
+        policy = BucketPolicy::LIFO;
+      }
+      else if (name == "clip") {
+        policy = BucketPolicy::CLIP;
+      }
+      else {
+        std::cerr << "Unknown bucket policy " << name << '\n';
+        return 1;
+      }
+    }
+    else if (arg == "--vcycle" && i+1 < argc) {
+      vcycle_seconds = std::atof(argv[++i]);
+    }
+    else if (arg == "--batch" && i+1 < argc) {
+      manifest_file = argv[++i];
+    }
+    else if (arg == "--fixed" && i+1 < argc) {
+      fixed_file = argv[++i];
+    }
+    else if (arg == "--daemon" && i+1 < argc) {
+      socket_path = argv[++i];
+    }
+    else if (arg == "--summary" && i+1 < argc) {
+      summary_file = argv[++i];
+    }
+    else if (arg == "--threads" && i+1 < argc) {
+      num_threads = std::atoi(argv[++i]);
+    }
+    else {
+      args.emplace_back(arg);
+    }
+  }
+
+  bool batch = !manifest_file.empty();
+  bool daemon = !socket_path.empty();
+  bool wrong = batch ? !args.empty() || daemon :
+               daemon ? args.size() != 1 && args.size() != 2 :
+               args.size() != 2 && args.size() != 3;
+  if (wrong) {
     std::cout << "------Wrong input------\n";
-    std::cout << "./fm input_file output_file\n";
+    std::cout << "./fm input_file output_file [balance_factor] [options]\n";
+    std::cout << "./fm --batch manifest.json [options]\n";
+    std::cout << "./fm --daemon socket input_file [balance_factor] [options]\n";
+    std::cout << "  input_file  : .dat netlist or hMETIS .hgr hypergraph\n";
+    std::cout << "  output_file : .part writes hMETIS partition format\n";
+    std::cout << "  --trace file : record every move into a binary trace\n";
+    std::cout << "  --huge-pages : back the netlist with 2MB huge pages\n";
+    std::cout << "  --policy fifo|lifo|clip : order of the cells in a bucket\n";
+    std::cout << "  --vcycle seconds : refine with V-cycles for up to seconds\n";
+    std::cout << "  --boundary hops : V-cycles move only cells hops from the cut\n";
+    std::cout << "  --fixed file : fix cells, name and side per line or .fix\n";
+    std::cout << "  --seed n : seed of the random partition, the time by default\n";
+    std::cout << "  --pin-kernel scalar|avx2|avx512 : net recount kernel\n";
+    std::cout << "  --memory : report heap allocations per pass and memory use\n";
+    std::cout << "  --batch manifest.json : partition every job of the manifest\n";
+    std::cout << "  --threads n : batch or daemon workers, one per core\n";
+    std::cout << "  --summary file : write the batch summary as JSON\n";
+    std::cout << "  --daemon socket : serve partitions on a UNIX socket\n";
+    return 1;
+  }
+
+  if (batch) {
+    std::vector<BatchJob> jobs = BatchRunner::read_manifest(manifest_file);
+    BatchRunner runner(jobs);
+    runner.huge_pages = huge_pages;
+    runner.policy = policy;
+    runner.vcycle_seconds = vcycle_seconds;
+    runner.seed = seed;
+    runner.pin_kernel = pin_kernel;
+    runner.boundary_only = boundary_only;
+    runner.halo = halo;
+    if (num_threads > 0) {
+      runner.num_threads = num_threads;
+    }
+    runner.run();
+
+    runner.print_summary(std::cout);
+    if (report_memory) {
+      std::cout << "  peak RSS = " << peak_rss() << " bytes\n";
+    }
+    if (!summary_file.empty()) {
+      runner.write_summary(summary_file);
+    }
+    return runner.num_failed() == 0 ? 0 : 1;
   }
 
-  std::srand(std::time(nullptr));
+  if (daemon) {
+    // the default balance factor of the requests
+    double r_factor = args.size() == 2 ? std::atof(args[1].c_str()) : 0.1;
+
+    Hypergraph netlist;
+    netlist.arena.huge_pages = huge_pages;
+    netlist.pin_kernel = pin_kernel;
+    netlist.verbose = false;
+    try {
+      netlist.load(args[0], "", r_factor);
+    }
+    catch (const std::runtime_error& e) {
+      std::cerr << e.what() << '\n';
+      return 1;
+    }
+
+    PartitionDaemon server(netlist, socket_path);
+    server.policy = policy;
+    server.pin_kernel = pin_kernel;
+    server.boundary_only = boundary_only;
+    server.halo = halo;
+    server.seed = seed;
+    if (num_threads > 0) {
+      server.num_threads = num_threads;
+    }
+    std::cout << "  serving " << netlist.num_cells() << " cells of "
+              << args[0] << " on " << socket_path << " with "
+              << server.num_threads << " threads, seed = " << seed << '\n';
+    return server.run() ? 0 : 1;
+  }
 
-  std::string input_file(argv[1]);
+  std::string input_file(args[0]);
   
-  std::string output_file(argv[2]);
+  std::string output_file(args[1]);
 
-  Hypergraph hypergraph(input_file, output_file);
+  // balance factor for .hgr inputs, .dat inputs carry their own
+  double r_factor = args.size() == 3 ? std::atof(args[2].c_str()) : 0.1;
+
+  Hypergraph hypergraph;
+  hypergraph.arena.huge_pages = huge_pages;
+  hypergraph.policy = policy;
+  hypergraph.rng.seed(seed);
+  hypergraph.pin_kernel = pin_kernel;
+  try {
+    hypergraph.read_netlist(input_file, output_file, r_factor);
+    if (!fixed_file.empty()) {
+      hypergraph.read_fixed(fixed_file);
+    }
+    hypergraph.initialize();
+  }
+  catch (const std::runtime_error& e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+
+  std::unique_ptr<MoveTracer> tracer;
+  if (!trace_file.empty()) {
+    tracer = std::make_unique<MoveTracer>(trace_file);
+    hypergraph.tracer = tracer.get();
+  }
+
+  std::cout << "  seed = " << seed << '\n';
 
   std::cout << "  r factor = " << hypergraph.r_factor << '\n';
 
@@ -30,6 +351,15 @@ int main(int argc, char** argv) {
 
   std::cout << "  num of cells = " << hypergraph.num_cells() << '\n';
 
+  if (!hypergraph.fixed.empty()) {
+    std::cout << "  num of fixed cells = " 
+              << hypergraph.num_cells() - std::count(hypergraph.fixed.begin(),
+                                                     hypergraph.fixed.end(), -1)
+              << ", dead nets = " 
+              << std::count(hypergraph.fixed_sides.begin(),
+                            hypergraph.fixed_sides.end(), 3) << '\n';
+  }
+
   std::cout << "  " 
             << hypergraph.area_lower_bound 
             << " <= area <= " 
@@ -38,10 +368,48 @@ int main(int argc, char** argv) {
   std::cout << "  max_gain = " << hypergraph.max_gain << '\n';
   
   std::cout << "  min_gain = " << hypergraph.min_gain << '\n';
-  
+
+  if (report_memory) {
+    std::cout << "  " << heap_allocations << " heap allocations, "
+              << heap_bytes << " bytes before FM\n";
+  }
+
+  hypergraph.report_memory = report_memory;
   hypergraph.run_fm();
 
-  hypergraph.output_answer();
+  if (vcycle_seconds > 0) {
+    std::cout << "  cutsize = " << hypergraph.cutsize << '\n';
+    // a random partition puts nearly every cell on the cut,
+    // so only the refinement of a converged one is restricted
+    hypergraph.boundary_only = boundary_only;
+    hypergraph.halo = halo;
+    VCycle vcycle(hypergraph);
+    vcycle.run(vcycle_seconds);
+  }
+
+  if (tracer) {
+    tracer->close();
+  }
+
+  if (report_memory) {
+    print_memory_usage(std::cout, hypergraph.memory_usage());
+  }
+
+  const std::string suffix = ".part";
+  try {
+    if (output_file.size() >= suffix.size() &&
+        output_file.compare(output_file.size()-suffix.size(),
+                            suffix.size(), suffix) == 0) {
+      hypergraph.output_part();
+    }
+    else {
+      hypergraph.output_answer();
+    }
+  }
+  catch (const std::runtime_error& e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
 
   return 0;
 }
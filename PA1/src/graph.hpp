@@ -1,38 +1,78 @@
 #pragma once
 
+#include <algorithm>
 #include <string>
 #include <vector>
-#include <unordered_map>
 #include <fstream>
 #include <iostream>
 #include <cstdlib>
+#include <cstring>
 #include <set>
 #include <cassert>
+#include <cctype>
 #include <chrono>
 #include <climits>
 #include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include "arena.hpp"
+#include "memory.hpp"
+#include "random.hpp"
+#include "pincount.hpp"
+#include "trace.hpp"
 
 class Net;
 
+// marks the end of a bucket list or an empty bucket
+static constexpr uint32_t no_cell = UINT32_MAX;
+
+// cells and nets live in the Hypergraph arena, their names and
+// pin lists point into the same arena
+//
+// a Cell only holds what the FM passes read but never write,
+// its gain, partition and lock live in Hypergraph::states
 class Cell {
 public:
-  bool locked = false;
-  bool partition = 0;
-  Cell* prev = nullptr;
-  Cell* next = nullptr;
-  int gain = 0;
+  int weight = 1;
   
-  std::string name;
-  std::set<Cell*> connected_cells;
-  std::vector<Net*> nets;
+  std::string_view name;
+  Span<Net*> nets;
 };
 
 class Net {
 public:
   int cnt_cells_p0 = 0;
   int cnt_cells_p1 = 0;
-  std::string name;
-  std::vector<Cell*> cells;
+  int weight = 1;
+  std::string_view name;
+
+  // IDs of the cells on the net
+  Span<uint32_t> cells;
+};
+
+// the part of a cell the FM passes touch on every gain update,
+// packed so that a cache line holds 16 cells
+struct CellState {
+  int gain : 30;
+  unsigned partition : 1;
+  unsigned locked : 1;
+
+  // largest gain magnitude the gain field holds
+  static constexpr long gain_limit = (1L << 29) - 1;
+};
+
+static_assert(sizeof(CellState) == 4, "CellState must stay 32 bits");
+
+// order of the cells within a bucket
+//   FIFO : a relinked cell goes to the tail, buckets are keyed by gain
+//   LIFO : a relinked cell goes to the head, buckets are keyed by gain
+//   CLIP : LIFO keyed by the gain change since the pass started, with
+//          every cell starting in the zero bucket sorted by its gain
+enum class BucketPolicy {
+  FIFO,
+  LIFO,
+  CLIP
 };
 
 
@@ -40,19 +80,112 @@ class Hypergraph {
 public:
   Hypergraph() = default;
 
-  Hypergraph(std::string&, std::string&);
+  Hypergraph(std::string&, std::string&, double = 0.1, bool = false,
+             BucketPolicy = BucketPolicy::FIFO, uint64_t = 0);
 
   std::string output_path;
 
-  std::unordered_map<std::string, Net> map_nets;
+  // owns every cell, net, pin list and name of the netlist
+  Arena arena;
+
+  // cells in the order they are first seen in the input,
+  // for .hgr inputs this is the vertex ID order
+  Span<Cell> cells;
+
+  Span<Net> nets;
+
+  // the pin lists of all nets back to back, net i owns
+  // pins[net_offsets[i]] to pins[net_offsets[i+1]-1]
+  Span<uint32_t> pins;
+
+  Span<uint32_t> net_offsets;
+
+  // open-addressing table from cell name to cell ID, UINT32_MAX if empty
+  Span<uint32_t> cell_index;
+
+  // per cell ID, resized by initialize_state
+  std::vector<CellState> states;
+
+  // links of the bucket lists per cell ID
+  std::vector<uint32_t> prev;
 
-  std::unordered_map<std::string, Cell> map_cells;
+  std::vector<uint32_t> next;
 
-  std::vector<Cell*> bucket;
+  std::vector<uint32_t> bucket;
   
-  std::vector<Cell*> tail_bucket;
+  std::vector<uint32_t> tail_bucket;
+
+  std::vector<uint32_t> locked_cells;
+
+  // per cell ID, the partition the cell is fixed in or -1 if it is free,
+  // empty if no cell is fixed; fixed cells start in their partition
+  // and stay locked through every pass
+  std::vector<int8_t> fixed;
+
+  // per net ID, bit p set if a fixed cell lies in partition p,
+  // empty if no cell is fixed
+  std::vector<uint8_t> fixed_sides;
+
+  // per net ID, bit p set if a locked cell lies in partition p during
+  // the pass, starting from fixed_sides; a net with both bits is dead,
+  // it stays cut whatever the pass moves and adds nothing to any gain,
+  // so update_gain only counts its pins
+  std::vector<uint8_t> locked_sides;
+
+  BucketPolicy policy = BucketPolicy::FIFO;
+
+  // draws the initial partition, seed it before load
+  Random rng;
+
+  // recounts the pins of every net in each partition
+  PinKernel pin_kernel = best_pin_kernel();
+
+  // partition of every cell, 32 per word, filled by pack_partition
+  std::vector<uint32_t> partition_bits;
+
+  // partition of every pin, 64 per word, and pins of every net 
+  // in partition 1, filled by count_pins
+  std::vector<uint64_t> pin_bits;
+
+  std::vector<uint32_t> pin_counts;
+
+  // gains at the start of the pass, kept for CLIP only
+  std::vector<int> initial_gains;
+
+  // only link the cells on cut nets into the buckets, and those within
+  // halo hops of them; other cells are linked once a net of theirs 
+  // becomes cut during the pass
+  bool boundary_only = false;
+
+  size_t halo = 0;
+
+  // per cell ID, set if the cell may be linked during this pass,
+  // kept for boundary_only only
+  std::vector<uint8_t> active;
+
+  // IDs of the active cells, in the order they were activated
+  std::vector<uint32_t> boundary;
 
-  std::vector<Cell*> locked_cells;
+  // per cell ID, the last pass_id that touched the cell, either 
+  // recomputing its gain between passes or recording its CLIP initial 
+  // gain, which an inactive cell only gets when its gain first changes
+  std::vector<uint32_t> stamp;
+
+  uint32_t pass_id = 0;
+
+  // cells linked when the pass started; with boundary_only a pass
+  // also ends after this many moves in a row fail to improve on 
+  // its best cumulative gain, otherwise cutting a net would keep 
+  // drawing in more cells until the pass has moved all of them
+  size_t num_boundary = 0;
+
+  // highest bucket index a cell was relinked into during the current move
+  int max_index = -1;
+
+  // lower bound on the weight of the cells of each partition per bucket,
+  // INT_MAX if the bucket holds none; only lowered by link, reset when 
+  // the bucket empties and made exact whenever one_pass walks a bucket
+  std::vector<int> min_weight[2];
   
   std::vector<int> locked_cells_gain;
 
@@ -74,18 +207,113 @@ public:
 
   size_t num_cells_p0 = 0;
 
+  // total weight of all cells and of the cells in partition 0
+  long total_area = 0;
+
+  long area_p0 = 0;
+
+  // total weight of nets spanning both partitions, 
+  // kept up to date on every move
+  size_t cutsize = 0;
+
+  // total length of all cell names, used to size the output buffers
+  size_t name_bytes = 0;
+
+  // bytes of input text read into the arena
+  size_t input_bytes = 0;
+
+  // number of neighbor gains changed by update_gain
+  size_t num_gain_updates = 0;
+
+  // records every move of one_pass when set
+  MoveTracer* tracer = nullptr;
+
+  // print the gain of every pass
+  bool verbose = true;
+
+  // print the heap allocations of every pass along with its gain
+  bool report_memory = false;
+
   size_t num_nets() const;
 
   size_t num_cells() const;
 
+  bool is_fixed(uint32_t) const;
+
+  bool is_dead(const Net*) const;
+
+  void classify_nets();
+
+  void unlock_nets();
+
+  MemoryUsage memory_usage() const;
+
+  // the readers and writers throw std::runtime_error on a file 
+  // they cannot use
+  void load(const std::string&, const std::string&, double = 0.1);
+
+  void read_netlist(const std::string&, const std::string&, double = 0.1);
+
+  void read_fixed(const std::string&);
+
+  void copy_netlist(const Hypergraph&);
+
+  void restart(double);
+
+  void clear_state();
+
+  char* read_file(const std::string&, size_t&);
+
+  void read_dat(const std::string&);
+
+  void parse_dat(const char*, size_t);
+
+  void read_hgr(const std::string&);
+
+  void link_cells_to_nets(size_t);
+
+  size_t find_slot(std::string_view) const;
+
+  Cell* find_cell(std::string_view) const;
+
+  uint32_t intern_cell(std::string_view);
+
+  void index_cells();
+
+  uint32_t cell_id(const Cell*) const;
+
+  std::set<Cell*> connected_cells(const Cell*) const;
+
+  // throws std::runtime_error if the fixed cells leave no balanced 
+  // partition
+  void initialize();
+
+  void initialize_state();
+
+  void initialize_max_edge();
+
+  void initialize_from_partition();
+
+  void reset_pass();
+
+  void reset_boundary_pass();
+
   void traverse() const;
 
   void initialize_gain();
+
+  int cell_gain(uint32_t) const;
   
   void initialize_partition();
 
   void initialize_count_cells();
 
+  void pack_partition();
+
+  void count_pins();
+
+  size_t evaluate_cutsize();
+
   void display_partition() const;
 
   void display_gain() const;
@@ -94,17 +322,25 @@ public:
 
   void construct_bucket();
 
+  void mark_boundary();
+
+  void expand_boundary();
+
+  void link_boundary();
+
+  void activate(const Net*, uint32_t);
+
   void display_bucket() const;
   
   void run_fm();
 
-  bool meet_balance_criterion(Cell*) const;
+  bool meet_balance_criterion(uint32_t) const;
 
-  void update_gain(Net*, Cell*);
+  void update_gain(Net*, uint32_t);
 
-  void update_bucket(int, Cell*);
+  void update_bucket(int, uint32_t);
 
-  void recover(Cell*);
+  void recover(uint32_t);
 
   size_t find_max_cumulative_gain();
 
@@ -114,186 +350,924 @@ public:
 
   void output_answer();
 
+  void output_part();
+
   void one_pass();
 
-  void delete_from_bucket(Cell*);
+  void delete_from_bucket(uint32_t);
+
+  int bucket_index(int, uint32_t) const;
+
+  void link(int, uint32_t);
+
+  void unlink(int, uint32_t);
+
+  bool may_fit(int) const;
 };
 
 
-Hypergraph::Hypergraph(std::string& input_file, std::string& output_file) {
+Hypergraph::Hypergraph(std::string& input_file, std::string& output_file,
+                       double r, bool huge_pages, BucketPolicy p,
+                       uint64_t seed) {
+  arena.huge_pages = huge_pages;
+  policy = p;
+  rng.seed(seed);
+  load(input_file, output_file, r);
+}
+
+// read a netlist and start from a random partition, dropping the one 
+// read before; the arena mappings and the capacity of the vectors 
+// are kept, so reading many netlists in turn allocates very little
+inline void Hypergraph::load(const std::string& input_file, 
+                             const std::string& output_file, double r) {
+  read_netlist(input_file, output_file, r);
+  initialize();
+}
+
+// load without the initial partition, so cells can be fixed first
+inline void Hypergraph::read_netlist(const std::string& input_file, 
+                                     const std::string& output_file, 
+                                     double r) {
+  arena.clear();
+  cells = Span<Cell>();
+  nets = Span<Net>();
+  pins = Span<uint32_t>();
+  net_offsets = Span<uint32_t>();
+  cell_index = Span<uint32_t>();
+
+  clear_state();
+  fixed.clear();
+  name_bytes = 0;
+  input_bytes = 0;
+
   output_path = output_file;
 
-  std::ifstream inClientFile(input_file, std::ios::in);
+  // .dat inputs carry their own balance factor, .hgr inputs take r
+  r_factor = r;
+
+  const std::string suffix = ".hgr";
+  if (input_file.size() >= suffix.size() &&
+      input_file.compare(input_file.size()-suffix.size(), 
+                         suffix.size(), suffix) == 0) {
+    read_hgr(input_file);
+  }
+  else {
+    read_dat(input_file);
+  }
+
+  // a gain never exceeds the total weight of the cell's nets,
+  // reject netlists whose gains would not fit the packed gain field
+  const Cell* itr;
+  for (itr = cells.begin(); itr != cells.end(); ++itr) {
+    long edge = 0;
+    for (size_t i = 0; i < itr->nets.size(); ++i) {
+      edge += std::labs(itr->nets[i]->weight);
+    }
+    if (edge > CellState::gain_limit) {
+      throw std::runtime_error(
+        "Cell " + std::string(itr->name) + " has nets of total weight " +
+        std::to_string(edge) + ", gains are limited to " + 
+        std::to_string(CellState::gain_limit));
+    }
+  }
+}
+
+// fix the cells listed in a file, either an hMETIS fix file (.fix) 
+// holding the partition of every cell in ID order, -1 if it is free,
+// or lines of a cell name and the partition, 0 or 1, it is fixed in;
+// fixed is left as it was if the file does not match the netlist
+inline void Hypergraph::read_fixed(const std::string& fixed_file) {
+  std::ifstream inFile(fixed_file);
+  if (!inFile) {
+    throw std::runtime_error(
+      "Fixed file " + fixed_file + " could not be opened or does not exist");
+  }
+
+  std::vector<int8_t> sides(cells.size(), -1);
+  const std::string suffix = ".fix";
+  bool hmetis = fixed_file.size() >= suffix.size() &&
+                fixed_file.compare(fixed_file.size()-suffix.size(),
+                                   suffix.size(), suffix) == 0;
+  if (hmetis) {
+    // exactly one entry per cell
+    int side;
+    size_t c = 0;
+    bool valid = true;
+    while (valid && inFile >> side) {
+      valid = c < cells.size() && side >= -1 && side <= 1;
+      if (valid) {
+        sides[c++] = static_cast<int8_t>(side);
+      }
+    }
+    if (!valid || c != cells.size() || !inFile.eof()) {
+      throw std::runtime_error(
+        "Fixed file " + fixed_file + " does not hold one side for each of " +
+        std::to_string(cells.size()) + " cells");
+    }
+  }
+  else {
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(inFile, line)) {
+      ++line_number;
+      std::istringstream fields(line);
+      std::string name;
+      int side;
+      if (!(fields >> name)) {
+        continue;
+      }
+      if (!(fields >> side) || !(fields >> std::ws).eof()) {
+        throw std::runtime_error(
+          "Fixed file " + fixed_file + " line " + 
+          std::to_string(line_number) + " is not a cell name and a side");
+      }
+      Cell* cell = find_cell(name);
+      if (cell == nullptr || (side != 0 && side != 1)) {
+        throw std::runtime_error(
+          "Cell " + name + " cannot be fixed in " + std::to_string(side));
+      }
+      sides[cell_id(cell)] = static_cast<int8_t>(side);
+    }
+  }
+  fixed.swap(sides);
+}
+
+// copy the netlist of source into the arena, dropping the one held
+// before; the names still point into the arena of source
+//
+// the copy is a few memcpys and a pointer rebase, far cheaper than
+// parsing, and leaves source untouched, so threads can each take a
+// copy of one shared netlist and run FM on it at the same time
+inline void Hypergraph::copy_netlist(const Hypergraph& source) {
+  arena.clear();
+  clear_state();
+  fixed.clear();
+
+  size_t num_pins = source.pins.size();
+  arena.reserve(source.cells.size()*sizeof(Cell) + 
+                source.nets.size()*sizeof(Net) +
+                num_pins*(sizeof(uint32_t) + sizeof(Net*)) +
+                (source.net_offsets.size() + 
+                 source.cell_index.size())*sizeof(uint32_t) + 64);
+
+  cells = Span<Cell>(arena.construct<Cell>(source.cells.size()),
+                     source.cells.size());
+  nets = Span<Net>(arena.construct<Net>(source.nets.size()), 
+                   source.nets.size());
+  pins = Span<uint32_t>(arena.allocate<uint32_t>(num_pins), num_pins);
+  net_offsets = Span<uint32_t>(
+    arena.allocate<uint32_t>(source.net_offsets.size()),
+    source.net_offsets.size());
+  cell_index = Span<uint32_t>(
+    arena.allocate<uint32_t>(source.cell_index.size()),
+    source.cell_index.size());
+  std::copy(source.cells.begin(), source.cells.end(), cells.begin());
+  std::copy(source.nets.begin(), source.nets.end(), nets.begin());
+  std::copy(source.pins.begin(), source.pins.end(), pins.begin());
+  std::copy(source.net_offsets.begin(), source.net_offsets.end(),
+            net_offsets.begin());
+  std::copy(source.cell_index.begin(), source.cell_index.end(),
+            cell_index.begin());
+
+  // the cell-to-net lists lie back to back from the first cell on
+  Net** cell_nets = arena.allocate<Net*>(num_pins);
+  Net* const* source_nets = cells.empty() ? nullptr 
+                                          : source.cells[0].nets.data;
+  for (size_t k = 0; k < num_pins; ++k) {
+    cell_nets[k] = nets.data + (source_nets[k] - source.nets.data);
+  }
+  for (size_t i = 0; i < cells.size(); ++i) {
+    cells[i].nets.data = cell_nets + (source.cells[i].nets.data - source_nets);
+  }
+  for (size_t i = 0; i < nets.size(); ++i) {
+    nets[i].cells.data = pins.data + net_offsets[i];
+  }
+
+  output_path = source.output_path;
+  r_factor = source.r_factor;
+  name_bytes = source.name_bytes;
+  input_bytes = 0;
+}
+
+// start over from a random partition of the netlist held, balanced 
+// by r; fixed and the seed of rng are taken as they are, and throw 
+// std::runtime_error if the fixed cells leave no balanced partition
+inline void Hypergraph::restart(double r) {
+  clear_state();
+  r_factor = r;
+  initialize();
+}
+
+// drop the partition, the buckets and the counters of the last run
+inline void Hypergraph::clear_state() {
+  bucket.clear();
+  tail_bucket.clear();
+  locked_cells.clear();
+  locked_cells_gain.clear();
+  initial_gains.clear();
+
+  max_index = -1;
+  max_gain = INT_MIN;
+  min_gain = INT_MAX;
+  max_edge = INT_MIN;
+  next_pass = true;
+  num_cells_p0 = 0;
+  cutsize = 0;
+  num_gain_updates = 0;
+}
+
+// read a whole file into the arena, NUL-terminated
+inline char* Hypergraph::read_file(const std::string& input_file, 
+                                   size_t& size) {
+  std::ifstream inClientFile(input_file, std::ios::in | std::ios::binary);
 
   if (!inClientFile) {
-    std::cerr << "File could not be opened or does not exist\n";
-    exit(1);
+    throw std::runtime_error(
+      "File " + input_file + " could not be opened or does not exist");
   }
 
-  std::string line;
-  inClientFile >> r_factor;
-  
-  std::string net_name;
-  std::string cell_name;
-  std::vector<Cell*> temp;
-
-  while(std::getline(inClientFile, line)) {
-    std::stringstream ss(line);
-    temp.clear();
-    while (std::getline(ss, line, ' ')) {
-      if (line != ";" && line != "NET" && line.length() != 0) {
-        // net string
-        if (line[0] == 'n' || line[0] == 'T') {
-          net_name = line;
-
-          Net n;
-          n.name = net_name;
-          map_nets[net_name] = n;
-        }
-        // cell string
-        else {
-          cell_name = line;
-
-          // new cell
-          if (map_cells.find(cell_name) == map_cells.end()) {
-            Cell c;
-            c.name = cell_name;
-            c.nets.emplace_back(&(map_nets[net_name])); 
-            map_cells[cell_name] = c;
-          }
-          else {
-            map_cells[cell_name].nets.emplace_back(&(map_nets[net_name]));
-          }
-          map_nets[net_name].cells.emplace_back(&(map_cells[cell_name]));
+  inClientFile.seekg(0, std::ios::end);
+  size = static_cast<size_t>(inClientFile.tellg());
+  inClientFile.seekg(0, std::ios::beg);
 
-          // the following is used to initialize the connected cells 
-          for (size_t i = 0; i < temp.size(); ++i) {
-            map_cells[cell_name].connected_cells.insert(temp[i]);
-            temp[i]->connected_cells.insert(&(map_cells[cell_name]));
-          }
-          temp.emplace_back(&(map_cells[cell_name]));
-        }
+  char* text = arena.allocate<char>(size+1);
+  input_bytes += size+1;
+  inClientFile.read(text, size);
+  text[size] = '\0';
+  return text;
+}
+
+inline void Hypergraph::read_dat(const std::string& input_file) {
+  size_t size = 0;
+  char* text = read_file(input_file, size);
+  parse_dat(text, size);
+}
+
+// parse the .dat format in two passes over the text
+//   pass 1 counts the nets and pins to size the arena
+//   pass 2 interns the cells and fills the pin lists
+// names are views into text, which must live in the arena
+//
+// besides the nets, a statement CELL name area ; gives a cell 
+// other than unit area
+inline void Hypergraph::parse_dat(const char* text, size_t size) {
+  const char* ptr = text;
+  const char* end = text + size;
+
+  // next whitespace-separated token, a trailing ';' is its own token
+  auto next_token = [&](std::string_view& token) {
+    while (ptr != end && std::isspace(static_cast<unsigned char>(*ptr))) {
+      ++ptr;
+    }
+    if (ptr == end) {
+      return false;
+    }
+    const char* begin = ptr;
+    while (ptr != end && !std::isspace(static_cast<unsigned char>(*ptr))) {
+      ++ptr;
+    }
+    if (ptr - begin > 1 && *(ptr-1) == ';') {
+      --ptr;
+    }
+    token = std::string_view(begin, ptr - begin);
+    return true;
+  };
+
+  std::string_view token;
+  if (!next_token(token)) {
+    throw std::runtime_error("Empty input");
+  }
+  char* parsed = nullptr;
+  r_factor = std::strtod(token.data(), &parsed);
+  if (parsed != token.data() + token.size()) {
+    throw std::runtime_error("Malformed header: missing balance factor");
+  }
+  const char* body = ptr;
+
+  // pass 1 : count nets, pins and areas
+  size_t num_net = 0;
+  size_t num_pin = 0;
+  size_t num_area = 0;
+  bool is_name = false;
+  // fields left in the current CELL statement
+  int cell_fields = 0;
+  while (next_token(token)) {
+    if (cell_fields > 0) {
+      --cell_fields;
+    }
+    else if (token == "NET") {
+      ++num_net;
+      is_name = true;
+    }
+    else if (token == "CELL") {
+      ++num_area;
+      cell_fields = 2;
+    }
+    else if (is_name) {
+      is_name = false;
+    }
+    else if (token != ";") {
+      ++num_pin;
+    }
+  }
+
+  // every pin or area may introduce a new cell, so cells are sized 
+  // by both; the pages of the unused tail are never touched
+  size_t max_cells = num_pin + num_area;
+  size_t table_size = 16;
+  while (table_size < 2*max_cells) {
+    table_size <<= 1;
+  }
+  arena.reserve(num_net*sizeof(Net) + max_cells*sizeof(Cell) +
+                num_pin*(sizeof(uint32_t) + sizeof(Net*)) +
+                table_size*sizeof(uint32_t) + 64);
+
+  nets = Span<Net>(arena.construct<Net>(num_net), num_net);
+  cells = Span<Cell>(arena.allocate<Cell>(max_cells), 0);
+  cell_index = Span<uint32_t>(arena.allocate<uint32_t>(table_size), 
+                              table_size);
+  std::fill(cell_index.begin(), cell_index.end(), UINT32_MAX);
+  uint32_t* pins = arena.allocate<uint32_t>(num_pin);
+
+  // pass 2 : fill the nets
+  ptr = body;
+  Net* net = nullptr;
+  size_t num = 0;
+  uint32_t cell = 0;
+  while (next_token(token)) {
+    if (cell_fields == 2) {
+      cell = intern_cell(token);
+      --cell_fields;
+    }
+    else if (cell_fields == 1) {
+      long area = std::strtol(token.data(), nullptr, 10);
+      if (area <= 0 || area > INT_MAX) {
+        throw std::runtime_error(
+          "Cell " + std::string(cells[cell].name) + " has invalid area " + 
+          std::string(token));
       }
+      cells[cell].weight = static_cast<int>(area);
+      --cell_fields;
+    }
+    else if (token == "CELL") {
+      cell_fields = 2;
+    }
+    else if (token == "NET") {
+      net = &nets[num++];
+      net->cells.data = pins;
+      is_name = true;
+    }
+    else if (is_name) {
+      net->name = token;
+      is_name = false;
+    }
+    else if (token != ";") {
+      uint32_t id = intern_cell(token);
+      *pins++ = id;
+      ++net->cells.length;
+      // count the degree, link_cells_to_nets turns it into the net list
+      ++cells[id].nets.length;
     }
   }
-  
-  // all cells have unit area
-  area_lower_bound = static_cast<double>(map_cells.size()*(1-r_factor)/2.0);
-  area_upper_bound = static_cast<double>(map_cells.size()*(1+r_factor)/2.0);
+
+  link_cells_to_nets(num_pin);
+}
+
+// cells carry their degree in nets.length,
+// carve the cell-to-net lists out of one array of num_pin entries;
+// the pin lists of the nets must lie back to back in net order
+inline void Hypergraph::link_cells_to_nets(size_t num_pin) {
+  pins = Span<uint32_t>(nets.empty() ? nullptr : nets[0].cells.data, 
+                        num_pin);
+  net_offsets = Span<uint32_t>(arena.allocate<uint32_t>(nets.size()+1),
+                               nets.size()+1);
+  net_offsets[0] = 0;
+  for (size_t i = 0; i < nets.size(); ++i) {
+    net_offsets[i+1] = net_offsets[i] + nets[i].cells.size();
+  }
+
+  Net** cell_nets = arena.allocate<Net*>(num_pin);
+  for (size_t i = 0; i < cells.size(); ++i) {
+    cells[i].nets.data = cell_nets;
+    cell_nets += cells[i].nets.length;
+    cells[i].nets.length = 0;
+  }
+
+  for (size_t i = 0; i < nets.size(); ++i) {
+    for (size_t j = 0; j < nets[i].cells.size(); ++j) {
+      Span<Net*>& list = cells[nets[i].cells[j]].nets;
+      list.data[list.length++] = &nets[i];
+    }
+  }
+}
+
+// slot of name in cell_index, either holding its ID or empty
+inline size_t Hypergraph::find_slot(std::string_view name) const {
+  // FNV-1a
+  uint64_t hash = 14695981039346656037ull;
+  for (char c : name) {
+    hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+  }
+
+  size_t mask = cell_index.size()-1;
+  size_t slot = hash & mask;
+  while (cell_index[slot] != UINT32_MAX && 
+         cells[cell_index[slot]].name != name) {
+    slot = (slot+1) & mask;
+  }
+  return slot;
+}
+
+inline Cell* Hypergraph::find_cell(std::string_view name) const {
+  if (cell_index.empty()) {
+    return nullptr;
+  }
+  size_t slot = find_slot(name);
+  return cell_index[slot] == UINT32_MAX ? nullptr : &cells[cell_index[slot]];
+}
+
+// ID of the cell called name, appended to cells if it is new;
+// cells must have room for it
+inline uint32_t Hypergraph::intern_cell(std::string_view name) {
+  size_t slot = find_slot(name);
+  if (cell_index[slot] == UINT32_MAX) {
+    cell_index[slot] = static_cast<uint32_t>(cells.length);
+    Cell* cell = new (&cells.data[cells.length++]) Cell();
+    cell->name = name;
+    name_bytes += name.length();
+  }
+  return cell_index[slot];
+}
+
+// build cell_index for cells created without intern_cell
+inline void Hypergraph::index_cells() {
+  size_t table_size = 16;
+  while (table_size < 2*cells.size()) {
+    table_size <<= 1;
+  }
+  cell_index = Span<uint32_t>(arena.allocate<uint32_t>(table_size), 
+                              table_size);
+  std::fill(cell_index.begin(), cell_index.end(), UINT32_MAX);
+
+  for (size_t i = 0; i < cells.size(); ++i) {
+    cell_index[find_slot(cells[i].name)] = static_cast<uint32_t>(i);
+  }
+}
+
+inline uint32_t Hypergraph::cell_id(const Cell* cell) const {
+  return static_cast<uint32_t>(cell - cells.begin());
+}
+
+// cells sharing at least one net with target
+inline std::set<Cell*> Hypergraph::connected_cells(const Cell* target) const {
+  std::set<Cell*> connected;
+  for (size_t i = 0; i < target->nets.size(); ++i) {
+    for (size_t j = 0; j < target->nets[i]->cells.size(); ++j) {
+      Cell* cell = &cells[target->nets[i]->cells[j]];
+      if (cell != target) {
+        connected.insert(cell);
+      }
+    }
+  }
+  return connected;
+}
+
+// read a hypergraph in hMETIS format
+//   % comment
+//   num_nets num_cells [fmt]
+//   [net_weight] cell cell ...      (num_nets lines, 1-based cell IDs)
+//   [cell_weight]                   (num_cells lines if fmt is 10 or 11)
+// fmt 1 gives net weights, 10 gives cell weights and 11 gives both
+inline void Hypergraph::read_hgr(const std::string& input_file) {
+  size_t size = 0;
+  const char* text = read_file(input_file, size);
+  const char* ptr = text;
+  const char* end = text + size;
+
+  // move ptr to the next integer on the current line,
+  // returns false at the end of the line
+  auto next_on_line = [&]() {
+    while (ptr != end && (*ptr == ' ' || *ptr == '\t' || *ptr == '\r')) {
+      ++ptr;
+    }
+    return ptr != end && *ptr >= '0' && *ptr <= '9';
+  };
+
+  // values past INT_MAX stick at INT_MAX+1 instead of overflowing
+  auto read_int = [&]() {
+    long value = 0;
+    while (ptr != end && *ptr >= '0' && *ptr <= '9') {
+      value = std::min(value*10 + (*ptr++ - '0'), long(INT_MAX) + 1);
+    }
+    return value;
+  };
+
+  // a net or cell weight, positive and within int as the cell areas
+  // of parse_dat; ptr is at its first digit or at a minus sign
+  auto read_weight = [&](const char* kind, size_t i) {
+    const char* token = ptr;
+    bool negative = *ptr == '-';
+    if (negative) {
+      ++ptr;
+    }
+    long weight = read_int();
+    if (negative || weight <= 0 || weight > INT_MAX) {
+      while (ptr != end && !std::isspace(static_cast<unsigned char>(*ptr))) {
+        ++ptr;
+      }
+      throw std::runtime_error(
+        std::string(kind) + " " + std::to_string(i+1) + 
+        " has invalid weight " + std::string(token, ptr));
+    }
+    return static_cast<int>(weight);
+  };
+
+  // whether ptr is at a weight, next_on_line leaves it at a minus sign
+  auto next_weight = [&]() {
+    return next_on_line() || (ptr != end && *ptr == '-');
+  };
+
+  // move ptr over comment lines starting at ptr
+  auto skip_comments = [&]() {
+    while (ptr != end && *ptr == '%') {
+      while (ptr != end && *ptr != '\n') {
+        ++ptr;
+      }
+      if (ptr != end) {
+        ++ptr;
+      }
+    }
+  };
+
+  // move ptr to the beginning of the next non-comment line
+  auto next_line = [&]() {
+    while (ptr != end && *ptr != '\n') {
+      ++ptr;
+    }
+    if (ptr != end) {
+      ++ptr;
+    }
+    skip_comments();
+  };
+
+  // decimal names "1", "2", ... written back to back into the arena
+  auto make_names = [&](size_t n, const char* prefix) {
+    size_t bytes = 0;
+    for (size_t i = 1; i <= n; ++i) {
+      bytes += std::strlen(prefix) + std::to_string(i).length();
+    }
+    char* names = arena.allocate<char>(bytes);
+    std::vector<std::string_view> views(n);
+    for (size_t i = 1; i <= n; ++i) {
+      std::string name = prefix + std::to_string(i);
+      std::copy(name.begin(), name.end(), names);
+      views[i-1] = std::string_view(names, name.length());
+      names += name.length();
+    }
+    return views;
+  };
+
+  // the number of nets and of cells must be on the header line,
+  // the fmt field may be left out
+  auto header_field = [&](const char* field) {
+    if (!next_on_line()) {
+      throw std::runtime_error(
+        std::string("Malformed hMETIS header: missing ") + field);
+    }
+    return read_int();
+  };
+
+  skip_comments();
+  size_t num_net = header_field("number of nets");
+  size_t num_cell = header_field("number of cells");
+  int fmt = next_on_line() ? read_int() : 0;
+  if (fmt != 0 && fmt != 1 && fmt != 10 && fmt != 11) {
+    throw std::runtime_error(
+      "Malformed hMETIS header: fmt " + std::to_string(fmt) + 
+      " is not 1, 10 or 11");
+  }
+  bool has_net_weights = (fmt % 10 == 1);
+  bool has_cell_weights = (fmt / 10 == 1);
+  const char* body = ptr;
+
+  // every net and every cell weight takes a line of its own, and cell
+  // ids are kept in 32 bits, so a header asking for more is rejected
+  // before anything is sized by it
+  // lines after the header, whose own end is counted among line_ends
+  size_t line_ends = std::count(body, end, '\n') + 
+                     (body != end && end[-1] != '\n');
+  size_t num_line = line_ends == 0 ? 0 : line_ends - 1;
+  if (num_net > num_line || num_cell > UINT32_MAX ||
+      (has_cell_weights && num_cell > num_line - num_net)) {
+    throw std::runtime_error(
+      "Malformed hMETIS header: " + std::to_string(num_net) + " nets and " + 
+      std::to_string(num_cell) + " cells do not fit in " + input_file);
+  }
+
+  // pass 1 : count pins
+  size_t num_pin = 0;
+  for (size_t i = 0; i < num_net; ++i) {
+    next_line();
+    if (has_net_weights && next_weight()) {
+      read_weight("Net", i);
+    }
+    while (next_on_line()) {
+      read_int();
+      ++num_pin;
+    }
+  }
+
+  arena.reserve(num_net*sizeof(Net) + num_cell*sizeof(Cell) +
+                num_pin*(sizeof(uint32_t) + sizeof(Net*)) + 64);
+
+  nets = Span<Net>(arena.construct<Net>(num_net), num_net);
+  cells = Span<Cell>(arena.construct<Cell>(num_cell), num_cell);
+  uint32_t* pins = arena.allocate<uint32_t>(num_pin);
+
+  std::vector<std::string_view> names = make_names(num_cell, "");
+  for (size_t i = 0; i < num_cell; ++i) {
+    cells[i].name = names[i];
+    name_bytes += names[i].length();
+  }
+  names = make_names(num_net, "n");
+  for (size_t i = 0; i < num_net; ++i) {
+    nets[i].name = names[i];
+  }
+
+  // pass 2 : fill the nets
+  ptr = body;
+  for (size_t i = 0; i < num_net; ++i) {
+    next_line();
+
+    Net& n = nets[i];
+    n.cells.data = pins;
+
+    if (has_net_weights && next_weight()) {
+      n.weight = read_weight("Net", i);
+    }
+
+    while (next_on_line()) {
+      size_t id = read_int();
+      if (id == 0 || id > num_cell) {
+        throw std::runtime_error(
+          "Net " + std::to_string(i+1) + " refers to cell " + 
+          std::to_string(id) + " out of range");
+      }
+      *pins++ = static_cast<uint32_t>(id-1);
+      ++n.cells.length;
+      ++cells[id-1].nets.length;
+    }
+  }
+
+  if (has_cell_weights) {
+    for (size_t i = 0; i < num_cell; ++i) {
+      next_line();
+      if (next_weight()) {
+        cells[i].weight = read_weight("Cell", i);
+      }
+    }
+  }
+
+  link_cells_to_nets(num_pin);
+
+  index_cells();
+}
+
+inline void Hypergraph::initialize() {
+  initialize_state();
+
+  // balance the total cell weight, the cell count if all cells have unit area
+  total_area = 0;
+  Cell* itr;
+  for (itr = cells.begin(); itr != cells.end(); ++itr) {
+    total_area += itr->weight;
+  }
+  area_lower_bound = static_cast<double>(total_area*(1-r_factor)/2.0);
+  area_upper_bound = static_cast<double>(total_area*(1+r_factor)/2.0);
 
   // initialize partition
   initialize_partition();
 
+  classify_nets();
+
   // initialize the gain for each cell
   initialize_gain();
 
-  std::unordered_map<std::string, Cell>::iterator itr;
-  for (itr = map_cells.begin(); itr != map_cells.end(); ++itr) {
-    max_edge = max_edge > static_cast<int>(itr->second.nets.size()) 
-             ? max_edge : static_cast<int>(itr->second.nets.size());
-  }
+  initialize_max_edge();
   
   // construct bucket data structure
   construct_bucket();
 }
 
+// a cell can gain or lose at most the total weight of its nets
+inline void Hypergraph::initialize_max_edge() {
+  const Cell* itr;
+  for (itr = cells.begin(); itr != cells.end(); ++itr) {
+    int edge = 0;
+    for (size_t i = 0; i < itr->nets.size(); ++i) {
+      edge += itr->nets[i]->weight;
+    }
+    max_edge = max_edge > edge ? max_edge : edge;
+  }
+  assert(max_edge <= CellState::gain_limit);
+}
+
+// prepare run_fm to start from the partition already in states
+// instead of a random one
+inline void Hypergraph::initialize_from_partition() {
+  num_cells_p0 = 0;
+  for (uint32_t c = 0; c < cells.size(); ++c) {
+    if (states[c].partition == 0) {
+      ++num_cells_p0;
+    }
+  }
+
+  Net* itr0;
+  for (itr0 = nets.begin(); itr0 != nets.end(); ++itr0) {
+    itr0->cnt_cells_p0 = 0;
+    itr0->cnt_cells_p1 = 0;
+  }
+  initialize_count_cells();
+  classify_nets();
+
+  next_pass = true;
+  reset_pass();
+}
+
+// zeroed state and unlinked bucket lists for every cell
+inline void Hypergraph::initialize_state() {
+  states.assign(cells.size(), CellState());
+  prev.assign(cells.size(), no_cell);
+  next.assign(cells.size(), no_cell);
+}
+
 inline size_t Hypergraph::num_nets() const {
-  return map_nets.size();  
+  return nets.size();  
 }
 
 inline size_t Hypergraph::num_cells() const { 
-  return map_cells.size();
+  return cells.size();
 }
 
-inline void Hypergraph::traverse() const {
-  // traverse map_nets
-  std::unordered_map<std::string, Net>::const_iterator itr0;
-  for (itr0 = map_nets.begin(); itr0 != map_nets.end(); ++itr0) {
-    assert(itr0->first == itr0->second.name);
+inline bool Hypergraph::is_fixed(uint32_t c) const {
+  return !fixed.empty() && fixed[c] >= 0;
+}
+
+// set if fixed cells lie in both partitions of net, 
+// which is then dead through every pass
+inline bool Hypergraph::is_dead(const Net* net) const {
+  return !fixed_sides.empty() && fixed_sides[net - nets.begin()] == 3;
+}
 
-    std::cout << "NET " << itr0->first << " : ";
-    for (size_t i = 0; i < itr0->second.cells.size(); ++i) {
-      if (i == itr0->second.cells.size()-1) {
-        std::cout << itr0->second.cells[i]->name << '\n';
+// find the partitions of the fixed cells of every net
+inline void Hypergraph::classify_nets() {
+  fixed_sides.clear();
+  if (!fixed.empty()) {
+    fixed_sides.assign(nets.size(), 0);
+    for (size_t i = 0; i < nets.size(); ++i) {
+      for (size_t j = 0; j < nets[i].cells.size(); ++j) {
+        uint32_t c = nets[i].cells[j];
+        if (is_fixed(c)) {
+          fixed_sides[i] |= 1 << fixed[c];
+        }
+      }
+    }
+  }
+  unlock_nets();
+}
+
+// only the fixed cells are locked when a pass starts
+inline void Hypergraph::unlock_nets() {
+  if (fixed_sides.empty()) {
+    locked_sides.assign(nets.size(), 0);
+  }
+  else {
+    locked_sides = fixed_sides;
+  }
+}
+
+// bytes held right now, the vectors never shrink so this is also 
+// their peak
+inline MemoryUsage Hypergraph::memory_usage() const {
+  MemoryUsage usage;
+  usage.input = input_bytes;
+  usage.cell_index = cell_index.size()*sizeof(uint32_t);
+  usage.netlist = arena.bytes_allocated() - usage.input - usage.cell_index;
+  usage.cell_state = states.capacity()*sizeof(CellState) +
+                     (prev.capacity() + next.capacity() +
+                      partition_bits.capacity() + 
+                      pin_counts.capacity())*sizeof(uint32_t) +
+                     pin_bits.capacity()*sizeof(uint64_t) +
+                     (boundary.capacity() + 
+                      stamp.capacity())*sizeof(uint32_t) +
+                     active.capacity() + fixed.capacity() + 
+                     fixed_sides.capacity() + locked_sides.capacity();
+  usage.buckets = 
+    (bucket.capacity() + tail_bucket.capacity())*sizeof(uint32_t) +
+    (min_weight[0].capacity() + min_weight[1].capacity() +
+     initial_gains.capacity())*sizeof(int);
+  usage.locked_cells = locked_cells.capacity()*sizeof(uint32_t) +
+                       locked_cells_gain.capacity()*sizeof(int);
+  usage.arena_mapped = arena.bytes_mapped();
+  return usage;
+}
+
+inline void Hypergraph::traverse() const {
+  // traverse nets
+  const Net* itr0;
+  for (itr0 = nets.begin(); itr0 != nets.end(); ++itr0) {
+    std::cout << "NET " << itr0->name << " : ";
+    for (size_t i = 0; i < itr0->cells.size(); ++i) {
+      if (i == itr0->cells.size()-1) {
+        std::cout << cells[itr0->cells[i]].name << '\n';
       }
       else {
-        std::cout << itr0->second.cells[i]->name << ", ";;
+        std::cout << cells[itr0->cells[i]].name << ", ";;
       } 
     }
   }
   
-  // traverse map_cells
-  std::unordered_map<std::string, Cell>::const_iterator itr1;
-  for (itr1 = map_cells.begin(); itr1 != map_cells.end(); ++itr1) {
-    assert(itr1->first == itr1->second.name);
-
-    std::cout << "Cell " << itr1->first << " belongs to ";
-    for (size_t i = 0; i < itr1->second.nets.size(); ++i) {
-      if (i == itr1->second.nets.size()-1) {
-        std::cout << itr1->second.nets[i]->name << '\n';
+  // traverse cells
+  const Cell* itr1;
+  for (itr1 = cells.begin(); itr1 != cells.end(); ++itr1) {
+    assert(find_cell(itr1->name) == itr1);
+
+    std::cout << "Cell " << itr1->name << " belongs to ";
+    for (size_t i = 0; i < itr1->nets.size(); ++i) {
+      if (i == itr1->nets.size()-1) {
+        std::cout << itr1->nets[i]->name << '\n';
       }
       else {
-        std::cout << itr1->second.nets[i]->name << ", ";
+        std::cout << itr1->nets[i]->name << ", ";
       }
     }
   }  
 }
 
 inline void Hypergraph::initialize_gain() {
-  std::unordered_map<std::string, Cell>::iterator itr;
-  for (itr = map_cells.begin(); itr != map_cells.end(); ++itr) {
-    int gain = 0;
-    int FromBlock = 0;
-    int ToBlock = 0;
+  for (uint32_t c = 0; c < cells.size(); ++c) {
+    CellState& state = states[c];
+    state.gain = cell_gain(c);
+    max_gain = state.gain > max_gain ? state.gain : max_gain;
+    min_gain = state.gain < min_gain ? state.gain : min_gain;
+  } 
+}
 
-    for (size_t i = 0; i < itr->second.nets.size(); ++i) {
-      if (itr->second.partition == 0) {
-        FromBlock = itr->second.nets[i]->cnt_cells_p0;
-        ToBlock = itr->second.nets[i]->cnt_cells_p1;
-      }
-      else {
-        FromBlock = itr->second.nets[i]->cnt_cells_p1;
-        ToBlock = itr->second.nets[i]->cnt_cells_p0;
-      }
+// gain of moving cell c under the current net counts
+inline int Hypergraph::cell_gain(uint32_t c) const {
+  const Span<Net*>& cell_nets = cells[c].nets;
+  bool partition = states[c].partition;
+  int gain = 0;
+  int FromBlock = 0;
+  int ToBlock = 0;
 
-      if (FromBlock == 1) {
-        ++gain;
-      }
-      if (ToBlock == 0) {
-        --gain;
-      }
+  for (size_t i = 0; i < cell_nets.size(); ++i) {
+    if (is_dead(cell_nets[i])) {
+      continue;
+    }
+    if (partition == 0) {
+      FromBlock = cell_nets[i]->cnt_cells_p0;
+      ToBlock = cell_nets[i]->cnt_cells_p1;
+    }
+    else {
+      FromBlock = cell_nets[i]->cnt_cells_p1;
+      ToBlock = cell_nets[i]->cnt_cells_p0;
+    }
 
-      itr->second.gain = gain;
+    if (FromBlock == 1) {
+      gain += cell_nets[i]->weight;
     }
-    max_gain = itr->second.gain > max_gain ? itr->second.gain : max_gain;
-    min_gain = itr->second.gain < min_gain ? itr->second.gain : min_gain;
-  } 
+    if (ToBlock == 0) {
+      gain -= cell_nets[i]->weight;
+    }
+  }
+  return gain;
 }
 
 inline void Hypergraph::display_partition() const {
-  std::unordered_map<std::string, Cell>::const_iterator itr;
-  for (itr = map_cells.begin(); itr != map_cells.end(); ++itr) {
-    std::cout << itr->second.name 
+  const Cell* itr;
+  for (itr = cells.begin(); itr != cells.end(); ++itr) {
+    std::cout << itr->name 
               << " at partition " 
-              << itr->second.partition << '\n'; 
+              << states[cell_id(itr)].partition << '\n'; 
   }  
 }
 
 inline void Hypergraph::display_gain() const {
-  std::unordered_map<std::string, Cell>::const_iterator itr;
-  for (itr = map_cells.begin(); itr != map_cells.end(); ++itr) {
-    std::cout << itr->second.name 
+  const Cell* itr;
+  for (itr = cells.begin(); itr != cells.end(); ++itr) {
+    std::cout << itr->name 
               << " has gain " 
-              << itr->second.gain << '\n'; 
+              << states[cell_id(itr)].gain << '\n'; 
   }  
 }
 
 inline void Hypergraph::display_connected_cells() const {
-  std::unordered_map<std::string, Cell>::const_iterator itr;
-  for (itr = map_cells.begin(); itr != map_cells.end(); ++itr) {
-    std::cout << itr->second.name 
+  const Cell* itr;
+  for (itr = cells.begin(); itr != cells.end(); ++itr) {
+    std::cout << itr->name 
               << " connects with ";
-    for (auto& cptr : itr->second.connected_cells) {
+    for (auto& cptr : connected_cells(itr)) {
       std::cout << cptr->name << " ";    
     }
     std::cout << '\n';
@@ -301,50 +1275,215 @@ inline void Hypergraph::display_connected_cells() const {
 }
 
 inline void Hypergraph::construct_bucket() {
-  bucket.resize(2*max_edge+1);
-  tail_bucket.resize(2*max_edge+1);
-  int offset = max_edge;
+  num_boundary = cells.size();
+  if (boundary_only) {
+    mark_boundary();
+    link_boundary();
+    return;
+  }
 
-  std::unordered_map<std::string, Cell>::iterator itr;
-  for (itr = map_cells.begin(); itr != map_cells.end(); ++itr) {
-    if (bucket[itr->second.gain+offset] == nullptr) {
-      bucket[itr->second.gain+offset] = &(itr->second);
-      tail_bucket[itr->second.gain+offset] = &(itr->second);
+  if (policy != BucketPolicy::CLIP) {
+    bucket.resize(2*max_edge+1, no_cell);
+    tail_bucket.resize(2*max_edge+1, no_cell);
+    min_weight[0].assign(bucket.size(), INT_MAX);
+    min_weight[1].assign(bucket.size(), INT_MAX);
+
+    for (uint32_t c = 0; c < cells.size(); ++c) {
+      if (!states[c].locked) {
+        link(bucket_index(states[c].gain, c), c);
+      }
     }
-    else {
-      tail_bucket[itr->second.gain+offset]->next = &(itr->second);
-      itr->second.prev = tail_bucket[itr->second.gain+offset];
-      tail_bucket[itr->second.gain+offset] = 
-      tail_bucket[itr->second.gain+offset]->next;
+    return;
+  }
+
+  // a gain can move by up to 2*max_edge either way from its initial
+  // value during a pass
+  bucket.resize(4*max_edge+1, no_cell);
+  tail_bucket.resize(4*max_edge+1, no_cell);
+  min_weight[0].assign(bucket.size(), INT_MAX);
+  min_weight[1].assign(bucket.size(), INT_MAX);
+
+  initial_gains.resize(cells.size());
+  for (uint32_t c = 0; c < cells.size(); ++c) {
+    initial_gains[c] = states[c].gain;
+  }
+
+  // fill the zero bucket from the lowest gain up, 
+  // so the head holds the highest gain
+  std::vector<uint32_t> order(cells.size());
+  for (uint32_t c = 0; c < cells.size(); ++c) {
+    order[c] = c;
+  }
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return initial_gains[a] < initial_gains[b];
+  });
+  for (uint32_t c : order) {
+    if (!states[c].locked) {
+      link(2*max_edge, c);
+    }
+  }
+}
+
+// activate the cells on cut nets, then their neighbors halo times
+inline void Hypergraph::mark_boundary() {
+  active.assign(cells.size(), 0);
+  stamp.resize(cells.size(), 0);
+  boundary.clear();
+
+  for (size_t i = 0; i < nets.size(); ++i) {
+    const Net& net = nets[i];
+    if (net.cnt_cells_p0 == 0 || net.cnt_cells_p1 == 0 || is_dead(&net)) {
+      continue;
+    }
+    for (size_t j = 0; j < net.cells.size(); ++j) {
+      if (!active[net.cells[j]]) {
+        active[net.cells[j]] = 1;
+        boundary.push_back(net.cells[j]);
+      }
+    }
+  }
+  expand_boundary();
+}
+
+// activate the neighbors of the boundary cells halo times
+inline void Hypergraph::expand_boundary() {
+  size_t begin = 0;
+  for (size_t hop = 0; hop < halo && begin < boundary.size(); ++hop) {
+    size_t end = boundary.size();
+    for (size_t k = begin; k < end; ++k) {
+      const Span<Net*>& cell_nets = cells[boundary[k]].nets;
+      for (size_t i = 0; i < cell_nets.size(); ++i) {
+        const Span<uint32_t>& net_cells = cell_nets[i]->cells;
+        for (size_t j = 0; j < net_cells.size(); ++j) {
+          if (!active[net_cells[j]]) {
+            active[net_cells[j]] = 1;
+            boundary.push_back(net_cells[j]);
+          }
+        }
+      }
+    }
+    begin = end;
+  }
+}
+
+// rebuild the buckets from the boundary cells alone
+inline void Hypergraph::link_boundary() {
+  ++pass_id;
+  num_boundary = boundary.size();
+
+  size_t size = policy == BucketPolicy::CLIP ? 4*max_edge+1 : 2*max_edge+1;
+  bucket.assign(size, no_cell);
+  tail_bucket.assign(size, no_cell);
+  min_weight[0].assign(size, INT_MAX);
+  min_weight[1].assign(size, INT_MAX);
+
+  if (policy != BucketPolicy::CLIP) {
+    for (uint32_t c : boundary) {
+      if (!states[c].locked) {
+        link(bucket_index(states[c].gain, c), c);
+      }
+    }
+    return;
+  }
+
+  initial_gains.resize(cells.size());
+  for (uint32_t c : boundary) {
+    initial_gains[c] = states[c].gain;
+    stamp[c] = pass_id;
+  }
+  std::stable_sort(boundary.begin(), boundary.end(), 
+                   [&](uint32_t a, uint32_t b) {
+    return initial_gains[a] < initial_gains[b];
+  });
+  for (uint32_t c : boundary) {
+    if (!states[c].locked) {
+      link(2*max_edge, c);
     }
   }
 }
 
+// link the cells of a net that has just become cut, 
+// except base which is being moved
+inline void Hypergraph::activate(const Net* net, uint32_t base) {
+  for (size_t i = 0; i < net->cells.size(); ++i) {
+    uint32_t c = net->cells[i];
+    if (c == base || active[c] || states[c].locked) {
+      continue;
+    }
+    active[c] = 1;
+    boundary.push_back(c);
+    if (policy == BucketPolicy::CLIP && stamp[c] != pass_id) {
+      stamp[c] = pass_id;
+      initial_gains[c] = states[c].gain;
+    }
+    int index = bucket_index(states[c].gain, c);
+    link(index, c);
+    if (index > max_index) {
+      max_index = index;
+    }
+  }
+}
+
+// bucket of cell c when its gain is gain
+inline int Hypergraph::bucket_index(int gain, uint32_t c) const {
+  if (policy == BucketPolicy::CLIP) {
+    return gain - initial_gains[c] + 2*max_edge;
+  }
+  return gain + max_edge;
+}
+
+// put target into the list at index, at the tail for FIFO
+// and at the head otherwise
+inline void Hypergraph::link(int index, uint32_t target) {
+  int& weight = min_weight[states[target].partition][index];
+  weight = std::min(weight, cells[target].weight);
+
+  if (bucket[index] == no_cell) {
+    prev[target] = no_cell;
+    next[target] = no_cell;
+    bucket[index] = target;
+    tail_bucket[index] = target;
+  }
+  else if (policy == BucketPolicy::FIFO) {
+    next[tail_bucket[index]] = target;
+    prev[target] = tail_bucket[index];
+    next[target] = no_cell;
+    tail_bucket[index] = target;
+  }
+  else {
+    prev[bucket[index]] = target;
+    next[target] = bucket[index];
+    prev[target] = no_cell;
+    bucket[index] = target;
+  }
+}
+
 inline void Hypergraph::display_bucket() const {
   for (size_t i = 0; i < bucket.size(); ++i) {
-    if (bucket[i] != nullptr) {
-      Cell* head = bucket[i];
+    if (bucket[i] != no_cell) {
+      uint32_t head = bucket[i];
       std::cout << "bucket[" << static_cast<int>(i - max_edge) << "] has cells: ";
-      while (head) {
-        std::cout << head->name << " ";
-        head = head->next;
+      while (head != no_cell) {
+        std::cout << cells[head].name << " ";
+        head = next[head];
       }
       std::cout << '\n';
     }
   }
 }
 
-inline bool Hypergraph::meet_balance_criterion(Cell* candidate) const {
-  if (candidate->partition == 0) {
-    if (area_lower_bound < (num_cells_p0-1) &&
-        area_upper_bound > (num_cells_p0-1)) {
+inline bool Hypergraph::meet_balance_criterion(uint32_t candidate) const {
+  long weight = cells[candidate].weight;
+  if (states[candidate].partition == 0) {
+    if (area_lower_bound < (area_p0-weight) &&
+        area_upper_bound > (area_p0-weight)) {
       return true;
     }
     return false;
   }
   else {
-    if (area_lower_bound < (num_cells_p0+1) &&
-        area_upper_bound > (num_cells_p0+1)) {
+    if (area_lower_bound < (area_p0+weight) &&
+        area_upper_bound > (area_p0+weight)) {
       return true;
     }
     return false;
@@ -354,66 +1493,152 @@ inline bool Hypergraph::meet_balance_criterion(Cell* candidate) const {
 inline void Hypergraph::run_fm() {
   size_t pass = 1;
   while(1) {
-    std::cout << "  Running pass " << pass++;
+    if (verbose) {
+      std::cout << "  Running pass " << pass;
+    }
+    ++pass;
+    size_t allocations = heap_allocations.load(std::memory_order_relaxed);
+    size_t bytes = heap_bytes.load(std::memory_order_relaxed);
     one_pass();
 
     // prepare for the next pass
     if (next_pass) {
-      // reset the cell state except the partition
-      std::unordered_map<std::string, Cell>::iterator itr;
-      for (itr = map_cells.begin(); itr != map_cells.end(); ++itr) {
-        itr->second.locked = false;
-        itr->second.prev = nullptr;
-        itr->second.next = nullptr;
-        itr->second.gain = 0;
-      }
-
-      max_gain = INT_MIN;
-      min_gain = INT_MAX;
-      bucket.clear();
-      tail_bucket.clear();
-      locked_cells.clear();
-      locked_cells_gain.clear();
-      initialize_gain();
-      construct_bucket();
+      if (boundary_only) {
+        reset_boundary_pass();
+      }
+      else {
+        reset_pass();
+      }
     }
-    else {
+
+    if (verbose && report_memory) {
+      allocations = heap_allocations.load(std::memory_order_relaxed) - 
+                    allocations;
+      bytes = heap_bytes.load(std::memory_order_relaxed) - bytes;
+      std::cout << "    " << allocations << " heap allocations, " 
+                << bytes << " bytes\n";
+    }
+
+    if (!next_pass) {
       break;
     }
   }
 }
 
-inline void Hypergraph::recover(Cell* target) {
-  int old_gain = target->gain;
+// reset the cell state except the partition and rebuild the buckets
+inline void Hypergraph::reset_pass() {
+  for (uint32_t c = 0; c < cells.size(); ++c) {
+    states[c].locked = is_fixed(c);
+    states[c].gain = 0;
+  }
+  prev.assign(cells.size(), no_cell);
+  next.assign(cells.size(), no_cell);
+
+  max_gain = INT_MIN;
+  min_gain = INT_MAX;
+  bucket.clear();
+  tail_bucket.clear();
+  locked_cells.clear();
+  locked_cells_gain.clear();
+  unlock_nets();
+  initialize_gain();
+  construct_bucket();
+}
 
-  if (target->partition == 0) {
+// reset_pass in time proportional to the cells the last pass touched;
+// only the nets of moved cells changed their counts, and every cell on
+// a cut net is still active, since the net was either cut when the pass
+// started or had its cells activated when it became cut
+inline void Hypergraph::reset_boundary_pass() {
+  ++pass_id;
+  for (uint32_t c : locked_cells) {
+    states[c].locked = false;
+  }
+  for (uint32_t c : locked_cells) {
+    const Span<Net*>& cell_nets = cells[c].nets;
+    for (size_t i = 0; i < cell_nets.size(); ++i) {
+      size_t n = cell_nets[i] - nets.begin();
+      locked_sides[n] = fixed_sides.empty() ? 0 : fixed_sides[n];
+      const Span<uint32_t>& net_cells = cell_nets[i]->cells;
+      for (size_t j = 0; j < net_cells.size(); ++j) {
+        uint32_t u = net_cells[j];
+        if (stamp[u] != pass_id) {
+          stamp[u] = pass_id;
+          states[u].gain = cell_gain(u);
+        }
+      }
+    }
+  }
+  locked_cells.clear();
+  locked_cells_gain.clear();
+
+  // keep the active cells that are on a cut net, then grow the halo
+  for (uint32_t c : boundary) {
+    active[c] = 0;
+  }
+  size_t kept = 0;
+  for (uint32_t c : boundary) {
+    const Span<Net*>& cell_nets = cells[c].nets;
+    for (size_t i = 0; i < cell_nets.size(); ++i) {
+      const Net* net = cell_nets[i];
+      if (net->cnt_cells_p0 != 0 && net->cnt_cells_p1 != 0 && !is_dead(net)) {
+        active[c] = 1;
+        boundary[kept++] = c;
+        break;
+      }
+    }
+  }
+  boundary.resize(kept);
+  expand_boundary();
+  link_boundary();
+}
+
+inline void Hypergraph::recover(uint32_t target) {
+  CellState& state = states[target];
+
+  if (state.partition == 0) {
     --num_cells_p0;
-    target->partition = 1;
+    area_p0 -= cells[target].weight;
+    state.partition = 1;
   }
   else {
     ++num_cells_p0;
-    target->partition = 0;
+    area_p0 += cells[target].weight;
+    state.partition = 0;
   }
   
-  for (size_t i = 0; i < target->nets.size(); ++i) {
-    if (target->partition == 1) {
-      --target->nets[i]->cnt_cells_p0;
-      ++target->nets[i]->cnt_cells_p1;
+  const Span<Net*>& target_nets = cells[target].nets;
+  for (size_t i = 0; i < target_nets.size(); ++i) {
+    Net* net = target_nets[i];
+    bool was_cut = (net->cnt_cells_p0 != 0 && net->cnt_cells_p1 != 0);
+
+    if (state.partition == 1) {
+      --net->cnt_cells_p0;
+      ++net->cnt_cells_p1;
     }
     else {
-      ++target->nets[i]->cnt_cells_p0;
-      --target->nets[i]->cnt_cells_p1;
+      ++net->cnt_cells_p0;
+      --net->cnt_cells_p1;
+    }
+
+    bool is_cut = (net->cnt_cells_p0 != 0 && net->cnt_cells_p1 != 0);
+    if (is_cut && !was_cut) {
+      cutsize += net->weight;
+    }
+    else if (!is_cut && was_cut) {
+      cutsize -= net->weight;
     }
   }
 }
 
 // update the gain of the target cell 
-inline void Hypergraph::update_gain(Net* net, Cell* base) {
+inline void Hypergraph::update_gain(Net* net, uint32_t base) {
   int FromBlock = 0;
   int ToBlock = 0;
   int temp = 0;
+  bool base_partition = states[base].partition;
 
-  if (base->partition == 0) {
+  if (base_partition == 0) {
     FromBlock = net->cnt_cells_p0;
     ToBlock = net->cnt_cells_p1;
     
@@ -427,130 +1652,239 @@ inline void Hypergraph::update_gain(Net* net, Cell* base) {
     ++(net->cnt_cells_p0); 
     --(net->cnt_cells_p1); 
   }
+
+  // base is locked on the to side once moved; if the net was already
+  // dead, no gain changes and the cut stays
+  if (!locked_sides.empty()) {
+    uint8_t& sides = locked_sides[net - nets.begin()];
+    bool dead = sides == 3;
+    sides |= 1 << !base_partition;
+    if (dead) {
+      return;
+    }
+  }
+
   if (ToBlock == 0) {
     for (size_t i = 0; i < net->cells.size(); ++i) {
-      if (net->cells[i] == base) {
+      uint32_t c = net->cells[i];
+      if (c == base) {
         continue;
       }
-      if (!net->cells[i]->locked) {
-        temp = net->cells[i]->gain;
-        ++(net->cells[i]->gain);
-        update_bucket(temp, net->cells[i]);
+      if (!states[c].locked) {
+        temp = states[c].gain;
+        states[c].gain += net->weight;
+        update_bucket(temp, c);
       }
     } 
   }
   else if (ToBlock == 1) {
     for (size_t i = 0; i < net->cells.size(); ++i) {
-      if (net->cells[i] == base) {
+      uint32_t c = net->cells[i];
+      if (c == base) {
         continue;
       }
-      if (!net->cells[i]->locked && 
-          net->cells[i]->partition == !(base->partition)) {
-        temp = net->cells[i]->gain;
-        --(net->cells[i]->gain);
-        update_bucket(temp, net->cells[i]);
+      if (!states[c].locked && 
+          states[c].partition == !base_partition) {
+        temp = states[c].gain;
+        states[c].gain -= net->weight;
+        update_bucket(temp, c);
       }
     }
   }
   
   --FromBlock;
   ++ToBlock;
+
+  // the net was uncut iff nothing sat on the to side,
+  // and stays cut iff something is left on the from side
+  if (ToBlock == 1 && FromBlock != 0) {
+    cutsize += net->weight;
+    if (boundary_only) {
+      activate(net, base);
+    }
+  }
+  else if (ToBlock != 1 && FromBlock == 0) {
+    cutsize -= net->weight;
+  }
+
   if (FromBlock == 0) {
     for (size_t i = 0; i < net->cells.size(); ++i) {
-      if (net->cells[i] == base) {
+      uint32_t c = net->cells[i];
+      if (c == base) {
         continue;
       }
-      if (!net->cells[i]->locked) {
-        temp = net->cells[i]->gain;
-        --(net->cells[i]->gain);
-        update_bucket(temp, net->cells[i]);
+      if (!states[c].locked) {
+        temp = states[c].gain;
+        states[c].gain -= net->weight;
+        update_bucket(temp, c);
       }
     }
   }
   else if (FromBlock == 1) {
     for (size_t i = 0; i < net->cells.size(); ++i) {
-      if (net->cells[i] == base) {
+      uint32_t c = net->cells[i];
+      if (c == base) {
         continue;
       }
-      if (!net->cells[i]->locked &&
-          net->cells[i]->partition == base->partition) {
-        temp = net->cells[i]->gain;
-        ++(net->cells[i]->gain);
-        update_bucket(temp, net->cells[i]);
+      if (!states[c].locked &&
+          states[c].partition == base_partition) {
+        temp = states[c].gain;
+        states[c].gain += net->weight;
+        update_bucket(temp, c);
       }
     }
   }
 }
 
-inline void Hypergraph::delete_from_bucket(Cell* target) {
-  int old_index = -1*target->gain + max_edge;
+// unlink target from the list at index
+inline void Hypergraph::unlink(int index, uint32_t target) {
+  uint32_t p = prev[target];
+  uint32_t n = next[target];
 
-  if (target->prev != nullptr) {
-    if (target->next != nullptr) {
-      target->prev->next = target->next;
-      target->next->prev = target->prev;
-    }
-    // target is the last
-    else {
-      target->prev->next = nullptr;
-      tail_bucket[old_index] = target->prev;
-    }
+  if (p != no_cell) {
+    next[p] = n;
   }
   // target is the first
   else {
-    if (target->next != nullptr) {
-      bucket[old_index] = target->next;
-      target->next->prev = nullptr;     
-    }
-    // target is the only element
-    else {
-      bucket[old_index] = nullptr;
-      tail_bucket[old_index] = nullptr;
-    }
+    bucket[index] = n;
+  }
+
+  if (n != no_cell) {
+    prev[n] = p;
+  }
+  // target is the last
+  else {
+    tail_bucket[index] = p;
   }
+
+  if (bucket[index] == no_cell) {
+    min_weight[0][index] = INT_MAX;
+    min_weight[1][index] = INT_MAX;
+  }
+}
+
+// false if no cell in bucket index can move without breaking the balance,
+// moving weight w out of partition 0 needs w < area_p0 - area_lower_bound
+// and out of partition 1 needs w < area_upper_bound - area_p0
+inline bool Hypergraph::may_fit(int index) const {
+  return min_weight[0][index] < area_p0 - area_lower_bound ||
+         min_weight[1][index] < area_upper_bound - area_p0;
+}
+
+inline void Hypergraph::delete_from_bucket(uint32_t target) {
+  // the gain of target is already negated
+  unlink(bucket_index(-1*states[target].gain, target), target);
   
-  target->next = nullptr;
-  target->prev = nullptr;
+  next[target] = no_cell;
+  prev[target] = no_cell;
 }
 
+// count the cells of every net in each partition from scratch
 inline void Hypergraph::initialize_count_cells() {
-  std::unordered_map<std::string, Cell>::iterator itr;
-  for (itr = map_cells.begin(); itr != map_cells.end(); ++itr) {
-    for (size_t i = 0; i < itr->second.nets.size(); ++i) {
-      if (itr->second.partition == 0) {
-        itr->second.nets[i]->cnt_cells_p0 += 1;
-      }
-      else {
-        itr->second.nets[i]->cnt_cells_p1 += 1;
-      }
+  count_pins();
+
+  // initial cut size, afterwards maintained by update_gain and recover
+  cutsize = 0;
+  for (size_t i = 0; i < nets.size(); ++i) {
+    Net& net = nets[i];
+    net.cnt_cells_p1 = pin_counts[i];
+    net.cnt_cells_p0 = net.cells.size() - pin_counts[i];
+    if (net.cnt_cells_p0 != 0 && net.cnt_cells_p1 != 0) {
+      cutsize += net.weight;
+    }
+  }
+
+  // initial area of partition 0, afterwards maintained 
+  // by one_pass and recover
+  Cell* itr;
+  area_p0 = 0;
+  for (itr = cells.begin(); itr != cells.end(); ++itr) {
+    if (states[cell_id(itr)].partition == 0) {
+      area_p0 += itr->weight;
+    }
+  }
+}
+
+inline void Hypergraph::pack_partition() {
+  partition_bits.assign((cells.size() + 31)/32, 0);
+  for (uint32_t c = 0; c < cells.size(); ++c) {
+    partition_bits[c >> 5] |= uint32_t(states[c].partition) << (c & 31);
+  }
+}
+
+inline void Hypergraph::count_pins() {
+  pack_partition();
+  pin_bits.resize((pins.size() + 63)/64);
+  pin_counts.resize(nets.size());
+  ::count_pins(pin_kernel, pins.data, pins.size(), net_offsets.data, 
+               nets.size(), partition_bits.data(), pin_bits.data(),
+               pin_counts.data());
+}
+
+// the cut of the partition in states, recounted without touching 
+// the pin counts of the nets
+inline size_t Hypergraph::evaluate_cutsize() {
+  count_pins();
+  size_t cut = 0;
+  for (size_t i = 0; i < nets.size(); ++i) {
+    if (pin_counts[i] != 0 && pin_counts[i] != nets[i].cells.size()) {
+      cut += nets[i].weight;
     }
   }
+  return cut;
 }
 
 inline void Hypergraph::initialize_partition() {
-  size_t p0 = 0;
-  size_t p1 = 0;
-  size_t half = num_cells()/2;
-
-  std::unordered_map<std::string, Cell>::iterator itr;
-  for (itr = map_cells.begin(); itr != map_cells.end(); ++itr) {
-    // the number of cells in p0 is enough
-    if (p0 == half) {
-      itr->second.partition = 1;
-    }
-    else if (p1 == half) {
-      itr->second.partition = 0;
+  long p0 = 0;
+  long p1 = 0;
+  long half = total_area/2;
+
+  // the fixed cells take their partitions first
+  for (uint32_t c = 0; c < fixed.size(); ++c) {
+    if (fixed[c] == 0) {
+      p0 += cells[c].weight;
+    }
+    else if (fixed[c] == 1) {
+      p1 += cells[c].weight;
+    }
+  }
+
+  // FM moves only the free cells, so no partition is balanced once
+  // the fixed cells alone take too much area for one side
+  if (p0 >= area_upper_bound || p1 >= area_upper_bound) {
+    int side = p0 >= area_upper_bound ? 0 : 1;
+    std::ostringstream message;
+    message << "Fixed cells take area " << (side == 0 ? p0 : p1) 
+            << " of partition " << side << ", a balanced partition has "
+            << "less than " << area_upper_bound;
+    throw std::runtime_error(message.str());
+  }
+
+  for (uint32_t c = 0; c < cells.size(); ++c) {
+    if (is_fixed(c)) {
+      states[c].partition = fixed[c];
+      states[c].locked = true;
+      num_cells_p0 += fixed[c] == 0;
+      continue;
+    }
+
+    // the area of p0 is enough
+    if (p0 >= half) {
+      states[c].partition = 1;
+    }
+    else if (p1 >= half) {
+      states[c].partition = 0;
       ++num_cells_p0;
     }
     else {
-      bool p = rand()%2;
+      bool p = rng.coin();
       if (p == 1) {
-        itr->second.partition = 1;
-        ++p1;  
+        states[c].partition = 1;
+        p1 += cells[c].weight;  
       }
       else {
-        itr->second.partition = 0;
-        ++p0;  
+        states[c].partition = 0;
+        p0 += cells[c].weight;  
         ++num_cells_p0;
       }
     }
@@ -559,51 +1893,38 @@ inline void Hypergraph::initialize_partition() {
 }
 
 // update the target in the bucket
-inline void Hypergraph::update_bucket(int old_gain, Cell* target) {
-  int old_index = old_gain + max_edge;
-  // update the linked list at old_index
-  // target is not the first
-  if (target->prev != nullptr) {
-    if (target->next != nullptr) {
-      target->prev->next = target->next;
-      target->next->prev = target->prev;
-    }
-    // target is the last
-    else {
-      target->prev->next = nullptr;
-      tail_bucket[old_index] = target->prev;
-    }
-  }
-  // target is the first
-  else {
-    if (target->next != nullptr) {
-      bucket[old_index] = target->next;
-      target->next->prev = nullptr;     
-    }
-    // target is the only element
-    else {
-      bucket[old_index] = nullptr;
-      tail_bucket[old_index] = nullptr;
+inline void Hypergraph::update_bucket(int old_gain, uint32_t target) {
+  ++num_gain_updates;
+
+  // an inactive cell only keeps its gain until it is linked
+  if (boundary_only && !active[target]) {
+    if (policy == BucketPolicy::CLIP && stamp[target] != pass_id) {
+      stamp[target] = pass_id;
+      initial_gains[target] = old_gain;
     }
+    return;
   }
 
-  int new_index = target->gain + max_edge;
-  // target will be the first pointer in the new_index position
-  if (bucket[new_index] == nullptr) {
-    target->next = nullptr;
-    target->prev = nullptr;
-    bucket[new_index] = target;
-    tail_bucket[new_index] = target;
-  }
-  else {
-    tail_bucket[new_index]->next = target;
-    target->next = nullptr;
-    target->prev = tail_bucket[new_index];
-    tail_bucket[new_index] = target;
+  // update the linked list at old_index
+  unlink(bucket_index(old_gain, target), target);
+
+  int new_index = bucket_index(states[target].gain, target);
+  link(new_index, target);
+
+  if (new_index > max_index) {
+    max_index = new_index;
   }
 }
 
 inline size_t Hypergraph::find_max_cumulative_gain() {
+  if (locked_cells_gain.empty()) {
+    if (verbose) {
+      std::cout << " gets 0 gains improvement\n";
+    }
+    next_pass = false;
+    return 0;
+  }
+
   size_t idx = 0;
   int prefix_gain = locked_cells_gain[0];
   int max_gain = prefix_gain;
@@ -614,7 +1935,9 @@ inline size_t Hypergraph::find_max_cumulative_gain() {
       idx = i;
     }
   }
-  std::cout << " gets " << max_gain << " gains improvement\n";
+  if (verbose) {
+    std::cout << " gets " << max_gain << " gains improvement\n";
+  }
   if (max_gain <= 0) {
     next_pass = false;
   }
@@ -624,69 +1947,91 @@ inline size_t Hypergraph::find_max_cumulative_gain() {
 
 inline void Hypergraph::display_locked_cells() const {
   for (size_t i = 0; i < locked_cells.size(); ++i) {
-    if (locked_cells[i] == nullptr) {
+    if (locked_cells[i] == no_cell) {
       return;
     }
-    std::cout << "Cell " << locked_cells[i]->name 
+    std::cout << "Cell " << cells[locked_cells[i]].name 
               << " has gain = " << locked_cells_gain[i] << '\n';
   }
 }
 
 inline void Hypergraph::output_answer() {
-  std::ofstream outClientFile(output_path, std::ios::out);
+  std::ofstream outClientFile(output_path, std::ios::out | std::ios::binary);
 
   if (!outClientFile) {
-    std::cerr << "File could not be opened.\n";
-    exit(1);
+    throw std::runtime_error("File " + output_path + " could not be opened");
   }
  
-  size_t cutsize = 0;
-  std::unordered_map<std::string, Net>::iterator itr;
-  for (itr = map_nets.begin(); itr != map_nets.end(); ++itr) {
-    if (itr->second.cnt_cells_p0 != 0 && itr->second.cnt_cells_p1 != 0) {
-      ++cutsize;
+  std::string header = "Cutsize = " + std::to_string(cutsize) + '\n'
+                     + "G1 " + std::to_string(num_cells_p0) + '\n';
+  std::string middle = "G2 " + std::to_string(num_cells()-num_cells_p0) + '\n';
+
+  // one buffer holds every cell name once, so it is reserved once for
+  // all of them; it takes one walk over the cells per partition
+  std::string buffer;
+  buffer.reserve(header.size() + middle.size() + name_bytes + num_cells() + 4);
+  buffer.append(header);
+  for (int partition = 0; partition < 2; ++partition) {
+    if (partition == 1) {
+      buffer.append(middle);
+    }
+    const Cell* itr;
+    for (itr = cells.begin(); itr != cells.end(); ++itr) {
+      if (states[cell_id(itr)].partition == partition) {
+        buffer.append(itr->name);
+        buffer.push_back(' ');
+      }
     }
+    buffer.append(";\n");
   }
 
-  outClientFile << "Cutsize = " << cutsize << '\n';
-  outClientFile << "G1 " << num_cells_p0 << '\n';
-  
-  std::unordered_map<std::string, Cell>::iterator itr1;
-  for (itr1 = map_cells.begin(); itr1 != map_cells.end(); ++itr1) {
-    if (itr1->second.partition == 0) {
-      outClientFile << itr1->second.name << ' ';
-    }
+  outClientFile.write(buffer.data(), buffer.size());
+}
+
+// write the partition in hMETIS .part format,
+// one line per cell holding its partition in cell ID order
+inline void Hypergraph::output_part() {
+  std::ofstream outClientFile(output_path, std::ios::out | std::ios::binary);
+
+  if (!outClientFile) {
+    throw std::runtime_error("File " + output_path + " could not be opened");
   }
-  outClientFile << ";\n";
-  
-  outClientFile << "G2 " << num_cells()-num_cells_p0 << '\n';
-  for (itr1 = map_cells.begin(); itr1 != map_cells.end(); ++itr1) {
-    if (itr1->second.partition == 1) {
-      outClientFile << itr1->second.name << ' ';
-    }
+
+  std::string buffer(2*cells.size(), '\n');
+  for (size_t i = 0; i < cells.size(); ++i) {
+    buffer[2*i] = states[i].partition ? '1' : '0';
   }
-  outClientFile << ";\n";
+  outClientFile.write(buffer.data(), buffer.size());
 }
 
 inline void Hypergraph::display_count_cells() const {
-  std::unordered_map<std::string, Net>::const_iterator itr0;
-  for (itr0 = map_nets.begin(); itr0 != map_nets.end(); ++itr0) {
-    std::cout << "NET " << itr0->first << " has \n";
-    std::cout << "cnt_0 = " << itr0->second.cnt_cells_p0
-              << ", cnt_1 = " << itr0->second.cnt_cells_p1<< '\n';
+  const Net* itr0;
+  for (itr0 = nets.begin(); itr0 != nets.end(); ++itr0) {
+    std::cout << "NET " << itr0->name << " has \n";
+    std::cout << "cnt_0 = " << itr0->cnt_cells_p0
+              << ", cnt_1 = " << itr0->cnt_cells_p1<< '\n';
   }
 }
 
 inline void Hypergraph::one_pass() {
-  locked_cells.resize(num_cells());
-  locked_cells_gain.resize(num_cells());
+  // the moves of this pass in order
+  locked_cells.clear();
+  locked_cells_gain.clear();
   size_t cnt = 0;
+  size_t rejections = 0;
   int index = bucket.size()-1;
 
-  while (cnt < num_cells()) {
-    Cell* head = bucket[index];
+  // cumulative gain of the moves so far, the best of it, and the
+  // moves made since it was reached
+  int prefix_gain = 0;
+  int best_gain = 0;
+  size_t fruitless = 0;
 
-    while (head == nullptr) {
+  while (cnt < num_cells() && (!boundary_only || fruitless < num_boundary)) {
+    uint32_t head = bucket[index];
+
+    // skip the empty buckets and those where nothing fits
+    while (head == no_cell || !may_fit(index)) {
       if (index > 0) {
         --index;
       }
@@ -696,51 +2041,106 @@ inline void Hypergraph::one_pass() {
       head = bucket[index];
     }
    
-    if (index == 0 && head == nullptr) {
+    if (index == 0 && (head == no_cell || !may_fit(index))) {
       break; 
     }
-    while (head) {
-      if (!head->locked && meet_balance_criterion(head)) {
-        if (head->partition == 0) {
+
+    // the exact minimum weights, if the walk sees the whole bucket
+    int seen_weight[2] = {INT_MAX, INT_MAX};
+
+    while (head != no_cell) {
+      CellState& state = states[head];
+      if (!state.locked && meet_balance_criterion(head)) {
+        if (state.partition == 0) {
           --num_cells_p0;
+          area_p0 -= cells[head].weight;
         }
         else {
           ++num_cells_p0;
+          area_p0 += cells[head].weight;
         }
         
-        for (size_t i = 0; i < head->nets.size(); ++i) {
-          update_gain(head->nets[i], head);
+        size_t updates = num_gain_updates;
+        max_index = -1;
+        const Span<Net*>& head_nets = cells[head].nets;
+        for (size_t i = 0; i < head_nets.size(); ++i) {
+          update_gain(head_nets[i], head);
+        }
+
+        if (tracer) {
+          TraceRecord record;
+          record.pass = tracer->pass;
+          record.cell = head;
+          record.gain = state.gain;
+          record.bucket = index;
+          record.gain_updates = num_gain_updates - updates;
+          record.balance_rejections = rejections;
+          tracer->push(record);
         }
-        head->partition = !(head->partition);
+        rejections = 0;
+
+        state.partition = !state.partition;
         
-        head->gain = -1 * head->gain;
+        state.gain = -1 * state.gain;
         delete_from_bucket(head);
 
-        head->locked = true;
-        locked_cells[cnt] = head; 
-        locked_cells_gain[cnt] = -1*head->gain; 
+        state.locked = true;
+        locked_cells.push_back(head);
+        locked_cells_gain.push_back(-1*state.gain);
         
         ++cnt;
 
+        prefix_gain -= state.gain;
+        if (prefix_gain > best_gain) {
+          best_gain = prefix_gain;
+          fruitless = 0;
+        }
+        else {
+          ++fruitless;
+        }
+
+        // under CLIP the neighbors may have climbed above the 
+        // current bucket, the other policies keep scanning down
+        if (policy == BucketPolicy::CLIP && max_index > index) {
+          index = max_index;
+        }
+
         break;
       }
       else {
-        head = head->next;
+        ++rejections;
+        int& weight = seen_weight[state.partition];
+        weight = std::min(weight, cells[head].weight);
+        head = next[head];
       }
     }
 
-    if (head == nullptr && index > 0) {
+    if (head == no_cell) {
+      min_weight[0][index] = seen_weight[0];
+      min_weight[1][index] = seen_weight[1];
+    }
+
+    if (head == no_cell && index > 0) {
       --index;
     }
   }
   
   size_t idx = find_max_cumulative_gain();
-  if (idx != num_cells() - 1) {
-    for (size_t i = locked_cells.size()-1; i > idx; --i) {
-      if (locked_cells[i] == nullptr) {
-        continue;
-      }
-      recover(locked_cells[i]);
+
+  if (tracer) {
+    TraceRecord record;
+    record.type = TraceType::PASS_END;
+    record.pass = tracer->pass;
+    record.cell = cnt;
+    record.bucket = cnt == 0 ? 0 : idx+1;
+    for (size_t i = 0; i < record.bucket; ++i) {
+      record.gain += locked_cells_gain[i];
     }
+    tracer->push(record);
+  }
+
+  // roll back the moves after the best one
+  for (size_t i = locked_cells.size(); i > idx+1; --i) {
+    recover(locked_cells[i-1]);
   }
 }
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <sys/resource.h>
+
+// heap allocations and bytes requested since count_heap was set, 
+// counted by the operator new that fm.cpp replaces; stay zero in 
+// programs that do not
+inline std::atomic<bool> count_heap{false};
+
+inline std::atomic<size_t> heap_allocations{0};
+
+inline std::atomic<size_t> heap_bytes{0};
+
+// bytes held by each part of a Hypergraph, see Hypergraph::memory_usage
+struct MemoryUsage {
+  // the input text kept in the arena, cell and net names point into it
+  size_t input = 0;
+
+  // cells, nets, pin lists and cell-to-net lists
+  size_t netlist = 0;
+
+  // the hash table from cell name to cell ID
+  size_t cell_index = 0;
+
+  // gains, partitions, locks and bucket links per cell, 
+  // and the packed partition and pin counts that recount the nets
+  size_t cell_state = 0;
+
+  // bucket heads and tails, minimum weights and CLIP initial gains
+  size_t buckets = 0;
+
+  // moves and gains logged by one_pass for recover
+  size_t locked_cells = 0;
+
+  // bytes the arena has mapped, of which input, netlist and cell_index
+  // are in use
+  size_t arena_mapped = 0;
+};
+
+// peak resident set size of the process in bytes
+inline size_t peak_rss() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+  // Linux reports kilobytes
+  return static_cast<size_t>(usage.ru_maxrss) * 1024;
+}
+
+inline void print_memory_usage(std::ostream& os, const MemoryUsage& usage) {
+  auto line = [&](const char* name, size_t bytes) {
+    os << "    " << std::left << std::setw(14) << name << std::right
+       << std::setw(14) << bytes << " bytes\n";
+  };
+
+  os << "  memory usage\n";
+  line("input", usage.input);
+  line("netlist", usage.netlist);
+  line("cell index", usage.cell_index);
+  line("cell state", usage.cell_state);
+  line("buckets", usage.buckets);
+  line("locked cells", usage.locked_cells);
+  line("arena mapped", usage.arena_mapped);
+  line("heap", heap_bytes.load(std::memory_order_relaxed));
+  os << "    " << std::left << std::setw(14) << "allocations" << std::right
+     << std::setw(14) << heap_allocations.load(std::memory_order_relaxed)
+     << '\n';
+  line("peak RSS", peak_rss());
+}
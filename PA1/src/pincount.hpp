@@ -0,0 +1,239 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+// count, for every net, the pins whose cell lies in partition 1
+//
+// the pins of all nets sit back to back in one array, net i owning
+// pins[offsets[i]] to pins[offsets[i+1]-1], and the partitions are
+// packed 32 cells per word; a count takes two passes
+//   1 : gather the partition bit of every pin into a pin bit-vector,
+//       streaming over the pin array regardless of the net bounds
+//   2 : popcount the bits of every net in the pin bit-vector
+// the AVX2 and AVX-512 kernels gather 8 and 16 pins at once in pass 1,
+// the popcounts of pass 2 are shared; nets of a few pins would leave
+// most lanes of a per-net vector idle
+enum class PinKernel {
+  SCALAR,
+  AVX2,
+  AVX512
+};
+
+// the widest kernel the CPU runs
+PinKernel best_pin_kernel();
+
+bool supports_pin_kernel(PinKernel);
+
+const char* pin_kernel_name(PinKernel);
+
+// counts[i] = pins of net i in partition 1,
+// pin_bits must hold (num_pins+63)/64 words
+void count_pins(PinKernel, const uint32_t*, size_t, const uint32_t*, size_t,
+                const uint32_t*, uint64_t*, uint32_t*);
+
+void count_pins_scalar(const uint32_t*, size_t, const uint32_t*, size_t,
+                       const uint32_t*, uint64_t*, uint32_t*);
+
+__attribute__((target("avx2,popcnt")))
+void count_pins_avx2(const uint32_t*, size_t, const uint32_t*, size_t,
+                     const uint32_t*, uint64_t*, uint32_t*);
+
+__attribute__((target("avx512f,popcnt")))
+void count_pins_avx512(const uint32_t*, size_t, const uint32_t*, size_t,
+                       const uint32_t*, uint64_t*, uint32_t*);
+
+
+inline bool supports_pin_kernel(PinKernel kernel) {
+  __builtin_cpu_init();
+  switch (kernel) {
+    case PinKernel::AVX512:
+      return __builtin_cpu_supports("avx512f") &&
+             __builtin_cpu_supports("popcnt");
+    case PinKernel::AVX2:
+      return __builtin_cpu_supports("avx2") &&
+             __builtin_cpu_supports("popcnt");
+    default:
+      return true;
+  }
+}
+
+inline PinKernel best_pin_kernel() {
+  if (supports_pin_kernel(PinKernel::AVX512)) {
+    return PinKernel::AVX512;
+  }
+  if (supports_pin_kernel(PinKernel::AVX2)) {
+    return PinKernel::AVX2;
+  }
+  return PinKernel::SCALAR;
+}
+
+inline const char* pin_kernel_name(PinKernel kernel) {
+  switch (kernel) {
+    case PinKernel::AVX512:
+      return "avx512";
+    case PinKernel::AVX2:
+      return "avx2";
+    default:
+      return "scalar";
+  }
+}
+
+inline void count_pins(PinKernel kernel, const uint32_t* pins,
+                       size_t num_pins, const uint32_t* offsets,
+                       size_t num_nets, const uint32_t* bits,
+                       uint64_t* pin_bits, uint32_t* counts) {
+  switch (kernel) {
+    case PinKernel::AVX512:
+      count_pins_avx512(pins, num_pins, offsets, num_nets, bits,
+                        pin_bits, counts);
+      break;
+    case PinKernel::AVX2:
+      count_pins_avx2(pins, num_pins, offsets, num_nets, bits,
+                      pin_bits, counts);
+      break;
+    default:
+      count_pins_scalar(pins, num_pins, offsets, num_nets, bits,
+                        pin_bits, counts);
+      break;
+  }
+}
+
+// pass 2, inlined into every kernel so the popcounts use its target
+__attribute__((always_inline))
+inline void count_net_bits(const uint32_t* offsets, size_t num_nets,
+                           const uint64_t* pin_bits, uint32_t* counts) {
+  for (size_t i = 0; i < num_nets; ++i) {
+    uint32_t a = offsets[i];
+    uint32_t b = offsets[i+1];
+    uint32_t first = a >> 6;
+    uint32_t last = b >> 6;
+
+    if (a == b) {
+      counts[i] = 0;
+      continue;
+    }
+    if (first == last) {
+      uint64_t bits = pin_bits[first] >> (a & 63);
+      counts[i] = __builtin_popcountll(bits & ((uint64_t(1) << (b-a)) - 1));
+      continue;
+    }
+
+    uint32_t count = __builtin_popcountll(pin_bits[first] >> (a & 63));
+    for (uint32_t w = first+1; w < last; ++w) {
+      count += __builtin_popcountll(pin_bits[w]);
+    }
+    if (b & 63) {
+      count += __builtin_popcountll(
+        pin_bits[last] & ((uint64_t(1) << (b & 63)) - 1));
+    }
+    counts[i] = count;
+  }
+}
+
+inline void count_pins_scalar(const uint32_t* pins, size_t num_pins,
+                              const uint32_t* offsets, size_t num_nets,
+                              const uint32_t* bits, uint64_t* pin_bits,
+                              uint32_t* counts) {
+  for (size_t k = 0; k < num_pins; k += 64) {
+    size_t n = num_pins - k < 64 ? num_pins - k : 64;
+    uint64_t word = 0;
+    for (size_t j = 0; j < n; ++j) {
+      uint32_t c = pins[k+j];
+      word |= uint64_t((bits[c >> 5] >> (c & 31)) & 1) << j;
+    }
+    pin_bits[k >> 6] = word;
+  }
+  count_net_bits(offsets, num_nets, pin_bits, counts);
+}
+
+__attribute__((target("avx2,popcnt")))
+inline void count_pins_avx2(const uint32_t* pins, size_t num_pins,
+                            const uint32_t* offsets, size_t num_nets,
+                            const uint32_t* bits, uint64_t* pin_bits,
+                            uint32_t* counts) {
+  const int* words = reinterpret_cast<const int*>(bits);
+  const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  const __m256i low = _mm256_set1_epi32(31);
+
+  // shift the bit of every pin into the sign of its lane
+  size_t k = 0;
+  for (; k + 64 <= num_pins; k += 64) {
+    uint64_t word = 0;
+    for (size_t j = 0; j < 64; j += 8) {
+      __m256i idx = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(pins + k + j));
+      __m256i word8 = _mm256_i32gather_epi32(
+        words, _mm256_srli_epi32(idx, 5), 4);
+      __m256i bit = _mm256_sllv_epi32(
+        word8, _mm256_sub_epi32(low, _mm256_and_si256(idx, low)));
+      word |= uint64_t(_mm256_movemask_ps(_mm256_castsi256_ps(bit))) << j;
+    }
+    pin_bits[k >> 6] = word;
+  }
+
+  // the last pins are masked instead of read past the end
+  if (k < num_pins) {
+    uint64_t word = 0;
+    for (size_t j = 0; k+j < num_pins; j += 8) {
+      __m256i mask = _mm256_cmpgt_epi32(
+        _mm256_set1_epi32(static_cast<int>(num_pins-k-j)), lanes);
+      __m256i idx = _mm256_maskload_epi32(
+        reinterpret_cast<const int*>(pins + k + j), mask);
+      __m256i word8 = _mm256_mask_i32gather_epi32(
+        _mm256_setzero_si256(), words, _mm256_srli_epi32(idx, 5), mask, 4);
+      __m256i bit = _mm256_sllv_epi32(
+        word8, _mm256_sub_epi32(low, _mm256_and_si256(idx, low)));
+      word |= uint64_t(_mm256_movemask_ps(_mm256_castsi256_ps(bit))) << j;
+    }
+    pin_bits[k >> 6] = word;
+  }
+  count_net_bits(offsets, num_nets, pin_bits, counts);
+}
+
+__attribute__((target("avx512f,popcnt")))
+inline void count_pins_avx512(const uint32_t* pins, size_t num_pins,
+                              const uint32_t* offsets, size_t num_nets,
+                              const uint32_t* bits, uint64_t* pin_bits,
+                              uint32_t* counts) {
+  const __m512i low = _mm512_set1_epi32(31);
+  const __m512i one = _mm512_set1_epi32(1);
+
+  // the unmasked shifts and gathers start from an undefined vector that
+  // gcc warns about, the zero-masked forms with every lane set do not
+  const __mmask16 all = 0xFFFF;
+
+  size_t k = 0;
+  for (; k + 64 <= num_pins; k += 64) {
+    uint64_t word = 0;
+    for (size_t j = 0; j < 64; j += 16) {
+      __m512i idx = _mm512_loadu_si512(pins + k + j);
+      __m512i word16 = _mm512_mask_i32gather_epi32(
+        _mm512_setzero_si512(), all, _mm512_maskz_srli_epi32(all, idx, 5), 
+        bits, 4);
+      __m512i bit = _mm512_maskz_srlv_epi32(
+        all, word16, _mm512_and_si512(idx, low));
+      word |= uint64_t(_mm512_test_epi32_mask(bit, one)) << j;
+    }
+    pin_bits[k >> 6] = word;
+  }
+
+  // the last pins are masked instead of read past the end
+  if (k < num_pins) {
+    uint64_t word = 0;
+    for (size_t j = 0; k+j < num_pins; j += 16) {
+      size_t n = num_pins-k-j < 16 ? num_pins-k-j : 16;
+      __mmask16 mask = static_cast<__mmask16>((1u << n) - 1);
+      __m512i idx = _mm512_maskz_loadu_epi32(mask, pins + k + j);
+      __m512i word16 = _mm512_mask_i32gather_epi32(
+        _mm512_setzero_si512(), mask, _mm512_maskz_srli_epi32(mask, idx, 5), 
+        bits, 4);
+      __m512i bit = _mm512_maskz_srlv_epi32(
+        mask, word16, _mm512_and_si512(idx, low));
+      word |= uint64_t(_mm512_test_epi32_mask(bit, one)) << j;
+    }
+    pin_bits[k >> 6] = word;
+  }
+  count_net_bits(offsets, num_nets, pin_bits, counts);
+}
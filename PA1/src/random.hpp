@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+
+// xoshiro256** by Blackman and Vigna
+//
+// every partitioner owns one, so runs replay exactly from their seed
+// and threads never share or lock a generator
+class Random {
+public:
+  Random(uint64_t = 0);
+
+  // restart the sequence of seed
+  void seed(uint64_t);
+
+  uint64_t next();
+
+  // uniform in [0, n), n > 0
+  uint32_t below(uint32_t);
+
+  bool coin();
+
+private:
+  uint64_t s[4];
+
+  static uint64_t rotl(uint64_t, int);
+};
+
+
+inline Random::Random(uint64_t value) {
+  seed(value);
+}
+
+// expand the seed with splitmix64, which never yields the all-zero state
+inline void Random::seed(uint64_t value) {
+  for (uint64_t& word : s) {
+    uint64_t z = (value += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    word = z ^ (z >> 31);
+  }
+}
+
+inline uint64_t Random::rotl(uint64_t x, int k) {
+  return (x << k) | (x >> (64 - k));
+}
+
+inline uint64_t Random::next() {
+  uint64_t result = rotl(s[1] * 5, 7) * 9;
+  uint64_t t = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl(s[3], 45);
+
+  return result;
+}
+
+// the high 32 bits scaled by n, Lemire's multiply-shift without the
+// rejection step; the bias is below n/2^32
+inline uint32_t Random::below(uint32_t n) {
+  return static_cast<uint32_t>(((next() >> 32) * n) >> 32);
+}
+
+inline bool Random::coin() {
+  return next() >> 63;
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// binary trace of the moves made by the FM passes
+//
+// the file starts with an 8-byte magic followed by fixed-size records
+//   MOVE     : one per cell moved in one_pass
+//   PASS_END : one per pass, written after the rollback
+// the fields of a PASS_END record are reinterpreted as
+//   cell = number of moves, gain = best cumulative gain,
+//   bucket = number of moves kept after recover
+
+static const char trace_magic[8] = {'F', 'M', 'T', 'R', 'A', 'C', 'E', '1'};
+
+enum class TraceType : uint32_t {
+  MOVE = 0,
+  PASS_END
+};
+
+struct TraceRecord {
+  TraceType type = TraceType::MOVE;
+  uint32_t pass = 0;
+  uint32_t cell = 0;
+  int32_t gain = 0;
+  uint32_t bucket = 0;
+  uint32_t gain_updates = 0;
+  uint32_t balance_rejections = 0;
+  uint32_t reserved = 0;
+};
+
+static_assert(sizeof(TraceRecord) == 32, "TraceRecord must stay packed");
+
+
+// stream TraceRecords to a file
+// the FM thread pushes into a single-producer single-consumer ring buffer
+// that a background thread drains, so the hot loop never blocks on I/O
+// unless the writer falls a whole ring behind
+//
+// neither side spins: the writer sleeps while the ring is empty, and the
+// FM thread, after a few yields, sleeps while the ring is full
+class MoveTracer {
+public:
+  MoveTracer(const std::string&, size_t = 1 << 16);
+
+  MoveTracer(const MoveTracer&) = delete;
+
+  MoveTracer& operator = (const MoveTracer&) = delete;
+
+  ~MoveTracer();
+
+  void push(const TraceRecord&);
+
+  void close();
+
+  uint32_t pass = 1;
+
+private:
+  void drain();
+
+  std::ofstream file;
+
+  std::vector<TraceRecord> ring;
+
+  size_t mask;
+
+  // head is written by the producer, tail by the consumer
+  alignas(64) std::atomic<size_t> head{0};
+
+  alignas(64) std::atomic<size_t> tail{0};
+
+  alignas(64) std::atomic<bool> done{false};
+
+  std::thread writer;
+};
+
+
+inline MoveTracer::MoveTracer(const std::string& path, size_t capacity) {
+  file.open(path, std::ios::out | std::ios::binary);
+
+  if (!file) {
+    std::cerr << "Trace file could not be opened.\n";
+    exit(1);
+  }
+  file.write(trace_magic, sizeof(trace_magic));
+
+  // round the capacity up to a power of two
+  size_t size = 1;
+  while (size < capacity) {
+    size <<= 1;
+  }
+  ring.resize(size);
+  mask = size-1;
+
+  writer = std::thread(&MoveTracer::drain, this);
+}
+
+inline MoveTracer::~MoveTracer() {
+  close();
+}
+
+inline void MoveTracer::push(const TraceRecord& record) {
+  size_t h = head.load(std::memory_order_relaxed);
+
+  // the ring is full, wait for the writer
+  for (size_t spins = 0; 
+       h - tail.load(std::memory_order_acquire) == ring.size(); ++spins) {
+    if (spins < 64) {
+      std::this_thread::yield();
+    }
+    else {
+      std::this_thread::sleep_for(std::chrono::microseconds(10));
+    }
+  }
+
+  ring[h & mask] = record;
+  head.store(h+1, std::memory_order_release);
+
+  if (record.type == TraceType::PASS_END) {
+    ++pass;
+  }
+}
+
+inline void MoveTracer::close() {
+  if (writer.joinable()) {
+    done.store(true, std::memory_order_release);
+    writer.join();
+    file.close();
+  }
+}
+
+// consumer side : write out whatever lies between tail and head
+inline void MoveTracer::drain() {
+  while (true) {
+    bool finished = done.load(std::memory_order_acquire);
+    size_t t = tail.load(std::memory_order_relaxed);
+    size_t h = head.load(std::memory_order_acquire);
+
+    if (t == h) {
+      if (finished) {
+        return;
+      }
+      // a whole ring takes the FM thread far longer than this to fill
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      continue;
+    }
+
+    // write at most up to the end of the ring, the rest in the next round
+    size_t begin = t & mask;
+    size_t count = std::min(h - t, ring.size() - begin);
+    file.write(reinterpret_cast<const char*>(&ring[begin]),
+               count*sizeof(TraceRecord));
+    tail.store(t+count, std::memory_order_release);
+  }
+}
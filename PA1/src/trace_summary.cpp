@@ -0,0 +1,128 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <cstring>
+#include <algorithm>
+#include "trace.hpp"
+
+// summarize a binary move trace written by ./fm --trace
+//   per pass : moves, moves rolled back, gain updates and balance rejections
+//   overall  : a histogram of the gain updates per move
+
+struct PassSummary {
+  size_t moves = 0;
+  size_t kept = 0;
+  int best_gain = 0;
+  size_t gain_updates = 0;
+  size_t max_gain_updates = 0;
+  size_t balance_rejections = 0;
+};
+
+int main(int argc, char** argv) {
+
+  if (argc != 2) {
+    std::cout << "------Wrong input------\n";
+    std::cout << "./fm_trace trace_file\n";
+    return 1;
+  }
+
+  std::ifstream inFile(argv[1], std::ios::in | std::ios::binary);
+
+  if (!inFile) {
+    std::cerr << "File could not be opened or does not exist\n";
+    return 1;
+  }
+
+  char magic[sizeof(trace_magic)];
+  if (!inFile.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, trace_magic, sizeof(magic)) != 0) {
+    std::cerr << "Not a move trace\n";
+    return 1;
+  }
+
+  std::vector<PassSummary> passes;
+  PassSummary current;
+
+  // histogram[k] counts moves with gain updates in [2^(k-1), 2^k)
+  std::vector<size_t> histogram;
+
+  TraceRecord record;
+  while (inFile.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+    if (record.type == TraceType::PASS_END) {
+      current.kept = record.bucket;
+      current.best_gain = record.gain;
+      passes.emplace_back(current);
+      current = PassSummary();
+      continue;
+    }
+
+    ++current.moves;
+    current.gain_updates += record.gain_updates;
+    current.max_gain_updates =
+      std::max<size_t>(current.max_gain_updates, record.gain_updates);
+    current.balance_rejections += record.balance_rejections;
+
+    size_t k = 0;
+    while ((1u << k) <= record.gain_updates) {
+      ++k;
+    }
+    if (histogram.size() <= k) {
+      histogram.resize(k+1);
+    }
+    ++histogram[k];
+  }
+
+  // a trace cut short keeps its last, unfinished pass
+  if (current.moves != 0) {
+    passes.emplace_back(current);
+  }
+
+  size_t total_moves = 0;
+  size_t total_kept = 0;
+
+  std::cout << std::setw(6)  << "pass"
+            << std::setw(12) << "moves"
+            << std::setw(12) << "rolled back"
+            << std::setw(10) << "gain"
+            << std::setw(14) << "updates/move"
+            << std::setw(14) << "max updates"
+            << std::setw(12) << "rejections" << '\n';
+
+  for (size_t i = 0; i < passes.size(); ++i) {
+    const PassSummary& p = passes[i];
+    total_moves += p.moves;
+    total_kept += p.kept;
+
+    std::cout << std::setw(6)  << i+1
+              << std::setw(12) << p.moves
+              << std::setw(12) << p.moves - p.kept
+              << std::setw(10) << p.best_gain
+              << std::setw(14) << std::fixed << std::setprecision(2)
+              << (p.moves ? static_cast<double>(p.gain_updates)/p.moves : 0.0)
+              << std::setw(14) << p.max_gain_updates
+              << std::setw(12) << p.balance_rejections << '\n';
+  }
+
+  std::cout << "\ntotal moves = " << total_moves
+            << ", rolled back by recover = " << total_moves - total_kept
+            << " (" << std::setprecision(2)
+            << (total_moves ? 100.0*(total_moves-total_kept)/total_moves : 0.0)
+            << "%)\n";
+
+  std::cout << "\ngain updates per move\n";
+  for (size_t k = 0; k < histogram.size(); ++k) {
+    if (k == 0) {
+      std::cout << std::setw(18) << "0";
+    }
+    else {
+      std::string range = std::to_string(1u << (k-1)) + "-"
+                        + std::to_string((1u << k) - 1);
+      std::cout << std::setw(18) << range;
+    }
+    std::cout << std::setw(12) << histogram[k] << '\n';
+  }
+
+  return 0;
+}
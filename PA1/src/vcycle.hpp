@@ -0,0 +1,278 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "graph.hpp"
+
+// iterated V-cycles on top of a partition FM has converged on
+//
+// every cycle coarsens the netlist by contracting pairs of strongly
+// connected cells that sit on the same side, so every level carries
+// exactly the partition and the cut of the finest one, then refines
+// it with FM from the coarsest level back up; cells moving together
+// on the coarse levels lets FM escape the local minima of the flat run
+class VCycle {
+public:
+  VCycle(Hypergraph&);
+
+  // stop coarsening at this many cells
+  size_t min_cells = 200;
+
+  // or when a level keeps more than this fraction of its cells
+  double min_reduction = 0.95;
+
+  // nets with more pins are ignored when rating neighbors
+  size_t max_net_size = 64;
+
+  // run cycles until one fails to lower the cut or the budget expires,
+  // returns the number of cycles that lowered the cut
+  size_t run(double);
+
+  // one cycle, the partition is kept only if it lowers the cut
+  bool cycle(std::chrono::steady_clock::time_point);
+
+  // contract fine into coarse, map takes a fine cell to its coarse cell
+  void coarsen(const Hypergraph&, Hypergraph&, std::vector<uint32_t>&);
+
+private:
+  Hypergraph& graph;
+
+  // orders the matching, seeded from the random stream of graph
+  Random rng;
+};
+
+
+inline VCycle::VCycle(Hypergraph& g) : graph(g), rng(g.rng.next()) {
+}
+
+inline size_t VCycle::run(double seconds) {
+  auto deadline = std::chrono::steady_clock::now() +
+    std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(seconds));
+
+  size_t cycles = 0;
+  while (std::chrono::steady_clock::now() < deadline && cycle(deadline)) {
+    ++cycles;
+    if (graph.verbose) {
+      std::cout << "  V-cycle " << cycles
+                << " lowers the cutsize to " << graph.cutsize << '\n';
+    }
+  }
+  return cycles;
+}
+
+inline bool VCycle::cycle(std::chrono::steady_clock::time_point deadline) {
+  size_t before = graph.cutsize;
+  std::vector<bool> saved(graph.num_cells());
+  for (uint32_t c = 0; c < graph.num_cells(); ++c) {
+    saved[c] = graph.states[c].partition;
+  }
+
+  // coarsen
+  std::vector<std::unique_ptr<Hypergraph>> levels;
+  std::vector<std::vector<uint32_t>> maps;
+  const Hypergraph* finer = &graph;
+  while (finer->num_cells() > min_cells) {
+    auto coarse = std::make_unique<Hypergraph>();
+    std::vector<uint32_t> map;
+    coarsen(*finer, *coarse, map);
+    if (coarse->num_cells() > min_reduction*finer->num_cells()) {
+      break;
+    }
+    levels.emplace_back(std::move(coarse));
+    maps.emplace_back(std::move(map));
+    finer = levels.back().get();
+  }
+
+  if (levels.empty()) {
+    return false;
+  }
+
+  // refine from the coarsest level up, once the budget expires
+  // the partition is only projected
+  for (size_t l = levels.size(); l-- > 0;) {
+    Hypergraph& level = *levels[l];
+    if (std::chrono::steady_clock::now() < deadline) {
+      level.initialize_from_partition();
+      level.run_fm();
+    }
+
+    Hypergraph& target = (l == 0) ? graph : *levels[l-1];
+    for (uint32_t c = 0; c < target.num_cells(); ++c) {
+      target.states[c].partition = level.states[maps[l][c]].partition;
+    }
+  }
+
+  graph.initialize_from_partition();
+  if (std::chrono::steady_clock::now() < deadline) {
+    bool verbose = graph.verbose;
+    graph.verbose = false;
+    graph.run_fm();
+    graph.verbose = verbose;
+  }
+
+  if (graph.cutsize < before) {
+    return true;
+  }
+
+  // keep the partition the cycle started from
+  for (uint32_t c = 0; c < graph.num_cells(); ++c) {
+    graph.states[c].partition = saved[c];
+  }
+  graph.initialize_from_partition();
+  return false;
+}
+
+inline void VCycle::coarsen(const Hypergraph& fine, Hypergraph& coarse,
+                            std::vector<uint32_t>& map) {
+  size_t n = fine.num_cells();
+  map.assign(n, no_cell);
+
+  // visit the cells in random order
+  std::vector<uint32_t> order(n);
+  for (uint32_t c = 0; c < n; ++c) {
+    order[c] = c;
+  }
+  for (size_t i = n; i > 1; --i) {
+    std::swap(order[i-1], order[rng.below(static_cast<uint32_t>(i))]);
+  }
+
+  // a cluster may take up at most a quarter of the balance slack,
+  // so FM can still move it on the coarse levels; 
+  // two unit cells may always pair up
+  long max_weight = std::max<long>(2, static_cast<long>(
+    (fine.area_upper_bound - fine.area_lower_bound)/4));
+
+  // match every cell with the unmatched neighbor on the same side
+  // it shares the most net weight with, a net of p pins counting 1/(p-1)
+  std::vector<double> score(n, 0.0);
+  std::vector<uint32_t> touched;
+  uint32_t num_coarse = 0;
+
+  for (uint32_t v : order) {
+    if (map[v] != no_cell) {
+      continue;
+    }
+
+    // a fixed cell stays a cluster of its own
+    if (fine.is_fixed(v)) {
+      map[v] = num_coarse++;
+      continue;
+    }
+
+    const Cell& cell = fine.cells[v];
+    bool side = fine.states[v].partition;
+    for (size_t i = 0; i < cell.nets.size(); ++i) {
+      const Net* net = cell.nets[i];
+      size_t size = net->cells.size();
+      if (size < 2 || size > max_net_size) {
+        continue;
+      }
+      double rating = static_cast<double>(net->weight)/(size-1);
+      for (size_t j = 0; j < size; ++j) {
+        uint32_t u = net->cells[j];
+        if (u == v || map[u] != no_cell || fine.is_fixed(u) ||
+            fine.states[u].partition != side ||
+            cell.weight + fine.cells[u].weight > max_weight) {
+          continue;
+        }
+        if (score[u] == 0.0) {
+          touched.push_back(u);
+        }
+        score[u] += rating;
+      }
+    }
+
+    uint32_t best = no_cell;
+    double best_score = 0.0;
+    for (uint32_t u : touched) {
+      if (score[u] > best_score) {
+        best_score = score[u];
+        best = u;
+      }
+      score[u] = 0.0;
+    }
+    touched.clear();
+
+    map[v] = num_coarse;
+    if (best != no_cell) {
+      map[best] = num_coarse;
+    }
+    ++num_coarse;
+  }
+
+  // map the pins, dropping duplicates and nets left with a single cell
+  std::vector<uint32_t> pins;
+  std::vector<size_t> offsets(1, 0);
+  std::vector<const Net*> kept;
+  std::vector<size_t> stamp(num_coarse, SIZE_MAX);
+  for (size_t i = 0; i < fine.num_nets(); ++i) {
+    const Net& net = fine.nets[i];
+    for (size_t j = 0; j < net.cells.size(); ++j) {
+      uint32_t c = map[net.cells[j]];
+      if (stamp[c] != i) {
+        stamp[c] = i;
+        pins.push_back(c);
+      }
+    }
+    if (pins.size() - offsets.back() < 2) {
+      pins.resize(offsets.back());
+    }
+    else {
+      offsets.push_back(pins.size());
+      kept.push_back(&net);
+    }
+  }
+
+  coarse.arena.huge_pages = fine.arena.huge_pages;
+  coarse.arena.reserve(num_coarse*sizeof(Cell) + kept.size()*sizeof(Net) +
+                       pins.size()*(sizeof(uint32_t) + sizeof(Net*)) + 64);
+
+  coarse.cells = Span<Cell>(coarse.arena.construct<Cell>(num_coarse),
+                            num_coarse);
+  coarse.nets = Span<Net>(coarse.arena.construct<Net>(kept.size()),
+                          kept.size());
+  uint32_t* coarse_pins = coarse.arena.allocate<uint32_t>(pins.size());
+  std::copy(pins.begin(), pins.end(), coarse_pins);
+
+  for (size_t i = 0; i < kept.size(); ++i) {
+    Net& net = coarse.nets[i];
+    net.name = kept[i]->name;
+    net.weight = kept[i]->weight;
+    net.cells = Span<uint32_t>(coarse_pins + offsets[i],
+                               offsets[i+1] - offsets[i]);
+    for (size_t j = 0; j < net.cells.size(); ++j) {
+      ++coarse.cells[net.cells[j]].nets.length;
+    }
+  }
+  coarse.link_cells_to_nets(pins.size());
+
+  // clusters carry the area and the side of their cells
+  coarse.initialize_state();
+  for (uint32_t c = 0; c < num_coarse; ++c) {
+    coarse.cells[c].weight = 0;
+  }
+  for (uint32_t v = 0; v < n; ++v) {
+    coarse.cells[map[v]].weight += fine.cells[v].weight;
+    coarse.states[map[v]].partition = fine.states[v].partition;
+  }
+  if (!fine.fixed.empty()) {
+    coarse.fixed.assign(num_coarse, -1);
+    for (uint32_t v = 0; v < n; ++v) {
+      coarse.fixed[map[v]] = fine.fixed[v];
+    }
+  }
+
+  coarse.r_factor = fine.r_factor;
+  coarse.total_area = fine.total_area;
+  coarse.area_lower_bound = fine.area_lower_bound;
+  coarse.area_upper_bound = fine.area_upper_bound;
+  coarse.policy = fine.policy;
+  coarse.boundary_only = fine.boundary_only;
+  coarse.halo = fine.halo;
+  coarse.verbose = false;
+  coarse.initialize_max_edge();
+}
@@ -5,64 +5,66 @@
 #include <doctest.h>
 #include <string>
 #include <unordered_map>
+#include <filesystem>
 #include "graph.hpp"
+#include "vcycle.hpp"
+#include "batch.hpp"
+#include "daemon.hpp"
 
 //std::string input_file("/home/chchiu/Documents/courses/ece5960/ECE5960-Physical-Design-Algorithm/PA1/unittest/test.dat");
 
 //std::string output_file("/home/chchiu/Documents/courses/ece5960/ECE5960-Physical-Design-Algorithm/PA1/build/out.dat");
 
 
+// the tests write their scratch files to the temporary directory,
+// not to the directory ctest runs in
+std::string scratch(const std::string& name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+
+// the netlist of test.dat, parsed from a copy in the arena
 class HypergraphTest : public Hypergraph {
 public:
   HypergraphTest() {
-    Net net1;
-    Net net2;
-    Net net3;
-    Net net4;
-    Net net5;
-    (&net1)->name = "n1";
-    (&net2)->name = "n2";
-    (&net3)->name = "n3";
-    (&net4)->name = "n4";
-    (&net5)->name = "n5";
-    map_nets["n1"] = net1;
-    map_nets["n2"] = net2; 
-    map_nets["n3"] = net3;
-    map_nets["n4"] = net4; 
-    map_nets["n5"] = net5;
-    
-    Cell  cell1;
-    Cell  cell2;
-    Cell  cell3;
-    Cell  cell4;
-    Cell  cell5;
-    (&cell1)->name = "c1";
-    (&cell2)->name = "c2";
-    (&cell3)->name = "c3";
-    (&cell4)->name = "c4";
-    (&cell5)->name = "c5";
-    map_cells["c1"] = cell1;
-    map_cells["c2"] = cell2;
-    map_cells["c3"] = cell3;
-    map_cells["c4"] = cell4;
-    map_cells["c5"] = cell5;
-
-    map_nets["n1"].cells = std::vector{&map_cells["c1"], &map_cells["c2"]};
-    map_nets["n2"].cells = std::vector{&map_cells["c1"], &map_cells["c2"], &map_cells["c3"]};
-    map_nets["n3"].cells = std::vector{&map_cells["c1"], &map_cells["c4"]};
-    map_nets["n4"].cells = std::vector{&map_cells["c1"], &map_cells["c5"]};
-    map_nets["n5"].cells = std::vector{&map_cells["c3"], &map_cells["c4"]};
-    
-    map_cells["c1"].connected_cells = std::set{&map_cells["c2"], &map_cells["c3"], &map_cells["c4"], &map_cells["c5"]};
-    map_cells["c2"].connected_cells = std::set{&map_cells["c1"], &map_cells["c3"]};
-    map_cells["c3"].connected_cells = std::set{&map_cells["c1"], &map_cells["c2"], &map_cells["c4"]};
-    map_cells["c4"].connected_cells = std::set{&map_cells["c1"], &map_cells["c3"]};
-    map_cells["c5"].connected_cells = std::set{&map_cells["c1"]};
-    map_cells["c1"].nets = std::vector{&map_nets["n1"], &map_nets["n2"], &map_nets["n3"], &map_nets["n4"]};
-    map_cells["c2"].nets = std::vector{&map_nets["n1"], &map_nets["n2"]};
-    map_cells["c3"].nets = std::vector{&map_nets["n2"], &map_nets["n5"]};
-    map_cells["c4"].nets = std::vector{&map_nets["n3"], &map_nets["n5"]};
-    map_cells["c5"].nets = std::vector{&map_nets["n4"]};
+    const std::string text = 
+      "0.5\n"
+      "NET n1 c1 c2 ;\n"
+      "NET n2 c1 c2 c3 ;\n"
+      "NET n3 c1 c4 ;\n"
+      "NET n4 c1 c5 ;\n"
+      "NET n5 c3 c4 ;\n";
+
+    char* buffer = arena.allocate<char>(text.size());
+    std::copy(text.begin(), text.end(), buffer);
+    parse_dat(buffer, text.size());
+    initialize_state();
+  }
+
+  Cell& cell(std::string_view name) {
+    return *find_cell(name);
+  }
+
+  uint32_t id(std::string_view name) {
+    return cell_id(find_cell(name));
+  }
+
+  CellState& state(std::string_view name) {
+    return states[id(name)];
+  }
+
+  CellState& state(const Cell* c) {
+    return states[cell_id(c)];
+  }
+
+  Net& net(std::string_view name) {
+    Net* itr;
+    for (itr = nets.begin(); itr != nets.end(); ++itr) {
+      if (itr->name == name) {
+        break;
+      }
+    }
+    return *itr;
   }
 };
 
@@ -70,39 +72,38 @@ public:
 
 // verify the initial gain
 TEST_CASE("verify_initial_gain" * doctest::timeout(600)) {
-  std::srand(std::time(nullptr));
 
   HypergraphTest hypergraph;
  
   //Hypergraph hypergraph(input_file, output_file);
   //hypergraph.traverse();
 
-  std::unordered_map<std::string, Cell>::iterator it;
-  for (it = hypergraph.map_cells.begin(); 
-       it != hypergraph.map_cells.end(); ++it) {
-    if (it->second.name == "c1") {
-      it->second.partition = 0;
+  Cell* it;
+  for (it = hypergraph.cells.begin(); 
+       it != hypergraph.cells.end(); ++it) {
+    if (it->name == "c1") {
+      hypergraph.state(it).partition = 0;
     }
-    else if(it->second.name == "c2") {
-      it->second.partition = 0;
+    else if(it->name == "c2") {
+      hypergraph.state(it).partition = 0;
     }
-    else if (it->second.name == "c3") {
-      it->second.partition = 1;
+    else if (it->name == "c3") {
+      hypergraph.state(it).partition = 1;
     }
-    else if (it->second.name == "c4") {
-      it->second.partition = 1;
+    else if (it->name == "c4") {
+      hypergraph.state(it).partition = 1;
     }
-    else if (it->second.name == "c5") {
-      it->second.partition = 1;
+    else if (it->name == "c5") {
+      hypergraph.state(it).partition = 1;
     }
   }
  
-  std::unordered_map<std::string, Net>::iterator it1;
-  for (it1 = hypergraph.map_nets.begin(); 
-       it1 != hypergraph.map_nets.end(); ++it1) {
-    //it1->second.cut = false;
-    it1->second.cnt_cells_p0 = 0;
-    it1->second.cnt_cells_p1 = 0;
+  Net* it1;
+  for (it1 = hypergraph.nets.begin(); 
+       it1 != hypergraph.nets.end(); ++it1) {
+    //it1->cut = false;
+    it1->cnt_cells_p0 = 0;
+    it1->cnt_cells_p1 = 0;
   }
 
   hypergraph.max_gain = -1000000;
@@ -118,34 +119,34 @@ TEST_CASE("verify_initial_gain" * doctest::timeout(600)) {
   //
   //hypergraph.display_gain();
 
-  //for (it1 = hypergraph.map_nets.begin();
-  //     it1 != hypergraph.map_nets.end(); ++it1) {
-  //  if (it1->second.name == "n2" || 
-  //      it1->second.name == "n3" ||
-  //      it1->second.name == "n4") {
-  //    REQUIRE(it1->second.cut == true);
+  //for (it1 = hypergraph.nets.begin();
+  //     it1 != hypergraph.nets.end(); ++it1) {
+  //  if (it1->name == "n2" || 
+  //      it1->name == "n3" ||
+  //      it1->name == "n4") {
+  //    REQUIRE(it1->cut == true);
   //  }
   //  else {
-  //    REQUIRE(it1->second.cut == false);
+  //    REQUIRE(it1->cut == false);
   //  }
   //}
    
-  for (it = hypergraph.map_cells.begin(); 
-       it != hypergraph.map_cells.end(); ++it) {
-    if (it->second.name == "c1") {
-      REQUIRE(it->second.gain == 1);
+  for (it = hypergraph.cells.begin(); 
+       it != hypergraph.cells.end(); ++it) {
+    if (it->name == "c1") {
+      REQUIRE(hypergraph.state(it).gain == 1);
     }
-    else if(it->second.name == "c2") {
-      REQUIRE(it->second.gain == -1);
+    else if(it->name == "c2") {
+      REQUIRE(hypergraph.state(it).gain == -1);
     }
-    else if (it->second.name == "c3") {
-      REQUIRE(it->second.gain == 0);
+    else if (it->name == "c3") {
+      REQUIRE(hypergraph.state(it).gain == 0);
     }
-    else if (it->second.name == "c4") {
-      REQUIRE(it->second.gain == 0);
+    else if (it->name == "c4") {
+      REQUIRE(hypergraph.state(it).gain == 0);
     }
-    else if (it->second.name == "c5") {
-      REQUIRE(it->second.gain == 1);
+    else if (it->name == "c5") {
+      REQUIRE(hypergraph.state(it).gain == 1);
     }
   }
   REQUIRE(hypergraph.max_gain == 1);  
@@ -159,32 +160,32 @@ TEST_CASE("verify_initial_count_cells_each_partition" * doctest::timeout(600)) {
   //Hypergraph hypergraph(input_file, output_file);
   HypergraphTest hypergraph;
 
-  std::unordered_map<std::string, Cell>::iterator it;
-  for (it = hypergraph.map_cells.begin(); 
-       it != hypergraph.map_cells.end(); ++it) {
-    if (it->second.name == "c1") {
-      it->second.partition = 0;
+  Cell* it;
+  for (it = hypergraph.cells.begin(); 
+       it != hypergraph.cells.end(); ++it) {
+    if (it->name == "c1") {
+      hypergraph.state(it).partition = 0;
     }
-    else if(it->second.name == "c2") {
-      it->second.partition = 0;
+    else if(it->name == "c2") {
+      hypergraph.state(it).partition = 0;
     }
-    else if (it->second.name == "c3") {
-      it->second.partition = 1;
+    else if (it->name == "c3") {
+      hypergraph.state(it).partition = 1;
     }
-    else if (it->second.name == "c4") {
-      it->second.partition = 1;
+    else if (it->name == "c4") {
+      hypergraph.state(it).partition = 1;
     }
-    else if (it->second.name == "c5") {
-      it->second.partition = 1;
+    else if (it->name == "c5") {
+      hypergraph.state(it).partition = 1;
     }
   }
   
-  std::unordered_map<std::string, Net>::iterator it1;
-  for (it1 = hypergraph.map_nets.begin(); 
-       it1 != hypergraph.map_nets.end(); ++it1) {
-    //it1->second.cut = false;
-    it1->second.cnt_cells_p0 = 0;
-    it1->second.cnt_cells_p1 = 0;
+  Net* it1;
+  for (it1 = hypergraph.nets.begin(); 
+       it1 != hypergraph.nets.end(); ++it1) {
+    //it1->cut = false;
+    it1->cnt_cells_p0 = 0;
+    it1->cnt_cells_p1 = 0;
   }
 
   hypergraph.max_gain = -1000000;
@@ -197,27 +198,27 @@ TEST_CASE("verify_initial_count_cells_each_partition" * doctest::timeout(600)) {
   //hypergraph.traverse();
   //hypergraph.display_partition();
    
-  for (it1 = hypergraph.map_nets.begin(); 
-       it1 != hypergraph.map_nets.end(); ++it1) {
-    if (it1->second.name == "n1") {
-      REQUIRE(it1->second.cnt_cells_p0 == 2);
-      REQUIRE(it1->second.cnt_cells_p1 == 0);
+  for (it1 = hypergraph.nets.begin(); 
+       it1 != hypergraph.nets.end(); ++it1) {
+    if (it1->name == "n1") {
+      REQUIRE(it1->cnt_cells_p0 == 2);
+      REQUIRE(it1->cnt_cells_p1 == 0);
     }
-    else if (it1->second.name == "n2") {
-      REQUIRE(it1->second.cnt_cells_p0 == 2);
-      REQUIRE(it1->second.cnt_cells_p1 == 1);
+    else if (it1->name == "n2") {
+      REQUIRE(it1->cnt_cells_p0 == 2);
+      REQUIRE(it1->cnt_cells_p1 == 1);
     }
-    else if (it1->second.name == "n3") {
-      REQUIRE(it1->second.cnt_cells_p0 == 1);
-      REQUIRE(it1->second.cnt_cells_p1 == 1);
+    else if (it1->name == "n3") {
+      REQUIRE(it1->cnt_cells_p0 == 1);
+      REQUIRE(it1->cnt_cells_p1 == 1);
     }
-    else if (it1->second.name == "n4") {
-      REQUIRE(it1->second.cnt_cells_p0 == 1);
-      REQUIRE(it1->second.cnt_cells_p1 == 1);
+    else if (it1->name == "n4") {
+      REQUIRE(it1->cnt_cells_p0 == 1);
+      REQUIRE(it1->cnt_cells_p1 == 1);
     }
-    else if (it1->second.name == "n5") {
-      REQUIRE(it1->second.cnt_cells_p0 == 0);
-      REQUIRE(it1->second.cnt_cells_p1 == 2);
+    else if (it1->name == "n5") {
+      REQUIRE(it1->cnt_cells_p0 == 0);
+      REQUIRE(it1->cnt_cells_p1 == 2);
     }
   }
 }
@@ -229,32 +230,32 @@ TEST_CASE("verify_initial_connected_cells" * doctest::timeout(600)) {
   //Hypergraph hypergraph(input_file, output_file);
   HypergraphTest hypergraph;
 
-  std::unordered_map<std::string, Cell>::iterator it;
-  for (it = hypergraph.map_cells.begin(); 
-       it != hypergraph.map_cells.end(); ++it) {
-    if (it->second.name == "c1") {
-      it->second.partition = 0;
+  Cell* it;
+  for (it = hypergraph.cells.begin(); 
+       it != hypergraph.cells.end(); ++it) {
+    if (it->name == "c1") {
+      hypergraph.state(it).partition = 0;
     }
-    else if(it->second.name == "c2") {
-      it->second.partition = 0;
+    else if(it->name == "c2") {
+      hypergraph.state(it).partition = 0;
     }
-    else if (it->second.name == "c3") {
-      it->second.partition = 1;
+    else if (it->name == "c3") {
+      hypergraph.state(it).partition = 1;
     }
-    else if (it->second.name == "c4") {
-      it->second.partition = 1;
+    else if (it->name == "c4") {
+      hypergraph.state(it).partition = 1;
     }
-    else if (it->second.name == "c5") {
-      it->second.partition = 1;
+    else if (it->name == "c5") {
+      hypergraph.state(it).partition = 1;
     }
   }
   
-  std::unordered_map<std::string, Net>::iterator it1;
-  for (it1 = hypergraph.map_nets.begin(); 
-       it1 != hypergraph.map_nets.end(); ++it1) {
-    //it1->second.cut = false;
-    it1->second.cnt_cells_p0 = 0;
-    it1->second.cnt_cells_p1 = 0;
+  Net* it1;
+  for (it1 = hypergraph.nets.begin(); 
+       it1 != hypergraph.nets.end(); ++it1) {
+    //it1->cut = false;
+    it1->cnt_cells_p0 = 0;
+    it1->cnt_cells_p1 = 0;
   }
 
   hypergraph.max_gain = -1000000;
@@ -264,38 +265,38 @@ TEST_CASE("verify_initial_connected_cells" * doctest::timeout(600)) {
   hypergraph.initialize_count_cells();
   hypergraph.initialize_gain(); 
   
-  for (it = hypergraph.map_cells.begin(); 
-       it != hypergraph.map_cells.end(); ++it) {
-    if (it->second.name == "c1") {
-      REQUIRE(it->second.connected_cells.size() == 4);
+  for (it = hypergraph.cells.begin(); 
+       it != hypergraph.cells.end(); ++it) {
+    if (it->name == "c1") {
+      REQUIRE(hypergraph.connected_cells(it).size() == 4);
     }
     
-    else if (it->second.name == "c2") {
-      REQUIRE(it->second.connected_cells.size() == 2);
-      for (auto& cptr : it->second.connected_cells) {
+    else if (it->name == "c2") {
+      REQUIRE(hypergraph.connected_cells(it).size() == 2);
+      for (auto& cptr : hypergraph.connected_cells(it)) {
         REQUIRE(cptr->name != "c5");
         REQUIRE(cptr->name != "c4");
       }
     }
     
-    else if (it->second.name == "c3") {
-      REQUIRE(it->second.connected_cells.size() == 3);
-      for (auto& cptr : it->second.connected_cells) {
+    else if (it->name == "c3") {
+      REQUIRE(hypergraph.connected_cells(it).size() == 3);
+      for (auto& cptr : hypergraph.connected_cells(it)) {
         REQUIRE(cptr->name != "c5");
       }
     }
     
-    else if (it->second.name == "c4") {
-      REQUIRE(it->second.connected_cells.size() == 2);
-      for (auto& cptr : it->second.connected_cells) {
+    else if (it->name == "c4") {
+      REQUIRE(hypergraph.connected_cells(it).size() == 2);
+      for (auto& cptr : hypergraph.connected_cells(it)) {
         REQUIRE(cptr->name != "c2");
         REQUIRE(cptr->name != "c5");
       }
     }
     
-    else if (it->second.name == "c5") {
-      REQUIRE(it->second.connected_cells.size() == 1);
-      for (auto& cptr : it->second.connected_cells) {
+    else if (it->name == "c5") {
+      REQUIRE(hypergraph.connected_cells(it).size() == 1);
+      for (auto& cptr : hypergraph.connected_cells(it)) {
         REQUIRE(cptr->name != "c2");
         REQUIRE(cptr->name != "c3");
         REQUIRE(cptr->name != "c4");
@@ -311,34 +312,34 @@ TEST_CASE("verify_initial_bucket" * doctest::timeout(600)) {
   //Hypergraph hypergraph(input_file, output_file);
   HypergraphTest hypergraph;
   
-  std::unordered_map<std::string, Cell>::iterator it;
-  for (it = hypergraph.map_cells.begin(); 
-       it != hypergraph.map_cells.end(); ++it) {
-    if (it->second.name == "c1") {
-      it->second.partition = 0;
+  Cell* it;
+  for (it = hypergraph.cells.begin(); 
+       it != hypergraph.cells.end(); ++it) {
+    if (it->name == "c1") {
+      hypergraph.state(it).partition = 0;
     }
-    else if(it->second.name == "c2") {
-      it->second.partition = 0;
+    else if(it->name == "c2") {
+      hypergraph.state(it).partition = 0;
     }
-    else if (it->second.name == "c3") {
-      it->second.partition = 1;
+    else if (it->name == "c3") {
+      hypergraph.state(it).partition = 1;
     }
-    else if (it->second.name == "c4") {
-      it->second.partition = 1;
+    else if (it->name == "c4") {
+      hypergraph.state(it).partition = 1;
     }
-    else if (it->second.name == "c5") {
-      it->second.partition = 1;
+    else if (it->name == "c5") {
+      hypergraph.state(it).partition = 1;
     }
-    it->second.prev = nullptr;
-    it->second.next = nullptr;
+    hypergraph.prev[hypergraph.cell_id(it)] = no_cell;
+    hypergraph.next[hypergraph.cell_id(it)] = no_cell;
   }
   
-  std::unordered_map<std::string, Net>::iterator it1;
-  for (it1 = hypergraph.map_nets.begin(); 
-       it1 != hypergraph.map_nets.end(); ++it1) {
-    //it1->second.cut = false;
-    it1->second.cnt_cells_p0 = 0;
-    it1->second.cnt_cells_p1 = 0;
+  Net* it1;
+  for (it1 = hypergraph.nets.begin(); 
+       it1 != hypergraph.nets.end(); ++it1) {
+    //it1->cut = false;
+    it1->cnt_cells_p0 = 0;
+    it1->cnt_cells_p1 = 0;
   }
 
   hypergraph.max_gain = -1000000;
@@ -357,91 +358,167 @@ TEST_CASE("verify_initial_bucket" * doctest::timeout(600)) {
 
   for (size_t i = 0; i < hypergraph.bucket.size(); ++i) {
     if (i < 3) {
-      REQUIRE(hypergraph.bucket[i] == nullptr);
+      REQUIRE(hypergraph.bucket[i] == no_cell);
     }
     else if (i == 3) {
-      Cell* head = hypergraph.bucket[i];
-      REQUIRE(head->name == "c2");
-      REQUIRE(head->prev == nullptr);
-      REQUIRE(head->next == nullptr);
+      uint32_t head = hypergraph.bucket[i];
+      REQUIRE(hypergraph.cells[head].name == "c2");
+      REQUIRE(hypergraph.prev[head] == no_cell);
+      REQUIRE(hypergraph.next[head] == no_cell);
     }
     else if (i == 4) {
-      Cell* head = hypergraph.bucket[i];
+      uint32_t head = hypergraph.bucket[i];
       size_t cnt = 1;
-      while(head->next) {
-        REQUIRE(head->name != "c1");
-        REQUIRE(head->name != "c2");
-        REQUIRE(head->name != "c5");
-        head = head->next;  
+      while(hypergraph.next[head] != no_cell) {
+        REQUIRE(hypergraph.cells[head].name != "c1");
+        REQUIRE(hypergraph.cells[head].name != "c2");
+        REQUIRE(hypergraph.cells[head].name != "c5");
+        head = hypergraph.next[head];  
         ++cnt;
       }
       REQUIRE(cnt == 2);
-      REQUIRE(head->name != "c1");
-      REQUIRE(head->name != "c2");
-      REQUIRE(head->name != "c5");
-      REQUIRE(head->prev->name != "c1"); 
-      REQUIRE(head->prev->name != "c2"); 
-      REQUIRE(head->prev->name != "c5"); 
+      REQUIRE(hypergraph.cells[head].name != "c1");
+      REQUIRE(hypergraph.cells[head].name != "c2");
+      REQUIRE(hypergraph.cells[head].name != "c5");
+      REQUIRE(hypergraph.cells[hypergraph.prev[head]].name != "c1"); 
+      REQUIRE(hypergraph.cells[hypergraph.prev[head]].name != "c2"); 
+      REQUIRE(hypergraph.cells[hypergraph.prev[head]].name != "c5"); 
     }
     else if (i == 5) {
-      Cell* head = hypergraph.bucket[i];
+      uint32_t head = hypergraph.bucket[i];
       size_t cnt = 1;
-      while(head->next) {
-        REQUIRE(head->name != "c2");
-        REQUIRE(head->name != "c3");
-        REQUIRE(head->name != "c4");
-        head = head->next;  
+      while(hypergraph.next[head] != no_cell) {
+        REQUIRE(hypergraph.cells[head].name != "c2");
+        REQUIRE(hypergraph.cells[head].name != "c3");
+        REQUIRE(hypergraph.cells[head].name != "c4");
+        head = hypergraph.next[head];  
         ++cnt;
       }
       REQUIRE(cnt == 2);
-      REQUIRE(head->name != "c2");
-      REQUIRE(head->name != "c3");
-      REQUIRE(head->name != "c4");
-      REQUIRE(head->prev->name != "c2"); 
-      REQUIRE(head->prev->name != "c3"); 
-      REQUIRE(head->prev->name != "c4"); 
+      REQUIRE(hypergraph.cells[head].name != "c2");
+      REQUIRE(hypergraph.cells[head].name != "c3");
+      REQUIRE(hypergraph.cells[head].name != "c4");
+      REQUIRE(hypergraph.cells[hypergraph.prev[head]].name != "c2"); 
+      REQUIRE(hypergraph.cells[hypergraph.prev[head]].name != "c3"); 
+      REQUIRE(hypergraph.cells[hypergraph.prev[head]].name != "c4"); 
     }
     else if (i > 5) {
-      REQUIRE(hypergraph.bucket[i] == nullptr);
+      REQUIRE(hypergraph.bucket[i] == no_cell);
     }
   }
 }  
 
 
+// verify the LIFO and CLIP bucket orders
+TEST_CASE("verify_bucket_policy" * doctest::timeout(600)) {
+  
+  HypergraphTest hypergraph;
+
+  hypergraph.state("c1").partition = 0;
+  hypergraph.state("c2").partition = 0;
+  hypergraph.state("c3").partition = 1;
+  hypergraph.state("c4").partition = 1;
+  hypergraph.state("c5").partition = 1;
+
+  hypergraph.num_cells_p0 = 2;
+  hypergraph.max_edge = 4;
+  hypergraph.initialize_count_cells();
+  hypergraph.initialize_gain(); 
+
+  SUBCASE("SUB : LIFO") {
+    hypergraph.policy = BucketPolicy::LIFO;
+    hypergraph.construct_bucket();
+
+    REQUIRE(hypergraph.bucket.size() == 9);
+    
+    // c3 and c4 have gain 0, the later one is the head
+    uint32_t head = hypergraph.bucket[4];
+    REQUIRE(hypergraph.cells[head].name == "c4");
+    REQUIRE(hypergraph.cells[hypergraph.next[head]].name == "c3");
+    REQUIRE(hypergraph.cells[hypergraph.tail_bucket[4]].name == "c3");
+
+    // a relinked cell goes in front of c5 and c1
+    hypergraph.max_index = -1;
+    hypergraph.state("c3").gain = 1;
+    hypergraph.update_bucket(0, hypergraph.id("c3"));
+    REQUIRE(hypergraph.bucket[4] == hypergraph.id("c4"));
+    REQUIRE(hypergraph.next[hypergraph.id("c4")] == no_cell);
+    REQUIRE(hypergraph.bucket[5] == hypergraph.id("c3"));
+    REQUIRE(hypergraph.cells[hypergraph.next[hypergraph.bucket[5]]].name 
+            == "c5");
+    REQUIRE(hypergraph.cells[hypergraph.tail_bucket[5]].name == "c1");
+    REQUIRE(hypergraph.max_index == 5);
+  }
+
+  SUBCASE("SUB : CLIP") {
+    hypergraph.policy = BucketPolicy::CLIP;
+    hypergraph.construct_bucket();
+
+    REQUIRE(hypergraph.bucket.size() == 17);
+
+    // every cell starts in the zero bucket ordered by decreasing gain
+    std::vector<std::string_view> order;
+    for (uint32_t c = hypergraph.bucket[8]; c != no_cell; 
+         c = hypergraph.next[c]) {
+      order.push_back(hypergraph.cells[c].name);
+    }
+    REQUIRE(order == std::vector<std::string_view>{"c5", "c1", "c4", "c3", "c2"});
+    for (size_t i = 0; i < hypergraph.bucket.size(); ++i) {
+      if (i != 8) {
+        REQUIRE(hypergraph.bucket[i] == no_cell);
+      }
+    }
+
+    // the bucket follows the gain change, not the gain
+    hypergraph.max_index = -1;
+    hypergraph.state("c2").gain = 0;
+    hypergraph.update_bucket(-1, hypergraph.id("c2"));
+    REQUIRE(hypergraph.bucket[9] == hypergraph.id("c2"));
+    REQUIRE(hypergraph.tail_bucket[8] == hypergraph.id("c3"));
+    REQUIRE(hypergraph.max_index == 9);
+
+    // locking c5 with its gain negated takes it out of the zero bucket
+    hypergraph.state("c5").gain = -1;
+    hypergraph.delete_from_bucket(hypergraph.id("c5"));
+    REQUIRE(hypergraph.bucket[8] == hypergraph.id("c1"));
+    REQUIRE(hypergraph.prev[hypergraph.id("c1")] == no_cell);
+  }
+}
+
 // verify the balance_criterion
 TEST_CASE("verify_balance_criterion" * doctest::timeout(600)) {
   
   //Hypergraph hypergraph(input_file, output_file);
   HypergraphTest hypergraph;
   
-  std::unordered_map<std::string, Cell>::iterator it;
-  for (it = hypergraph.map_cells.begin(); 
-       it != hypergraph.map_cells.end(); ++it) {
-    if (it->second.name == "c1") {
-      it->second.partition = 0;
+  Cell* it;
+  for (it = hypergraph.cells.begin(); 
+       it != hypergraph.cells.end(); ++it) {
+    if (it->name == "c1") {
+      hypergraph.state(it).partition = 0;
     }
-    else if(it->second.name == "c2") {
-      it->second.partition = 0;
+    else if(it->name == "c2") {
+      hypergraph.state(it).partition = 0;
     }
-    else if (it->second.name == "c3") {
-      it->second.partition = 1;
+    else if (it->name == "c3") {
+      hypergraph.state(it).partition = 1;
     }
-    else if (it->second.name == "c4") {
-      it->second.partition = 1;
+    else if (it->name == "c4") {
+      hypergraph.state(it).partition = 1;
     }
-    else if (it->second.name == "c5") {
-      it->second.partition = 1;
+    else if (it->name == "c5") {
+      hypergraph.state(it).partition = 1;
     }
-    it->second.prev = nullptr;
-    it->second.next = nullptr;
+    hypergraph.prev[hypergraph.cell_id(it)] = no_cell;
+    hypergraph.next[hypergraph.cell_id(it)] = no_cell;
   }
   
-  std::unordered_map<std::string, Net>::iterator it1;
-  for (it1 = hypergraph.map_nets.begin(); 
-       it1 != hypergraph.map_nets.end(); ++it1) {
-    //it1->second.cut = false;
-    it1->second.cnt_cells_p0 = 0;
-    it1->second.cnt_cells_p1 = 0;
+  Net* it1;
+  for (it1 = hypergraph.nets.begin(); 
+       it1 != hypergraph.nets.end(); ++it1) {
+    //it1->cut = false;
+    it1->cnt_cells_p0 = 0;
+    it1->cnt_cells_p1 = 0;
   }
 
   hypergraph.max_gain = -1000000;
@@ -453,63 +530,124 @@ TEST_CASE("verify_balance_criterion" * doctest::timeout(600)) {
   hypergraph.initialize_count_cells();
   hypergraph.initialize_gain(); 
    
-  for (it = hypergraph.map_cells.begin(); 
-       it != hypergraph.map_cells.end(); 
+  for (it = hypergraph.cells.begin(); 
+       it != hypergraph.cells.end(); 
        ++it) {
     
-    if (it->second.name == "c1") {
-      REQUIRE(hypergraph.meet_balance_criterion(&(it->second)) == false);  
+    if (it->name == "c1") {
+      REQUIRE(hypergraph.meet_balance_criterion(hypergraph.cell_id(it)) == false);  
     }
-    else if (it->second.name == "c2") {
-      REQUIRE(hypergraph.meet_balance_criterion(&(it->second)) == false);  
+    else if (it->name == "c2") {
+      REQUIRE(hypergraph.meet_balance_criterion(hypergraph.cell_id(it)) == false);  
     }
-    else if (it->second.name == "c3") {
-      REQUIRE(hypergraph.meet_balance_criterion(&(it->second)) == true);  
+    else if (it->name == "c3") {
+      REQUIRE(hypergraph.meet_balance_criterion(hypergraph.cell_id(it)) == true);  
     }
-    else if (it->second.name == "c4") {
-      REQUIRE(hypergraph.meet_balance_criterion(&(it->second)) == true);  
+    else if (it->name == "c4") {
+      REQUIRE(hypergraph.meet_balance_criterion(hypergraph.cell_id(it)) == true);  
     }
-    else if (it->second.name == "c5") {
-      REQUIRE(hypergraph.meet_balance_criterion(&(it->second)) == true);  
+    else if (it->name == "c5") {
+      REQUIRE(hypergraph.meet_balance_criterion(hypergraph.cell_id(it)) == true);  
     }
   } 
 }
 
 
+// verify cell areas and the weighted balance criterion
+TEST_CASE("verify_cell_area" * doctest::timeout(600)) {
+  
+  Hypergraph hypergraph;
+
+  const std::string text = 
+    "0.5\n"
+    "CELL c1 4 ;\n"
+    "NET n1 c1 c2 ;\n"
+    "NET n2 c1 c2 c3 ;\n"
+    "CELL c3 2;\n"
+    "NET n3 c1 c4 ;\n"
+    "NET n4 c1 c5 ;\n"
+    "NET n5 c3 c4 ;\n";
+
+  char* buffer = hypergraph.arena.allocate<char>(text.size());
+  std::copy(text.begin(), text.end(), buffer);
+  hypergraph.parse_dat(buffer, text.size());
+  hypergraph.initialize_state();
+
+  REQUIRE(hypergraph.num_cells() == 5);
+  REQUIRE(hypergraph.num_nets() == 5);
+  REQUIRE(hypergraph.find_cell("c1")->weight == 4);
+  REQUIRE(hypergraph.find_cell("c2")->weight == 1);
+  REQUIRE(hypergraph.find_cell("c3")->weight == 2);
+  REQUIRE(hypergraph.find_cell("c1")->nets.size() == 4);
+  REQUIRE(hypergraph.find_cell("c3")->nets.size() == 2);
+
+  for (uint32_t c = 0; c < hypergraph.num_cells(); ++c) {
+    std::string_view name = hypergraph.cells[c].name;
+    hypergraph.states[c].partition = (name == "c1" || name == "c2") ? 0 : 1;
+  }
+  hypergraph.initialize_count_cells();
+
+  // total area 9, so 2.25 < area of p0 < 6.75
+  hypergraph.area_lower_bound = 2.25;
+  hypergraph.area_upper_bound = 6.75;
+  REQUIRE(hypergraph.area_p0 == 5);
+
+  REQUIRE(hypergraph.meet_balance_criterion(hypergraph.cell_id(
+          hypergraph.find_cell("c1"))) == false);
+  REQUIRE(hypergraph.meet_balance_criterion(hypergraph.cell_id(
+          hypergraph.find_cell("c2"))) == true);
+  REQUIRE(hypergraph.meet_balance_criterion(hypergraph.cell_id(
+          hypergraph.find_cell("c3"))) == false);
+  REQUIRE(hypergraph.meet_balance_criterion(hypergraph.cell_id(
+          hypergraph.find_cell("c4"))) == true);
+
+  // room is 2.75 out of p0 and 1.75 out of p1
+  hypergraph.min_weight[0].assign(1, 4);
+  hypergraph.min_weight[1].assign(1, 2);
+  REQUIRE(hypergraph.may_fit(0) == false);
+  hypergraph.min_weight[1][0] = INT_MAX;
+  REQUIRE(hypergraph.may_fit(0) == false);
+  hypergraph.min_weight[0][0] = 2;
+  REQUIRE(hypergraph.may_fit(0) == true);
+  hypergraph.min_weight[0][0] = INT_MAX;
+  hypergraph.min_weight[1][0] = 1;
+  REQUIRE(hypergraph.may_fit(0) == true);
+}
+
 // verify the update_gain of c1 moved
 TEST_CASE("verify_update_gain" * doctest::timeout(600)) {
   
   //Hypergraph hypergraph(input_file, output_file);
   HypergraphTest hypergraph;
   
-  std::unordered_map<std::string, Cell>::iterator it;
-  for (it = hypergraph.map_cells.begin(); 
-       it != hypergraph.map_cells.end(); ++it) {
-    if (it->second.name == "c1") {
-      it->second.partition = 0;
+  Cell* it;
+  for (it = hypergraph.cells.begin(); 
+       it != hypergraph.cells.end(); ++it) {
+    if (it->name == "c1") {
+      hypergraph.state(it).partition = 0;
     }
-    else if(it->second.name == "c2") {
-      it->second.partition = 0;
+    else if(it->name == "c2") {
+      hypergraph.state(it).partition = 0;
     }
-    else if (it->second.name == "c3") {
-      it->second.partition = 1;
+    else if (it->name == "c3") {
+      hypergraph.state(it).partition = 1;
     }
-    else if (it->second.name == "c4") {
-      it->second.partition = 1;
+    else if (it->name == "c4") {
+      hypergraph.state(it).partition = 1;
     }
-    else if (it->second.name == "c5") {
-      it->second.partition = 1;
+    else if (it->name == "c5") {
+      hypergraph.state(it).partition = 1;
     }
-    it->second.prev = nullptr;
-    it->second.next = nullptr;
+    hypergraph.prev[hypergraph.cell_id(it)] = no_cell;
+    hypergraph.next[hypergraph.cell_id(it)] = no_cell;
   }
   
-  std::unordered_map<std::string, Net>::iterator it1;
-  for (it1 = hypergraph.map_nets.begin(); 
-       it1 != hypergraph.map_nets.end(); ++it1) {
-    //it1->second.cut = false;
-    it1->second.cnt_cells_p0 = 0;
-    it1->second.cnt_cells_p1 = 0;
+  Net* it1;
+  for (it1 = hypergraph.nets.begin(); 
+       it1 != hypergraph.nets.end(); ++it1) {
+    //it1->cut = false;
+    it1->cnt_cells_p0 = 0;
+    it1->cnt_cells_p1 = 0;
   }
 
   hypergraph.max_gain = -1000000;
@@ -523,293 +661,293 @@ TEST_CASE("verify_update_gain" * doctest::timeout(600)) {
  
  
   SUBCASE("SUB : move c1") {
-    Cell* target = &(hypergraph.map_cells["c1"]);
+    Cell* target = &(hypergraph.cell("c1"));
     for (size_t i = 0; i < target->nets.size(); ++i) { 
-      hypergraph.update_gain(target->nets[i], target);
+      hypergraph.update_gain(target->nets[i], hypergraph.cell_id(target));
     }
     //hypergraph.traverse();
     //hypergraph.display_cut();
     //hypergraph.display_gain();
 
-    //for (it1 = hypergraph.map_nets.begin();
-    //     it1 != hypergraph.map_nets.end(); ++it1) {
-    //  if (it1->second.name == "n1") {
-    //    REQUIRE(it1->second.cut == true);
+    //for (it1 = hypergraph.nets.begin();
+    //     it1 != hypergraph.nets.end(); ++it1) {
+    //  if (it1->name == "n1") {
+    //    REQUIRE(it1->cut == true);
     //  }
-    //  else if (it1->second.name == "n2") {
-    //    REQUIRE(it1->second.cut == true);
+    //  else if (it1->name == "n2") {
+    //    REQUIRE(it1->cut == true);
     //  }
-    //  else if (it1->second.name == "n3") {
-    //    REQUIRE(it1->second.cut == false);
+    //  else if (it1->name == "n3") {
+    //    REQUIRE(it1->cut == false);
     //  }
-    //  else if (it1->second.name == "n4") {
-    //    REQUIRE(it1->second.cut == false);
+    //  else if (it1->name == "n4") {
+    //    REQUIRE(it1->cut == false);
     //  }
-    //  else if (it1->second.name == "n5") {
-    //    REQUIRE(it1->second.cut == false);
+    //  else if (it1->name == "n5") {
+    //    REQUIRE(it1->cut == false);
     //  }
     //}
     
-    for (it = hypergraph.map_cells.begin(); 
-         it != hypergraph.map_cells.end(); ++it) {
+    for (it = hypergraph.cells.begin(); 
+         it != hypergraph.cells.end(); ++it) {
       
-      if (it->second.name == "c1") {
+      if (it->name == "c1") {
         continue;
-        //REQUIRE(it->second.gain == -1);
+        //REQUIRE(hypergraph.state(it).gain == -1);
       }
-      else if (it->second.name == "c2") {
-        REQUIRE(it->second.gain == 2);
+      else if (it->name == "c2") {
+        REQUIRE(hypergraph.state(it).gain == 2);
       }
-      else if (it->second.name == "c3") {
-        REQUIRE(it->second.gain == -1);
+      else if (it->name == "c3") {
+        REQUIRE(hypergraph.state(it).gain == -1);
       }
-      else if (it->second.name == "c4") {
-        REQUIRE(it->second.gain == -2);
+      else if (it->name == "c4") {
+        REQUIRE(hypergraph.state(it).gain == -2);
       }
-      else if (it->second.name == "c5") {
-        REQUIRE(it->second.gain == -1);
+      else if (it->name == "c5") {
+        REQUIRE(hypergraph.state(it).gain == -1);
       }
     }
 
-    REQUIRE(hypergraph.map_nets["n1"].cnt_cells_p0 == 1);
-    REQUIRE(hypergraph.map_nets["n1"].cnt_cells_p1 == 1);
-    REQUIRE(hypergraph.map_nets["n2"].cnt_cells_p0 == 1);
-    REQUIRE(hypergraph.map_nets["n2"].cnt_cells_p1 == 2);
-    REQUIRE(hypergraph.map_nets["n3"].cnt_cells_p0 == 0);
-    REQUIRE(hypergraph.map_nets["n3"].cnt_cells_p1 == 2);
-    REQUIRE(hypergraph.map_nets["n4"].cnt_cells_p0 == 0);
-    REQUIRE(hypergraph.map_nets["n4"].cnt_cells_p1 == 2);
-    REQUIRE(hypergraph.map_nets["n5"].cnt_cells_p0 == 0);
-    REQUIRE(hypergraph.map_nets["n5"].cnt_cells_p1 == 2);
+    REQUIRE(hypergraph.net("n1").cnt_cells_p0 == 1);
+    REQUIRE(hypergraph.net("n1").cnt_cells_p1 == 1);
+    REQUIRE(hypergraph.net("n2").cnt_cells_p0 == 1);
+    REQUIRE(hypergraph.net("n2").cnt_cells_p1 == 2);
+    REQUIRE(hypergraph.net("n3").cnt_cells_p0 == 0);
+    REQUIRE(hypergraph.net("n3").cnt_cells_p1 == 2);
+    REQUIRE(hypergraph.net("n4").cnt_cells_p0 == 0);
+    REQUIRE(hypergraph.net("n4").cnt_cells_p1 == 2);
+    REQUIRE(hypergraph.net("n5").cnt_cells_p0 == 0);
+    REQUIRE(hypergraph.net("n5").cnt_cells_p1 == 2);
 
   }
  
   SUBCASE("SUB : move c2") {
-    Cell* target = &(hypergraph.map_cells["c2"]);
+    Cell* target = &(hypergraph.cell("c2"));
     for (size_t i = 0; i < target->nets.size(); ++i) { 
-      hypergraph.update_gain(target->nets[i], target);
+      hypergraph.update_gain(target->nets[i], hypergraph.cell_id(target));
     }
 
     //hypergraph.traverse();
     //hypergraph.display_cut();
     //hypergraph.display_gain();
     
-    //for (it1 = hypergraph.map_nets.begin();
-    //     it1 != hypergraph.map_nets.end(); ++it1) {
-    //  if (it1->second.name == "n1") {
-    //    REQUIRE(it1->second.cut == true);
+    //for (it1 = hypergraph.nets.begin();
+    //     it1 != hypergraph.nets.end(); ++it1) {
+    //  if (it1->name == "n1") {
+    //    REQUIRE(it1->cut == true);
     //  }
-    //  else if (it1->second.name == "n2") {
-    //    REQUIRE(it1->second.cut == true);
+    //  else if (it1->name == "n2") {
+    //    REQUIRE(it1->cut == true);
     //  }
-    //  else if (it1->second.name == "n3") {
-    //    REQUIRE(it1->second.cut == true);
+    //  else if (it1->name == "n3") {
+    //    REQUIRE(it1->cut == true);
     //  }
-    //  else if (it1->second.name == "n4") {
-    //    REQUIRE(it1->second.cut == true);
+    //  else if (it1->name == "n4") {
+    //    REQUIRE(it1->cut == true);
     //  }
-    //  else if (it1->second.name == "n5") {
-    //    REQUIRE(it1->second.cut == false);
+    //  else if (it1->name == "n5") {
+    //    REQUIRE(it1->cut == false);
     //  }
     //}
     
-    for (it = hypergraph.map_cells.begin(); 
-         it != hypergraph.map_cells.end(); ++it) {
-      if (it->second.name == "c1") {
-        REQUIRE(it->second.gain == 4);
+    for (it = hypergraph.cells.begin(); 
+         it != hypergraph.cells.end(); ++it) {
+      if (it->name == "c1") {
+        REQUIRE(hypergraph.state(it).gain == 4);
       }
-      else if (it->second.name == "c2") {
+      else if (it->name == "c2") {
         continue;
-        //REQUIRE(it->second.gain == 1);
+        //REQUIRE(hypergraph.state(it).gain == 1);
       }
-      else if (it->second.name == "c3") {
-        REQUIRE(it->second.gain == -1);
+      else if (it->name == "c3") {
+        REQUIRE(hypergraph.state(it).gain == -1);
       }
-      else if (it->second.name == "c4") {
-        REQUIRE(it->second.gain == 0);
+      else if (it->name == "c4") {
+        REQUIRE(hypergraph.state(it).gain == 0);
       }
-      else if (it->second.name == "c5") {
-        REQUIRE(it->second.gain == 1);
+      else if (it->name == "c5") {
+        REQUIRE(hypergraph.state(it).gain == 1);
       }
     }
-    REQUIRE(hypergraph.map_nets["n1"].cnt_cells_p0 == 1);
-    REQUIRE(hypergraph.map_nets["n1"].cnt_cells_p1 == 1);
-    REQUIRE(hypergraph.map_nets["n2"].cnt_cells_p0 == 1);
-    REQUIRE(hypergraph.map_nets["n2"].cnt_cells_p1 == 2);
-    REQUIRE(hypergraph.map_nets["n3"].cnt_cells_p0 == 1);
-    REQUIRE(hypergraph.map_nets["n3"].cnt_cells_p1 == 1);
-    REQUIRE(hypergraph.map_nets["n4"].cnt_cells_p0 == 1);
-    REQUIRE(hypergraph.map_nets["n4"].cnt_cells_p1 == 1);
-    REQUIRE(hypergraph.map_nets["n5"].cnt_cells_p0 == 0);
-    REQUIRE(hypergraph.map_nets["n5"].cnt_cells_p1 == 2);
+    REQUIRE(hypergraph.net("n1").cnt_cells_p0 == 1);
+    REQUIRE(hypergraph.net("n1").cnt_cells_p1 == 1);
+    REQUIRE(hypergraph.net("n2").cnt_cells_p0 == 1);
+    REQUIRE(hypergraph.net("n2").cnt_cells_p1 == 2);
+    REQUIRE(hypergraph.net("n3").cnt_cells_p0 == 1);
+    REQUIRE(hypergraph.net("n3").cnt_cells_p1 == 1);
+    REQUIRE(hypergraph.net("n4").cnt_cells_p0 == 1);
+    REQUIRE(hypergraph.net("n4").cnt_cells_p1 == 1);
+    REQUIRE(hypergraph.net("n5").cnt_cells_p0 == 0);
+    REQUIRE(hypergraph.net("n5").cnt_cells_p1 == 2);
   }
 
   SUBCASE("SUB : move c3") { 
-    Cell* target = &(hypergraph.map_cells["c3"]);
+    Cell* target = &(hypergraph.cell("c3"));
     for (size_t i = 0; i < target->nets.size(); ++i) { 
-      hypergraph.update_gain(target->nets[i], target);
+      hypergraph.update_gain(target->nets[i], hypergraph.cell_id(target));
     }
 
-    //for (it1 = hypergraph.map_nets.begin();
-    //     it1 != hypergraph.map_nets.end(); ++it1) {
-    //  if (it1->second.name == "n1") {
-    //    REQUIRE(it1->second.cut == false);
+    //for (it1 = hypergraph.nets.begin();
+    //     it1 != hypergraph.nets.end(); ++it1) {
+    //  if (it1->name == "n1") {
+    //    REQUIRE(it1->cut == false);
     //  }
-    //  else if (it1->second.name == "n2") {
-    //    REQUIRE(it1->second.cut == false);
+    //  else if (it1->name == "n2") {
+    //    REQUIRE(it1->cut == false);
     //  }
-    //  else if (it1->second.name == "n3") {
-    //    REQUIRE(it1->second.cut == true);
+    //  else if (it1->name == "n3") {
+    //    REQUIRE(it1->cut == true);
     //  }
-    //  else if (it1->second.name == "n4") {
-    //    REQUIRE(it1->second.cut == true);
+    //  else if (it1->name == "n4") {
+    //    REQUIRE(it1->cut == true);
     //  }
-    //  else if (it1->second.name == "n5") {
-    //    REQUIRE(it1->second.cut == true);
+    //  else if (it1->name == "n5") {
+    //    REQUIRE(it1->cut == true);
     //  }
     //}
     
-    for (it = hypergraph.map_cells.begin(); 
-         it != hypergraph.map_cells.end(); ++it) {
-      if (it->second.name == "c1") {
-        REQUIRE(it->second.gain == 0);
+    for (it = hypergraph.cells.begin(); 
+         it != hypergraph.cells.end(); ++it) {
+      if (it->name == "c1") {
+        REQUIRE(hypergraph.state(it).gain == 0);
       }
-      else if (it->second.name == "c2") {
-        REQUIRE(it->second.gain == -2);
+      else if (it->name == "c2") {
+        REQUIRE(hypergraph.state(it).gain == -2);
       }
-      else if (it->second.name == "c3") {
+      else if (it->name == "c3") {
         continue;
-        //REQUIRE(it->second.gain == 0);
+        //REQUIRE(hypergraph.state(it).gain == 0);
       }
-      else if (it->second.name == "c4") {
-        REQUIRE(it->second.gain == 2);
+      else if (it->name == "c4") {
+        REQUIRE(hypergraph.state(it).gain == 2);
       }
-      else if (it->second.name == "c5") {
-        REQUIRE(it->second.gain == 1);
+      else if (it->name == "c5") {
+        REQUIRE(hypergraph.state(it).gain == 1);
       }
     }
-    REQUIRE(hypergraph.map_nets["n1"].cnt_cells_p0 == 2);
-    REQUIRE(hypergraph.map_nets["n1"].cnt_cells_p1 == 0);
-    REQUIRE(hypergraph.map_nets["n2"].cnt_cells_p0 == 3);
-    REQUIRE(hypergraph.map_nets["n2"].cnt_cells_p1 == 0);
-    REQUIRE(hypergraph.map_nets["n3"].cnt_cells_p0 == 1);
-    REQUIRE(hypergraph.map_nets["n3"].cnt_cells_p1 == 1);
-    REQUIRE(hypergraph.map_nets["n4"].cnt_cells_p0 == 1);
-    REQUIRE(hypergraph.map_nets["n4"].cnt_cells_p1 == 1);
-    REQUIRE(hypergraph.map_nets["n5"].cnt_cells_p0 == 1);
-    REQUIRE(hypergraph.map_nets["n5"].cnt_cells_p1 == 1);
+    REQUIRE(hypergraph.net("n1").cnt_cells_p0 == 2);
+    REQUIRE(hypergraph.net("n1").cnt_cells_p1 == 0);
+    REQUIRE(hypergraph.net("n2").cnt_cells_p0 == 3);
+    REQUIRE(hypergraph.net("n2").cnt_cells_p1 == 0);
+    REQUIRE(hypergraph.net("n3").cnt_cells_p0 == 1);
+    REQUIRE(hypergraph.net("n3").cnt_cells_p1 == 1);
+    REQUIRE(hypergraph.net("n4").cnt_cells_p0 == 1);
+    REQUIRE(hypergraph.net("n4").cnt_cells_p1 == 1);
+    REQUIRE(hypergraph.net("n5").cnt_cells_p0 == 1);
+    REQUIRE(hypergraph.net("n5").cnt_cells_p1 == 1);
   }
 
   SUBCASE("SUB : move c4") {
-    Cell* target = &(hypergraph.map_cells["c4"]);
+    Cell* target = &(hypergraph.cell("c4"));
     for (size_t i = 0; i < target->nets.size(); ++i) { 
-      hypergraph.update_gain(target->nets[i], target);
+      hypergraph.update_gain(target->nets[i], hypergraph.cell_id(target));
     }
 
-    //for (it1 = hypergraph.map_nets.begin();
-    //     it1 != hypergraph.map_nets.end(); ++it1) {
-    //  if (it1->second.name == "n1") {
-    //    REQUIRE(it1->second.cut == false);
+    //for (it1 = hypergraph.nets.begin();
+    //     it1 != hypergraph.nets.end(); ++it1) {
+    //  if (it1->name == "n1") {
+    //    REQUIRE(it1->cut == false);
     //  }
-    //  else if (it1->second.name == "n2") {
-    //    REQUIRE(it1->second.cut == true);
+    //  else if (it1->name == "n2") {
+    //    REQUIRE(it1->cut == true);
     //  }
-    //  else if (it1->second.name == "n3") {
-    //    REQUIRE(it1->second.cut == false);
+    //  else if (it1->name == "n3") {
+    //    REQUIRE(it1->cut == false);
     //  }
-    //  else if (it1->second.name == "n4") {
-    //    REQUIRE(it1->second.cut == true);
+    //  else if (it1->name == "n4") {
+    //    REQUIRE(it1->cut == true);
     //  }
-    //  else if (it1->second.name == "n5") {
-    //    REQUIRE(it1->second.cut == true);
+    //  else if (it1->name == "n5") {
+    //    REQUIRE(it1->cut == true);
     //  }
     //}
     
-    for (it = hypergraph.map_cells.begin(); 
-         it != hypergraph.map_cells.end(); ++it) {
-      if (it->second.name == "c1") {
-        REQUIRE(it->second.gain == -1);
+    for (it = hypergraph.cells.begin(); 
+         it != hypergraph.cells.end(); ++it) {
+      if (it->name == "c1") {
+        REQUIRE(hypergraph.state(it).gain == -1);
       }
-      else if (it->second.name == "c2") {
-        REQUIRE(it->second.gain == -1);
+      else if (it->name == "c2") {
+        REQUIRE(hypergraph.state(it).gain == -1);
       }
-      else if (it->second.name == "c3") {
-        REQUIRE(it->second.gain == 2);
+      else if (it->name == "c3") {
+        REQUIRE(hypergraph.state(it).gain == 2);
       }
-      else if (it->second.name == "c4") {
+      else if (it->name == "c4") {
         continue;
-        //REQUIRE(it->second.gain == 0);
-      }
-      else if (it->second.name == "c5") {
-        REQUIRE(it->second.gain == 1);
-      }
-    }
-    REQUIRE(hypergraph.map_nets["n1"].cnt_cells_p0 == 2);
-    REQUIRE(hypergraph.map_nets["n1"].cnt_cells_p1 == 0);
-    REQUIRE(hypergraph.map_nets["n2"].cnt_cells_p0 == 2);
-    REQUIRE(hypergraph.map_nets["n2"].cnt_cells_p1 == 1);
-    REQUIRE(hypergraph.map_nets["n3"].cnt_cells_p0 == 2);
-    REQUIRE(hypergraph.map_nets["n3"].cnt_cells_p1 == 0);
-    REQUIRE(hypergraph.map_nets["n4"].cnt_cells_p0 == 1);
-    REQUIRE(hypergraph.map_nets["n4"].cnt_cells_p1 == 1);
-    REQUIRE(hypergraph.map_nets["n5"].cnt_cells_p0 == 1);
-    REQUIRE(hypergraph.map_nets["n5"].cnt_cells_p1 == 1);
+        //REQUIRE(hypergraph.state(it).gain == 0);
+      }
+      else if (it->name == "c5") {
+        REQUIRE(hypergraph.state(it).gain == 1);
+      }
+    }
+    REQUIRE(hypergraph.net("n1").cnt_cells_p0 == 2);
+    REQUIRE(hypergraph.net("n1").cnt_cells_p1 == 0);
+    REQUIRE(hypergraph.net("n2").cnt_cells_p0 == 2);
+    REQUIRE(hypergraph.net("n2").cnt_cells_p1 == 1);
+    REQUIRE(hypergraph.net("n3").cnt_cells_p0 == 2);
+    REQUIRE(hypergraph.net("n3").cnt_cells_p1 == 0);
+    REQUIRE(hypergraph.net("n4").cnt_cells_p0 == 1);
+    REQUIRE(hypergraph.net("n4").cnt_cells_p1 == 1);
+    REQUIRE(hypergraph.net("n5").cnt_cells_p0 == 1);
+    REQUIRE(hypergraph.net("n5").cnt_cells_p1 == 1);
   }
 
   SUBCASE("SUB : move c5") {
-    Cell* target = &(hypergraph.map_cells["c5"]);
+    Cell* target = &(hypergraph.cell("c5"));
     for (size_t i = 0; i < target->nets.size(); ++i) { 
-      hypergraph.update_gain(target->nets[i], target);
+      hypergraph.update_gain(target->nets[i], hypergraph.cell_id(target));
     }
 
-    //for (it1 = hypergraph.map_nets.begin();
-    //     it1 != hypergraph.map_nets.end(); ++it1) {
-    //  if (it1->second.name == "n1") {
-    //    REQUIRE(it1->second.cut == false);
+    //for (it1 = hypergraph.nets.begin();
+    //     it1 != hypergraph.nets.end(); ++it1) {
+    //  if (it1->name == "n1") {
+    //    REQUIRE(it1->cut == false);
     //  }
-    //  else if (it1->second.name == "n2") {
-    //    REQUIRE(it1->second.cut == true);
+    //  else if (it1->name == "n2") {
+    //    REQUIRE(it1->cut == true);
     //  }
-    //  else if (it1->second.name == "n3") {
-    //    REQUIRE(it1->second.cut == true);
+    //  else if (it1->name == "n3") {
+    //    REQUIRE(it1->cut == true);
     //  }
-    //  else if (it1->second.name == "n4") {
-    //    REQUIRE(it1->second.cut == false);
+    //  else if (it1->name == "n4") {
+    //    REQUIRE(it1->cut == false);
     //  }
-    //  else if (it1->second.name == "n5") {
-    //    REQUIRE(it1->second.cut == false);
+    //  else if (it1->name == "n5") {
+    //    REQUIRE(it1->cut == false);
     //  }
     //}
     
-    for (it = hypergraph.map_cells.begin(); 
-         it != hypergraph.map_cells.end(); ++it) {
-      if (it->second.name == "c1") {
-        REQUIRE(it->second.gain == -1);
+    for (it = hypergraph.cells.begin(); 
+         it != hypergraph.cells.end(); ++it) {
+      if (it->name == "c1") {
+        REQUIRE(hypergraph.state(it).gain == -1);
       }
-      else if (it->second.name == "c2") {
-        REQUIRE(it->second.gain == -1);
+      else if (it->name == "c2") {
+        REQUIRE(hypergraph.state(it).gain == -1);
       }
-      else if (it->second.name == "c3") {
-        REQUIRE(it->second.gain == 0);
+      else if (it->name == "c3") {
+        REQUIRE(hypergraph.state(it).gain == 0);
       }
-      else if (it->second.name == "c4") {
-        REQUIRE(it->second.gain == 0);
+      else if (it->name == "c4") {
+        REQUIRE(hypergraph.state(it).gain == 0);
       }
-      else if (it->second.name == "c5") {
+      else if (it->name == "c5") {
         continue;
-        //REQUIRE(it->second.gain == -1);
-      }
-    }
-    REQUIRE(hypergraph.map_nets["n1"].cnt_cells_p0 == 2);
-    REQUIRE(hypergraph.map_nets["n1"].cnt_cells_p1 == 0);
-    REQUIRE(hypergraph.map_nets["n2"].cnt_cells_p0 == 2);
-    REQUIRE(hypergraph.map_nets["n2"].cnt_cells_p1 == 1);
-    REQUIRE(hypergraph.map_nets["n3"].cnt_cells_p0 == 1);
-    REQUIRE(hypergraph.map_nets["n3"].cnt_cells_p1 == 1);
-    REQUIRE(hypergraph.map_nets["n4"].cnt_cells_p0 == 2);
-    REQUIRE(hypergraph.map_nets["n4"].cnt_cells_p1 == 0);
-    REQUIRE(hypergraph.map_nets["n5"].cnt_cells_p0 == 0);
-    REQUIRE(hypergraph.map_nets["n5"].cnt_cells_p1 == 2);
+        //REQUIRE(hypergraph.state(it).gain == -1);
+      }
+    }
+    REQUIRE(hypergraph.net("n1").cnt_cells_p0 == 2);
+    REQUIRE(hypergraph.net("n1").cnt_cells_p1 == 0);
+    REQUIRE(hypergraph.net("n2").cnt_cells_p0 == 2);
+    REQUIRE(hypergraph.net("n2").cnt_cells_p1 == 1);
+    REQUIRE(hypergraph.net("n3").cnt_cells_p0 == 1);
+    REQUIRE(hypergraph.net("n3").cnt_cells_p1 == 1);
+    REQUIRE(hypergraph.net("n4").cnt_cells_p0 == 2);
+    REQUIRE(hypergraph.net("n4").cnt_cells_p1 == 0);
+    REQUIRE(hypergraph.net("n5").cnt_cells_p0 == 0);
+    REQUIRE(hypergraph.net("n5").cnt_cells_p1 == 2);
   }
 }
 
@@ -821,34 +959,34 @@ TEST_CASE("verify_update_bucket" * doctest::timeout(600)) {
   //Hypergraph hypergraph(input_file, output_file);
   HypergraphTest hypergraph;
   
-  std::unordered_map<std::string, Cell>::iterator it;
-  for (it = hypergraph.map_cells.begin(); 
-       it != hypergraph.map_cells.end(); ++it) {
-    if (it->second.name == "c1") {
-      it->second.partition = 0;
+  Cell* it;
+  for (it = hypergraph.cells.begin(); 
+       it != hypergraph.cells.end(); ++it) {
+    if (it->name == "c1") {
+      hypergraph.state(it).partition = 0;
     }
-    else if(it->second.name == "c2") {
-      it->second.partition = 0;
+    else if(it->name == "c2") {
+      hypergraph.state(it).partition = 0;
     }
-    else if (it->second.name == "c3") {
-      it->second.partition = 1;
+    else if (it->name == "c3") {
+      hypergraph.state(it).partition = 1;
     }
-    else if (it->second.name == "c4") {
-      it->second.partition = 1;
+    else if (it->name == "c4") {
+      hypergraph.state(it).partition = 1;
     }
-    else if (it->second.name == "c5") {
-      it->second.partition = 1;
+    else if (it->name == "c5") {
+      hypergraph.state(it).partition = 1;
     }
-    it->second.prev = nullptr;
-    it->second.next = nullptr;
+    hypergraph.prev[hypergraph.cell_id(it)] = no_cell;
+    hypergraph.next[hypergraph.cell_id(it)] = no_cell;
   }
   
-  std::unordered_map<std::string, Net>::iterator it1;
-  for (it1 = hypergraph.map_nets.begin(); 
-       it1 != hypergraph.map_nets.end(); ++it1) {
-    //it1->second.cut = false;
-    it1->second.cnt_cells_p0 = 0;
-    it1->second.cnt_cells_p1 = 0;
+  Net* it1;
+  for (it1 = hypergraph.nets.begin(); 
+       it1 != hypergraph.nets.end(); ++it1) {
+    //it1->cut = false;
+    it1->cnt_cells_p0 = 0;
+    it1->cnt_cells_p1 = 0;
   }
 
   hypergraph.max_gain = -1000000;
@@ -861,190 +999,190 @@ TEST_CASE("verify_update_bucket" * doctest::timeout(600)) {
   hypergraph.construct_bucket();
 
   SUBCASE("SUB : Move c1") { 
-    int old_gain = hypergraph.map_cells["c1"].gain;
-    //hypergraph.map_cells["c1"].partition = 1;
-    //hypergraph.map_nets["n1"].cnt_cells_p0 -=1;
-    //hypergraph.map_nets["n1"].cnt_cells_p1 +=1;
-    //hypergraph.map_nets["n2"].cnt_cells_p0 -=1;
-    //hypergraph.map_nets["n2"].cnt_cells_p1 +=1;
-    //hypergraph.map_nets["n3"].cnt_cells_p0 -=1;
-    //hypergraph.map_nets["n3"].cnt_cells_p1 +=1;
-    //hypergraph.map_nets["n4"].cnt_cells_p0 -=1;
-    //hypergraph.map_nets["n4"].cnt_cells_p1 +=1;
+    int old_gain = hypergraph.state("c1").gain;
+    //hypergraph.state("c1").partition = 1;
+    //hypergraph.net("n1").cnt_cells_p0 -=1;
+    //hypergraph.net("n1").cnt_cells_p1 +=1;
+    //hypergraph.net("n2").cnt_cells_p0 -=1;
+    //hypergraph.net("n2").cnt_cells_p1 +=1;
+    //hypergraph.net("n3").cnt_cells_p0 -=1;
+    //hypergraph.net("n3").cnt_cells_p1 +=1;
+    //hypergraph.net("n4").cnt_cells_p0 -=1;
+    //hypergraph.net("n4").cnt_cells_p1 +=1;
  
-    hypergraph.map_cells["c1"].gain *= (-1); 
-    Cell* target = &(hypergraph.map_cells["c1"]);
+    hypergraph.state("c1").gain *= (-1); 
+    Cell* target = &(hypergraph.cell("c1"));
 
     for (size_t i = 0; i < target->nets.size(); ++i) { 
-      hypergraph.update_gain(target->nets[i], target);
+      hypergraph.update_gain(target->nets[i], hypergraph.cell_id(target));
     }
-    hypergraph.delete_from_bucket(target);
+    hypergraph.delete_from_bucket(hypergraph.cell_id(target));
 
     for (size_t i = 0; i < hypergraph.bucket.size(); ++i) {
       if (i < 2 || i == 4 || i == 5 || i > 6) {
-        REQUIRE(hypergraph.bucket[i] == nullptr);
+        REQUIRE(hypergraph.bucket[i] == no_cell);
       }
       else if (i == 2) {
-        REQUIRE(hypergraph.bucket[i]->name == "c4");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c4");
       }
       else if (i == 3) {
-        REQUIRE(hypergraph.bucket[i]->name != "c2");
-        REQUIRE(hypergraph.bucket[i]->name != "c4");
-        REQUIRE(hypergraph.bucket[i]->name != "c1");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c2");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c4");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c1");
       }
       else if (i == 6) {
-        REQUIRE(hypergraph.bucket[i]->name == "c2");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c2");
       }
     }
   }
   
   SUBCASE("SUB : Move c2") { 
-    //int old_gain = hypergraph.map_cells["c2"].gain;
-    //hypergraph.map_cells["c2"].partition = 1;
-    //hypergraph.map_nets["n1"].cnt_cells_p0 -=1;
-    //hypergraph.map_nets["n1"].cnt_cells_p1 +=1;
-    //hypergraph.map_nets["n2"].cnt_cells_p0 -=1;
-    //hypergraph.map_nets["n2"].cnt_cells_p1 +=1;
-    //hypergraph.update_cut_net(&(hypergraph.map_cells["c2"]));
-    //hypergraph.update_gain(&(hypergraph.map_cells["c2"]));
+    //int old_gain = hypergraph.state("c2").gain;
+    //hypergraph.state("c2").partition = 1;
+    //hypergraph.net("n1").cnt_cells_p0 -=1;
+    //hypergraph.net("n1").cnt_cells_p1 +=1;
+    //hypergraph.net("n2").cnt_cells_p0 -=1;
+    //hypergraph.net("n2").cnt_cells_p1 +=1;
+    //hypergraph.update_cut_net(&(hypergraph.cell("c2")));
+    //hypergraph.update_gain(&(hypergraph.cell("c2")));
     //hypergraph.update_bucket(
-    //  old_gain+hypergraph.num_nets(), &(hypergraph.map_cells["c2"]));
+    //  old_gain+hypergraph.num_nets(), &(hypergraph.cell("c2")));
 
-    hypergraph.map_cells["c2"].gain *= (-1); 
-    Cell* target = &(hypergraph.map_cells["c2"]);
+    hypergraph.state("c2").gain *= (-1); 
+    Cell* target = &(hypergraph.cell("c2"));
 
     for (size_t i = 0; i < target->nets.size(); ++i) { 
-      hypergraph.update_gain(target->nets[i], target);
+      hypergraph.update_gain(target->nets[i], hypergraph.cell_id(target));
     }
-    hypergraph.delete_from_bucket(target);
+    hypergraph.delete_from_bucket(hypergraph.cell_id(target));
 
     for (size_t i = 0; i < hypergraph.bucket.size(); ++i) {
       if (i < 3 || i == 6 || i == 7 || i > 8) {
-        REQUIRE(hypergraph.bucket[i] == nullptr);
+        REQUIRE(hypergraph.bucket[i] == no_cell);
       }
       else if (i == 3) {
-        REQUIRE(hypergraph.bucket[i]->name == "c3");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c3");
       }
       else if (i == 4) {
-        REQUIRE(hypergraph.bucket[i]->name == "c4");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c4");
       }
       else if (i == 5) {
-        REQUIRE(hypergraph.bucket[i]->name == "c5");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c5");
       }
       else if (i == 8) {
-        REQUIRE(hypergraph.bucket[i]->name == "c1");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c1");
       }
     }
   }
   
   SUBCASE("SUB : Move c3") { 
-    //int old_gain = hypergraph.map_cells["c3"].gain;
-    //hypergraph.map_cells["c3"].partition = 0;
-    //hypergraph.map_nets["n2"].cnt_cells_p0 +=1;
-    //hypergraph.map_nets["n2"].cnt_cells_p1 -=1;
-    //hypergraph.map_nets["n5"].cnt_cells_p0 +=1;
-    //hypergraph.map_nets["n5"].cnt_cells_p1 -=1;
-    //hypergraph.update_cut_net(&(hypergraph.map_cells["c3"]));
-    //hypergraph.update_gain(&(hypergraph.map_cells["c3"]));
+    //int old_gain = hypergraph.state("c3").gain;
+    //hypergraph.state("c3").partition = 0;
+    //hypergraph.net("n2").cnt_cells_p0 +=1;
+    //hypergraph.net("n2").cnt_cells_p1 -=1;
+    //hypergraph.net("n5").cnt_cells_p0 +=1;
+    //hypergraph.net("n5").cnt_cells_p1 -=1;
+    //hypergraph.update_cut_net(&(hypergraph.cell("c3")));
+    //hypergraph.update_gain(&(hypergraph.cell("c3")));
     //hypergraph.update_bucket(
-    //  old_gain+hypergraph.num_nets(), &(hypergraph.map_cells["c3"]));
+    //  old_gain+hypergraph.num_nets(), &(hypergraph.cell("c3")));
 
-    hypergraph.map_cells["c3"].gain *= (-1); 
-    Cell* target = &(hypergraph.map_cells["c3"]);
+    hypergraph.state("c3").gain *= (-1); 
+    Cell* target = &(hypergraph.cell("c3"));
 
     for (size_t i = 0; i < target->nets.size(); ++i) { 
-      hypergraph.update_gain(target->nets[i], target);
+      hypergraph.update_gain(target->nets[i], hypergraph.cell_id(target));
     }
-    hypergraph.delete_from_bucket(target);
+    hypergraph.delete_from_bucket(hypergraph.cell_id(target));
 
     for (size_t i = 0; i < hypergraph.bucket.size(); ++i) {
       if (i < 2 || i == 3 || i > 6) {
-        REQUIRE(hypergraph.bucket[i] == nullptr);
+        REQUIRE(hypergraph.bucket[i] == no_cell);
       }
       else if (i == 2) {
-        REQUIRE(hypergraph.bucket[i]->name == "c2");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c2");
       }
       else if (i == 4) {
-        REQUIRE(hypergraph.bucket[i]->name == "c1");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c1");
       }
       else if (i == 5) {
-        REQUIRE(hypergraph.bucket[i]->name == "c5");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c5");
       }
       else if (i == 6) {
-        REQUIRE(hypergraph.bucket[i]->name == "c4");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c4");
       }
     }
   }
   
   SUBCASE("SUB : Move c4") { 
-    //int old_gain = hypergraph.map_cells["c4"].gain;
-    //hypergraph.map_cells["c4"].partition = 0;
-    //hypergraph.map_nets["n3"].cnt_cells_p0 +=1;
-    //hypergraph.map_nets["n3"].cnt_cells_p1 -=1;
-    //hypergraph.map_nets["n5"].cnt_cells_p0 +=1;
-    //hypergraph.map_nets["n5"].cnt_cells_p1 -=1;
-    //hypergraph.update_cut_net(&(hypergraph.map_cells["c4"]));
-    //hypergraph.update_gain(&(hypergraph.map_cells["c4"]));
+    //int old_gain = hypergraph.state("c4").gain;
+    //hypergraph.state("c4").partition = 0;
+    //hypergraph.net("n3").cnt_cells_p0 +=1;
+    //hypergraph.net("n3").cnt_cells_p1 -=1;
+    //hypergraph.net("n5").cnt_cells_p0 +=1;
+    //hypergraph.net("n5").cnt_cells_p1 -=1;
+    //hypergraph.update_cut_net(&(hypergraph.cell("c4")));
+    //hypergraph.update_gain(&(hypergraph.cell("c4")));
     //hypergraph.update_bucket(
-    //  old_gain+hypergraph.num_nets(), &(hypergraph.map_cells["c4"]));
+    //  old_gain+hypergraph.num_nets(), &(hypergraph.cell("c4")));
 
-    hypergraph.map_cells["c4"].gain *= (-1); 
-    Cell* target = &(hypergraph.map_cells["c4"]);
+    hypergraph.state("c4").gain *= (-1); 
+    Cell* target = &(hypergraph.cell("c4"));
 
     for (size_t i = 0; i < target->nets.size(); ++i) { 
-      hypergraph.update_gain(target->nets[i], target);
+      hypergraph.update_gain(target->nets[i], hypergraph.cell_id(target));
     }
-    hypergraph.delete_from_bucket(target);
+    hypergraph.delete_from_bucket(hypergraph.cell_id(target));
     
     for (size_t i = 0; i < hypergraph.bucket.size(); ++i) {
       if (i < 3 || i == 4 || i > 7) {
-        REQUIRE(hypergraph.bucket[i] == nullptr);
+        REQUIRE(hypergraph.bucket[i] == no_cell);
       }
       else if (i == 3) {
-        REQUIRE(hypergraph.bucket[i]->name != "c3");
-        REQUIRE(hypergraph.bucket[i]->name != "c4");
-        REQUIRE(hypergraph.bucket[i]->name != "c5");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c3");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c4");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c5");
       }
       else if (i == 5) {
-        REQUIRE(hypergraph.bucket[i]->name == "c5");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c5");
       }
       else if (i == 6) {
-        REQUIRE(hypergraph.bucket[i]->name == "c3");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c3");
       }
     }
   }
   
   SUBCASE("SUB : Move c5") { 
-    //int old_gain = hypergraph.map_cells["c5"].gain;
-    //hypergraph.map_cells["c5"].partition = 0;
-    //hypergraph.map_nets["n4"].cnt_cells_p0 +=1;
-    //hypergraph.map_nets["n4"].cnt_cells_p1 -=1;
-    //hypergraph.update_cut_net(&(hypergraph.map_cells["c5"]));
-    //hypergraph.update_gain(&(hypergraph.map_cells["c5"]));
+    //int old_gain = hypergraph.state("c5").gain;
+    //hypergraph.state("c5").partition = 0;
+    //hypergraph.net("n4").cnt_cells_p0 +=1;
+    //hypergraph.net("n4").cnt_cells_p1 -=1;
+    //hypergraph.update_cut_net(&(hypergraph.cell("c5")));
+    //hypergraph.update_gain(&(hypergraph.cell("c5")));
     //hypergraph.update_bucket(
-    //  old_gain+hypergraph.num_nets(), &(hypergraph.map_cells["c5"]));
+    //  old_gain+hypergraph.num_nets(), &(hypergraph.cell("c5")));
 
-    hypergraph.map_cells["c5"].gain *= (-1); 
-    Cell* target = &(hypergraph.map_cells["c5"]);
+    hypergraph.state("c5").gain *= (-1); 
+    Cell* target = &(hypergraph.cell("c5"));
 
     for (size_t i = 0; i < target->nets.size(); ++i) { 
-      hypergraph.update_gain(target->nets[i], target);
+      hypergraph.update_gain(target->nets[i], hypergraph.cell_id(target));
     }
-    hypergraph.delete_from_bucket(target);
+    hypergraph.delete_from_bucket(hypergraph.cell_id(target));
     
     for (size_t i = 0; i < hypergraph.bucket.size(); ++i) {
       if (i < 3 || i > 4) {
-        REQUIRE(hypergraph.bucket[i] == nullptr);
+        REQUIRE(hypergraph.bucket[i] == no_cell);
       }
       else if (i == 3) {
-        REQUIRE(hypergraph.bucket[i]->name != "c3");
-        REQUIRE(hypergraph.bucket[i]->name != "c4");
-        REQUIRE(hypergraph.bucket[i]->name != "c5");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c3");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c4");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c5");
       }
       else if (i == 4) {
-        REQUIRE(hypergraph.bucket[i]->name != "c1");
-        REQUIRE(hypergraph.bucket[i]->name != "c2");
-        REQUIRE(hypergraph.bucket[i]->name != "c5");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c1");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c2");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c5");
       }
     }
   }
@@ -1056,34 +1194,34 @@ TEST_CASE("verify_find_max_cumulative_gain" * doctest::timeout(600)) {
   //Hypergraph hypergraph(input_file, output_file);
   HypergraphTest hypergraph;
   
-  std::unordered_map<std::string, Cell>::iterator it;
-  for (it = hypergraph.map_cells.begin(); 
-       it != hypergraph.map_cells.end(); ++it) {
-    if (it->second.name == "c1") {
-      it->second.partition = 0;
+  Cell* it;
+  for (it = hypergraph.cells.begin(); 
+       it != hypergraph.cells.end(); ++it) {
+    if (it->name == "c1") {
+      hypergraph.state(it).partition = 0;
     }
-    else if(it->second.name == "c2") {
-      it->second.partition = 0;
+    else if(it->name == "c2") {
+      hypergraph.state(it).partition = 0;
     }
-    else if (it->second.name == "c3") {
-      it->second.partition = 1;
+    else if (it->name == "c3") {
+      hypergraph.state(it).partition = 1;
     }
-    else if (it->second.name == "c4") {
-      it->second.partition = 1;
+    else if (it->name == "c4") {
+      hypergraph.state(it).partition = 1;
     }
-    else if (it->second.name == "c5") {
-      it->second.partition = 1;
+    else if (it->name == "c5") {
+      hypergraph.state(it).partition = 1;
     }
-    it->second.prev = nullptr;
-    it->second.next = nullptr;
+    hypergraph.prev[hypergraph.cell_id(it)] = no_cell;
+    hypergraph.next[hypergraph.cell_id(it)] = no_cell;
   }
   
-  std::unordered_map<std::string, Net>::iterator it1;
-  for (it1 = hypergraph.map_nets.begin(); 
-       it1 != hypergraph.map_nets.end(); ++it1) {
-    //it1->second.cut = false;
-    it1->second.cnt_cells_p0 = 0;
-    it1->second.cnt_cells_p1 = 0;
+  Net* it1;
+  for (it1 = hypergraph.nets.begin(); 
+       it1 != hypergraph.nets.end(); ++it1) {
+    //it1->cut = false;
+    it1->cnt_cells_p0 = 0;
+    it1->cnt_cells_p1 = 0;
   }
 
   hypergraph.max_gain = -1000000;
@@ -1128,39 +1266,1096 @@ TEST_CASE("verify_find_max_cumulative_gain" * doctest::timeout(600)) {
   }
 }
 
+// verify the cutsize maintained by update_gain and recover
+TEST_CASE("verify_cutsize" * doctest::timeout(600)) {
+  
+  HypergraphTest hypergraph;
+  
+  Cell* it;
+  for (it = hypergraph.cells.begin(); 
+       it != hypergraph.cells.end(); ++it) {
+    if (it->name == "c1" || it->name == "c2") {
+      hypergraph.state(it).partition = 0;
+    }
+    else {
+      hypergraph.state(it).partition = 1;
+    }
+    hypergraph.prev[hypergraph.cell_id(it)] = no_cell;
+    hypergraph.next[hypergraph.cell_id(it)] = no_cell;
+  }
+  
+  Net* it1;
+  for (it1 = hypergraph.nets.begin(); 
+       it1 != hypergraph.nets.end(); ++it1) {
+    it1->cnt_cells_p0 = 0;
+    it1->cnt_cells_p1 = 0;
+  }
+
+  hypergraph.max_gain = -1000000;
+  hypergraph.min_gain = 1000000;
+  hypergraph.num_cells_p0 = 2;
+  hypergraph.max_edge = 4;
+  hypergraph.initialize_count_cells();
+  hypergraph.initialize_gain(); 
+  hypergraph.bucket.clear();
+  hypergraph.construct_bucket();
+
+  // n2, n3 and n4 are cut
+  REQUIRE(hypergraph.cutsize == 3);
+
+  SUBCASE("SUB : move c1") {
+    Cell* target = &(hypergraph.cell("c1"));
+    for (size_t i = 0; i < target->nets.size(); ++i) { 
+      hypergraph.update_gain(target->nets[i], hypergraph.cell_id(target));
+    }
+    // n1 and n2 are cut
+    REQUIRE(hypergraph.cutsize == 2);
+  }
+  
+  SUBCASE("SUB : move c3") {
+    Cell* target = &(hypergraph.cell("c3"));
+    for (size_t i = 0; i < target->nets.size(); ++i) { 
+      hypergraph.update_gain(target->nets[i], hypergraph.cell_id(target));
+    }
+    // n3, n4 and n5 are cut
+    REQUIRE(hypergraph.cutsize == 3);
+  }
+  
+  SUBCASE("SUB : recover c5") {
+    hypergraph.recover(hypergraph.id("c5"));
+    // n2 and n3 are cut
+    REQUIRE(hypergraph.cutsize == 2);
+  }
+}
+
+
+// verify the output file
+TEST_CASE("verify_output_answer" * doctest::timeout(600)) {
+  
+  HypergraphTest hypergraph;
+  
+  Cell* it;
+  for (it = hypergraph.cells.begin(); 
+       it != hypergraph.cells.end(); ++it) {
+    if (it->name == "c1" || it->name == "c2") {
+      hypergraph.state(it).partition = 0;
+    }
+    else {
+      hypergraph.state(it).partition = 1;
+    }
+  }
+  
+  Net* it1;
+  for (it1 = hypergraph.nets.begin(); 
+       it1 != hypergraph.nets.end(); ++it1) {
+    it1->cnt_cells_p0 = 0;
+    it1->cnt_cells_p1 = 0;
+  }
+
+  hypergraph.num_cells_p0 = 2;
+  hypergraph.initialize_count_cells();
+  hypergraph.output_path = scratch("verify_output_answer.dat");
+  hypergraph.output_answer();
+
+  std::ifstream ifs(hypergraph.output_path);
+  std::string token;
+  std::vector<std::string> g1, g2;
+  size_t size1 = 0, size2 = 0, cutsize = 0;
+
+  ifs >> token >> token >> cutsize;
+  ifs >> token >> size1;
+  while (ifs >> token && token != ";") {
+    g1.push_back(token);
+  }
+  ifs >> token >> size2;
+  while (ifs >> token && token != ";") {
+    g2.push_back(token);
+  }
+
+  REQUIRE(cutsize == 3);
+  REQUIRE(size1 == 2);
+  REQUIRE(size2 == 3);
+  REQUIRE(g1.size() == 2);
+  REQUIRE(g2.size() == 3);
+  for (auto& name : g1) {
+    REQUIRE(hypergraph.state(name).partition == 0);
+  }
+  for (auto& name : g2) {
+    REQUIRE(hypergraph.state(name).partition == 1);
+  }
+}
+
+// verify the hMETIS reader and the .part writer
+TEST_CASE("verify_read_hgr" * doctest::timeout(600)) {
+  
+  std::string input_file(scratch("verify_read_hgr.hgr"));
+  std::string output_file(scratch("verify_read_hgr.part"));
+  
+  std::ofstream ofs(input_file);
+  ofs << "% the netlist of test.dat with net and cell weights\n"
+      << "5 5 11\n"
+      << "2 1 2\n"
+      << "1 1 2 3\n"
+      << "1 1 4\n"
+      << "3 1 5\n"
+      << "1 3 4\n"
+      << "% cell weights\n"
+      << "1\n2\n1\n1\n4\n";
+  ofs.close();
+
+  Hypergraph hypergraph(input_file, output_file, 0.5);
+
+  REQUIRE(hypergraph.num_cells() == 5);
+  REQUIRE(hypergraph.num_nets() == 5);
+  REQUIRE(hypergraph.r_factor == 0.5);
+  
+  REQUIRE(hypergraph.nets[0].weight == 2);
+  REQUIRE(hypergraph.nets[1].weight == 1);
+  REQUIRE(hypergraph.nets[3].weight == 3);
+  REQUIRE(hypergraph.nets[1].cells.size() == 3);
+  REQUIRE(hypergraph.find_cell("1")->nets.size() == 4);
+  REQUIRE(hypergraph.find_cell("2")->weight == 2);
+  REQUIRE(hypergraph.find_cell("5")->weight == 4);
+
+  // c1 touches n1, n2, n3 and n4 with a total weight of 7
+  REQUIRE(hypergraph.max_edge == 7);
+  REQUIRE(hypergraph.bucket.size() == 15);
+
+  size_t cutsize = 0;
+  for (auto& net : hypergraph.nets) {
+    if (net.cnt_cells_p0 != 0 && net.cnt_cells_p1 != 0) {
+      cutsize += net.weight;
+    }
+  }
+  REQUIRE(hypergraph.cutsize == cutsize);
+
+  hypergraph.output_part();
+
+  std::ifstream ifs(output_file);
+  int p = 0;
+  size_t id = 0;
+  while (ifs >> p) {
+    REQUIRE(id < hypergraph.cells.size());
+    REQUIRE(hypergraph.cells[id].name == std::to_string(id+1));
+    REQUIRE(hypergraph.states[id].partition == p);
+    ++id;
+  }
+  REQUIRE(id == 5);
+}
+
+// verify the move tracer streams every record in order
+TEST_CASE("verify_move_tracer" * doctest::timeout(600)) {
+  
+  std::string trace_file(scratch("verify_move_tracer.bin"));
+  
+  // a tiny ring makes the producer wrap around many times
+  MoveTracer tracer(trace_file, 4);
+  for (uint32_t i = 0; i < 1000; ++i) {
+    TraceRecord record;
+    record.type = (i % 100 == 99) ? TraceType::PASS_END : TraceType::MOVE;
+    record.pass = tracer.pass;
+    record.cell = i;
+    record.gain = -static_cast<int32_t>(i);
+    tracer.push(record);
+  }
+  tracer.close();
+  REQUIRE(tracer.pass == 11);
+
+  std::ifstream ifs(trace_file, std::ios::binary);
+  char magic[sizeof(trace_magic)];
+  ifs.read(magic, sizeof(magic));
+  REQUIRE(std::string(magic, sizeof(magic)) == "FMTRACE1");
+
+  TraceRecord record;
+  uint32_t i = 0;
+  while (ifs.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+    REQUIRE(record.cell == i);
+    REQUIRE(record.gain == -static_cast<int32_t>(i));
+    REQUIRE(record.pass == i/100 + 1);
+    ++i;
+  }
+  REQUIRE(i == 1000);
+}
+
+// verify the V-cycle coarsening keeps the partition and the cut
+TEST_CASE("verify_vcycle" * doctest::timeout(600)) {
+  
+  HypergraphTest hypergraph;
+
+  hypergraph.state("c1").partition = 0;
+  hypergraph.state("c2").partition = 0;
+  hypergraph.state("c3").partition = 1;
+  hypergraph.state("c4").partition = 1;
+  hypergraph.state("c5").partition = 1;
+
+  hypergraph.total_area = 5;
+  hypergraph.area_lower_bound = 1.25;
+  hypergraph.area_upper_bound = 3.75;
+  hypergraph.verbose = false;
+  hypergraph.initialize_max_edge();
+  hypergraph.initialize_from_partition();
+  REQUIRE(hypergraph.cutsize == 3);
+  REQUIRE(hypergraph.num_cells_p0 == 2);
+
+  VCycle vcycle(hypergraph);
+
+  SUBCASE("SUB : coarsen") {
+    Hypergraph coarse;
+    std::vector<uint32_t> map;
+    vcycle.coarsen(hypergraph, coarse, map);
+
+    // c1 and c2 pair up through n1 and n2, c3 and c4 through n5, 
+    // c5 only shares n4 with c1 across the cut
+    REQUIRE(coarse.num_cells() == 3);
+    REQUIRE(map[hypergraph.id("c1")] == map[hypergraph.id("c2")]);
+    REQUIRE(map[hypergraph.id("c3")] == map[hypergraph.id("c4")]);
+    REQUIRE(map[hypergraph.id("c1")] != map[hypergraph.id("c5")]);
+    REQUIRE(map[hypergraph.id("c3")] != map[hypergraph.id("c5")]);
+
+    for (uint32_t c = 0; c < hypergraph.num_cells(); ++c) {
+      REQUIRE(coarse.states[map[c]].partition == 
+              hypergraph.states[c].partition);
+    }
+    REQUIRE(coarse.cells[map[hypergraph.id("c1")]].weight == 2);
+    REQUIRE(coarse.cells[map[hypergraph.id("c5")]].weight == 1);
+
+    // n1 and n5 end up inside a cluster
+    REQUIRE(coarse.num_nets() == 3);
+
+    coarse.initialize_from_partition();
+    REQUIRE(coarse.cutsize == 3);
+    REQUIRE(coarse.num_cells_p0 == 1);
+  }
+
+  SUBCASE("SUB : cycle") {
+    std::vector<bool> before(hypergraph.num_cells());
+    for (uint32_t c = 0; c < hypergraph.num_cells(); ++c) {
+      before[c] = hypergraph.states[c].partition;
+    }
+
+    vcycle.min_cells = 2;
+    bool improved = vcycle.cycle(std::chrono::steady_clock::now() + 
+                                 std::chrono::seconds(10));
+
+    if (improved) {
+      REQUIRE(hypergraph.cutsize < 3);
+    }
+    else {
+      REQUIRE(hypergraph.cutsize == 3);
+      for (uint32_t c = 0; c < hypergraph.num_cells(); ++c) {
+        REQUIRE(hypergraph.states[c].partition == before[c]);
+      }
+    }
+    REQUIRE(hypergraph.area_p0 > 1.25);
+    REQUIRE(hypergraph.area_p0 < 3.75);
+  }
+}
+
+// verify the batch runner reuses one hypergraph across its jobs
+TEST_CASE("verify_batch" * doctest::timeout(600)) {
+
+  std::ofstream dat(scratch("verify_batch.dat"));
+  dat << "0.5\n"
+      << "NET n1 c1 c2 ;\n"
+      << "NET n2 c1 c2 c3 ;\n"
+      << "NET n3 c1 c4 ;\n"
+      << "NET n4 c1 c5 ;\n"
+      << "NET n5 c3 c4 ;\n";
+  dat.close();
+
+  std::ofstream hgr(scratch("verify_batch.hgr"));
+  hgr << "3 4\n" << "1 2\n" << "2 3\n" << "3 4\n";
+  hgr.close();
+
+  std::ofstream manifest(scratch("verify_batch.json"));
+  manifest << "{ \"balance_factor\" : 0.5, \"jobs\" : [\n"
+           << "  { \"input\" : \"" << scratch("verify_batch.dat") << "\", "
+           << "\"output\" : \"" << scratch("verify_batch_1.out") << "\" },\n"
+           << "  { \"input\" : \"" << scratch("verify_batch.hgr") << "\", "
+           << "\"output\" : \"" << scratch("verify_batch_2.part") << "\" },\n"
+           << "  { \"input\" : \"" << scratch("verify_batch_missing.dat") 
+           << "\", "
+           << "\"output\" : \"" << scratch("verify_batch_3.out") << "\" },\n"
+           << "  { \"input\" : \"" << scratch("verify_batch.dat") << "\", "
+           << "\"output\" : \"" << scratch("verify_batch_4.out") << "\", "
+           << "\"balance_factor\" : 0.2 } ] }\n";
+  manifest.close();
+
+  std::vector<BatchJob> jobs = 
+    BatchRunner::read_manifest(scratch("verify_batch.json"));
+  REQUIRE(jobs.size() == 4);
+  REQUIRE(jobs[1].r_factor == 0.5);
+  REQUIRE(jobs[3].r_factor == 0.2);
+
+  BatchRunner runner(jobs);
+  runner.num_threads = 2;
+  runner.run();
+
+  REQUIRE(runner.num_threads == 2);
+  REQUIRE(runner.num_failed() == 1);
+  REQUIRE(!jobs[2].done);
+  REQUIRE(!jobs[2].error.empty());
+
+  REQUIRE(jobs[0].num_cells == 5);
+  REQUIRE(jobs[0].num_nets == 5);
+  REQUIRE(jobs[1].num_cells == 4);
+  REQUIRE(jobs[1].num_nets == 3);
+
+  // every answer starts with the cutsize the runner reports
+  for (size_t i : {0, 3}) {
+    std::ifstream ifs(jobs[i].output);
+    std::string word;
+    size_t cutsize = 0;
+    ifs >> word >> word >> cutsize;
+    REQUIRE(cutsize == jobs[i].cutsize);
+  }
+
+  runner.write_summary(scratch("verify_batch_summary.json"));
+  std::ifstream ifs(scratch("verify_batch_summary.json"));
+  nlohmann::json summary = nlohmann::json::parse(ifs);
+  REQUIRE(summary["failed"] == 1);
+  REQUIRE(summary["jobs"].size() == 4);
+  REQUIRE(summary["jobs"][1]["cutsize"] == jobs[1].cutsize);
+  REQUIRE(summary["jobs"][2].contains("error"));
+
+  // reloading a netlist maps no more memory
+  Hypergraph hypergraph;
+  hypergraph.verbose = false;
+  hypergraph.load(scratch("verify_batch.dat"), scratch("verify_batch_1.out"));
+  size_t mapped = hypergraph.arena.bytes_mapped();
+  for (int i = 0; i < 3; ++i) {
+    hypergraph.load(scratch("verify_batch.hgr"), scratch("verify_batch_2.part"),
+                    0.5);
+    hypergraph.load(scratch("verify_batch.dat"), scratch("verify_batch_1.out"));
+    hypergraph.run_fm();
+  }
+  REQUIRE(hypergraph.arena.bytes_mapped() == mapped);
+  REQUIRE(hypergraph.num_cells() == 5);
+  REQUIRE(hypergraph.bucket.size() == 9);
+}
+
+// verify a bad input throws, and fails only its own job of a batch
+TEST_CASE("verify_input_errors" * doctest::timeout(600)) {
+
+  std::ofstream bad(scratch("verify_input_errors.hgr"));
+  bad << "2 3\n" << "1 2\n" << "2 4\n";
+  bad.close();
+
+  std::ofstream good(scratch("verify_input_errors.dat"));
+  good << "0.5\n" << "NET n1 c1 c2 ;\n" << "NET n2 c2 c3 ;\n";
+  good.close();
+
+  Hypergraph hypergraph;
+  hypergraph.verbose = false;
+  REQUIRE_THROWS_AS(
+    hypergraph.load(scratch("verify_input_errors.hgr"), 
+                    scratch("verify_input_errors_1.part")), 
+    std::runtime_error);
+  REQUIRE_THROWS_AS(
+    hypergraph.load(scratch("verify_input_errors_missing.dat"), 
+                    scratch("verify_input_errors_2.out")), 
+    std::runtime_error);
+
+  // net and cell weights must be positive and fit in an int
+  const char* bad_weights[] = {
+    "2 3 1\n0 1 2\n1 2 3\n",
+    "2 3 1\n-2 1 2\n1 2 3\n",
+    "2 3 1\n1 1 2\n2147483648 2 3\n",
+    "2 3 10\n1 2\n2 3\n1\n0\n1\n",
+    "2 3 10\n1 2\n2 3\n1\n1\n99999999999999999999\n"
+  };
+  for (const char* content : bad_weights) {
+    std::ofstream ofs(scratch("verify_input_errors_weight.hgr"));
+    ofs << content;
+    ofs.close();
+    REQUIRE_THROWS_AS(
+      hypergraph.load(scratch("verify_input_errors_weight.hgr"), 
+                      scratch("verify_input_errors_weight.part")), 
+      std::runtime_error);
+  }
+
+  // a header may not ask for more nets or cells than the file holds
+  const char* bad_headers[] = {
+    "1000000000 3\n1 2\n",
+    "1 5000000000\n1 2\n",
+    "2 3 10\n1 2\n2 3\n1\n"
+  };
+  for (const char* content : bad_headers) {
+    std::ofstream ofs(scratch("verify_input_errors_header.hgr"));
+    ofs << content;
+    ofs.close();
+    REQUIRE_THROWS_AS(
+      hypergraph.load(scratch("verify_input_errors_header.hgr"), 
+                      scratch("verify_input_errors_header.part")), 
+      std::runtime_error);
+  }
+  REQUIRE_THROWS_AS(hypergraph.arena.allocate<Cell>(SIZE_MAX / 2), 
+                    std::runtime_error);
+
+  // the hypergraph is still usable after a failed load
+  hypergraph.load(scratch("verify_input_errors.dat"), 
+                  scratch("verify_input_errors_3.out"));
+  REQUIRE(hypergraph.num_cells() == 3);
+
+  std::vector<BatchJob> jobs(3);
+  jobs[0].input = scratch("verify_input_errors.dat");
+  jobs[0].output = scratch("verify_input_errors_4.out");
+  jobs[1].input = scratch("verify_input_errors.hgr");
+  jobs[1].output = scratch("verify_input_errors_5.part");
+  jobs[2].input = scratch("verify_input_errors.dat");
+  jobs[2].output = scratch("verify_input_errors_6.out");
+
+  BatchRunner runner(jobs);
+  runner.num_threads = 1;
+  runner.run();
+
+  REQUIRE(runner.num_failed() == 1);
+  REQUIRE(jobs[0].done);
+  REQUIRE(!jobs[1].done);
+  REQUIRE(jobs[1].error == "Net 2 refers to cell 4 out of range");
+  REQUIRE(jobs[2].done);
+}
+
+// verify the memory accounting of each part of the hypergraph
+TEST_CASE("verify_memory_usage" * doctest::timeout(600)) {
+
+  const std::string text = 
+    "0.5\n"
+    "NET n1 c1 c2 ;\n"
+    "NET n2 c1 c2 c3 ;\n"
+    "NET n3 c1 c4 ;\n"
+    "NET n4 c1 c5 ;\n"
+    "NET n5 c3 c4 ;\n";
+
+  std::ofstream ofs(scratch("verify_memory_usage.dat"));
+  ofs << text;
+  ofs.close();
+
+  Hypergraph hypergraph;
+  hypergraph.verbose = false;
+  hypergraph.load(scratch("verify_memory_usage.dat"), 
+                  scratch("verify_memory_usage.out"));
+
+  MemoryUsage usage = hypergraph.memory_usage();
+  REQUIRE(usage.input == text.size()+1);
+
+  // 12 pins may introduce 12 cells, the table keeps twice that many slots
+  REQUIRE(usage.cell_index == 32*sizeof(uint32_t));
+  REQUIRE(usage.netlist >= 5*sizeof(Cell) + 5*sizeof(Net) + 
+                           12*(sizeof(uint32_t) + sizeof(Net*)));
+  REQUIRE(usage.input + usage.netlist + usage.cell_index ==
+          hypergraph.arena.bytes_allocated());
+  REQUIRE(usage.arena_mapped >= hypergraph.arena.bytes_allocated());
+
+  REQUIRE(usage.cell_state >= 5*(sizeof(CellState) + 2*sizeof(uint32_t)));
+  REQUIRE(usage.buckets >= 9*(2*sizeof(uint32_t) + 2*sizeof(int)));
+  REQUIRE(usage.locked_cells == 0);
+
+  hypergraph.run_fm();
+  usage = hypergraph.memory_usage();
+  REQUIRE(hypergraph.locked_cells.size() > 0);
+  REQUIRE(usage.locked_cells >= hypergraph.locked_cells.size()*
+                                (sizeof(uint32_t) + sizeof(int)));
+
+  REQUIRE(peak_rss() > 0);
+}
+
+// verify runs replay exactly from their seed
+TEST_CASE("verify_random" * doctest::timeout(600)) {
+
+  Random a(42);
+  Random b(42);
+  Random c(43);
+  bool differs = false;
+  for (int i = 0; i < 1000; ++i) {
+    uint64_t x = a.next();
+    REQUIRE(x == b.next());
+    differs |= (x != c.next());
+  }
+  REQUIRE(differs);
+
+  a.seed(7);
+  size_t heads = 0;
+  std::vector<size_t> counts(10, 0);
+  for (int i = 0; i < 10000; ++i) {
+    heads += a.coin();
+    uint32_t k = a.below(10);
+    REQUIRE(k < 10);
+    ++counts[k];
+  }
+  REQUIRE(heads > 4500);
+  REQUIRE(heads < 5500);
+  for (size_t count : counts) {
+    REQUIRE(count > 800);
+  }
+
+  // random netlist of 300 cells
+  std::ofstream ofs(scratch("verify_random.dat"));
+  ofs << "0.1\n";
+  Random netlist(1);
+  for (int n = 0; n < 400; ++n) {
+    ofs << "NET n" << n;
+    for (uint32_t p = 0, size = 2 + netlist.below(4); p < size; ++p) {
+      ofs << " c" << netlist.below(300);
+    }
+    ofs << " ;\n";
+  }
+  ofs.close();
+
+  std::string input_file(scratch("verify_random.dat"));
+  std::string output_file(scratch("verify_random.out"));
+
+  SUBCASE("SUB : same seed, same partition") {
+    Hypergraph first(input_file, output_file, 0.1, false, 
+                     BucketPolicy::FIFO, 5);
+    Hypergraph second(input_file, output_file, 0.1, false, 
+                      BucketPolicy::FIFO, 5);
+    first.verbose = false;
+    second.verbose = false;
+
+    for (uint32_t c = 0; c < first.num_cells(); ++c) {
+      REQUIRE(first.states[c].partition == second.states[c].partition);
+    }
+
+    first.run_fm();
+    second.run_fm();
+    REQUIRE(first.cutsize == second.cutsize);
+    VCycle(first).run(10);
+    VCycle(second).run(10);
+    REQUIRE(first.cutsize == second.cutsize);
+    for (uint32_t c = 0; c < first.num_cells(); ++c) {
+      REQUIRE(first.states[c].partition == second.states[c].partition);
+    }
+  }
+
+  SUBCASE("SUB : batch results do not depend on the threads") {
+    std::vector<BatchJob> jobs(6);
+    for (size_t i = 0; i < jobs.size(); ++i) {
+      jobs[i].input = input_file;
+      jobs[i].output = "verify_random_" + std::to_string(i) + ".out";
+    }
+    std::vector<BatchJob> others = jobs;
+
+    BatchRunner one(jobs);
+    one.num_threads = 1;
+    one.seed = 11;
+    one.run();
+
+    BatchRunner three(others);
+    three.num_threads = 3;
+    three.seed = 11;
+    three.run();
+
+    for (size_t i = 0; i < jobs.size(); ++i) {
+      REQUIRE(jobs[i].seed == 11+i);
+      REQUIRE(jobs[i].cutsize == others[i].cutsize);
+    }
+  }
+}
+
+// verify every pin-count kernel the CPU runs agrees with a plain count
+TEST_CASE("verify_pin_count" * doctest::timeout(600)) {
+
+  // nets of 2 to 40 pins cover whole and partial vectors of both widths
+  std::ofstream ofs(scratch("verify_pin_count.dat"));
+  ofs << "0.1\n";
+  Random netlist(3);
+  for (int n = 0; n < 500; ++n) {
+    ofs << "NET n" << n;
+    for (uint32_t p = 0, size = 2 + netlist.below(39); p < size; ++p) {
+      ofs << " c" << netlist.below(1000);
+    }
+    ofs << " ;\n";
+  }
+  ofs.close();
+
+  Hypergraph hypergraph;
+  hypergraph.verbose = false;
+  hypergraph.load(scratch("verify_pin_count.dat"), 
+                  scratch("verify_pin_count.out"));
+  REQUIRE(hypergraph.pins.size() == hypergraph.net_offsets[500]);
+
+  std::vector<uint32_t> expected(hypergraph.num_nets());
+  for (size_t i = 0; i < hypergraph.num_nets(); ++i) {
+    const Net& net = hypergraph.nets[i];
+    REQUIRE(net.cells.data == 
+            hypergraph.pins.data + hypergraph.net_offsets[i]);
+    for (size_t j = 0; j < net.cells.size(); ++j) {
+      expected[i] += hypergraph.states[net.cells[j]].partition;
+    }
+    REQUIRE(net.cnt_cells_p1 == expected[i]);
+    REQUIRE(net.cnt_cells_p0 == net.cells.size() - expected[i]);
+  }
+
+  for (PinKernel kernel : {PinKernel::SCALAR, PinKernel::AVX2, 
+                           PinKernel::AVX512}) {
+    if (!supports_pin_kernel(kernel)) {
+      continue;
+    }
+    hypergraph.pin_kernel = kernel;
+    hypergraph.count_pins();
+    for (size_t i = 0; i < hypergraph.num_nets(); ++i) {
+      REQUIRE(hypergraph.pin_counts[i] == expected[i]);
+    }
+  }
+
+  // the cut FM keeps up to date matches a recount
+  hypergraph.pin_kernel = best_pin_kernel();
+  hypergraph.run_fm();
+  REQUIRE(hypergraph.evaluate_cutsize() == hypergraph.cutsize);
+}
+
+// verify boundary_only links the cells near the cut and keeps it exact
+TEST_CASE("verify_boundary" * doctest::timeout(600)) {
+
+  // a 30x30 grid, every cell on a net with its right and lower neighbor
+  std::ofstream ofs(scratch("verify_boundary.dat"));
+  ofs << "0.1\n";
+  for (int y = 0; y < 30; ++y) {
+    for (int x = 0; x < 30; ++x) {
+      if (x+1 < 30) {
+        ofs << "NET h" << y << '_' << x << " c" << y*30+x 
+            << " c" << y*30+x+1 << " ;\n";
+      }
+      if (y+1 < 30) {
+        ofs << "NET v" << y << '_' << x << " c" << y*30+x 
+            << " c" << (y+1)*30+x << " ;\n";
+      }
+    }
+  }
+  ofs.close();
+
+  for (BucketPolicy policy : {BucketPolicy::FIFO, BucketPolicy::LIFO,
+                              BucketPolicy::CLIP}) {
+    Hypergraph hypergraph;
+    hypergraph.verbose = false;
+    hypergraph.policy = policy;
+    hypergraph.rng.seed(5);
+    hypergraph.load(scratch("verify_boundary.dat"), 
+                    scratch("verify_boundary.out"));
+    hypergraph.run_fm();
+
+    // cells on a cut net, and those sharing a net with one
+    std::vector<uint8_t> on_cut(hypergraph.num_cells(), 0);
+    std::vector<uint8_t> near_cut(hypergraph.num_cells(), 0);
+    for (size_t i = 0; i < hypergraph.num_nets(); ++i) {
+      const Net& net = hypergraph.nets[i];
+      if (net.cnt_cells_p0 != 0 && net.cnt_cells_p1 != 0) {
+        for (size_t j = 0; j < net.cells.size(); ++j) {
+          on_cut[net.cells[j]] = 1;
+        }
+      }
+    }
+    for (size_t i = 0; i < hypergraph.num_nets(); ++i) {
+      const Net& net = hypergraph.nets[i];
+      bool cut = false;
+      for (size_t j = 0; j < net.cells.size(); ++j) {
+        cut = cut || on_cut[net.cells[j]];
+      }
+      for (size_t j = 0; cut && j < net.cells.size(); ++j) {
+        near_cut[net.cells[j]] = 1;
+      }
+    }
+
+    for (size_t halo = 0; halo < 2; ++halo) {
+      hypergraph.boundary_only = true;
+      hypergraph.halo = halo;
+      hypergraph.initialize_from_partition();
+
+      size_t linked = 0;
+      for (uint32_t c : hypergraph.bucket) {
+        for (; c != no_cell; c = hypergraph.next[c]) {
+          REQUIRE(hypergraph.active[c]);
+          ++linked;
+        }
+      }
+      REQUIRE(linked == hypergraph.num_boundary);
+      REQUIRE(linked < hypergraph.num_cells());
+      const std::vector<uint8_t>& expected = halo == 0 ? on_cut : near_cut;
+      for (uint32_t c = 0; c < hypergraph.num_cells(); ++c) {
+        REQUIRE(hypergraph.active[c] == expected[c]);
+      }
+    }
+
+    // restart from a perturbed partition, the cut only goes down
+    // and matches a recount after every pass
+    Random flips(7);
+    for (int i = 0; i < 45; ++i) {
+      uint32_t c = flips.below(900);
+      if (hypergraph.meet_balance_criterion(c)) {
+        CellState& state = hypergraph.states[c];
+        hypergraph.area_p0 += state.partition ? hypergraph.cells[c].weight
+                                              : -hypergraph.cells[c].weight;
+        state.partition = !state.partition;
+      }
+    }
+    hypergraph.initialize_from_partition();
+    size_t start = hypergraph.cutsize;
+    hypergraph.run_fm();
+    REQUIRE(hypergraph.cutsize <= start);
+    REQUIRE(hypergraph.evaluate_cutsize() == hypergraph.cutsize);
+  }
+}
+
+// verify the daemon serves partitions from copies of one netlist
+TEST_CASE("verify_daemon" * doctest::timeout(600)) {
+  std::ofstream ofs(scratch("verify_daemon.dat"));
+  ofs << "0.1\n";
+  Random netlist_rng(9);
+  for (int n = 0; n < 300; ++n) {
+    ofs << "NET n" << n;
+    for (uint32_t p = 0, size = 2 + netlist_rng.below(4); p < size; ++p) {
+      ofs << " c" << netlist_rng.below(200);
+    }
+    ofs << " ;\n";
+  }
+  ofs.close();
+
+  Hypergraph netlist;
+  netlist.verbose = false;
+  netlist.load(scratch("verify_daemon.dat"), scratch("verify_daemon.out"));
+  std::vector<int> counts(netlist.num_nets());
+  for (size_t i = 0; i < netlist.num_nets(); ++i) {
+    counts[i] = netlist.nets[i].cnt_cells_p0;
+  }
+
+  PartitionDaemon daemon(netlist, scratch("verify_daemon.sock"));
+  daemon.num_threads = 2;
+
+  SUBCASE("copy") {
+    Hypergraph graph;
+    daemon.prepare(graph);
+    REQUIRE(graph.num_cells() == netlist.num_cells());
+    REQUIRE(graph.num_nets() == netlist.num_nets());
+    for (uint32_t c = 0; c < graph.num_cells(); ++c) {
+      REQUIRE(graph.find_cell(netlist.cells[c].name) == &graph.cells[c]);
+      REQUIRE(graph.cells[c].nets.size() == netlist.cells[c].nets.size());
+      for (size_t i = 0; i < graph.cells[c].nets.size(); ++i) {
+        REQUIRE(graph.cells[c].nets[i] - graph.nets.begin() ==
+                netlist.cells[c].nets[i] - netlist.nets.begin());
+      }
+    }
+    for (size_t i = 0; i < graph.num_nets(); ++i) {
+      REQUIRE(graph.nets[i].cells.data != netlist.nets[i].cells.data);
+      REQUIRE(std::equal(graph.nets[i].cells.begin(), 
+                         graph.nets[i].cells.end(),
+                         netlist.nets[i].cells.begin()));
+    }
+
+    // FM on the copy leaves the shared netlist alone
+    graph.rng.seed(1);
+    graph.restart(0.1);
+    graph.run_fm();
+    REQUIRE(graph.evaluate_cutsize() == graph.cutsize);
+    for (size_t i = 0; i < netlist.num_nets(); ++i) {
+      REQUIRE(netlist.nets[i].cnt_cells_p0 == counts[i]);
+    }
+  }
+
+  SUBCASE("serve") {
+    Hypergraph graph;
+    daemon.prepare(graph);
+
+    auto reply = [&](const std::string& line) {
+      return nlohmann::json::parse(daemon.serve(graph, line));
+    };
+
+    // a seed replays its partition
+    nlohmann::json first = reply("{ \"seed\" : 4 }");
+    nlohmann::json second = reply("{ \"seed\" : 4, \"time_limit\" : 0 }");
+    REQUIRE(first["partition"] == second["partition"]);
+    REQUIRE(first["cutsize"] == second["cutsize"]);
+    REQUIRE(first["partition"].get<std::string>().size() == 
+            netlist.num_cells());
+
+    // fixed cells keep their sides, also through the V-cycles
+    nlohmann::json fixed = reply(
+      "{ \"seed\" : 4, \"time_limit\" : 0.5, "
+      "\"fixed\" : { \"c0\" : 1, \"c1\" : 0, \"c2\" : 1 } }");
+    std::string sides = fixed["partition"];
+    uint32_t c0 = graph.cell_id(graph.find_cell("c0"));
+    uint32_t c1 = graph.cell_id(graph.find_cell("c1"));
+    uint32_t c2 = graph.cell_id(graph.find_cell("c2"));
+    REQUIRE(sides[c0] == '1');
+    REQUIRE(sides[c1] == '0');
+    REQUIRE(sides[c2] == '1');
+    REQUIRE(graph.evaluate_cutsize() == fixed["cutsize"]);
+
+    REQUIRE(reply("{ \"command\" : \"cells\" }")["cells"].size() == 
+            netlist.num_cells());
+    REQUIRE(reply("not json").contains("error"));
+    REQUIRE(reply("{ \"fixed\" : { \"c0\" : 2 } }").contains("error"));
+    REQUIRE(reply("{ \"fixed\" : { \"none\" : 0 } }").contains("error"));
+    REQUIRE(reply("{ \"seed\" : \"x\" }").contains("error"));
+
+    // fixing most of the area to one side is refused
+    std::string heavy = "{ \"fixed\" : { ";
+    for (uint32_t c = 0; c < netlist.num_cells()*3/4; ++c) {
+      heavy += std::string(c ? ", " : "") + "\"" + 
+               std::string(netlist.cells[c].name) + "\" : 0";
+    }
+    heavy += " } }";
+    REQUIRE(reply(heavy).contains("error"));
+    REQUIRE(reply("{ \"seed\" : 4 }")["partition"] == first["partition"]);
+  }
+
+  SUBCASE("socket") {
+    daemon.max_line = 256;
+    std::thread server(&PartitionDaemon::run, &daemon);
+
+    auto connect_daemon = [&]() {
+      sockaddr_un address;
+      std::memset(&address, 0, sizeof(address));
+      address.sun_family = AF_UNIX;
+      std::strcpy(address.sun_path, scratch("verify_daemon.sock").c_str());
+      int fd = -1;
+      for (int attempt = 0; attempt < 500; ++attempt) {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address), 
+                    sizeof(address)) == 0) {
+          break;
+        }
+        close(fd);
+        fd = -1;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      return fd;
+    };
+
+    // everything the daemon sends until it closes the connection
+    // or has sent num_lines lines
+    auto receive = [&](int fd, long num_lines) {
+      std::string replies;
+      char chunk[4096];
+      ssize_t size;
+      while (std::count(replies.begin(), replies.end(), '\n') < num_lines &&
+             (size = recv(fd, chunk, sizeof(chunk), 0)) > 0) {
+        replies.append(chunk, size);
+      }
+      return replies;
+    };
+
+    // a line that never ends within max_line is refused, 
+    // and its connection closed
+    int fd = connect_daemon();
+    REQUIRE(fd >= 0);
+    std::string unended(1000, ' ');
+    REQUIRE(send(fd, unended.data(), unended.size(), 0) == 
+            static_cast<ssize_t>(unended.size()));
+    std::string refused = receive(fd, 2);
+    close(fd);
+    REQUIRE(std::count(refused.begin(), refused.end(), '\n') == 1);
+    REQUIRE(nlohmann::json::parse(refused).contains("error"));
+
+    // two requests in one write, answered in order
+    fd = connect_daemon();
+    REQUIRE(fd >= 0);
+    std::string requests = 
+      "{ \"seed\" : 4 }\n{ \"command\" : \"shutdown\" }\n";
+    REQUIRE(send(fd, requests.data(), requests.size(), 0) == 
+            static_cast<ssize_t>(requests.size()));
+
+    std::string replies = receive(fd, 2);
+    close(fd);
+    server.join();
+
+    std::istringstream lines(replies);
+    std::string line;
+    std::getline(lines, line);
+    nlohmann::json partition = nlohmann::json::parse(line);
+    REQUIRE(partition["seed"] == 4);
+    REQUIRE(partition["partition"].get<std::string>().size() == 
+            netlist.num_cells());
+    std::getline(lines, line);
+    REQUIRE(nlohmann::json::parse(line)["shutdown"] == true);
+    REQUIRE(!std::ifstream(scratch("verify_daemon.sock")));
+  }
+
+  SUBCASE("bad socket") {
+    // the daemon reports a socket it cannot set up instead of exiting
+    PartitionDaemon bad(netlist, scratch(std::string(200, 'x')));
+    REQUIRE(!bad.run());
+  }
+}
+
+// verify fixed cells stay put and their dead nets keep the cut exact
+TEST_CASE("verify_fixed" * doctest::timeout(600)) {
+  std::ofstream ofs(scratch("verify_fixed.dat"));
+  ofs << "0.2\n";
+  Random netlist_rng(13);
+  for (int n = 0; n < 600; ++n) {
+    ofs << "NET n" << n;
+    for (uint32_t p = 0, size = 2 + netlist_rng.below(5); p < size; ++p) {
+      ofs << " c" << netlist_rng.below(400);
+    }
+    ofs << " ;\n";
+  }
+  ofs.close();
+
+  // a quarter of the cells, as names and as an hMETIS fix file
+  Hypergraph reference;
+  reference.verbose = false;
+  reference.read_netlist(scratch("verify_fixed.dat"), 
+                         scratch("verify_fixed.out"));
+  std::ofstream names(scratch("verify_fixed.txt"));
+  std::ofstream hmetis(scratch("verify_fixed.fix"));
+  for (uint32_t c = 0; c < reference.num_cells(); ++c) {
+    int side = c % 4 == 0 ? static_cast<int>(c/4 % 2) : -1;
+    if (side >= 0) {
+      names << reference.cells[c].name << ' ' << side << '\n';
+    }
+    hmetis << side << '\n';
+  }
+  names.close();
+  hmetis.close();
+
+  for (const std::string& fixed_file : {scratch("verify_fixed.txt"), 
+                                        scratch("verify_fixed.fix")}) {
+    for (BucketPolicy policy : {BucketPolicy::FIFO, BucketPolicy::CLIP}) {
+      for (bool boundary_only : {false, true}) {
+        Hypergraph hypergraph;
+        hypergraph.verbose = false;
+        hypergraph.policy = policy;
+        hypergraph.rng.seed(2);
+        hypergraph.read_netlist(scratch("verify_fixed.dat"), 
+                                scratch("verify_fixed.out"));
+        hypergraph.read_fixed(fixed_file);
+        hypergraph.initialize();
+
+        // fixed cells are locked and never linked
+        for (uint32_t c = 0; c < hypergraph.num_cells(); ++c) {
+          REQUIRE(hypergraph.is_fixed(c) == (c % 4 == 0));
+          if (hypergraph.is_fixed(c)) {
+            REQUIRE(hypergraph.states[c].partition == c/4 % 2);
+            REQUIRE(hypergraph.states[c].locked);
+          }
+        }
+        for (uint32_t c : hypergraph.bucket) {
+          for (; c != no_cell; c = hypergraph.next[c]) {
+            REQUIRE(!hypergraph.is_fixed(c));
+          }
+        }
+
+        // dead nets have fixed cells in both partitions
+        size_t num_dead = 0;
+        for (size_t i = 0; i < hypergraph.num_nets(); ++i) {
+          const Net& net = hypergraph.nets[i];
+          bool sides[2] = {false, false};
+          for (size_t j = 0; j < net.cells.size(); ++j) {
+            if (hypergraph.is_fixed(net.cells[j])) {
+              sides[hypergraph.fixed[net.cells[j]]] = true;
+            }
+          }
+          REQUIRE(hypergraph.is_dead(&net) == (sides[0] && sides[1]));
+          num_dead += hypergraph.is_dead(&net);
+        }
+        REQUIRE(num_dead > 0);
+
+        hypergraph.run_fm();
+        hypergraph.boundary_only = boundary_only;
+        VCycle vcycle(hypergraph);
+        vcycle.run(1.0);
+
+        for (uint32_t c = 0; c < hypergraph.num_cells(); ++c) {
+          if (hypergraph.is_fixed(c)) {
+            REQUIRE(hypergraph.states[c].partition == c/4 % 2);
+          }
+        }
+        REQUIRE(hypergraph.evaluate_cutsize() == hypergraph.cutsize);
+        REQUIRE(hypergraph.area_lower_bound < hypergraph.area_p0);
+        REQUIRE(hypergraph.area_p0 < hypergraph.area_upper_bound);
+      }
+    }
+  }
+
+  // fix files that do not match the netlist are refused, and leave
+  // the fixed cells read before alone
+  {
+    Hypergraph hypergraph;
+    hypergraph.verbose = false;
+    hypergraph.read_netlist(scratch("verify_fixed.dat"), 
+                            scratch("verify_fixed.out"));
+    hypergraph.read_fixed(scratch("verify_fixed.fix"));
+    std::vector<int8_t> before = hypergraph.fixed;
+
+    std::ofstream shorter(scratch("verify_fixed_short.fix"));
+    std::ofstream longer(scratch("verify_fixed_long.fix"));
+    for (uint32_t c = 0; c < reference.num_cells(); ++c) {
+      shorter << (c+1 < reference.num_cells() ? "-1\n" : "");
+      longer << "-1\n";
+    }
+    longer << "0\n";
+    shorter.close();
+    longer.close();
+
+    std::ofstream unknown(scratch("verify_fixed_unknown.txt"));
+    unknown << reference.cells[0].name << " 1\n" << "nowhere 0\n";
+    unknown.close();
+
+    std::ofstream partial(scratch("verify_fixed_partial.txt"));
+    partial << reference.cells[0].name << " 1\n" 
+            << reference.cells[1].name << '\n';
+    partial.close();
+
+    for (const char* name : {"verify_fixed_short.fix", 
+                             "verify_fixed_long.fix",
+                             "verify_fixed_unknown.txt", 
+                             "verify_fixed_partial.txt"}) {
+      REQUIRE_THROWS_AS(hypergraph.read_fixed(scratch(name)), 
+                        std::runtime_error);
+      REQUIRE(hypergraph.fixed == before);
+    }
+  }
+
+  // three quarters of the area fixed to one side leave no balanced
+  // partition, with a balance factor of 0.2
+  std::ofstream heavy(scratch("verify_fixed_heavy.txt"));
+  for (uint32_t c = 0; c < reference.num_cells()*3/4; ++c) {
+    heavy << reference.cells[c].name << " 0\n";
+  }
+  heavy.close();
+
+  Hypergraph hypergraph;
+  hypergraph.verbose = false;
+  hypergraph.read_netlist(scratch("verify_fixed.dat"), 
+                          scratch("verify_fixed.out"));
+  hypergraph.read_fixed(scratch("verify_fixed_heavy.txt"));
+  REQUIRE_THROWS_AS(hypergraph.initialize(), std::runtime_error);
+}
+
 /*
 // verify the recover
 TEST_CASE("verify_recover" * doctest::timeout(600)) {
   Hypergraph hypergraph(input_file, output_file);
   
-  std::unordered_map<std::string, Cell>::iterator it;
-  for (it = hypergraph.map_cells.begin(); 
-       it != hypergraph.map_cells.end(); ++it) {
-    if (it->second.name == "c1") {
-      it->second.partition = 0;
+  Cell* it;
+  for (it = hypergraph.cells.begin(); 
+       it != hypergraph.cells.end(); ++it) {
+    if (it->name == "c1") {
+      hypergraph.state(it).partition = 0;
     }
-    else if(it->second.name == "c2") {
-      it->second.partition = 0;
+    else if(it->name == "c2") {
+      hypergraph.state(it).partition = 0;
     }
-    else if (it->second.name == "c3") {
-      it->second.partition = 1;
+    else if (it->name == "c3") {
+      hypergraph.state(it).partition = 1;
     }
-    else if (it->second.name == "c4") {
-      it->second.partition = 1;
+    else if (it->name == "c4") {
+      hypergraph.state(it).partition = 1;
     }
-    else if (it->second.name == "c5") {
-      it->second.partition = 1;
+    else if (it->name == "c5") {
+      hypergraph.state(it).partition = 1;
     }
-    it->second.prev = nullptr;
-    it->second.next = nullptr;
+    hypergraph.prev[hypergraph.cell_id(it)] = no_cell;
+    hypergraph.next[hypergraph.cell_id(it)] = no_cell;
   }
   
-  std::unordered_map<std::string, Net>::iterator it1;
-  for (it1 = hypergraph.map_nets.begin(); 
-       it1 != hypergraph.map_nets.end(); ++it1) {
-    it1->second.cut = false;
-    it1->second.cnt_cells_p0 = 0;
-    it1->second.cnt_cells_p1 = 0;
+  Net* it1;
+  for (it1 = hypergraph.nets.begin(); 
+       it1 != hypergraph.nets.end(); ++it1) {
+    it1->cut = false;
+    it1->cnt_cells_p0 = 0;
+    it1->cnt_cells_p1 = 0;
   }
 
   hypergraph.max_gain = -1000000;
@@ -1174,59 +2369,59 @@ TEST_CASE("verify_recover" * doctest::timeout(600)) {
   // recover c1 = move c1 to another partition
   SUBCASE("SUB : recover c1") {
     
-    hypergraph.recover(&(hypergraph.map_cells["c1"]));
+    hypergraph.recover(hypergraph.id("c1"));
     
-    //for (it1 = hypergraph.map_nets.begin();
-    //     it1 != hypergraph.map_nets.end(); ++it1) {
-    //  if (it1->second.name == "n1") {
-    //    REQUIRE(it1->second.cut == true);
+    //for (it1 = hypergraph.nets.begin();
+    //     it1 != hypergraph.nets.end(); ++it1) {
+    //  if (it1->name == "n1") {
+    //    REQUIRE(it1->cut == true);
     //  }
-    //  else if (it1->second.name == "n2") {
-    //    REQUIRE(it1->second.cut == true);
+    //  else if (it1->name == "n2") {
+    //    REQUIRE(it1->cut == true);
     //  }
-    //  else if (it1->second.name == "n3") {
-    //    REQUIRE(it1->second.cut == false);
+    //  else if (it1->name == "n3") {
+    //    REQUIRE(it1->cut == false);
     //  }
-    //  else if (it1->second.name == "n4") {
-    //    REQUIRE(it1->second.cut == false);
+    //  else if (it1->name == "n4") {
+    //    REQUIRE(it1->cut == false);
     //  }
-    //  else if (it1->second.name == "n5") {
-    //    REQUIRE(it1->second.cut == false);
+    //  else if (it1->name == "n5") {
+    //    REQUIRE(it1->cut == false);
     //  }
     //}
   
-    //for (it = hypergraph.map_cells.begin(); 
-    //     it != hypergraph.map_cells.end(); ++it) {
+    //for (it = hypergraph.cells.begin(); 
+    //     it != hypergraph.cells.end(); ++it) {
     //  
-    //  if (it->second.name == "c1") {
-    //    REQUIRE(it->second.gain == -1);
+    //  if (it->name == "c1") {
+    //    REQUIRE(hypergraph.state(it).gain == -1);
     //  }
-    //  else if (it->second.name == "c2") {
-    //    REQUIRE(it->second.gain == 2);
+    //  else if (it->name == "c2") {
+    //    REQUIRE(hypergraph.state(it).gain == 2);
     //  }
-    //  else if (it->second.name == "c3") {
-    //    REQUIRE(it->second.gain == -1);
+    //  else if (it->name == "c3") {
+    //    REQUIRE(hypergraph.state(it).gain == -1);
     //  }
-    //  else if (it->second.name == "c4") {
-    //    REQUIRE(it->second.gain == -2);
+    //  else if (it->name == "c4") {
+    //    REQUIRE(hypergraph.state(it).gain == -2);
     //  }
-    //  else if (it->second.name == "c5") {
-    //    REQUIRE(it->second.gain == -1);
+    //  else if (it->name == "c5") {
+    //    REQUIRE(hypergraph.state(it).gain == -1);
     //  }
     //}
     //for (size_t i = 0; i < hypergraph.bucket.size(); ++i) {
     //  if (i < 3 || i == 5 || i == 6 || i > 7) {
-    //    REQUIRE(hypergraph.bucket[i] == nullptr);
+    //    REQUIRE(hypergraph.bucket[i] == no_cell);
     //  }
     //  else if (i == 3) {
-    //    REQUIRE(hypergraph.bucket[i]->name == "c4");
+    //    REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c4");
     //  }
     //  else if (i == 4) {
-    //    REQUIRE(hypergraph.bucket[i]->name != "c2");
-    //    REQUIRE(hypergraph.bucket[i]->name != "c4");
+    //    REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c2");
+    //    REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c4");
     //  }
     //  else if (i == 7) {
-    //    REQUIRE(hypergraph.bucket[i]->name == "c2");
+    //    REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c2");
     //  }
     //}
 
@@ -1234,247 +2429,247 @@ TEST_CASE("verify_recover" * doctest::timeout(600)) {
   
   // recover c2 = move c2 to another partition
   SUBCASE("SUB : recover c2") {
-    hypergraph.recover(&(hypergraph.map_cells["c2"]));
+    hypergraph.recover(hypergraph.id("c2"));
 
-    for (it1 = hypergraph.map_nets.begin();
-         it1 != hypergraph.map_nets.end(); ++it1) {
-      if (it1->second.name == "n1") {
-        REQUIRE(it1->second.cut == true);
+    for (it1 = hypergraph.nets.begin();
+         it1 != hypergraph.nets.end(); ++it1) {
+      if (it1->name == "n1") {
+        REQUIRE(it1->cut == true);
       }
-      else if (it1->second.name == "n2") {
-        REQUIRE(it1->second.cut == true);
+      else if (it1->name == "n2") {
+        REQUIRE(it1->cut == true);
       }
-      else if (it1->second.name == "n3") {
-        REQUIRE(it1->second.cut == true);
+      else if (it1->name == "n3") {
+        REQUIRE(it1->cut == true);
       }
-      else if (it1->second.name == "n4") {
-        REQUIRE(it1->second.cut == true);
+      else if (it1->name == "n4") {
+        REQUIRE(it1->cut == true);
       }
-      else if (it1->second.name == "n5") {
-        REQUIRE(it1->second.cut == false);
+      else if (it1->name == "n5") {
+        REQUIRE(it1->cut == false);
       }
     }
     
-    for (it = hypergraph.map_cells.begin(); 
-         it != hypergraph.map_cells.end(); ++it) {
-      if (it->second.name == "c1") {
-        REQUIRE(it->second.gain == 4);
+    for (it = hypergraph.cells.begin(); 
+         it != hypergraph.cells.end(); ++it) {
+      if (it->name == "c1") {
+        REQUIRE(hypergraph.state(it).gain == 4);
       }
-      else if (it->second.name == "c2") {
-        REQUIRE(it->second.gain == 1);
+      else if (it->name == "c2") {
+        REQUIRE(hypergraph.state(it).gain == 1);
       }
-      else if (it->second.name == "c3") {
-        REQUIRE(it->second.gain == -1);
+      else if (it->name == "c3") {
+        REQUIRE(hypergraph.state(it).gain == -1);
       }
-      else if (it->second.name == "c4") {
-        REQUIRE(it->second.gain == 0);
+      else if (it->name == "c4") {
+        REQUIRE(hypergraph.state(it).gain == 0);
       }
-      else if (it->second.name == "c5") {
-        REQUIRE(it->second.gain == 1);
+      else if (it->name == "c5") {
+        REQUIRE(hypergraph.state(it).gain == 1);
       }
     }
     
     for (size_t i = 0; i < hypergraph.bucket.size(); ++i) {
       if (i < 4 || i == 7 || i == 8 || i > 9) {
-        REQUIRE(hypergraph.bucket[i] == nullptr);
+        REQUIRE(hypergraph.bucket[i] == no_cell);
       }
       else if (i == 4) {
-        REQUIRE(hypergraph.bucket[i]->name == "c3");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c3");
       }
       else if (i == 5) {
-        REQUIRE(hypergraph.bucket[i]->name == "c4");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c4");
       }
       else if (i == 6) {
-        REQUIRE(hypergraph.bucket[i]->name != "c1");
-        REQUIRE(hypergraph.bucket[i]->name != "c3");
-        REQUIRE(hypergraph.bucket[i]->name != "c4");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c1");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c3");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c4");
       }
       else if (i == 9) {
-        REQUIRE(hypergraph.bucket[i]->name == "c1");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c1");
       }
     }
   }
   
   // recover c3 = move c3 to another partition
   SUBCASE("SUB : recover c3") {
-    hypergraph.recover(&(hypergraph.map_cells["c3"]));
+    hypergraph.recover(hypergraph.id("c3"));
 
-    for (it1 = hypergraph.map_nets.begin();
-         it1 != hypergraph.map_nets.end(); ++it1) {
-      if (it1->second.name == "n1") {
-        REQUIRE(it1->second.cut == false);
+    for (it1 = hypergraph.nets.begin();
+         it1 != hypergraph.nets.end(); ++it1) {
+      if (it1->name == "n1") {
+        REQUIRE(it1->cut == false);
       }
-      else if (it1->second.name == "n2") {
-        REQUIRE(it1->second.cut == false);
+      else if (it1->name == "n2") {
+        REQUIRE(it1->cut == false);
       }
-      else if (it1->second.name == "n3") {
-        REQUIRE(it1->second.cut == true);
+      else if (it1->name == "n3") {
+        REQUIRE(it1->cut == true);
       }
-      else if (it1->second.name == "n4") {
-        REQUIRE(it1->second.cut == true);
+      else if (it1->name == "n4") {
+        REQUIRE(it1->cut == true);
       }
-      else if (it1->second.name == "n5") {
-        REQUIRE(it1->second.cut == true);
+      else if (it1->name == "n5") {
+        REQUIRE(it1->cut == true);
       }
     }
     
-    for (it = hypergraph.map_cells.begin(); 
-         it != hypergraph.map_cells.end(); ++it) {
-      if (it->second.name == "c1") {
-        REQUIRE(it->second.gain == 0);
+    for (it = hypergraph.cells.begin(); 
+         it != hypergraph.cells.end(); ++it) {
+      if (it->name == "c1") {
+        REQUIRE(hypergraph.state(it).gain == 0);
       }
-      else if (it->second.name == "c2") {
-        REQUIRE(it->second.gain == -2);
+      else if (it->name == "c2") {
+        REQUIRE(hypergraph.state(it).gain == -2);
       }
-      else if (it->second.name == "c3") {
-        REQUIRE(it->second.gain == 0);
+      else if (it->name == "c3") {
+        REQUIRE(hypergraph.state(it).gain == 0);
       }
-      else if (it->second.name == "c4") {
-        REQUIRE(it->second.gain == 2);
+      else if (it->name == "c4") {
+        REQUIRE(hypergraph.state(it).gain == 2);
       }
-      else if (it->second.name == "c5") {
-        REQUIRE(it->second.gain == 1);
+      else if (it->name == "c5") {
+        REQUIRE(hypergraph.state(it).gain == 1);
       }
     }
     
     for (size_t i = 0; i < hypergraph.bucket.size(); ++i) {
       if (i < 3 || i == 4 || i > 7) {
-        REQUIRE(hypergraph.bucket[i] == nullptr);
+        REQUIRE(hypergraph.bucket[i] == no_cell);
       }
       else if (i == 3) {
-        REQUIRE(hypergraph.bucket[i]->name == "c2");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c2");
       }
       else if (i == 5) {
-        REQUIRE(hypergraph.bucket[i]->name != "c2");
-        REQUIRE(hypergraph.bucket[i]->name != "c4");
-        REQUIRE(hypergraph.bucket[i]->name != "c5");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c2");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c4");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c5");
       }
       else if (i == 6) {
-        REQUIRE(hypergraph.bucket[i]->name == "c5");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c5");
       }
       else if (i == 7) {
-        REQUIRE(hypergraph.bucket[i]->name == "c4");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c4");
       }
     }
   }
   
   // recover c4 = move c4 to another partition
   SUBCASE("SUB : recover c4") {
-    hypergraph.recover(&(hypergraph.map_cells["c4"]));
+    hypergraph.recover(hypergraph.id("c4"));
 
-    for (it1 = hypergraph.map_nets.begin();
-         it1 != hypergraph.map_nets.end(); ++it1) {
-      if (it1->second.name == "n1") {
-        REQUIRE(it1->second.cut == false);
+    for (it1 = hypergraph.nets.begin();
+         it1 != hypergraph.nets.end(); ++it1) {
+      if (it1->name == "n1") {
+        REQUIRE(it1->cut == false);
       }
-      else if (it1->second.name == "n2") {
-        REQUIRE(it1->second.cut == true);
+      else if (it1->name == "n2") {
+        REQUIRE(it1->cut == true);
       }
-      else if (it1->second.name == "n3") {
-        REQUIRE(it1->second.cut == false);
+      else if (it1->name == "n3") {
+        REQUIRE(it1->cut == false);
       }
-      else if (it1->second.name == "n4") {
-        REQUIRE(it1->second.cut == true);
+      else if (it1->name == "n4") {
+        REQUIRE(it1->cut == true);
       }
-      else if (it1->second.name == "n5") {
-        REQUIRE(it1->second.cut == true);
+      else if (it1->name == "n5") {
+        REQUIRE(it1->cut == true);
       }
     }
     
-    for (it = hypergraph.map_cells.begin(); 
-         it != hypergraph.map_cells.end(); ++it) {
-      if (it->second.name == "c1") {
-        REQUIRE(it->second.gain == -1);
+    for (it = hypergraph.cells.begin(); 
+         it != hypergraph.cells.end(); ++it) {
+      if (it->name == "c1") {
+        REQUIRE(hypergraph.state(it).gain == -1);
       }
-      else if (it->second.name == "c2") {
-        REQUIRE(it->second.gain == -1);
+      else if (it->name == "c2") {
+        REQUIRE(hypergraph.state(it).gain == -1);
       }
-      else if (it->second.name == "c3") {
-        REQUIRE(it->second.gain == 2);
+      else if (it->name == "c3") {
+        REQUIRE(hypergraph.state(it).gain == 2);
       }
-      else if (it->second.name == "c4") {
-        REQUIRE(it->second.gain == 0);
+      else if (it->name == "c4") {
+        REQUIRE(hypergraph.state(it).gain == 0);
       }
-      else if (it->second.name == "c5") {
-        REQUIRE(it->second.gain == 1);
+      else if (it->name == "c5") {
+        REQUIRE(hypergraph.state(it).gain == 1);
       }
     }
     
     for (size_t i = 0; i < hypergraph.bucket.size(); ++i) {
       if (i < 4 || i > 7) {
-        REQUIRE(hypergraph.bucket[i] == nullptr);
+        REQUIRE(hypergraph.bucket[i] == no_cell);
       }
       else if (i == 4) {
-        REQUIRE(hypergraph.bucket[i]->name != "c3");
-        REQUIRE(hypergraph.bucket[i]->name != "c4");
-        REQUIRE(hypergraph.bucket[i]->name != "c5");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c3");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c4");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c5");
       }
       else if (i == 5) {
-        REQUIRE(hypergraph.bucket[i]->name == "c4");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c4");
       }
       else if (i == 6) {
-        REQUIRE(hypergraph.bucket[i]->name == "c5");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c5");
       }
       else if (i == 7) {
-        REQUIRE(hypergraph.bucket[i]->name == "c3");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name == "c3");
       }
     }
   }
   
   // recover c5 = move c5 to another partition
   SUBCASE("SUB : recover c5") {
-    hypergraph.recover(&(hypergraph.map_cells["c5"]));
+    hypergraph.recover(hypergraph.id("c5"));
     
-    for (it1 = hypergraph.map_nets.begin();
-         it1 != hypergraph.map_nets.end(); ++it1) {
-      if (it1->second.name == "n1") {
-        REQUIRE(it1->second.cut == false);
+    for (it1 = hypergraph.nets.begin();
+         it1 != hypergraph.nets.end(); ++it1) {
+      if (it1->name == "n1") {
+        REQUIRE(it1->cut == false);
       }
-      else if (it1->second.name == "n2") {
-        REQUIRE(it1->second.cut == true);
+      else if (it1->name == "n2") {
+        REQUIRE(it1->cut == true);
       }
-      else if (it1->second.name == "n3") {
-        REQUIRE(it1->second.cut == true);
+      else if (it1->name == "n3") {
+        REQUIRE(it1->cut == true);
       }
-      else if (it1->second.name == "n4") {
-        REQUIRE(it1->second.cut == false);
+      else if (it1->name == "n4") {
+        REQUIRE(it1->cut == false);
       }
-      else if (it1->second.name == "n5") {
-        REQUIRE(it1->second.cut == false);
+      else if (it1->name == "n5") {
+        REQUIRE(it1->cut == false);
       }
     }
     
-    for (it = hypergraph.map_cells.begin(); 
-         it != hypergraph.map_cells.end(); ++it) {
-      if (it->second.name == "c1") {
-        REQUIRE(it->second.gain == -1);
+    for (it = hypergraph.cells.begin(); 
+         it != hypergraph.cells.end(); ++it) {
+      if (it->name == "c1") {
+        REQUIRE(hypergraph.state(it).gain == -1);
       }
-      else if (it->second.name == "c2") {
-        REQUIRE(it->second.gain == -1);
+      else if (it->name == "c2") {
+        REQUIRE(hypergraph.state(it).gain == -1);
       }
-      else if (it->second.name == "c3") {
-        REQUIRE(it->second.gain == 0);
+      else if (it->name == "c3") {
+        REQUIRE(hypergraph.state(it).gain == 0);
       }
-      else if (it->second.name == "c4") {
-        REQUIRE(it->second.gain == 0);
+      else if (it->name == "c4") {
+        REQUIRE(hypergraph.state(it).gain == 0);
       }
-      else if (it->second.name == "c5") {
-        REQUIRE(it->second.gain == -1);
+      else if (it->name == "c5") {
+        REQUIRE(hypergraph.state(it).gain == -1);
       }
     }
     
     for (size_t i = 0; i < hypergraph.bucket.size(); ++i) {
       if (i < 4 || i > 5) {
-        REQUIRE(hypergraph.bucket[i] == nullptr);
+        REQUIRE(hypergraph.bucket[i] == no_cell);
       }
       else if (i == 4) {
-        REQUIRE(hypergraph.bucket[i]->name != "c3");
-        REQUIRE(hypergraph.bucket[i]->name != "c4");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c3");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c4");
       }
       else if (i == 5) {
-        REQUIRE(hypergraph.bucket[i]->name != "c1");
-        REQUIRE(hypergraph.bucket[i]->name != "c2");
-        REQUIRE(hypergraph.bucket[i]->name != "c5");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c1");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c2");
+        REQUIRE(hypergraph.cells[hypergraph.bucket[i]].name != "c5");
       }
     }
   }
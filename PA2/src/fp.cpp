@@ -1,23 +1,115 @@
 #include <iostream>
 #include "sp.hpp"
+#include "tempering.hpp"
+#include "speculative.hpp"
 #include <string>
+#include <vector>
 #include <cstdlib>
 
 
 int main(int argc, char** argv) {
 
-  if (argc != 5) {
+  // split the options from the positional arguments
+  std::vector<std::string> args;
+  fp::PackEngine pack_engine = fp::PackEngine::LCS;
+  bool incremental = true;
+  bool adaptive = true;
+  size_t num_replicas = 0;
+  size_t num_threads = 0;
+  size_t num_speculative = 0;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg(argv[i]);
+    if (arg == "--pack" && i+1 < argc) {
+      std::string name(argv[++i]);
+      if (name == "spfa") {
+        pack_engine = fp::PackEngine::SPFA;
+      }
+      else if (name == "dag") {
+        pack_engine = fp::PackEngine::DAG;
+      }
+      else if (name == "lcs") {
+        pack_engine = fp::PackEngine::LCS;
+      }
+      else {
+        std::cerr << "Unknown pack engine " << name << '\n';
+        exit(-1);
+      }
+    }
+    else if (arg == "--full") {
+      incremental = false;
+    }
+    else if (arg == "--fixed") {
+      adaptive = false;
+    }
+    else if (arg == "--replicas" && i+1 < argc) {
+      num_replicas = std::atoi(argv[++i]);
+    }
+    else if (arg == "--threads" && i+1 < argc) {
+      num_threads = std::atoi(argv[++i]);
+    }
+    else if (arg == "--speculate" && i+1 < argc) {
+      num_speculative = std::atoi(argv[++i]);
+    }
+    else {
+      args.emplace_back(arg);
+    }
+  }
+
+  if (args.size() != 4) {
     std::cerr << "Wrong commands\n";
+    std::cerr << "./fp alpha input_block input_nets output [options]\n";
+    std::cerr << "  --pack spfa|dag|lcs : longest path engine of pack, "
+              << "spfa and dag with --full only\n";
+    std::cerr << "  --full : pack every move from scratch with that engine\n";
+    std::cerr << "  --fixed : cool from 1000 to 0.1 by 0.95, 3000 moves each\n";
+    std::cerr << "  --replicas n : parallel tempering with n replicas\n";
+    std::cerr << "  --threads n : threads of the replicas, one per core\n";
+    std::cerr << "  --speculate n : evaluate n moves of one chain at once\n";
+    exit(-1);
+  }
+
+  // the incremental re-pack has its own engine, spfa and dag would only
+  // pack the first floorplan, after building graphs of O(n^2) edges
+  if (incremental && pack_engine != fp::PackEngine::LCS) {
+    std::cerr << "--pack spfa and --pack dag need --full\n";
     exit(-1);
   }
 
-  double alpha = std::atof(argv[1]);
-  std::string input_block_path(argv[2]);
-  std::string input_net_path(argv[3]);
-  std::string output_path(argv[4]);
+  double alpha = std::atof(args[0].c_str());
+  std::string input_block_path(args[1]);
+  std::string input_net_path(args[2]);
+  std::string output_path(args[3]);
 
   fp::SP sp(alpha, input_block_path, input_net_path, output_path);
-  sp.run();
+  sp.pack_engine = pack_engine;
+  sp.incremental = incremental;
+  sp.adaptive = adaptive;
+
+  if (num_replicas > 0) {
+    fp::ParallelTempering tempering(alpha, input_block_path, input_net_path);
+    tempering.num_replicas = num_replicas;
+    if (num_threads > 0) {
+      tempering.num_threads = num_threads;
+    }
+    if (!tempering.run(sp)) {
+      std::cerr << "No legal floorplan found\n";
+      exit(1);
+    }
+    std::cerr << "  " << tempering.num_rounds << " rounds, "
+              << tempering.num_exchanges << " exchanges, legal after "
+              << tempering.seconds_to_legal << " s\n";
+  }
+  else if (num_speculative > 1) {
+    fp::SpeculativeAnnealer annealer(sp, input_block_path, input_net_path);
+    annealer.num_threads = num_speculative;
+    annealer.run();
+    std::cerr << "  " << annealer.num_batches << " batches, "
+              << annealer.num_wasted << " candidates thrown away\n";
+  }
+  else {
+    sp.run();
+  }
+  sp.visualize();
   sp.dump_solution();
   return 0;
 }
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <vector>
-#include <variant>
 #include <fstream>
 #include <regex>
 #include <unordered_map>
@@ -10,8 +9,18 @@
 #include <ctime>
 #include <deque>
 #include <climits>
+#include <cfloat>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
 #include <random>
 #include <set>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <utility>
 
 
 namespace fp {
@@ -19,37 +28,16 @@ namespace fp {
 
 
 // random generator
-static std::minstd_rand engine{std::random_device{}()};
-static std::uniform_int_distribution<size_t> distribution;
+// one per thread, so that replicas annealing on different threads
+// do not share it
+static thread_local std::minstd_rand engine{std::random_device{}()};
+static thread_local std::uniform_int_distribution<size_t> distribution;
 static size_t max_dist = distribution.max();
 static size_t random_value() {
   return distribution(engine);
 }
 
 
-class Block {
-public:
-  size_t lower_left_x = 0;
-  size_t lower_left_y = 0;
-  size_t backup_lower_left_x = 0;
-  size_t backup_lower_left_y = 0;
-  size_t width = 0;
-  size_t height = 0;
-  size_t backup_width = 0;
-  size_t backup_height = 0;
-  std::string name;
-
-  std::vector<Block*> rightof;
-  std::vector<Block*> aboveof;
-  std::vector<Block*> backup_rightof;
-  std::vector<Block*> backup_aboveof;
-
-  int idx_positive_sequence = -1;
-  int idx_negative_sequence = -1;
-  int backup_idx_positive_sequence = -1;
-  int backup_idx_negative_sequence = -1;
-};
-
 class Terminal {
 public:
   size_t pos_x = 0;
@@ -57,11 +45,6 @@ public:
   std::string name;
 };
 
-class Net {
-public:
-  std::vector<std::variant<Block*, Terminal*>> net; 
-};
-
 
 enum Sequence {
   POS = 0,
@@ -75,6 +58,14 @@ enum Orientation {
 };
 
 
+// how pack computes the longest paths of the constraint graphs
+enum PackEngine {
+  SPFA = 0,
+  DAG,
+  LCS
+};
+
+
 enum MoveType {
   nomove = 0,
   move1,
@@ -84,17 +75,99 @@ enum MoveType {
 };
 
 
+// a move and the positions it swapped, those of the rotated block
+// for move4, as move1 to move4 return them
+class Move {
+public:
+  MoveType type = MoveType::nomove;
+  size_t id1 = 0;
+  size_t id2 = 0;
+};
+
+
+// what the moves since the floorplan was last backed up changed, in
+// order, so that resume_backup_data can put it back: the corners pack
+// and repack overwrote with their old values, the rightof/aboveof 
+// construct_relative_locations rebuilt, the net boxes that changed, 
+// and the backed up bounding box, hpwl and excess lengths
+//
+// a sweep over every net saves net_boxes as a whole instead, once,
+// after the first num_net_boxes entries of net_boxes
+//
+// the first num_relations entries of relations are in use, the rest
+// keep the vectors of earlier moves so that rebuilding one reuses them
+class UndoLog {
+public:
+  std::vector<std::pair<size_t*, size_t>> corners;
+  std::vector<std::tuple<size_t, std::vector<size_t>, std::vector<size_t>>> relations;
+  size_t num_relations = 0;
+  std::vector<std::pair<size_t, std::array<int, 4>>> net_boxes;
+  std::vector<std::array<int, 4>> all_net_boxes;
+  bool saved_all_net_boxes = false;
+  size_t num_net_boxes = 0;
+
+  int bb_width = 0;
+  int bb_height = 0;
+  int hpwl = 0;
+  int wirelength = 0;
+  int excess_width = 0;
+  int excess_height = 0;
+};
+
+
 class SP {
 public:
 
-  std::unordered_map<std::string, Block> map_blocks;
+  // blocks have the ids 0 to num_blocks-1 in the order of the input,
+  // and the arrays below hold their fields by id; map_blocks and
+  // names are only for reading and writing files
+  std::unordered_map<std::string, size_t> map_blocks;
+  std::vector<std::string> names;
+
+  std::vector<size_t> lower_left_x;
+  std::vector<size_t> lower_left_y;
+  std::vector<size_t> width;
+  std::vector<size_t> height;
+
+  std::vector<int> idx_positive_sequence;
+  std::vector<int> idx_negative_sequence;
+
   std::unordered_map<std::string, Terminal> map_terminals;
-  std::vector<Net> vec_nets;
 
-  std::vector<Block*> positive_sequence;
-  std::vector<Block*> negative_sequence;
-  std::vector<Block*> backup_positive_sequence;
-  std::vector<Block*> backup_negative_sequence;
+  // the block pins of net n are net_pins[net_offset[n]..net_offset[n+1]),
+  // and its terminals, which never move, are reduced into the box
+  // terminal_boxes[n], as net_boxes
+  std::vector<size_t> net_pins;
+  std::vector<size_t> net_offset = {0};
+  std::vector<std::array<int, 4>> terminal_boxes;
+
+  // compute_net_boxes reduces the boxes of net_lanes nets at once, one
+  // net per lane: group g stores its pins pin by pin, net_lanes at a time,
+  // in lane_pins[lane_offset[g]..lane_offset[g+1]), its nets in
+  // lane_nets and their terminal boxes as four rows of lane_boxes; the
+  // nets of a group have about the same number of pins, the short ones
+  // and the empty lanes repeat a pin or a net, see build_net_lanes
+  static constexpr size_t net_lanes = 8;
+  std::vector<size_t> lane_offset = {0};
+  std::vector<uint32_t> lane_pins;
+  std::vector<size_t> lane_nets;
+  std::vector<int> lane_boxes;
+  std::vector<int> center_x;
+  std::vector<int> center_y;
+
+  // the nets of every block, by id
+  std::vector<std::vector<size_t>> block_nets;
+
+  // bounding box of the pin centers of every net, as {min_x, max_x,
+  // min_y, max_y} in doubled coordinates, and the sum of their half
+  // perimeters, which is twice hpwl; pack computes them for every net,
+  // repack only for the nets of the blocks it moved
+  std::vector<std::array<int, 4>> net_boxes;
+  int wirelength = 0;
+
+  // block ids in sequence order
+  std::vector<size_t> positive_sequence;
+  std::vector<size_t> negative_sequence;
 
   size_t outline_width;
   size_t outline_height;
@@ -104,26 +177,91 @@ public:
   
   double alpha = 0;
 
-  // parameters for Simulated Annealing
+  // parameters for Simulated Annealing, the fixed schedule cools from
+  // initial_temperature by decay until frozen_temperature
   const double initial_temperature = 1000.0;
 
-  const double frozen_temperature = 0.1;
+  double frozen_temperature = 0.1;
 
   const double decay = 0.95; 
     
   const size_t iterations_per_temperature = 3000;
+
+  // the adaptive schedule instead starts where an average uphill move of
+  // num_samples sampled ones is accepted with initial_acceptance, runs
+  // moves_per_block moves per block at every temperature, and moves
+  // its decay by decay_step between min_decay and max_decay, faster while
+  // more moves than target_acceptance are accepted; once fewer than
+  // stop_acceptance are, it stops after num_stable_temperatures
+  // temperatures that did not lower schedule_cost by min_improvement,
+  // see next_temperature
+  bool adaptive = true;
+  size_t num_samples = 200;
+  double initial_acceptance = 0.9;
+  size_t moves_per_block = 30;
+  double target_acceptance = 0.44;
+  double min_decay = 0.8;
+  double max_decay = 0.95;
+  double decay_step = 0.02;
+  double stop_acceptance = 0.05;
+  size_t num_stable_temperatures = 20;
+  double min_improvement = 1e-3;
+
+  // decay and moves per temperature of the schedule start_schedule 
+  // set up, the fixed ones or those the adaptive schedule picks
+  double schedule_decay = 0.95;
+  size_t schedule_iterations = 3000;
+
+  // average_area and average_length when start_schedule ran, which
+  // schedule_cost normalises by
+  double schedule_area = 1.0;
+  double schedule_length = 1.0;
+
+  // the lowest schedule_cost at the end of a temperature, and how many
+  // temperatures since it was set
+  double lowest_cost = DBL_MAX;
+  size_t num_stable = 0;
  
-  // source and terminus blocks for horizontal/vertical constraint graph
-  Block source;
-  Block terminus;
+  // constraint graphs of SPFA and DAG by id, the source and terminus
+  // blocks follow the blocks, their ids and names are set in
+  // initialize_sequence
+  std::vector<std::vector<size_t>> rightof;
+  std::vector<std::vector<size_t>> aboveof;
+  size_t source = 0;
+  size_t terminus = 1;
+
+  // rightof (index Horizontal) and aboveof (index Vertical) again as
+  // flat rows of graph_stride edges by block id, of which the first
+  // graph_degree are in use; construct_relative_locations and undo
+  // rewrite the rows whose lists they change, see update_graph_row;
+  // only DAG reads them, so they are left empty (graph_stride 0)
+  // unless start or a test calls initialize_graph_rows
+  size_t graph_stride = 0;
+  std::vector<size_t> graph_edges[2];
+  std::vector<size_t> graph_degree[2];
  
-  // bounding box width and height and its backups
+  // bounding box width and height
   int bb_width = 0;
   int bb_height = 0;
   int hpwl = 0;
-  int backup_bb_width = 0;
-  int backup_bb_height = 0; 
-  int backup_hpwl = 0;
+
+  // changes since the last backup
+  UndoLog undo_log;
+
+  // cost of the backed up floorplan
+  double backup_cost = 0.0;
+
+  // moves kept so far
+  size_t num_accepted = 0;
+
+  // the best legal floorplan anneal has accepted, if keep_best is set,
+  // with the corners and sizes of the blocks by id
+  bool keep_best = false;
+  double best_cost = DBL_MAX;
+  int best_bb_width = 0;
+  int best_bb_height = 0;
+  int best_hpwl = 0;
+  std::vector<std::array<size_t, 4>> best_locations;
 
   double average_area = 0.0;
   double average_length = 0.0;
@@ -131,7 +269,30 @@ public:
 
   int overshoot_length = 0;
 
+  // total length the blocks stick out of the outline width and height,
+  // overshoot_length is penalty_ratio times their sum
+  int excess_width = 0;
+  int excess_height = 0;
+
   int penalty_ratio = 2;
+
+  // LCS packs without the rightof/aboveof graphs,
+  // so run only builds them for SPFA and DAG; with incremental the
+  // engine only packs the first floorplan, so SPFA and DAG are meant
+  // for incremental off
+  PackEngine pack_engine = PackEngine::LCS;
+
+  // run re-packs only the blocks a move can shift, see repack
+  bool incremental = true;
+
+  // fenwick tree of repack
+  std::vector<int> lcs_tree;
+
+  // blocks repack moved since the last update_net_boxes, which marks
+  // the nets it visits with its number
+  std::vector<size_t> changed_blocks;
+  std::vector<size_t> net_visits;
+  size_t num_net_updates = 0;
  
   std::string output_path;
   
@@ -141,10 +302,14 @@ public:
 
   void dump(std::ostream&) const;
 
-  void dump_backup(std::ostream&) const;
-
   void visualize() const;
 
+  size_t add_block(const std::string&, const size_t, const size_t);
+
+  void add_net(const std::vector<std::string>&);
+
+  void build_net_lanes();
+
   void initialize_sequence();
 
   std::pair<size_t, size_t> move1();
@@ -157,11 +322,57 @@ public:
 
   void run();
 
+  void start();
+
+  double start_schedule();
+
+  bool next_temperature(double&, const double);
+
+  double schedule_cost() const;
+
+  void anneal(const double, const size_t);
+
+  Move propose();
+
+  void apply_move(const Move&);
+
+  double try_move(const Move&);
+
+  bool accept(const double, const double) const;
+
+  void keep(const Move&, const double);
+
+  void undo(const Move&);
+
+  bool fits_outline() const;
+
+  double final_cost() const;
+
+  void save_best();
+
+  void load_best(const SP&);
+
   double pack();
 
+  double repack(const size_t, const size_t, const MoveType);
+
+  void relocate(const size_t, const size_t, const MoveType, const Orientation);
+
+  double evaluate();
+
   void construct_relative_locations(const size_t, const size_t, const MoveType);
   
   std::vector<int> spfa(const Orientation);
+
+  std::vector<int> weighted_lcs(const Orientation);
+
+  std::vector<int> dag_longest_path(const Orientation);
+
+  void initialize_graph_rows();
+
+  void update_graph_row(const size_t);
+
+  size_t node_index(const size_t) const;
   
   void compute_block_locations(std::vector<int>&, const Orientation);
 
@@ -169,6 +380,14 @@ public:
 
   int compute_hpwl() const;
 
+  std::array<int, 4> net_box(const size_t) const;
+
+  void update_net_box(const size_t);
+
+  void update_net_boxes();
+
+  void compute_net_boxes();
+
   void initialize_backup_data();
 
   void update_backup_data(const size_t, const size_t, const MoveType);
@@ -184,9 +403,6 @@ inline SP::SP(double a, const std::string& input_block_path,
               const std::string& out_path) {
 
   output_path = out_path;
-  source.name = "source";
-  terminus.name = "terminus";
-
   alpha = a;
    
   std::ifstream inBlkFile(input_block_path, std::ios::in);
@@ -237,11 +453,10 @@ inline SP::SP(double a, const std::string& input_block_path,
     
     // dimensions of blocks
     if (num_lines < num_blocks) {
-      Block blk;
-      blk.name = *(it);
-      blk.width = std::stoi(*(++it));
-      blk.height = std::stoi(*(++it));
-      map_blocks[blk.name] = blk;
+      std::string name = *(it);
+      size_t w = std::stoi(*(++it));
+      size_t h = std::stoi(*(++it));
+      add_block(name, w, h);
       ++num_lines;
     }
 
@@ -272,21 +487,13 @@ inline SP::SP(double a, const std::string& input_block_path,
     it = std::sregex_token_iterator(line.begin(), line.end(), reg, -1);
     netdegree = std::stoi(*(++it));
     
-    Net n;
+    std::vector<std::string> pins;
     for (size_t i = 0; i < netdegree; ++i) {
-      std::variant<Block*, Terminal*> var;
       std::getline(inNetFile, line);
       it = std::sregex_token_iterator(line.begin(), line.end(), reg, -1);
-      
-      if (map_blocks.find(*it) != map_blocks.end()) {
-        var = &(map_blocks[*it]);
-      }
-      else {
-        var = &(map_terminals[*it]);
-      }
-      n.net.emplace_back(var);
+      pins.emplace_back(*it);
     }
-    vec_nets.emplace_back(n);
+    add_net(pins);
   }
   // end of parsing
   
@@ -295,26 +502,144 @@ inline SP::SP(double a, const std::string& input_block_path,
 }
 
 
+// add a block of the size and return its id
+inline size_t SP::add_block(const std::string& name, const size_t w,
+  const size_t h) {
+
+  size_t id = names.size();
+  map_blocks[name] = id;
+  names.push_back(name);
+  lower_left_x.push_back(0);
+  lower_left_y.push_back(0);
+  width.push_back(w);
+  height.push_back(h);
+  idx_positive_sequence.push_back(-1);
+  idx_negative_sequence.push_back(-1);
+  block_nets.emplace_back();
+  return id;
+}
+
+
+// add a net of the named pins, a name that is no block is a terminal,
+// with an empty box, the lanes are built again by the next sweep
+inline void SP::add_net(const std::vector<std::string>& pins) {
+  size_t n = terminal_boxes.size();
+  std::array<int, 4> box = {INT_MAX, 0, INT_MAX, 0};
+
+  for (auto& pin : pins) {
+    auto it = map_blocks.find(pin);
+    if (it != map_blocks.end()) {
+      size_t blk = it->second;
+      net_pins.push_back(blk);
+      if (block_nets[blk].empty() || block_nets[blk].back() != n) {
+        block_nets[blk].push_back(n);
+      }
+    }
+    else {
+      const Terminal& terminal = map_terminals[pin];
+      int x = 2*terminal.pos_x;
+      int y = 2*terminal.pos_y;
+      box = {std::min(box[0], x), std::max(box[1], x),
+             std::min(box[2], y), std::max(box[3], y)};
+    }
+  }
+
+  net_offset.push_back(net_pins.size());
+  terminal_boxes.push_back(box);
+  net_boxes.push_back({0, 0, 0, 0});
+  net_visits.push_back(0);
+  lane_nets.clear();
+}
+
+
+// group the nets by their number of block pins into the lanes of
+// compute_net_boxes, the nets without block pins apart
+inline void SP::build_net_lanes() {
+  auto degree = [this](const size_t n) {
+    return net_offset[n+1]-net_offset[n];
+  };
+
+  std::vector<size_t> order(terminal_boxes.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return degree(a) < degree(b);
+  });
+  size_t num_empty = 0;
+  while (num_empty < order.size() && degree(order[num_empty]) == 0) {
+    ++num_empty;
+  }
+
+  lane_offset.assign(1, 0);
+  lane_pins.clear();
+  lane_nets.clear();
+  lane_boxes.clear();
+  for (size_t first = 0; first < order.size(); ) {
+    size_t last = std::min(first+net_lanes,
+                           first < num_empty ? num_empty : order.size());
+    size_t num_pins = degree(order[last-1]);
+
+    for (size_t k = 0; k < net_lanes; ++k) {
+      lane_nets.push_back(order[std::min(first+k, last-1)]);
+    }
+    const size_t* nets = &lane_nets[lane_nets.size()-net_lanes];
+
+    // a repeated pin leaves the box as is
+    for (size_t p = 0; p < num_pins; ++p) {
+      for (size_t k = 0; k < net_lanes; ++k) {
+        size_t n = nets[k];
+        lane_pins.push_back(net_pins[net_offset[n] + 
+                                     std::min(p, degree(n)-1)]);
+      }
+    }
+    lane_offset.push_back(lane_pins.size());
+
+    for (size_t i = 0; i < 4; ++i) {
+      for (size_t k = 0; k < net_lanes; ++k) {
+        lane_boxes.push_back(terminal_boxes[nets[k]][i]);
+      }
+    }
+    first = last;
+  }
+
+  center_x.resize(num_blocks);
+  center_y.resize(num_blocks);
+}
+
+
 // initialize positive and negative sequences
 inline void SP::initialize_sequence() {
-  positive_sequence.resize(num_blocks); 
-  negative_sequence.resize(num_blocks);
+  positive_sequence.assign(num_blocks, num_blocks); 
+  negative_sequence.assign(num_blocks, num_blocks);
+
+  source = num_blocks;
+  terminus = num_blocks+1;
+  names.resize(num_blocks);
+  names.push_back("source");
+  names.push_back("terminus");
+  rightof.resize(num_blocks+2);
+  aboveof.resize(num_blocks+2);
+
+  graph_stride = 0;
+  for (auto orientation : {Orientation::Horizontal, Orientation::Vertical}) {
+    graph_edges[orientation].clear();
+    graph_degree[orientation].clear();
+  }
   
   size_t idx = random_value()%num_blocks;
 
-  for (auto& [key, value] : map_blocks) {
-    while (positive_sequence[idx] != nullptr) {
+  for (size_t blk = 0; blk < num_blocks; ++blk) {
+    while (positive_sequence[idx] != num_blocks) {
       idx = random_value()%num_blocks;
     }
-    positive_sequence[idx] = &(map_blocks[key]);
-    map_blocks[key].idx_positive_sequence = idx;
+    positive_sequence[idx] = blk;
+    idx_positive_sequence[blk] = idx;
 
     idx = random_value()%num_blocks;
-    while (negative_sequence[idx] != nullptr) {
+    while (negative_sequence[idx] != num_blocks) {
       idx = random_value()%num_blocks;
     }
-    negative_sequence[idx] = &(map_blocks[key]);
-    map_blocks[key].idx_negative_sequence = idx;
+    negative_sequence[idx] = blk;
+    idx_negative_sequence[blk] = idx;
   }
 }
 
@@ -323,7 +648,7 @@ inline void SP::initialize_sequence() {
 inline void SP::construct_relative_locations(
   const size_t id1, const size_t id2, const MoveType move_type) {
   
-  std::set<Block*> affected;
+  std::set<size_t> affected;
 
   switch(move_type) {
     // nomove or move1
@@ -343,8 +668,8 @@ inline void SP::construct_relative_locations(
     case 3:
       {
         size_t nid1, nid2;
-        nid1 = positive_sequence[id1]->idx_negative_sequence;
-        nid2 = positive_sequence[id2]->idx_negative_sequence;
+        nid1 = idx_negative_sequence[positive_sequence[id1]];
+        nid2 = idx_negative_sequence[positive_sequence[id2]];
 
         for (size_t i = id1; i <= id2; ++i) {
           affected.insert(positive_sequence[i]);
@@ -368,54 +693,104 @@ inline void SP::construct_relative_locations(
   int pidx, nidx;
   // construct rightof vector
   for (auto& blk : affected) {
-    blk->rightof.clear();
+    if (undo_log.num_relations == undo_log.relations.size()) {
+      undo_log.relations.emplace_back();
+    }
+    auto& [logged, old_rightof, old_aboveof] = 
+      undo_log.relations[undo_log.num_relations++];
+    logged = blk;
+    std::swap(old_rightof, rightof[blk]);
+    std::swap(old_aboveof, aboveof[blk]);
+
+    rightof[blk].clear();
     
-    pidx = blk->idx_positive_sequence+1;
-    nidx = blk->idx_negative_sequence;
+    pidx = idx_positive_sequence[blk]+1;
+    nidx = idx_negative_sequence[blk];
     
     while (pidx < num_blocks) {
-      Block* target = positive_sequence[pidx];
-      if (target->idx_negative_sequence > nidx) {
-        blk->rightof.push_back(target);
+      size_t target = positive_sequence[pidx];
+      if (idx_negative_sequence[target] > nidx) {
+        rightof[blk].push_back(target);
       }
       ++pidx;
     }
     if (move_type != MoveType::nomove) {
-      blk->rightof.push_back(&terminus);
+      rightof[blk].push_back(terminus);
     }
   }
 
   // construct aboveof vector
   for (auto& blk : affected) {
-    blk->aboveof.clear();
+    aboveof[blk].clear();
     
-    pidx = static_cast<int>(blk->idx_positive_sequence)-1; 
-    nidx = blk->idx_negative_sequence;
+    pidx = idx_positive_sequence[blk]-1; 
+    nidx = idx_negative_sequence[blk];
 
     while (pidx >= 0) {
-      Block* target = positive_sequence[pidx];
-      if (target->idx_negative_sequence > nidx) {
-        blk->aboveof.push_back(target);
+      size_t target = positive_sequence[pidx];
+      if (idx_negative_sequence[target] > nidx) {
+        aboveof[blk].push_back(target);
       }
       --pidx;
     }
     if (move_type != MoveType::nomove) {
-      blk->aboveof.push_back(&terminus);
+      aboveof[blk].push_back(terminus);
     }
   }
   
   // rightof and aboveof regarding source and 
   // terminus blocks have been inserted
   if (move_type != MoveType::nomove) {
+    for (auto& blk : affected) {
+      update_graph_row(blk);
+    }
     return; 
   }
 
   // construct relative locations for source & terminus blocks
-  for (auto& [key, value] : map_blocks) {
-    source.rightof.push_back(&value);
-    source.aboveof.push_back(&value);
-    value.rightof.push_back(&terminus);
-    value.aboveof.push_back(&terminus);
+  rightof[source].clear();
+  aboveof[source].clear();
+  for (size_t blk = 0; blk < num_blocks; ++blk) {
+    rightof[source].push_back(blk);
+    aboveof[source].push_back(blk);
+    rightof[blk].push_back(terminus);
+    aboveof[blk].push_back(terminus);
+  }
+  for (size_t blk = 0; blk < num_blocks+2; ++blk) {
+    update_graph_row(blk);
+  }
+}
+
+
+// allocate the rows of graph_edges, (num_blocks+2)*num_blocks entries
+// each, and fill them from rightof and aboveof
+inline void SP::initialize_graph_rows() {
+  // a block is right of or above at most the other blocks and the
+  // terminus, the source of every block
+  graph_stride = num_blocks;
+  for (auto orientation : {Orientation::Horizontal, Orientation::Vertical}) {
+    graph_edges[orientation].assign((num_blocks+2)*graph_stride, 0);
+    graph_degree[orientation].assign(num_blocks+2, 0);
+  }
+  for (size_t blk = 0; blk < num_blocks+2; ++blk) {
+    update_graph_row(blk);
+  }
+}
+
+
+// copy rightof[blk] and aboveof[blk] into their rows of graph_edges,
+// if there are rows
+inline void SP::update_graph_row(const size_t blk) {
+  if (graph_stride == 0) {
+    return;
+  }
+  const std::vector<size_t>* lists[2] = {&rightof[blk], &aboveof[blk]};
+  for (auto orientation : {Orientation::Horizontal, Orientation::Vertical}) {
+    const std::vector<size_t>& vec = *lists[orientation];
+    assert(vec.size() <= graph_stride);
+    std::copy(vec.begin(), vec.end(), 
+              graph_edges[orientation].begin() + blk*graph_stride);
+    graph_degree[orientation][blk] = vec.size();
   }
 }
 
@@ -430,57 +805,39 @@ inline std::vector<int> SP::spfa(const Orientation orientation) {
 
   distance[0] = 0;
   
-  std::deque<Block*> Q;
+  std::deque<size_t> Q;
 
-  Q.push_back(&source);
+  Q.push_back(source);
   in_queue[0] = true;
 
   while (!Q.empty()) {
-    Block* u = Q.front();
+    size_t u = Q.front();
     Q.pop_front();
 
-    size_t indexu = 0, indexv = 0;
-    if (u->idx_positive_sequence == -1) {
-      if (u == &source) {
-        indexu = 0;
-      }
-      else {
-        indexu = num_blocks+1;
-      }
-    }
-    else {
-      indexu = u->idx_positive_sequence+1;
-    }
+    size_t indexu = node_index(u), indexv = 0;
     in_queue[indexu] = false;
   
-    std::vector<Block*> vec; 
+    std::vector<size_t> vec; 
     if(orientation == Orientation::Horizontal) {
-      vec = u->rightof;
+      vec = rightof[u];
     }
     else {
-      vec = u->aboveof;
+      vec = aboveof[u];
     }
 
     for (auto& blk : vec) {
 
-      if (blk->idx_positive_sequence == -1) {
-        if (blk == &source) {
-          indexv = 0;
-        }
-        else {
-          indexv = num_blocks+1;
-        }
-      }
-      else {
-        indexv = blk->idx_positive_sequence+1;
-      }
+      indexv = node_index(blk);
      
       int weight = 0;
-      if (orientation == Orientation::Horizontal) {
-        weight = -1 * static_cast<int>(blk->width);
+      if (blk == terminus) {
+        weight = 0;
+      }
+      else if (orientation == Orientation::Horizontal) {
+        weight = -1 * static_cast<int>(width[blk]);
       }
       else {
-        weight = -1 * static_cast<int>(blk->height);
+        weight = -1 * static_cast<int>(height[blk]);
       }
       
       if (distance[indexu] + weight < distance[indexv]) {
@@ -497,56 +854,219 @@ inline std::vector<int> SP::spfa(const Orientation orientation) {
 }
 
 
+// index of a block in the distances of spfa,
+// the source is 0 and the terminus num_blocks+1
+inline size_t SP::node_index(const size_t blk) const {
+  if (blk >= num_blocks) {
+    return blk == source ? 0 : num_blocks+1;
+  }
+  return idx_positive_sequence[blk]+1;
+}
+
+
+// longest paths of the constraint graph in one pass, a drop-in for spfa
+//
+// the graphs are acyclic and the positive sequence orders them: a block
+// is only right of blocks before it and only above blocks after it,
+// so relaxing the nodes forwards (backwards for vertical) after the
+// source sees every node once, when its distance is final; the edges
+// come from the rows of graph_edges, which the moves keep up to date
+inline std::vector<int> SP::dag_longest_path(const Orientation orientation) {
+  assert(graph_stride == num_blocks);
+  const std::vector<size_t>& edges = graph_edges[orientation];
+  const std::vector<size_t>& degree = graph_degree[orientation];
+  const std::vector<size_t>& size = orientation == Orientation::Horizontal ?
+                                    width : height;
+
+  std::vector<int> distance(num_blocks+2, INT_MAX);
+  distance[0] = 0;
+
+  for (size_t k = 0; k <= num_blocks; ++k) {
+    size_t u = k == 0 ? 0 :
+               orientation == Orientation::Horizontal ? k : num_blocks+1-k;
+    if (distance[u] == INT_MAX) {
+      continue;
+    }
+    size_t blk = u == 0 ? source : positive_sequence[u-1];
+    const size_t* row = edges.data() + blk*graph_stride;
+    for (size_t e = 0; e < degree[blk]; ++e) {
+      size_t v = row[e];
+      int d = distance[u] - (v == terminus ? 0 : static_cast<int>(size[v]));
+      size_t index = node_index(v);
+      if (d < distance[index]) {
+        distance[index] = d;
+      }
+    }
+  }
+  return distance;
+}
+
+
+// longest paths as a weighted longest common subsequence of the
+// positive and negative sequences (Tang, Tian and Wong), O(n log n)
+// without any graph, returns the same distances as spfa
+//
+// a block is right of every block before it in both sequences and
+// above every block after it in the positive sequence but before it
+// in the negative sequence, so walking the positive sequence forwards
+// (backwards for vertical) it starts at the longest path among the
+// blocks walked so far that precede it in the negative sequence
+inline std::vector<int> SP::weighted_lcs(const Orientation orientation) {
+  std::vector<int> distance(num_blocks+2);
+  
+  // fenwick tree of the longest path ending at each negative sequence
+  // position walked so far, queried by prefix maximum
+  std::vector<int> tree(num_blocks+1, 0);
+  int longest = 0;
+
+  for (size_t k = 0; k < num_blocks; ++k) {
+    size_t blk = orientation == Orientation::Horizontal ?
+                 positive_sequence[k] : positive_sequence[num_blocks-1-k];
+    
+    int start = 0;
+    for (int i = idx_negative_sequence[blk]; i > 0; i -= i & -i) {
+      start = std::max(start, tree[i]);
+    }
+
+    int end = start + static_cast<int>(
+      orientation == Orientation::Horizontal ? width[blk] : height[blk]);
+    
+    for (size_t i = idx_negative_sequence[blk]+1; i <= num_blocks; 
+         i += i & -i) {
+      tree[i] = std::max(tree[i], end);
+    }
+
+    distance[idx_positive_sequence[blk]+1] = -end;
+    longest = std::max(longest, end);
+  }
+
+  distance[0] = 0;
+  distance[num_blocks+1] = -longest;
+  return distance;
+}
+
+
 // compute hpwl
 inline int SP::compute_hpwl() const {
   int tmp_hpwl = 0;
-  int max_x = 0, min_x = INT_MAX, max_y = 0, min_y = INT_MAX;
-  int llx = 0, lly = 0;
   
-  for (auto& net : vec_nets) {
-
-    max_x = 0;
-    min_x = INT_MAX;
-    max_y = 0;
-    min_y = INT_MAX;
-    llx = 0;
-    lly = 0;
+  for (size_t n = 0; n < net_boxes.size(); ++n) {
+    std::array<int, 4> box = net_box(n);
+    tmp_hpwl = tmp_hpwl + (box[1]-box[0]) + (box[3]-box[2]);
+  }
     
-    for (auto& n : net.net) {
-      // n is a terminal
-      if (std::holds_alternative<Terminal*>(n)) {
-        llx = 2*std::get<Terminal*>(n)->pos_x;
-        lly = 2*std::get<Terminal*>(n)->pos_y;
-      }
-      // n is a block
-      else {
-        int x = std::get<Block*>(n)->lower_left_x;
-        int y = std::get<Block*>(n)->lower_left_y;
-        int w = std::get<Block*>(n)->width;
-        int h = std::get<Block*>(n)->height;
-        
-        llx = 2*x + ((x+w)-x); 
-        lly = 2*y + ((y+h)-y); 
-      }
+  return tmp_hpwl;
+}
 
-      if (llx >= max_x) {
-        max_x = llx;    
-      }
-      if (llx <= min_x) {
-        min_x = llx;
-      }
-      if (lly >= max_y) {
-        max_y = lly;
+
+// bounding box of the pin centers of net n, in doubled coordinates
+inline std::array<int, 4> SP::net_box(const size_t n) const {
+  std::array<int, 4> box = terminal_boxes[n];
+
+  for (size_t p = net_offset[n]; p < net_offset[n+1]; ++p) {
+    size_t blk = net_pins[p];
+    int x = 2*lower_left_x[blk] + width[blk];
+    int y = 2*lower_left_y[blk] + height[blk];
+    box[0] = std::min(box[0], x);
+    box[1] = std::max(box[1], x);
+    box[2] = std::min(box[2], y);
+    box[3] = std::max(box[3], y);
+  }
+
+  return box;
+}
+
+
+// recompute the box of net n, logging the old one if it changed,
+// and add the difference to wirelength
+inline void SP::update_net_box(const size_t n) {
+  std::array<int, 4> box = net_box(n);
+  std::array<int, 4>& old_box = net_boxes[n];
+  if (box != old_box) {
+    undo_log.net_boxes.emplace_back(n, old_box);
+    wirelength += (box[1]-box[0]) + (box[3]-box[2]) - 
+                  (old_box[1]-old_box[0]) - (old_box[3]-old_box[2]);
+    old_box = box;
+  }
+}
+
+
+// recompute the boxes of the nets of changed_blocks, once each, or
+// of every net in order, which is faster once they are half the nets
+inline void SP::update_net_boxes() {
+  size_t num_pins = 0;
+  for (auto blk : changed_blocks) {
+    num_pins += block_nets[blk].size();
+  }
+  if (2*num_pins > net_boxes.size()) {
+    compute_net_boxes();
+    changed_blocks.clear();
+    return;
+  }
+
+  ++num_net_updates;
+  for (auto blk : changed_blocks) {
+    for (auto n : block_nets[blk]) {
+      if (net_visits[n] != num_net_updates) {
+        net_visits[n] = num_net_updates;
+        update_net_box(n);
       }
-      if (lly <= min_y) {
-        min_y = lly;
+    }
+  }
+  changed_blocks.clear();
+}
+
+
+// recompute the box of every net and wirelength
+inline void SP::compute_net_boxes() {
+  if (!undo_log.saved_all_net_boxes) {
+    std::swap(undo_log.all_net_boxes, net_boxes);
+    undo_log.saved_all_net_boxes = true;
+    undo_log.num_net_boxes = undo_log.net_boxes.size();
+    net_boxes.resize(terminal_boxes.size());
+  }
+  if (lane_nets.empty()) {
+    build_net_lanes();
+  }
+
+  for (size_t blk = 0; blk < num_blocks; ++blk) {
+    center_x[blk] = 2*lower_left_x[blk] + width[blk];
+    center_y[blk] = 2*lower_left_y[blk] + height[blk];
+  }
+
+  // the lanes are independent and without branches, so the compiler
+  // can keep them in vector registers and take min and max of all at once
+  for (size_t g = 0; g+1 < lane_offset.size(); ++g) {
+    int min_x[net_lanes], max_x[net_lanes], min_y[net_lanes], max_y[net_lanes];
+    const int* box = &lane_boxes[4*net_lanes*g];
+    for (size_t k = 0; k < net_lanes; ++k) {
+      min_x[k] = box[k];
+      max_x[k] = box[net_lanes+k];
+      min_y[k] = box[2*net_lanes+k];
+      max_y[k] = box[3*net_lanes+k];
+    }
+
+    for (size_t p = lane_offset[g]; p < lane_offset[g+1]; p += net_lanes) {
+      for (size_t k = 0; k < net_lanes; ++k) {
+        uint32_t blk = lane_pins[p+k];
+        min_x[k] = std::min(min_x[k], center_x[blk]);
+        max_x[k] = std::max(max_x[k], center_x[blk]);
+        min_y[k] = std::min(min_y[k], center_y[blk]);
+        max_y[k] = std::max(max_y[k], center_y[blk]);
       }
     }
 
-    tmp_hpwl = tmp_hpwl + (max_x-min_x) + (max_y-min_y);
+    // the empty lanes write the box of a net again
+    for (size_t k = 0; k < net_lanes; ++k) {
+      net_boxes[lane_nets[net_lanes*g+k]] = {min_x[k], max_x[k],
+                                             min_y[k], max_y[k]};
+    }
+  }
+
+  wirelength = 0;
+  for (auto& box : net_boxes) {
+    wirelength += (box[1]-box[0]) + (box[3]-box[2]);
   }
-    
-  return tmp_hpwl;
 }
 
 
@@ -557,17 +1077,23 @@ inline void SP::compute_block_locations(std::vector<int>& distance,
   switch (orientation) {
     // horizontal
     case 0:
-      for (auto& [key, value] : map_blocks) {
-        value.lower_left_x = 
-          -1*distance[value.idx_positive_sequence+1] - value.width;
+      for (size_t blk = 0; blk < num_blocks; ++blk) {
+        size_t x = -1*distance[idx_positive_sequence[blk]+1] - width[blk];
+        if (x != lower_left_x[blk]) {
+          undo_log.corners.emplace_back(&lower_left_x[blk], lower_left_x[blk]);
+          lower_left_x[blk] = x;
+        }
       }
     break;
 
     // vertical
     case 1:
-      for (auto& [key, value] : map_blocks) {
-        value.lower_left_y = 
-          -1*distance[value.idx_positive_sequence+1] - value.height;
+      for (size_t blk = 0; blk < num_blocks; ++blk) {
+        size_t y = -1*distance[idx_positive_sequence[blk]+1] - height[blk];
+        if (y != lower_left_y[blk]) {
+          undo_log.corners.emplace_back(&lower_left_y[blk], lower_left_y[blk]);
+          lower_left_y[blk] = y;
+        }
       }
     break;
   }
@@ -579,6 +1105,8 @@ inline void SP::compute_area(const std::vector<int>& distance, int& bb,
   const Orientation orientation) {
 
   size_t limit = 0;
+  int& excess = orientation == Orientation::Horizontal ? 
+                excess_width : excess_height;
   if (orientation == Orientation::Horizontal) {
     limit = outline_width;
   }
@@ -586,15 +1114,17 @@ inline void SP::compute_area(const std::vector<int>& distance, int& bb,
     limit = outline_height;
   }
 
+  excess = 0;
+
   bb = INT_MIN;
-  for (auto& [key, value] : map_blocks) {
-    bb = bb > -1*distance[value.idx_positive_sequence+1]
-            ? bb : -1*distance[value.idx_positive_sequence+1];  
+  for (size_t blk = 0; blk < num_blocks; ++blk) {
+    bb = bb > -1*distance[idx_positive_sequence[blk]+1]
+            ? bb : -1*distance[idx_positive_sequence[blk]+1];  
   
-    int len = -1*distance[value.idx_positive_sequence+1]-static_cast<int>(limit);
+    int len = -1*distance[idx_positive_sequence[blk]+1]-static_cast<int>(limit);
     
     if (len > 0) {
-      overshoot_length = overshoot_length + penalty_ratio*len;
+      excess = excess + len;
     }
   }
 }
@@ -613,10 +1143,7 @@ inline std::pair<size_t, size_t> SP::move1() {
     std::swap(id1, id2);
   }
   
-  std::swap(positive_sequence[id1], positive_sequence[id2]);
-
-  positive_sequence[id1]->idx_positive_sequence = id1;
-  positive_sequence[id2]->idx_positive_sequence = id2;
+  apply_move({MoveType::move1, id1, id2});
  
   return std::make_pair(id1, id2);
 }
@@ -635,10 +1162,7 @@ inline std::pair<size_t, size_t> SP::move2() {
     std::swap(id1, id2);
   }
   
-  std::swap(negative_sequence[id1], negative_sequence[id2]);
-  
-  negative_sequence[id1]->idx_negative_sequence = id1;
-  negative_sequence[id2]->idx_negative_sequence = id2;
+  apply_move({MoveType::move2, id1, id2});
  
   return std::make_pair(id1, id2);
 }
@@ -657,18 +1181,7 @@ inline std::pair<size_t, size_t> SP::move3() {
     std::swap(id1, id2);
   }
 
-  std::swap(positive_sequence[id1], positive_sequence[id2]);
-  
-  positive_sequence[id1]->idx_positive_sequence = id1;
-  positive_sequence[id2]->idx_positive_sequence = id2;
- 
-  size_t nid1 = positive_sequence[id1]->idx_negative_sequence;
-  size_t nid2 = positive_sequence[id2]->idx_negative_sequence;
-  
-  std::swap(negative_sequence[nid1], negative_sequence[nid2]);
-  
-  negative_sequence[nid1]->idx_negative_sequence = nid1;
-  negative_sequence[nid2]->idx_negative_sequence = nid2;
+  apply_move({MoveType::move3, id1, id2});
 
   return std::make_pair(id1, id2);
 }
@@ -678,288 +1191,171 @@ inline std::pair<size_t, size_t> SP::move3() {
 inline std::pair<size_t, size_t> SP::move4() {
   size_t id = random_value()%num_blocks;
 
-  while (positive_sequence[id]->width == positive_sequence[id]->height) {
+  while (width[positive_sequence[id]] == height[positive_sequence[id]]) {
     id = random_value()%num_blocks;
   }
   
-  std::swap(positive_sequence[id]->width,
-            positive_sequence[id]->height);
+  apply_move({MoveType::move4, id, id});
 
   return std::make_pair(id, id);
 }
 
 
-// backup the data 
-inline void SP::initialize_backup_data() {
-  for (auto& [key, value] : map_blocks) {
-    value.backup_width = value.width;
-    value.backup_height = value.height;
-    value.backup_lower_left_x = value.lower_left_x;
-    value.backup_lower_left_y = value.lower_left_y;
-    value.backup_rightof = value.rightof;
-    value.backup_aboveof = value.aboveof;
-    value.backup_idx_positive_sequence = value.idx_positive_sequence;
-    value.backup_idx_negative_sequence = value.idx_negative_sequence;
-  }
-
-  backup_bb_width = bb_width;
-  backup_bb_height = bb_height;
-  backup_hpwl = hpwl;
-  backup_positive_sequence = positive_sequence;
-  backup_negative_sequence = negative_sequence;
-}
-
-
-// update backup data
-// copy modified data to backup data
-inline void SP::update_backup_data(
-  const size_t id1, const size_t id2, const MoveType move_type) {
-
+// make a move at the given positions, see move1 to move4
+inline void SP::apply_move(const Move& move) {
+  const size_t id1 = move.id1;
+  const size_t id2 = move.id2;
   size_t nid1, nid2;
-  switch(move_type) {
-    case 1:
-      std::swap(backup_positive_sequence[id1], backup_positive_sequence[id2]);
-      positive_sequence[id1]->backup_idx_positive_sequence = id1;
-      positive_sequence[id2]->backup_idx_positive_sequence = id2;
-     
-      for (size_t i = id1; i <= id2; ++i) {
-        positive_sequence[i]->backup_rightof = 
-          positive_sequence[i]->rightof;
-        positive_sequence[i]->backup_aboveof = 
-          positive_sequence[i]->aboveof;
-      }
 
-      for (auto& [key, value] : map_blocks) {
-        value.backup_lower_left_x = value.lower_left_x;
-        value.backup_lower_left_y = value.lower_left_y;
-      }
+  switch (move.type) {
+    case 1:
+      std::swap(positive_sequence[id1], positive_sequence[id2]);
 
-      assert(backup_positive_sequence[id1] == positive_sequence[id1]);
-      assert(backup_positive_sequence[id2] == positive_sequence[id2]);
+      idx_positive_sequence[positive_sequence[id1]] = id1;
+      idx_positive_sequence[positive_sequence[id2]] = id2;
     break;
-    
+
     case 2:
-      std::swap(backup_negative_sequence[id1], backup_negative_sequence[id2]);
-      negative_sequence[id1]->backup_idx_negative_sequence = id1;
-      negative_sequence[id2]->backup_idx_negative_sequence = id2;
-      
-      for (size_t i = id1; i <= id2; ++i) {
-        negative_sequence[i]->backup_rightof = 
-          negative_sequence[i]->rightof;
-        negative_sequence[i]->backup_aboveof = 
-          negative_sequence[i]->aboveof;
-      }
+      std::swap(negative_sequence[id1], negative_sequence[id2]);
       
-      for (auto& [key, value] : map_blocks) {
-        value.backup_lower_left_x = value.lower_left_x;
-        value.backup_lower_left_y = value.lower_left_y;
-      }
-      assert(backup_negative_sequence[id1] == negative_sequence[id1]);
-      assert(backup_negative_sequence[id2] == negative_sequence[id2]);
+      idx_negative_sequence[negative_sequence[id1]] = id1;
+      idx_negative_sequence[negative_sequence[id2]] = id2;
     break;
 
     case 3:
-      std::swap(backup_positive_sequence[id1], backup_positive_sequence[id2]);
-      positive_sequence[id1]->backup_idx_positive_sequence = id1;
-      positive_sequence[id2]->backup_idx_positive_sequence = id2;
+      std::swap(positive_sequence[id1], positive_sequence[id2]);
       
-      for (size_t i = id1; i <= id2; ++i) {
-        positive_sequence[i]->backup_rightof = 
-          positive_sequence[i]->rightof;
-        positive_sequence[i]->backup_aboveof =
-          positive_sequence[i]->aboveof;
-      }
-
+      idx_positive_sequence[positive_sequence[id1]] = id1;
+      idx_positive_sequence[positive_sequence[id2]] = id2;
+     
+      nid1 = idx_negative_sequence[positive_sequence[id1]];
+      nid2 = idx_negative_sequence[positive_sequence[id2]];
       
-      nid1 = positive_sequence[id1]->idx_negative_sequence;
-      nid2 = positive_sequence[id2]->idx_negative_sequence;
-      std::swap(backup_negative_sequence[nid1], backup_negative_sequence[nid2]);
-      negative_sequence[nid1]->backup_idx_negative_sequence = nid1;
-      negative_sequence[nid2]->backup_idx_negative_sequence = nid2;
-    
-      if (nid1 > nid2) {
-        std::swap(nid1, nid2);
-      }
-
-      for (size_t i = nid1; i <= nid2; ++i) {
-        negative_sequence[i]->backup_rightof = 
-          negative_sequence[i]->rightof;
-        negative_sequence[i]->backup_aboveof = 
-          negative_sequence[i]->aboveof;
-      }
+      std::swap(negative_sequence[nid1], negative_sequence[nid2]);
       
-      for (auto& [key, value] : map_blocks) {
-        value.backup_lower_left_x = value.lower_left_x;
-        value.backup_lower_left_y = value.lower_left_y;
-      }
-      assert(backup_positive_sequence[id1] == positive_sequence[id1]);
-      assert(backup_negative_sequence[id1] == negative_sequence[id1]);
-      assert(backup_positive_sequence[id2] == positive_sequence[id2]);
-      assert(backup_negative_sequence[id2] == negative_sequence[id2]);
+      idx_negative_sequence[negative_sequence[nid1]] = nid1;
+      idx_negative_sequence[negative_sequence[nid2]] = nid2;
     break;
 
     case 4:
-      positive_sequence[id1]->backup_width = 
-        positive_sequence[id1]->width; 
-      positive_sequence[id1]->backup_height = 
-        positive_sequence[id1]->height; 
-      
-      for (auto& [key, value] : map_blocks) {
-        value.backup_lower_left_x = value.lower_left_x;
-        value.backup_lower_left_y = value.lower_left_y;
-      }
+      std::swap(width[positive_sequence[id1]],
+                height[positive_sequence[id1]]);
     break;
 
     case 0:
-      std::cerr << "Nomove does not update backup data\n";
-      exit(-1);
     break;
   }
-
-  backup_bb_width  = bb_width;
-  backup_bb_height = bb_height;
-  backup_hpwl = hpwl;
 }
 
 
-// resume backup data
-// resume data from backup data
-inline void SP::resume_backup_data(
-  const size_t id1, const size_t id2, const MoveType move_type) {
-
-  size_t nid1, nid2;
-  switch(move_type) {
-    case 1:
-      std::swap(positive_sequence[id1], positive_sequence[id2]);
-
-      positive_sequence[id1]->idx_positive_sequence  = 
-      positive_sequence[id1]->backup_idx_positive_sequence;
-
-      positive_sequence[id2]->idx_positive_sequence = 
-      positive_sequence[id2]->backup_idx_positive_sequence;
-      
-      for (size_t i = id1; i <= id2; ++i) {
-        positive_sequence[i]->rightof = 
-        positive_sequence[i]->backup_rightof;
-       
-        positive_sequence[i]->aboveof = 
-        positive_sequence[i]->backup_aboveof;
-      }
-
-      for (auto& [key, value] : map_blocks) {
-        value.lower_left_x = value.backup_lower_left_x;
-        value.lower_left_y = value.backup_lower_left_y;
-      }
-    break;
-    
-    case 2:
-      std::swap(negative_sequence[id1], negative_sequence[id2]);
-     
-      negative_sequence[id1]->idx_negative_sequence = 
-      negative_sequence[id1]->backup_idx_negative_sequence; 
-     
-      negative_sequence[id2]->idx_negative_sequence = 
-      negative_sequence[id2]->backup_idx_negative_sequence; 
-      
-      for (size_t i = id1; i <= id2; ++i) {
-        negative_sequence[i]->rightof = 
-        negative_sequence[i]->backup_rightof;
+// backup the data, which starts an empty undo log
+inline void SP::initialize_backup_data() {
+  undo_log.corners.clear();
+  undo_log.num_relations = 0;
+  undo_log.net_boxes.clear();
+  undo_log.saved_all_net_boxes = false;
+
+  undo_log.bb_width = bb_width;
+  undo_log.bb_height = bb_height;
+  undo_log.hpwl = hpwl;
+  undo_log.wirelength = wirelength;
+  undo_log.excess_width = excess_width;
+  undo_log.excess_height = excess_height;
+}
 
-        negative_sequence[i]->aboveof = 
-        negative_sequence[i]->backup_aboveof;
-      }
-      
-      for (auto& [key, value] : map_blocks) {
-        value.lower_left_x = value.backup_lower_left_x;
-        value.lower_left_y = value.backup_lower_left_y;
-      }
-    break;
 
-    case 3:
-      std::swap(positive_sequence[id1], positive_sequence[id2]);
-
-      positive_sequence[id1]->idx_positive_sequence = 
-      positive_sequence[id1]->backup_idx_positive_sequence;
-      
-      positive_sequence[id2]->idx_positive_sequence = 
-      positive_sequence[id2]->backup_idx_positive_sequence;
-      
-      for (size_t i = id1; i <= id2; ++i) {
-        positive_sequence[i]->rightof = 
-        positive_sequence[i]->backup_rightof;
+// update backup data
+// keep what the move changed by forgetting how to undo it
+inline void SP::update_backup_data(
+  const size_t, const size_t, const MoveType move_type) {
 
-        positive_sequence[i]->aboveof = 
-        positive_sequence[i]->backup_aboveof;
-      }
+  if (move_type == MoveType::nomove) {
+    std::cerr << "Nomove does not update backup data\n";
+    exit(-1);
+  }
 
-      nid1 = positive_sequence[id1]->idx_negative_sequence;
-      nid2 = positive_sequence[id2]->idx_negative_sequence;
-      std::swap(negative_sequence[nid1], negative_sequence[nid2]);
-     
-      negative_sequence[nid1]->idx_negative_sequence =  
-      negative_sequence[nid1]->backup_idx_negative_sequence;
+  initialize_backup_data();
+}
 
-      negative_sequence[nid2]->idx_negative_sequence = 
-      negative_sequence[nid2]->backup_idx_negative_sequence;
-    
-      if (nid1 > nid2) {
-        std::swap(nid1, nid2);
-      }
 
-      for (size_t i = nid1; i <= nid2; ++i) {
-        negative_sequence[i]->rightof = 
-        negative_sequence[i]->backup_rightof;
+// resume backup data
+// make the move again, which swaps or rotates the blocks back, and
+// replay the undo log backwards
+inline void SP::resume_backup_data(
+  const size_t id1, const size_t id2, const MoveType move_type) {
 
-        negative_sequence[i]->aboveof = 
-        negative_sequence[i]->backup_aboveof;
-      }
-      
-      for (auto& [key, value] : map_blocks) {
-        value.lower_left_x = value.backup_lower_left_x;
-        value.lower_left_y = value.backup_lower_left_y;
-      }
-    break;
+  if (move_type == MoveType::nomove) {
+    std::cerr << "Nomove does not update backup data\n";
+    exit(-1);
+  }
 
-    case 4:
-      positive_sequence[id1]->width =
-      positive_sequence[id1]->backup_width;
+  apply_move({move_type, id1, id2});
 
-      positive_sequence[id1]->height =
-      positive_sequence[id1]->backup_height;
-      
-      for (auto& [key, value] : map_blocks) {
-        value.lower_left_x = value.backup_lower_left_x;
-        value.lower_left_y = value.backup_lower_left_y;
-      }
-    break;
+  for (auto it = undo_log.corners.rbegin(); it != undo_log.corners.rend(); ++it) {
+    *(it->first) = it->second;
+  }
+  
+  while (undo_log.num_relations > 0) {
+    auto& [blk, old_rightof, old_aboveof] = 
+      undo_log.relations[--undo_log.num_relations];
+    std::swap(rightof[blk], old_rightof);
+    std::swap(aboveof[blk], old_aboveof);
+    update_graph_row(blk);
+  }
 
-    case 0:
-      std::cerr << "Nomove does not update backup data\n";
-      exit(-1);
-    break;
+  size_t num_logged = undo_log.net_boxes.size();
+  if (undo_log.saved_all_net_boxes) {
+    std::swap(net_boxes, undo_log.all_net_boxes);
+    num_logged = undo_log.num_net_boxes;
+  }
+  while (num_logged > 0) {
+    auto& [n, box] = undo_log.net_boxes[--num_logged];
+    net_boxes[n] = box;
   }
 
-  bb_width  = backup_bb_width;
-  bb_height = backup_bb_height;
-  hpwl = backup_hpwl;
+  bb_width = undo_log.bb_width;
+  bb_height = undo_log.bb_height;
+  hpwl = undo_log.hpwl;
+  wirelength = undo_log.wirelength;
+  excess_width = undo_log.excess_width;
+  excess_height = undo_log.excess_height;
+
+  undo_log.corners.clear();
+  undo_log.net_boxes.clear();
+  undo_log.saved_all_net_boxes = false;
 }
 
 
 // pack SP
 inline double SP::pack() {
-  overshoot_length = 0;
-  std::vector<int> distance = spfa(Orientation::Horizontal);
+  std::vector<int> distance = 
+    pack_engine == PackEngine::LCS ? weighted_lcs(Orientation::Horizontal) :
+    pack_engine == PackEngine::DAG ? dag_longest_path(Orientation::Horizontal) :
+                                     spfa(Orientation::Horizontal);
   
   compute_block_locations(distance, Orientation::Horizontal);
   compute_area(distance, bb_width, Orientation::Horizontal);
   
   
-  distance = spfa(Orientation::Vertical);
+  distance = 
+    pack_engine == PackEngine::LCS ? weighted_lcs(Orientation::Vertical) :
+    pack_engine == PackEngine::DAG ? dag_longest_path(Orientation::Vertical) :
+                                     spfa(Orientation::Vertical);
   
   compute_block_locations(distance, Orientation::Vertical);
   compute_area(distance, bb_height, Orientation::Vertical); 
+
+  compute_net_boxes();
   
-  hpwl = compute_hpwl()/2;
+  return evaluate();
+}
+
+
+// cost of the packed floorplan, which also enters the averages
+inline double SP::evaluate() {
+  overshoot_length = penalty_ratio*(excess_width + excess_height);
+
+  hpwl = wirelength/2;
   
   average_area = 
     (average_area*(num_iterations-1) + bb_width*bb_height)/static_cast<double>(num_iterations);
@@ -972,130 +1368,457 @@ inline double SP::pack() {
 }
 
 
+// re-pack after a move changed the blocks at id1 and id2 (positions in
+// the sequence the move swapped), returns the cost as pack does
+//
+// every block keeps its corners unless it is a moved block or follows
+// one in the positive sequence and in the negative sequence (or, for
+// vertical, precedes one in the positive sequence); relocate visits
+// only those and logs the corners it changes into undo_log; only the
+// nets of those blocks and of the two blocks of the move get new boxes
+inline double SP::repack(const size_t id1, const size_t id2, 
+  const MoveType move_type) {
+ 
+  size_t p1 = id1, p2 = id2;
+  if (move_type == MoveType::move2) {
+    p1 = idx_positive_sequence[negative_sequence[id1]];
+    p2 = idx_positive_sequence[negative_sequence[id2]];
+  }
+  if (p1 > p2) {
+    std::swap(p1, p2);
+  }
+
+  relocate(p1, p2, move_type, Orientation::Horizontal);
+  relocate(p1, p2, move_type, Orientation::Vertical);
+
+  // a rotated block may keep its corner
+  changed_blocks.push_back(positive_sequence[p1]);
+  changed_blocks.push_back(positive_sequence[p2]);
+  update_net_boxes();
+
+  return evaluate();
+}
+
+
+// weighted_lcs over the blocks at positive sequence positions p1 and p2
+// and the blocks they can shift, updating the corners, bounding box and
+// excess length of one orientation after a move of the type; move2 and
+// move3 swap the two blocks in the negative sequence, move4 rotates one
+//
+// the walk goes through the positive sequence forwards (horizontal) or
+// backwards (vertical); blocks before the moved ones in the walk keep
+// their corners and only enter the fenwick tree, and so does a block
+// whose predecessors, the blocks walked before it that precede it in
+// the negative sequence, are all unchanged; once past the moved blocks
+// only a change of a far end, or a moved block's new place in the 
+// negative sequence, can shift anything, so the walk stops as soon as
+// every block after such a change in the negative sequence has been
+// walked
+inline void SP::relocate(const size_t p1, const size_t p2, 
+  const MoveType move_type, const Orientation orientation) {
+
+  const bool horizontal = orientation == Orientation::Horizontal;
+  const int n = static_cast<int>(num_blocks);
+  const int limit = horizontal ? outline_width : outline_height;
+  int& bb = horizontal ? bb_width : bb_height;
+  int& excess = horizontal ? excess_width : excess_height;
+
+  std::vector<size_t>& corners = horizontal ? lower_left_x : lower_left_y;
+  const std::vector<size_t>& lengths = horizontal ? width : height;
+
+  size_t m1 = positive_sequence[p1];
+  size_t m2 = positive_sequence[p2];
+  const bool swapped = 
+    move_type == MoveType::move2 || move_type == MoveType::move3;
+  const bool rotated = move_type == MoveType::move4;
+  
+  // walk steps of the moved blocks
+  const int first = horizontal ? p1 : n-1-p2;
+  const int last = horizontal ? p2 : n-1-p1;
+
+  // blocks after low in the negative sequence may shift within the
+  // moved range, blocks after high past it
+  const int low = std::min(idx_negative_sequence[m1], 
+                           idx_negative_sequence[m2]);
+  int high = n-1;
+  int num_seen = 0;
+
+  // the longest far end among the changed ones, and whether a far end 
+  // at the old bounding box got shorter
+  int longest = 0;
+  bool shrunk = false;
+
+  // blocks before the moved ones go into the fenwick tree at once,
+  // in linear time
+  lcs_tree.assign(n+1, 0);
+  for (int k = 0; k < first; ++k) {
+    size_t blk = positive_sequence[horizontal ? k : n-1-k];
+    lcs_tree[idx_negative_sequence[blk]+1] = corners[blk] + lengths[blk];
+  }
+  for (int i = 1; i <= n; ++i) {
+    int j = i + (i & -i);
+    if (j <= n) {
+      lcs_tree[j] = std::max(lcs_tree[j], lcs_tree[i]);
+    }
+  }
+
+  for (int k = first; k < n; ++k) {
+    size_t blk = positive_sequence[horizontal ? k : n-1-k];
+    const int neg = idx_negative_sequence[blk];
+    size_t& corner = corners[blk];
+    const int len = lengths[blk];
+    
+    if (k == last+1) {
+      // count the walked blocks after high in the negative sequence
+      for (int j = high+1; j < n; ++j) {
+        int pos = idx_positive_sequence[negative_sequence[j]];
+        num_seen += (horizontal ? pos : n-1-pos) <= last;
+      }
+    }
+    if (k > last && num_seen == n-1-high) {
+      break;
+    }
+
+    bool moved = blk == m1 || blk == m2;
+    if (moved && swapped) {
+      high = std::min(high, neg);
+    }
+
+    if (k <= last ? neg > low || moved : neg > high) {
+      int start = 0;
+      for (int i = neg; i > 0; i -= i & -i) {
+        start = std::max(start, lcs_tree[i]);
+      }
+      
+      int old_len = moved && rotated ? 
+        (horizontal ? height[blk] : width[blk]) : len;
+      int old_end = static_cast<int>(corner) + old_len;
+      int end = start + len;
+
+      if (start != static_cast<int>(corner)) {
+        undo_log.corners.emplace_back(&corner, corner);
+        corner = start;
+        changed_blocks.push_back(blk);
+      }
+
+      if (end != old_end) {
+        excess += std::max(0, end-limit) - std::max(0, old_end-limit);
+        longest = std::max(longest, end);
+        shrunk = shrunk || old_end == bb;
+        high = std::min(high, neg);
+      }
+    }
+
+    if (k > last && neg > high) {
+      ++num_seen;
+    }
+    
+    for (int i = neg+1; i <= n; i += i & -i) {
+      lcs_tree[i] = std::max(lcs_tree[i], static_cast<int>(corner) + len);
+    }
+  }
+
+  // blocks left out kept their far ends, which are at most the old
+  // bounding box, so only a shrunk one needs all far ends again
+  if (longest >= bb) {
+    bb = longest;
+  }
+  else if (shrunk) {
+    bb = longest;
+    for (size_t blk = 0; blk < num_blocks; ++blk) {
+      bb = std::max(bb, static_cast<int>(corners[blk] + lengths[blk]));
+    }
+  }
+}
+
+
 // run SP with SA
 inline void SP::run() {
   bool pass = false;
-  double current_temperature = initial_temperature;
   
   // first run
+  start();
+  double current_temperature = start_schedule();
+ 
+  do { 
+    bool cooling = true;
+    while (cooling) {
+      size_t accepted = num_accepted;
+      anneal(current_temperature, schedule_iterations);
+      cooling = next_temperature(current_temperature, 
+        static_cast<double>(num_accepted-accepted)/schedule_iterations);
+    }
+
+    pass = fits_outline();
+    if (pass == false) {
+      penalty_ratio *= 2;
+      current_temperature = start_schedule();
+    }
+  }
+  while(pass == false);
+}
+
+
+// the first temperature of run, and with adaptive, the moves per
+// temperature and the temperature at which an average uphill move
+// of num_samples moves from the backed up floorplan is accepted
+// with probability initial_acceptance
+inline double SP::start_schedule() {
+  lowest_cost = DBL_MAX;
+  num_stable = 0;
+  schedule_area = average_area;
+  schedule_length = average_length;
+  schedule_decay = decay;
+  schedule_iterations = iterations_per_temperature;
+  if (!adaptive) {
+    return initial_temperature;
+  }
+
+  schedule_iterations = std::max<size_t>(1, moves_per_block*num_blocks);
+  schedule_decay = min_decay;
+
+  // deltas are scaled as in accept
+  double uphill = 0.0;
+  size_t num_uphill = 0;
+  for (size_t sample = 0; sample < num_samples; ++sample) {
+    Move move = propose();
+    double delta = (try_move(move) - backup_cost) * 1000;
+    undo(move);
+    if (delta > 0) {
+      uphill += delta;
+      ++num_uphill;
+    }
+  }
+  if (num_uphill == 0) {
+    return initial_temperature;
+  }
+  return -uphill/num_uphill/std::log(initial_acceptance);
+}
+
+
+// cool after a temperature that accepted the ratio of its moves and
+// whether run goes on: until frozen_temperature, and with adaptive,
+// until schedule_cost is stable once the ratio is below stop_acceptance;
+// schedule_cost is that of the floorplan the chain is at, not best_cost,
+// so a chain that wanders off its best one keeps going
+inline bool SP::next_temperature(double& current_temperature,
+  const double acceptance) {
+
+  if (adaptive) {
+    if (acceptance > target_acceptance) {
+      schedule_decay = std::max(min_decay, schedule_decay-decay_step);
+    }
+    else {
+      schedule_decay = std::min(max_decay, schedule_decay+decay_step);
+    }
+  }
+  current_temperature *= schedule_decay;
+  if (!adaptive) {
+    return current_temperature > frozen_temperature;
+  }
+
+  double cost = schedule_cost();
+  if (cost < lowest_cost*(1-min_improvement)) {
+    lowest_cost = cost;
+    num_stable = 0;
+  }
+  else if (acceptance < stop_acceptance) {
+    ++num_stable;
+  }
+  return num_stable < num_stable_temperatures &&
+         current_temperature > frozen_temperature;
+}
+
+
+// cost of the floorplan as evaluate weighs it, but normalised by the
+// averages start_schedule saw instead of the running ones, which drift
+// with every move, so it only falls when the floorplan gets better
+inline double SP::schedule_cost() const {
+  double overshoot = penalty_ratio*(excess_width + excess_height);
+  return alpha*bb_width*bb_height/schedule_area + 
+         (1-alpha)*(hpwl + overshoot)/schedule_length;
+}
+
+
+// pack the initial sequence pair and back it up
+inline void SP::start() {
   ++num_iterations;
-  construct_relative_locations(0, num_blocks-1, MoveType::nomove);
-  double backup_cost = pack();
-  double cost = backup_cost;
+  if (pack_engine == PackEngine::DAG) {
+    initialize_graph_rows();
+  }
+  if (pack_engine != PackEngine::LCS) {
+    construct_relative_locations(0, num_blocks-1, MoveType::nomove);
+  }
+  backup_cost = pack();
  
   // backup data  
   initialize_backup_data(); 
-  
-  // SA 
-  double delta = 0.0;
-  size_t rv;
+}
+
+
+// SA at one temperature, from the backed up floorplan
+inline void SP::anneal(const double current_temperature, 
+  const size_t iterations) {
+
+  for (size_t ite = 0; ite < iterations; ++ite) {
+    Move move = propose();
+    double cost = try_move(move);
+    
+    if (accept(cost, current_temperature)) {
+      keep(move, cost);
+    }
+    else {
+      undo(move);
+    }
+  }
+}
+
+
+// a new neighbor from one of the four moves
+inline Move SP::propose() {
   std::pair<size_t, size_t> pair_idx;
-  MoveType move_type;
- 
-  do { 
-    while (current_temperature > frozen_temperature) {
-      for (size_t ite = 0; ite < iterations_per_temperature; ++ite) {
-
-        rv = random_value()%4;
-        // neighborhood from four moves   
-        switch (rv) {
-          // a new neighbor from move1
-          case 0:
-            //std::cout << "iteration " << ite << ", temperature : " << current_temperature << ", move 1 chosen" << '\n';
-            pair_idx = move1();
-            move_type = MoveType::move1;
-          break;
-
-          // a new neighbor from move2 
-          case 1:
-            //std::cout << "iteration " << ite << ", temperature : " << current_temperature << ", move 2 chosen" << '\n';
-            pair_idx = move2();
-            move_type = MoveType::move2;
-          break;
-      
-          // a new neighbor from move3
-          case 2:
-            //std::cout << "iteration " << ite << ", temperature : " << current_temperature << ", move 3 chosen" << '\n';
-            pair_idx = move3();
-            move_type = MoveType::move3;
-          break;
-
-          // a new neighbor from move4
-          case 3:
-            //std::cout << "iteration " << ite << ", temperature : " << current_temperature << ", move 4 chosen" << '\n';
-            pair_idx = move4();
-            move_type = MoveType::move4;
-          break;
-        }
+  MoveType move_type = MoveType::nomove;
 
-        construct_relative_locations(pair_idx.first, pair_idx.second, move_type);
-        ++num_iterations;
-        cost = pack(); 
-        delta = (cost - backup_cost) * 1000;
-        
-        // better neighbor, always accept it
-        if (delta < 0) {
-          update_backup_data(pair_idx.first, pair_idx.second, move_type);
-          backup_cost = cost;
-        }
+  switch (random_value()%4) {
+    case 0:
+      pair_idx = move1();
+      move_type = MoveType::move1;
+    break;
 
-        // worse neighbor
-        else {
-          auto prob = std::exp(-delta/current_temperature);
+    case 1:
+      pair_idx = move2();
+      move_type = MoveType::move2;
+    break;
 
-          // accept the worse neighbor
-          if (prob > static_cast<double>(random_value())/max_dist) { 
-            update_backup_data(pair_idx.first, pair_idx.second, move_type);  
-            backup_cost = cost;
-          }
+    case 2:
+      pair_idx = move3();
+      move_type = MoveType::move3;
+    break;
 
-          // decline the worse neighbor
-          else {
-            average_area = (average_area*num_iterations-bb_width*bb_height)/(num_iterations-1);
-            average_length = (average_length*num_iterations-hpwl)/(num_iterations-1);
-            --num_iterations;
+    case 3:
+      pair_idx = move4();
+      move_type = MoveType::move4;
+    break;
+  }
 
-            resume_backup_data(pair_idx.first, pair_idx.second, move_type);
-          }
-        }
-      }
+  return {move_type, pair_idx.first, pair_idx.second};
+}
 
-      current_temperature *= decay;
-    }
 
-    if (outline_width >= outline_height) {
-      if (bb_width >= bb_height) {
-        if (outline_width >= bb_width && outline_height >= bb_height) {
-          pass = true; 
-        }
-      }
-      else {
-        if (outline_width >= bb_height && outline_height >= bb_width) {
-          pass = true;
-        }
+// pack the neighbor of a move and return its cost
+inline double SP::try_move(const Move& move) {
+  ++num_iterations;
+  if (incremental) {
+    return repack(move.id1, move.id2, move.type);
+  }
+  if (pack_engine != PackEngine::LCS) {
+    construct_relative_locations(move.id1, move.id2, move.type);
+  }
+  return pack(); 
+}
+
+
+// whether SA at the temperature accepts a neighbor of the cost:
+// a better one always, a worse one with probability exp(-delta/T)
+inline bool SP::accept(const double cost, 
+  const double current_temperature) const {
+
+  double delta = (cost - backup_cost) * 1000;
+  if (delta < 0) {
+    return true;
+  }
+  auto prob = std::exp(-delta/current_temperature);
+  return prob > static_cast<double>(random_value())/max_dist;
+}
+
+
+// accept the neighbor of a move
+inline void SP::keep(const Move& move, const double cost) {
+  update_backup_data(move.id1, move.id2, move.type);
+  backup_cost = cost;
+  ++num_accepted;
+
+  if (keep_best && fits_outline() && final_cost() < best_cost) {
+    save_best();
+  }
+}
+
+
+// decline the neighbor of a move
+inline void SP::undo(const Move& move) {
+  average_area = (average_area*num_iterations-bb_width*bb_height)/(num_iterations-1);
+  average_length = (average_length*num_iterations-hpwl)/(num_iterations-1);
+  --num_iterations;
+
+  resume_backup_data(move.id1, move.id2, move.type);
+}
+
+
+// whether the floorplan, possibly turned by 90 degrees, fits the outline
+inline bool SP::fits_outline() const {
+  bool pass = false;
+  if (outline_width >= outline_height) {
+    if (bb_width >= bb_height) {
+      if (outline_width >= bb_width && outline_height >= bb_height) {
+        pass = true; 
       }
     }
-
     else {
-      if (bb_width >= bb_height) {
-        if (outline_width >= bb_height && outline_height >= bb_width) {
-          pass = true;
-        }
+      if (outline_width >= bb_height && outline_height >= bb_width) {
+        pass = true;
       }
-      else {
-        if (outline_width >= bb_width && outline_height >= bb_height) {
-          pass = true;
-        }
+    }
+  }
+
+  else {
+    if (bb_width >= bb_height) {
+      if (outline_width >= bb_height && outline_height >= bb_width) {
+        pass = true;
       }
     }
-    if (pass == false) {
-      current_temperature = initial_temperature;
-      penalty_ratio *= 2;
+    else {
+      if (outline_width >= bb_width && outline_height >= bb_height) {
+        pass = true;
+      }
     }
   }
-  while(pass == false);
+  return pass;
+}
 
-  visualize();
+
+// the objective of the assignment, without the averages
+inline double SP::final_cost() const {
+  return alpha*bb_width*bb_height + (1-alpha)*hpwl;
+}
+
+
+// remember the current floorplan as the best one
+inline void SP::save_best() {
+  best_cost = final_cost();
+  best_bb_width = bb_width;
+  best_bb_height = bb_height;
+  best_hpwl = hpwl;
+  best_locations.clear();
+  for (size_t blk = 0; blk < num_blocks; ++blk) {
+    best_locations.push_back({lower_left_x[blk], lower_left_y[blk],
+                              width[blk], height[blk]});
+  }
+}
+
+
+// move the blocks to the best floorplan of sp, which read the same 
+// files, and take its bounding box and wirelength
+inline void SP::load_best(const SP& sp) {
+  assert(sp.num_blocks == num_blocks);
+  for (size_t blk = 0; blk < num_blocks; ++blk) {
+    lower_left_x[blk] = sp.best_locations[blk][0];
+    lower_left_y[blk] = sp.best_locations[blk][1];
+    width[blk] = sp.best_locations[blk][2];
+    height[blk] = sp.best_locations[blk][3];
+  }
+  bb_width = sp.best_bb_width;
+  bb_height = sp.best_bb_height;
+  hpwl = sp.best_hpwl;
 }
 
 
@@ -1106,15 +1829,15 @@ inline void SP::dump(std::ostream& os) const {
      << ", num_blocks = " << num_blocks
      << ", num_terminals = " << num_terminals << '\n';
 
-  for (auto& [key, value] : map_blocks) {
-    assert(key == value.name);
-    os << "Block " << value.name
-       << " has width : " << value.width
-       << ", height : "   << value.height
-       << ", lf.x : "     << value.lower_left_x
-       << ", lf.y : "     << value.lower_left_y
-       << ", ur.x : "     << (value.lower_left_x + value.width)
-       << ", ur.y : "     << (value.lower_left_y + value.height)
+  for (size_t blk = 0; blk < num_blocks; ++blk) {
+    assert(map_blocks.at(names[blk]) == blk);
+    os << "Block " << names[blk]
+       << " has width : " << width[blk]
+       << ", height : "   << height[blk]
+       << ", lf.x : "     << lower_left_x[blk]
+       << ", lf.y : "     << lower_left_y[blk]
+       << ", ur.x : "     << (lower_left_x[blk] + width[blk])
+       << ", ur.y : "     << (lower_left_y[blk] + height[blk])
        << '\n';
   }
   
@@ -1126,44 +1849,44 @@ inline void SP::dump(std::ostream& os) const {
        << '\n';
   }
 
-  for (auto& vec : vec_nets) {
+  for (size_t n = 0; n < terminal_boxes.size(); ++n) {
     os << "Net : ";
-    for (auto& v : vec.net) {
-      if (std::holds_alternative<Block*>(v)) {
-        os << (std::get<Block*>(v))->name    << "(b) ";
-      }
-      else {
-        os << (std::get<Terminal*>(v))->name << "(t) ";
-      }
+    for (size_t p = net_offset[n]; p < net_offset[n+1]; ++p) {
+      os << names[net_pins[p]] << "(b) ";
+    }
+    const std::array<int, 4>& box = terminal_boxes[n];
+    if (box[0] <= box[1]) {
+      os << "terminals in x : [" << box[0]/2.0 << ", " << box[1]/2.0
+         << "], y : [" << box[2]/2.0 << ", " << box[3]/2.0 << ']';
     }
     os << '\n';
   }
 
   os << "Positive sequence : ";
   for (auto& ps : positive_sequence) {
-    os << ps->name << ' '; 
+    os << names[ps] << ' '; 
   }
   os << '\n';
   
   os << "Negative sequence : ";
   for (auto& ns : negative_sequence) {
-    os << ns->name << ' '; 
+    os << names[ns] << ' '; 
   }
   os << '\n';
 
   os << "Relative Locations : \n";
-  for (auto& [key, value] : map_blocks) {
-    os << key << ".rightof = [";
-    for (auto& v : value.rightof) {
-      os << v->name << ", ";
+  for (size_t blk = 0; blk < rightof.size(); ++blk) {
+    os << names[blk] << ".rightof = [";
+    for (auto& v : rightof[blk]) {
+      os << names[v] << ", ";
     }
     os << "]\n";
   }
   
-  for (auto& [key, value] : map_blocks) {
-    os << key << ".aboveof = [";
-    for (auto& v : value.aboveof) {
-      os << v->name << ", ";
+  for (size_t blk = 0; blk < aboveof.size(); ++blk) {
+    os << names[blk] << ".aboveof = [";
+    for (auto& v : aboveof[blk]) {
+      os << names[v] << ", ";
     }
     os << "]\n";
   }
@@ -1185,12 +1908,12 @@ inline void SP::visualize() const {
             << "\"coordinates\":[";
   
   size_t blks = 0;
-  for (auto& [key, value] : map_blocks) {
-    std::cout << "{\"idx\":\"" << key << "\","
-              << "\"llx\":" << value.lower_left_x << ","
-              << "\"lly\":" << value.lower_left_y << ","
-              << "\"width\":" << value.width << ","
-              << "\"height\":" << value.height << "}";
+  for (size_t blk = 0; blk < num_blocks; ++blk) {
+    std::cout << "{\"idx\":\"" << names[blk] << "\","
+              << "\"llx\":" << lower_left_x[blk] << ","
+              << "\"lly\":" << lower_left_y[blk] << ","
+              << "\"width\":" << width[blk] << ","
+              << "\"height\":" << height[blk] << "}";
     if (blks++ < num_blocks-1) {
       std::cout << ",";
     }
@@ -1199,73 +1922,6 @@ inline void SP::visualize() const {
 }
 
 
-// dump backup SP data structure
-inline void SP::dump_backup(std::ostream& os) const {
-  os << "outline width = " << outline_width 
-     << ", outline height = " << outline_height
-     << ", num_blocks = " << num_blocks
-     << ", num_terminals = " << num_terminals << '\n';
-
-  for (auto& [key, value] : map_blocks) {
-    assert(key == value.name);
-    os << "Block " << value.name
-       << " has width : " << value.backup_width
-       << ", height : "   << value.backup_height
-       << ", lf.x : "     << value.backup_lower_left_x
-       << ", lf.y : "     << value.backup_lower_left_y
-       << ", ur.x : "     << (value.backup_lower_left_x + value.backup_width)
-       << ", ur.y : "     << (value.backup_lower_left_y + value.backup_height)
-       << '\n';
-    assert(value.backup_width == value.width);
-    assert(value.backup_height == value.height);
-    assert(value.backup_lower_left_x == value.lower_left_x);
-    assert(value.backup_lower_left_y == value.lower_left_y);
-    assert(value.backup_idx_positive_sequence == value.idx_positive_sequence);
-    assert(value.backup_idx_negative_sequence == value.idx_negative_sequence);
-  }
-
-  assert(positive_sequence == backup_positive_sequence);
-  os << "Backup positive sequence : ";
-  for (auto& ps : backup_positive_sequence) {
-    os << ps->name << ' '; 
-  }
-  os << '\n';
-  
-  assert(negative_sequence == backup_negative_sequence);
-  os << "Backup negative sequence : ";
-  for (auto& ns : backup_negative_sequence) {
-    os << ns->name << ' '; 
-  }
-  os << '\n';
-
-  os << "Backup relative Locations : \n";
-  for (auto& [key, value] : map_blocks) {
-    os << key << ".backup_rightof = [";
-    assert(value.backup_rightof == value.rightof);
-    for (auto& v : value.backup_rightof) {
-      os << v->name << ", ";
-    }
-    os << "]\n";
-  }
-  
-  for (auto& [key, value] : map_blocks) {
-    os << key << ".backup_aboveof = [";
-    assert(value.backup_aboveof == value.aboveof);
-    for (auto& v : value.backup_aboveof) {
-      os << v->name << ", ";
-    }
-    os << "]\n";
-  }
-
-  os << "Area = " << backup_bb_width 
-     << " * "     << backup_bb_height
-     << " = "     << backup_bb_width * backup_bb_height << '\n'; 
-  assert(backup_bb_width == bb_width);
-  assert(backup_bb_height == bb_height);
-  //visualize();
-}
-
-
 inline void SP::dump_solution() const {
   std::ofstream outFile(output_path, std::ios::out);
 
@@ -1282,22 +1938,22 @@ inline void SP::dump_solution() const {
   
   if ( ((outline_width >= outline_height) && (bb_width >= bb_height)) ||
        ((outline_width <= outline_height) && (bb_width <= bb_height)) ) {
-    for (auto& [key, value] : map_blocks) {
-      outFile << key << ' '
-              << value.lower_left_x << ' '
-              << value.lower_left_y << ' '
-              << value.lower_left_x + value.width  << ' '
-              << value.lower_left_y + value.height << '\n';   
+    for (size_t blk = 0; blk < num_blocks; ++blk) {
+      outFile << names[blk] << ' '
+              << lower_left_x[blk] << ' '
+              << lower_left_y[blk] << ' '
+              << lower_left_x[blk] + width[blk]  << ' '
+              << lower_left_y[blk] + height[blk] << '\n';   
     }
   }
  
   else { 
-    for (auto& [key, value] : map_blocks) {
-      outFile << key << ' '
-              << value.lower_left_y << ' '
-              << value.lower_left_x << ' '
-              << value.lower_left_y + value.height << ' '
-              << value.lower_left_x + value.width  << '\n';   
+    for (size_t blk = 0; blk < num_blocks; ++blk) {
+      outFile << names[blk] << ' '
+              << lower_left_y[blk] << ' '
+              << lower_left_x[blk] << ' '
+              << lower_left_y[blk] + height[blk] << ' '
+              << lower_left_x[blk] + width[blk]  << '\n';   
     }
   }
 }
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "sp.hpp"
+
+
+namespace fp {
+
+
+// speculative SA: the chain of one floorplan proposes and packs the next
+// num_threads moves at once, one per thread, each on its own copy of the
+// sequence pair, as if every earlier one were rejected
+//
+// the first candidate the chain accepts commits, every copy makes that
+// move, and the candidates after it are thrown away; as a rejected move
+// leaves no trace, the chain takes the same steps with the same
+// probabilities as SP::anneal, and the copies stay equal to it
+//
+// at high temperatures most moves are accepted and the batches commit
+// at their first candidate, so temperatures whose acceptance ratio was
+// above max_acceptance anneal one move at a time on the calling thread
+class SpeculativeAnnealer {
+public:
+  SpeculativeAnnealer(SP&, const std::string&, const std::string&);
+
+  ~SpeculativeAnnealer();
+
+  // candidates per batch, the floorplan itself and num_threads-1 copies
+  size_t num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  double max_acceptance = 0.3;
+
+  // filled in by anneal
+  size_t num_batches = 0;
+  size_t num_wasted = 0;
+
+  // the schedule of SP::run, with anneal in place of SP::anneal
+  void run();
+
+  // iterations moves of SA at the temperature, as SP::anneal
+  void anneal(const double, const size_t);
+
+private:
+  SP& sp;
+
+  std::string block_path;
+  std::string net_path;
+
+  // sp and its copies
+  std::vector<SP*> replicas;
+  std::vector<std::unique_ptr<SP>> copies;
+
+  // the copies miss moves sp made on its own
+  bool stale = true;
+
+  // acceptance ratio of the last call of anneal
+  double acceptance = 1.0;
+
+  // the batch every replica works on
+  struct Candidate {
+    Move move;
+    double cost = 0.0;
+    bool accepted = false;
+  };
+  std::vector<Candidate> candidates;
+  double temperature = 0.0;
+  size_t commit = 0;
+
+  // workers wait for the next phase of a batch, 1 for proposing
+  // and 2 for committing, and count themselves done
+  std::vector<std::thread> workers;
+  std::atomic<size_t> generation{0};
+  std::atomic<size_t> phase{0};
+  std::atomic<size_t> num_done{0};
+  std::atomic<bool> stopping{false};
+
+  void start_workers();
+
+  void work(const size_t);
+
+  void run_phase(const size_t);
+
+  void step(const size_t, const size_t);
+
+  void sync();
+};
+
+
+inline SpeculativeAnnealer::SpeculativeAnnealer(SP& floorplan,
+  const std::string& input_block_path, const std::string& input_net_path)
+  : sp(floorplan), block_path(input_block_path), net_path(input_net_path) {
+}
+
+
+inline SpeculativeAnnealer::~SpeculativeAnnealer() {
+  stopping = true;
+  ++generation;
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+
+inline void SpeculativeAnnealer::run() {
+  bool pass = false;
+
+  // first run
+  sp.start();
+  double current_temperature = sp.start_schedule();
+  stale = true;
+
+  do {
+    bool cooling = true;
+    while (cooling) {
+      anneal(current_temperature, sp.schedule_iterations);
+      cooling = sp.next_temperature(current_temperature, acceptance);
+    }
+
+    pass = sp.fits_outline();
+    if (pass == false) {
+      sp.penalty_ratio *= 2;
+      current_temperature = sp.start_schedule();
+      stale = true;
+    }
+  }
+  while(pass == false);
+}
+
+
+inline void SpeculativeAnnealer::anneal(const double current_temperature,
+  const size_t iterations) {
+
+  size_t num_accepted = sp.num_accepted;
+
+  if (num_threads <= 1 || acceptance > max_acceptance) {
+    sp.anneal(current_temperature, iterations);
+    stale = true;
+  }
+  else {
+    start_workers();
+    if (stale) {
+      sync();
+    }
+
+    temperature = current_temperature;
+    for (size_t ite = 0; ite < iterations; ) {
+      run_phase(1);
+      ++num_batches;
+
+      commit = replicas.size();
+      for (size_t w = 0; w < replicas.size(); ++w) {
+        if (candidates[w].accepted) {
+          commit = w;
+          break;
+        }
+      }
+
+      if (commit == replicas.size()) {
+        ite += replicas.size();
+      }
+      else {
+        run_phase(2);
+        ite += commit+1;
+        num_wasted += replicas.size()-commit-1;
+      }
+    }
+  }
+
+  acceptance = static_cast<double>(sp.num_accepted-num_accepted) /
+               std::max<size_t>(1, iterations);
+}
+
+
+inline void SpeculativeAnnealer::start_workers() {
+  if (!replicas.empty()) {
+    return;
+  }
+
+  replicas.push_back(&sp);
+  for (size_t t = 1; t < num_threads; ++t) {
+    copies.emplace_back(std::make_unique<SP>(sp.alpha, block_path, net_path, ""));
+    copies.back()->pack_engine = sp.pack_engine;
+    copies.back()->incremental = sp.incremental;
+    replicas.push_back(copies.back().get());
+  }
+  candidates.resize(replicas.size());
+
+  for (size_t t = 1; t < replicas.size(); ++t) {
+    workers.emplace_back(&SpeculativeAnnealer::work, this, t);
+  }
+}
+
+
+// worker t runs the phases of replica t until stopping
+inline void SpeculativeAnnealer::work(const size_t t) {
+  size_t seen = 0;
+  while (true) {
+    // batches follow each other within microseconds, but back off
+    // while sp anneals on its own
+    for (size_t spins = 0; 
+         generation.load(std::memory_order_acquire) == seen; ++spins) {
+      if (spins < 4096) {
+        std::this_thread::yield();
+      }
+      else {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+      }
+    }
+    ++seen;
+    if (stopping) {
+      return;
+    }
+    step(t, phase.load(std::memory_order_relaxed));
+    num_done.fetch_add(1, std::memory_order_acq_rel);
+  }
+}
+
+
+// every replica runs the phase, sp on the calling thread
+inline void SpeculativeAnnealer::run_phase(const size_t p) {
+  phase.store(p, std::memory_order_relaxed);
+  num_done.store(0, std::memory_order_relaxed);
+  generation.fetch_add(1, std::memory_order_release);
+
+  step(0, p);
+
+  while (num_done.load(std::memory_order_acquire) + 1 < replicas.size()) {
+    std::this_thread::yield();
+  }
+}
+
+
+inline void SpeculativeAnnealer::step(const size_t w, const size_t p) {
+  SP& replica = *replicas[w];
+  Candidate& candidate = candidates[w];
+
+  // propose a move and decide it as SP::anneal, a rejected
+  // one is undone at once and an accepted one waits
+  if (p == 1) {
+    candidate.move = replica.propose();
+    candidate.cost = replica.try_move(candidate.move);
+    candidate.accepted = replica.accept(candidate.cost, temperature);
+    if (!candidate.accepted) {
+      replica.undo(candidate.move);
+    }
+  }
+  // keep the committed move, everyone else makes it
+  else {
+    if (w == commit) {
+      replica.keep(candidate.move, candidate.cost);
+      return;
+    }
+    if (candidate.accepted) {
+      replica.undo(candidate.move);
+    }
+    const Candidate& committed = candidates[commit];
+    replica.apply_move(committed.move);
+    replica.try_move(committed.move);
+    replica.keep(committed.move, committed.cost);
+  }
+}
+
+
+// copy the sequence pair, the rotations and the counters of sp
+inline void SpeculativeAnnealer::sync() {
+  for (auto& copy : copies) {
+    // the copies read the same files, so the ids agree
+    copy->positive_sequence = sp.positive_sequence;
+    copy->negative_sequence = sp.negative_sequence;
+    copy->idx_positive_sequence = sp.idx_positive_sequence;
+    copy->idx_negative_sequence = sp.idx_negative_sequence;
+    copy->width = sp.width;
+    copy->height = sp.height;
+
+    copy->penalty_ratio = sp.penalty_ratio;
+    copy->num_iterations = sp.num_iterations-1;
+    copy->start();
+    copy->average_area = sp.average_area;
+    copy->average_length = sp.average_length;
+    copy->backup_cost = sp.backup_cost;
+    copy->num_accepted = sp.num_accepted;
+  }
+  stale = false;
+}
+
+
+} // end of namespace fp
@@ -0,0 +1,297 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "sp.hpp"
+
+
+namespace fp {
+
+
+// parallel tempering: replicas of one floorplan anneal at fixed
+// temperatures, from initial_temperature down to frozen_temperature
+// in a geometric ladder, on their own threads
+//
+// after every round of iterations_per_round moves per replica, the
+// replicas on neighbouring temperatures trade temperatures with the
+// replica-exchange probability min(1, exp((b_i-b_j)(E_i-E_j))), where
+// b = 1000/T matches the acceptance of SP::anneal and E is the cost of
+// a replica under the averages of the pair; trading temperatures
+// instead of floorplans keeps every SP where it is
+//
+// each replica keeps its best legal floorplan, and the run ends once
+// the best of all has not improved for patience rounds; while none is
+// legal, the penalty of every replica doubles every patience rounds
+//
+// the worker threads live as long as run and wait for every round,
+// the calling thread takes the share of worker 0
+class ParallelTempering {
+public:
+  ParallelTempering(double, const std::string&, const std::string&);
+
+  ~ParallelTempering();
+
+  size_t num_replicas = 8;
+
+  // replicas are spread over at most this many threads
+  size_t num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  double initial_temperature = 1000.0;
+
+  double frozen_temperature = 0.1;
+
+  size_t iterations_per_round = 3000;
+
+  size_t patience = 20;
+
+  // give up after this many seconds, 0 for no limit
+  double time_limit = 0.0;
+
+  // filled in by run
+  size_t num_rounds = 0;
+  size_t num_exchanges = 0;
+  double seconds_to_legal = -1.0;
+
+  // anneal until done and move the blocks of sp to the best legal
+  // floorplan, returns false if no replica found one
+  bool run(SP&);
+
+private:
+  double alpha;
+
+  std::string block_path;
+  std::string net_path;
+
+  std::vector<std::unique_ptr<SP>> replicas;
+
+  // replicas[slot[i]] anneals at temperatures[i]
+  std::vector<double> temperatures;
+  std::vector<size_t> slot;
+
+  // workers wait for round to change, and count themselves done
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable round_started;
+  std::condition_variable round_done;
+  size_t round = 0;
+  size_t num_done = 0;
+  bool stopping = false;
+
+  void start_workers();
+
+  void stop_workers();
+
+  void work(const size_t);
+
+  void anneal_share(const size_t);
+
+  void anneal_round();
+
+  void exchange(const size_t);
+
+  double energy(const SP&, const double, const double) const;
+};
+
+
+inline ParallelTempering::ParallelTempering(double a,
+  const std::string& input_block_path, const std::string& input_net_path)
+  : alpha(a), block_path(input_block_path), net_path(input_net_path) {
+}
+
+
+inline ParallelTempering::~ParallelTempering() {
+  stop_workers();
+}
+
+
+inline bool ParallelTempering::run(SP& sp) {
+  auto start = std::chrono::steady_clock::now();
+  auto seconds = [&start]() {
+    return std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  };
+
+  num_replicas = std::max<size_t>(1, num_replicas);
+  num_threads = std::max<size_t>(1, std::min(num_threads, num_replicas));
+
+  replicas.clear();
+  temperatures.clear();
+  slot.clear();
+  for (size_t i = 0; i < num_replicas; ++i) {
+    replicas.emplace_back(std::make_unique<SP>(alpha, block_path, net_path, ""));
+    replicas[i]->pack_engine = sp.pack_engine;
+    replicas[i]->incremental = sp.incremental;
+    replicas[i]->keep_best = true;
+    replicas[i]->start();
+    if (replicas[i]->fits_outline()) {
+      replicas[i]->save_best();
+    }
+
+    double ratio = num_replicas == 1 ? 0.0 :
+                   static_cast<double>(i) / (num_replicas-1);
+    temperatures.push_back(
+      frozen_temperature * std::pow(initial_temperature/frozen_temperature, ratio));
+    slot.push_back(i);
+  }
+
+  double best_cost = DBL_MAX;
+  size_t best = 0;
+  size_t stale_rounds = 0;
+  num_rounds = 0;
+  num_exchanges = 0;
+  seconds_to_legal = -1.0;
+
+  start_workers();
+
+  while (stale_rounds < patience || best_cost == DBL_MAX) {
+    if (time_limit > 0 && seconds() > time_limit) {
+      break;
+    }
+
+    anneal_round();
+    ++num_rounds;
+
+    // even and odd neighbours by turns
+    for (size_t i = num_rounds%2; i+1 < num_replicas; i += 2) {
+      exchange(i);
+    }
+
+    ++stale_rounds;
+    for (size_t i = 0; i < num_replicas; ++i) {
+      if (replicas[i]->best_cost < best_cost) {
+        if (best_cost == DBL_MAX) {
+          seconds_to_legal = seconds();
+        }
+        best_cost = replicas[i]->best_cost;
+        best = i;
+        stale_rounds = 0;
+      }
+    }
+
+    if (best_cost == DBL_MAX && stale_rounds == patience) {
+      for (auto& replica : replicas) {
+        replica->penalty_ratio *= 2;
+        replica->backup_cost = energy(*replica, replica->average_area,
+                                      replica->average_length);
+      }
+      stale_rounds = 0;
+    }
+  }
+
+  stop_workers();
+  if (best_cost == DBL_MAX) {
+    return false;
+  }
+  sp.load_best(*replicas[best]);
+  return true;
+}
+
+
+inline void ParallelTempering::start_workers() {
+  stop_workers();
+  round = 0;
+  for (size_t t = 1; t < num_threads; ++t) {
+    workers.emplace_back(&ParallelTempering::work, this, t);
+  }
+}
+
+
+inline void ParallelTempering::stop_workers() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  round_started.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  workers.clear();
+  stopping = false;
+}
+
+
+// worker t anneals its share of every round until stopping
+inline void ParallelTempering::work(const size_t t) {
+  size_t seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      round_started.wait(lock, [&]() { return stopping || round != seen; });
+      if (stopping) {
+        return;
+      }
+      seen = round;
+    }
+
+    anneal_share(t);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (++num_done + 1 == num_threads) {
+      round_done.notify_one();
+    }
+  }
+}
+
+
+// thread t takes the replicas t, t+num_threads, ...
+inline void ParallelTempering::anneal_share(const size_t t) {
+  for (size_t i = t; i < num_replicas; i += num_threads) {
+    replicas[slot[i]]->anneal(temperatures[i], iterations_per_round);
+  }
+}
+
+
+// every replica anneals iterations_per_round moves at its temperature
+inline void ParallelTempering::anneal_round() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++round;
+    num_done = 0;
+  }
+  round_started.notify_all();
+
+  anneal_share(0);
+
+  std::unique_lock<std::mutex> lock(mutex);
+  round_done.wait(lock, [this]() { return num_done + 1 == num_threads; });
+}
+
+
+// trade the temperatures of slots i and i+1 with the replica-exchange
+// probability
+inline void ParallelTempering::exchange(const size_t i) {
+  SP& a = *replicas[slot[i]];
+  SP& b = *replicas[slot[i+1]];
+
+  double average_area = (a.average_area + b.average_area) / 2;
+  double average_length = (a.average_length + b.average_length) / 2;
+
+  double exponent = (1000/temperatures[i] - 1000/temperatures[i+1]) *
+                    (energy(a, average_area, average_length) - 
+                     energy(b, average_area, average_length));
+  if (exponent >= 0 ||
+      std::exp(exponent) > static_cast<double>(random_value())/max_dist) {
+    std::swap(slot[i], slot[i+1]);
+    ++num_exchanges;
+  }
+}
+
+
+// cost of the backed up floorplan of sp under the given averages
+inline double ParallelTempering::energy(const SP& sp, 
+  const double average_area, const double average_length) const {
+
+  int overshoot_length = sp.penalty_ratio*(sp.excess_width + sp.excess_height);
+  return alpha*sp.bb_width*sp.bb_height/average_area +
+         (1-alpha)*(sp.hpwl + overshoot_length)/average_length;
+}
+
+
+} // end of namespace fp
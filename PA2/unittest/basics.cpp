@@ -5,13 +5,23 @@
 #include <doctest.h>
 #include <string>
 #include <unordered_map>
-#include <variant>
 #include <list>
 #include <iterator>
 #include <set>
 #include "sp.hpp"
+#include "tempering.hpp"
+#include "speculative.hpp"
+#include <fstream>
+#include <cstdio>
 #include <algorithm>
 #include <climits>
+#include <filesystem>
+
+// the tests write their scratch files to the temporary directory,
+// not to the directory ctest runs in
+std::string scratch(const std::string& name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
 
 
 /*
@@ -49,34 +59,10 @@ public:
   SPTest() {
     alpha = 0.6;
 
-    Block b1;
-    Block b2;
-    Block b3;
-    Block b4;
-    Block b5;
-    
     Terminal t1;
     Terminal t2;
     Terminal t3;
     
-    Net n;
-    
-    b1.name = "bk1";
-    b2.name = "bk2";
-    b3.name = "bk3";
-    b4.name = "bk4";
-    b5.name = "bk5";
-    b1.width  = 200;
-    b1.height = 200;    
-    b2.width  = 600;
-    b2.height = 600;    
-    b3.width  = 400;
-    b3.height = 200;    
-    b4.width  = 400;
-    b4.height = 400;
-    b5.width  = 200;
-    b5.height = 400;
-   
     t1.name = "VSS";
     t2.name = "VDD";
     t3.name = "P9";
@@ -91,36 +77,74 @@ public:
     num_terminals = 3;
     num_nets = 1;
 
-    map_blocks[b1.name] = b1;
-    map_blocks[b2.name] = b2;
-    map_blocks[b3.name] = b3;
-    map_blocks[b4.name] = b4;
-    map_blocks[b5.name] = b5;
+    add_block("bk1", 200, 200);
+    add_block("bk2", 600, 600);
+    add_block("bk3", 400, 200);
+    add_block("bk4", 400, 400);
+    add_block("bk5", 200, 400);
 
     map_terminals[t1.name] = t1;
     map_terminals[t2.name] = t2;
     map_terminals[t3.name] = t3;
     
-    std::variant<Block*, Terminal*> v1 = &(map_blocks["bk1"]);
-    std::variant<Block*, Terminal*> v2 = &(map_blocks["bk2"]);
-    std::variant<Block*, Terminal*> v3 = &(map_blocks["bk3"]);
-    std::variant<Block*, Terminal*> v4 = &(map_blocks["bk4"]);
-    n.net.emplace_back(v1);
-    n.net.emplace_back(v2);
-    n.net.emplace_back(v3);
-    n.net.emplace_back(v4);
-    
-    vec_nets.emplace_back(n);
+    add_net({"bk1", "bk2", "bk3", "bk4"});
 
     outline_width  = 600;
     outline_height = 1200;
-  
-    source.name = "source";
-    terminus.name = "terminus";  
   }
 };
 
 
+// a copy of the blocks, sequences and bounding box of a floorplan,
+// to hold it against after moves are kept or undone
+class Backup {
+public:
+  Backup(const SP& sp) : 
+    lower_left_x(sp.lower_left_x), lower_left_y(sp.lower_left_y),
+    width(sp.width), height(sp.height),
+    idx_positive_sequence(sp.idx_positive_sequence),
+    idx_negative_sequence(sp.idx_negative_sequence),
+    rightof(sp.rightof), aboveof(sp.aboveof),
+    positive_sequence(sp.positive_sequence),
+    negative_sequence(sp.negative_sequence),
+    bb_width(sp.bb_width), bb_height(sp.bb_height), hpwl(sp.hpwl) {
+  }
+
+  std::vector<size_t> lower_left_x;
+  std::vector<size_t> lower_left_y;
+  std::vector<size_t> width;
+  std::vector<size_t> height;
+  std::vector<int> idx_positive_sequence;
+  std::vector<int> idx_negative_sequence;
+  std::vector<std::vector<size_t>> rightof;
+  std::vector<std::vector<size_t>> aboveof;
+  std::vector<size_t> positive_sequence;
+  std::vector<size_t> negative_sequence;
+  int bb_width;
+  int bb_height;
+  int hpwl;
+};
+
+
+// make, pack and undo one more move, which leaves sptest
+// as it was last backed up
+void undo_next_move(SPTest& sptest) {
+  Move move = sptest.propose();
+  sptest.construct_relative_locations(move.id1, move.id2, move.type);
+
+  std::vector<int> distance = sptest.weighted_lcs(Orientation::Horizontal);
+  sptest.compute_block_locations(distance, Orientation::Horizontal);
+  sptest.compute_area(distance, sptest.bb_width, Orientation::Horizontal);
+
+  distance = sptest.weighted_lcs(Orientation::Vertical);
+  sptest.compute_block_locations(distance, Orientation::Vertical);
+  sptest.compute_area(distance, sptest.bb_height, Orientation::Vertical);
+  sptest.hpwl = sptest.compute_hpwl()/2;
+
+  sptest.resume_backup_data(move.id1, move.id2, move.type);
+}
+
+
 // verify the initialization of positive and negative sequences
 TEST_CASE("verify_initialize_sequence" * doctest::timeout(600)) {
   SPTest sptest;
@@ -136,8 +160,8 @@ TEST_CASE("verify_initialize_sequence" * doctest::timeout(600)) {
   size_t index = 0;
   // check positive_sequence
   for (auto& sq : sptest.positive_sequence) {
-    REQUIRE(sq->idx_positive_sequence == index++);
-    blocks.push_back(sq->name);
+    REQUIRE(sptest.idx_positive_sequence[sq] == index++);
+    blocks.push_back(sptest.names[sq]);
   }
 
   std::vector<std::string>::iterator it;
@@ -154,8 +178,8 @@ TEST_CASE("verify_initialize_sequence" * doctest::timeout(600)) {
   // check negative_sequence
   index = 0;
   for (auto& sq : sptest.negative_sequence) {
-    REQUIRE(sq->idx_negative_sequence == index++);
-    blocks.push_back(sq->name);
+    REQUIRE(sptest.idx_negative_sequence[sq] == index++);
+    blocks.push_back(sptest.names[sq]);
   }
 
   for (it = blocks.begin(); it != blocks.end();) {
@@ -175,93 +199,93 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
   SPTest sptest;
   sptest.initialize_sequence();
 
-  sptest.source.rightof.clear();
-  sptest.terminus.rightof.clear();
-  sptest.map_blocks["bk1"].rightof.clear();
-  sptest.map_blocks["bk2"].rightof.clear();
-  sptest.map_blocks["bk3"].rightof.clear();
-  sptest.map_blocks["bk4"].rightof.clear();
-  sptest.map_blocks["bk5"].rightof.clear();
-
-  sptest.source.aboveof.clear();
-  sptest.terminus.aboveof.clear();
-  sptest.map_blocks["bk1"].aboveof.clear();
-  sptest.map_blocks["bk2"].aboveof.clear();
-  sptest.map_blocks["bk3"].aboveof.clear();
-  sptest.map_blocks["bk4"].aboveof.clear();
-  sptest.map_blocks["bk5"].aboveof.clear();
+  sptest.rightof[sptest.source].clear();
+  sptest.rightof[sptest.terminus].clear();
+  sptest.rightof[sptest.map_blocks["bk1"]].clear();
+  sptest.rightof[sptest.map_blocks["bk2"]].clear();
+  sptest.rightof[sptest.map_blocks["bk3"]].clear();
+  sptest.rightof[sptest.map_blocks["bk4"]].clear();
+  sptest.rightof[sptest.map_blocks["bk5"]].clear();
+
+  sptest.aboveof[sptest.source].clear();
+  sptest.aboveof[sptest.terminus].clear();
+  sptest.aboveof[sptest.map_blocks["bk1"]].clear();
+  sptest.aboveof[sptest.map_blocks["bk2"]].clear();
+  sptest.aboveof[sptest.map_blocks["bk3"]].clear();
+  sptest.aboveof[sptest.map_blocks["bk4"]].clear();
+  sptest.aboveof[sptest.map_blocks["bk5"]].clear();
   
   // positive sequence = [bk1, bk2, bk3, bk4, bk5]
   // negative sequence = [bk1, bk2, bk3, bk4, bk5]
   SUBCASE("SUB : case 1 with nomove") { 
-    sptest.positive_sequence[0] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_positive_sequence = 0;
-    sptest.positive_sequence[1] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_positive_sequence = 1;
-    sptest.positive_sequence[2] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_positive_sequence = 2;
-    sptest.positive_sequence[3] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_positive_sequence = 3;
-    sptest.positive_sequence[4] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_positive_sequence = 4;
+    sptest.positive_sequence[0] = sptest.map_blocks["bk1"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk1"]] = 0;
+    sptest.positive_sequence[1] = sptest.map_blocks["bk2"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk2"]] = 1;
+    sptest.positive_sequence[2] = sptest.map_blocks["bk3"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk3"]] = 2;
+    sptest.positive_sequence[3] = sptest.map_blocks["bk4"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk4"]] = 3;
+    sptest.positive_sequence[4] = sptest.map_blocks["bk5"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk5"]] = 4;
     
-    sptest.negative_sequence[0] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_negative_sequence = 0;
-    sptest.negative_sequence[1] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_negative_sequence = 1;
-    sptest.negative_sequence[2] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_negative_sequence = 2;
-    sptest.negative_sequence[3] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_negative_sequence = 3;
-    sptest.negative_sequence[4] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_negative_sequence = 4;
+    sptest.negative_sequence[0] = sptest.map_blocks["bk1"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk1"]] = 0;
+    sptest.negative_sequence[1] = sptest.map_blocks["bk2"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk2"]] = 1;
+    sptest.negative_sequence[2] = sptest.map_blocks["bk3"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk3"]] = 2;
+    sptest.negative_sequence[3] = sptest.map_blocks["bk4"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk4"]] = 3;
+    sptest.negative_sequence[4] = sptest.map_blocks["bk5"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk5"]] = 4;
 
     sptest.construct_relative_locations(0, 4, MoveType::nomove);
   
     for (auto& [key1, value1] : sptest.map_blocks) {
       for (auto& [key2, value2] : sptest.map_blocks) {
         if (key1 != key2) {
-          REQUIRE(value1.aboveof.size() == 1);
-          REQUIRE(value1.aboveof[0] == &sptest.terminus);
+          REQUIRE(sptest.aboveof[value1].size() == 1);
+          REQUIRE(sptest.aboveof[value1][0] == sptest.terminus);
           
           auto found = std::find(
-            value1.rightof.begin(),
-            value1.rightof.end(),
-            &value2);
+            sptest.rightof[value1].begin(),
+            sptest.rightof[value1].end(),
+            value2);
           
           if (key1 == "bk1") {
-            REQUIRE(found != value1.rightof.end());
+            REQUIRE(found != sptest.rightof[value1].end());
           }
 
           else if (key1 == "bk2") {
             if (key2 == "bk1") {
-              REQUIRE(found == value1.rightof.end());
+              REQUIRE(found == sptest.rightof[value1].end());
             }
             else {
-              REQUIRE(found != value1.rightof.end());
+              REQUIRE(found != sptest.rightof[value1].end());
             }
           }
 
           else if (key1 == "bk3") {
             if (key2 == "bk1" || key2 == "bk2") {
-              REQUIRE(found == value1.rightof.end());
+              REQUIRE(found == sptest.rightof[value1].end());
             }
             else {
-              REQUIRE(found != value1.rightof.end());
+              REQUIRE(found != sptest.rightof[value1].end());
             }
           }
 
           else if (key1 == "bk4") {
             if (key2 == "bk5") {
-              REQUIRE(found != value1.rightof.end());
+              REQUIRE(found != sptest.rightof[value1].end());
             }
             else {
-              REQUIRE(found == value1.rightof.end());
+              REQUIRE(found == sptest.rightof[value1].end());
             }
           }
 
           else {
-            REQUIRE(found == value1.rightof.end());
+            REQUIRE(found == sptest.rightof[value1].end());
           }
         }
       }
@@ -270,60 +294,60 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     // check rightof and aboveof of source and teminus blocks
     for (auto& [key, value] : sptest.map_blocks) {
       auto found1 = std::find(
-        sptest.source.rightof.begin(),
-        sptest.source.rightof.end(),
-        &value
+        sptest.rightof[sptest.source].begin(),
+        sptest.rightof[sptest.source].end(),
+        value
       );
 
       auto found2 = std::find(
-        sptest.source.aboveof.begin(),
-        sptest.source.aboveof.end(),
-        &value
+        sptest.aboveof[sptest.source].begin(),
+        sptest.aboveof[sptest.source].end(),
+        value
       );
 
       auto found3 = std::find(
-        value.rightof.begin(),
-        value.rightof.end(),
-        &sptest.terminus
+        sptest.rightof[value].begin(),
+        sptest.rightof[value].end(),
+        sptest.terminus
       );
       
       auto found4 = std::find(
-        value.aboveof.begin(),
-        value.aboveof.end(),
-        &sptest.terminus
+        sptest.aboveof[value].begin(),
+        sptest.aboveof[value].end(),
+        sptest.terminus
       );
 
-      REQUIRE(found1 != sptest.source.rightof.end());
-      REQUIRE(found2 != sptest.source.aboveof.end());
-      REQUIRE(found3 != value.rightof.end());
-      REQUIRE(found4 != value.aboveof.end());
+      REQUIRE(found1 != sptest.rightof[sptest.source].end());
+      REQUIRE(found2 != sptest.aboveof[sptest.source].end());
+      REQUIRE(found3 != sptest.rightof[value].end());
+      REQUIRE(found4 != sptest.aboveof[value].end());
     }
-    REQUIRE(sptest.terminus.rightof.size() == 0);
-    REQUIRE(sptest.terminus.aboveof.size() == 0);
+    REQUIRE(sptest.rightof[sptest.terminus].size() == 0);
+    REQUIRE(sptest.aboveof[sptest.terminus].size() == 0);
   } 
 
   SUBCASE("SUB : case 1 with move1") { 
-    sptest.positive_sequence[0] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_positive_sequence = 0;
-    sptest.positive_sequence[1] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_positive_sequence = 1;
-    sptest.positive_sequence[2] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_positive_sequence = 2;
-    sptest.positive_sequence[3] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_positive_sequence = 3;
-    sptest.positive_sequence[4] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_positive_sequence = 4;
+    sptest.positive_sequence[0] = sptest.map_blocks["bk1"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk1"]] = 0;
+    sptest.positive_sequence[1] = sptest.map_blocks["bk2"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk2"]] = 1;
+    sptest.positive_sequence[2] = sptest.map_blocks["bk3"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk3"]] = 2;
+    sptest.positive_sequence[3] = sptest.map_blocks["bk4"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk4"]] = 3;
+    sptest.positive_sequence[4] = sptest.map_blocks["bk5"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk5"]] = 4;
     
-    sptest.negative_sequence[0] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_negative_sequence = 0;
-    sptest.negative_sequence[1] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_negative_sequence = 1;
-    sptest.negative_sequence[2] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_negative_sequence = 2;
-    sptest.negative_sequence[3] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_negative_sequence = 3;
-    sptest.negative_sequence[4] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_negative_sequence = 4;
+    sptest.negative_sequence[0] = sptest.map_blocks["bk1"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk1"]] = 0;
+    sptest.negative_sequence[1] = sptest.map_blocks["bk2"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk2"]] = 1;
+    sptest.negative_sequence[2] = sptest.map_blocks["bk3"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk3"]] = 2;
+    sptest.negative_sequence[3] = sptest.map_blocks["bk4"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk4"]] = 3;
+    sptest.negative_sequence[4] = sptest.map_blocks["bk5"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk5"]] = 4;
 
     sptest.construct_relative_locations(0, 4, MoveType::nomove);
   
@@ -336,114 +360,114 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
       MoveType::move1
     );
    
-    REQUIRE(sptest.source.rightof.size() == 5);
-    REQUIRE(sptest.source.aboveof.size() == 5);
+    REQUIRE(sptest.rightof[sptest.source].size() == 5);
+    REQUIRE(sptest.aboveof[sptest.source].size() == 5);
     
     if (pair_idx.first == 0 && pair_idx.second == 1) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");  
-            REQUIRE(blk->name != "bk2");  
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");  
+            REQUIRE(sptest.names[blk] != "bk2");  
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
 
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk2");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk2");
         }
         else if (key == "bk2") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");  
-            REQUIRE(blk->name != "bk2");  
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");  
+            REQUIRE(sptest.names[blk] != "bk2");  
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
           
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
         else if (key == "bk3") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1"); 
-            REQUIRE(blk->name != "bk2"); 
-            REQUIRE(blk->name != "bk3"); 
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1"); 
+            REQUIRE(sptest.names[blk] != "bk2"); 
+            REQUIRE(sptest.names[blk] != "bk3"); 
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
         else if (key == "bk4") {
-          REQUIRE(value.rightof[0]->name == "bk5");
-          REQUIRE(value.rightof.size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk5");
+          REQUIRE(sptest.rightof[value].size() == 2);
           
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
       }
     }
     else if (pair_idx.first == 0 && pair_idx.second == 2) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk2");
-            REQUIRE(blk->name != "bk3");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk2");
+            REQUIRE(sptest.names[blk] != "bk3");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
           
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk4");
-            REQUIRE(blk->name != "bk5");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk4");
+            REQUIRE(sptest.names[blk] != "bk5");
           }
-          REQUIRE(value.aboveof.size() == 3);
+          REQUIRE(sptest.aboveof[value].size() == 3);
         }
 
         else if (key == "bk2") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk2");
-            REQUIRE(blk->name != "bk3");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk2");
+            REQUIRE(sptest.names[blk] != "bk3");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
         
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk3");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk3");
         }
 
         else if (key == "bk3") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk2");
-            REQUIRE(blk->name != "bk3");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk2");
+            REQUIRE(sptest.names[blk] != "bk3");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
           
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof[0]->name == "bk5");
-          REQUIRE(value.rightof.size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk5");
+          REQUIRE(sptest.rightof[value].size() == 2);
           
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
           
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
       }
     }
@@ -451,50 +475,50 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 0 && pair_idx.second == 3) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          REQUIRE(value.rightof.size() == 2);
-          REQUIRE(value.rightof[0]->name == "bk5");
+          REQUIRE(sptest.rightof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk5");
 
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk5");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk5");
           }
-          REQUIRE(value.aboveof.size() == 4);
+          REQUIRE(sptest.aboveof[value].size() == 4);
         }
         
         else if (key == "bk2") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk2");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk2");
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
         
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk4");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk4");
         }
 
         else if (key == "bk3") {
-          REQUIRE(value.rightof.size() == 2);
-          REQUIRE(value.rightof[0]->name == "bk5");
+          REQUIRE(sptest.rightof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk5");
 
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk4");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk4");
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 2);
-          REQUIRE(value.rightof[0]->name == "bk5");
+          REQUIRE(sptest.rightof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk5");
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
       }
     }
@@ -502,49 +526,49 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 0 && pair_idx.second == 4) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk1");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
           }
-          REQUIRE(value.aboveof.size() == 5);
+          REQUIRE(sptest.aboveof[value].size() == 5);
         }
 
         else if (key == "bk2") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk2");
-            REQUIRE(blk->name != "bk5");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk2");
+            REQUIRE(sptest.names[blk] != "bk5");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
         
-          REQUIRE(value.aboveof[0]->name == "bk5");
-          REQUIRE(value.aboveof.size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk5");
+          REQUIRE(sptest.aboveof[value].size() == 2);
         }
 
         else if (key == "bk3") {
-          REQUIRE(value.rightof[0]->name == "bk4");
-          REQUIRE(value.rightof.size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk4");
+          REQUIRE(sptest.rightof[value].size() == 2);
 
-          REQUIRE(value.aboveof[0]->name == "bk5");
-          REQUIRE(value.aboveof.size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk5");
+          REQUIRE(sptest.aboveof[value].size() == 2);
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof[0]->name == "terminus");
-          REQUIRE(value.rightof.size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
 
-          REQUIRE(value.aboveof[0]->name == "bk5");
-          REQUIRE(value.aboveof.size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk5");
+          REQUIRE(sptest.aboveof[value].size() == 2);
         }
 
         else {
-          REQUIRE(value.rightof[0]->name == "terminus");
-          REQUIRE(value.rightof.size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
           
-          REQUIRE(value.aboveof[0]->name == "terminus");
-          REQUIRE(value.aboveof.size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
         }
       }
     }
@@ -552,53 +576,53 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 1 && pair_idx.second == 2) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
           }
-          REQUIRE(value.rightof.size() == 5);
+          REQUIRE(sptest.rightof[value].size() == 5);
         
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk2");
-            REQUIRE(blk->name != "bk3");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk2");
+            REQUIRE(sptest.names[blk] != "bk3");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
         
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk3");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk3");
         }
 
         else if (key == "bk3") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk2");
-            REQUIRE(blk->name != "bk3");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk2");
+            REQUIRE(sptest.names[blk] != "bk3");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
          
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus"); 
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus"); 
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof[0]->name == "bk5");
-          REQUIRE(value.rightof.size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk5");
+          REQUIRE(sptest.rightof[value].size() == 2);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus"); 
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus"); 
         }
 
         else {
-          REQUIRE(value.rightof[0]->name == "terminus");
-          REQUIRE(value.rightof.size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus"); 
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus"); 
         }
       }
     }
@@ -606,49 +630,49 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 1 && pair_idx.second == 3) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
           }
-          REQUIRE(value.rightof.size() == 5);
+          REQUIRE(sptest.rightof[value].size() == 5);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          REQUIRE(value.rightof.size() == 2);
-          REQUIRE(value.rightof[0]->name == "bk5");
+          REQUIRE(sptest.rightof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk5");
         
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk1"); 
-            REQUIRE(blk->name != "bk2"); 
-            REQUIRE(blk->name != "bk5"); 
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1"); 
+            REQUIRE(sptest.names[blk] != "bk2"); 
+            REQUIRE(sptest.names[blk] != "bk5"); 
           }
-          REQUIRE(value.aboveof.size() == 3);
+          REQUIRE(sptest.aboveof[value].size() == 3);
         }
 
         else if (key == "bk3") {
-          REQUIRE(value.rightof.size() == 2);
-          REQUIRE(value.rightof[0]->name == "bk5");
+          REQUIRE(sptest.rightof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk5");
           
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk4");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk4");
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 2);
-          REQUIRE(value.rightof[0]->name == "bk5");
+          REQUIRE(sptest.rightof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk5");
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
       }
     }
@@ -656,48 +680,48 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 1 && pair_idx.second == 4) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1")  {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
           }
-          REQUIRE(value.rightof.size() == 5);
+          REQUIRE(sptest.rightof[value].size() == 5);
         
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
          
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk2");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk2");
           }
-          REQUIRE(value.aboveof.size() == 4);
+          REQUIRE(sptest.aboveof[value].size() == 4);
         }
 
         else if (key == "bk3") {
-          REQUIRE(value.rightof.size() == 2);
-          REQUIRE(value.rightof[0]->name == "bk4");
+          REQUIRE(sptest.rightof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk4");
         
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk5");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk5");
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk5");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk5");
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
       }
     }
@@ -705,48 +729,48 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 2 && pair_idx.second == 3) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
           }
-          REQUIRE(value.rightof.size() == 5);
+          REQUIRE(sptest.rightof[value].size() == 5);
         
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk2");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk2");
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
          
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk3") {
-          REQUIRE(value.rightof.size() == 2);
-          REQUIRE(value.rightof[0]->name == "bk5");
+          REQUIRE(sptest.rightof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk5");
         
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk4");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk4");
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 2);
-          REQUIRE(value.rightof[0]->name == "bk5");
+          REQUIRE(sptest.rightof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk5");
          
-          REQUIRE(value.aboveof.size() == 1); 
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1); 
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1); 
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1); 
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
           
-          REQUIRE(value.aboveof.size() == 1); 
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1); 
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
       }
     }
@@ -754,52 +778,52 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 2 && pair_idx.second == 4) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
           }
-          REQUIRE(value.rightof.size() == 5);
+          REQUIRE(sptest.rightof[value].size() == 5);
         
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk2");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk2");
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
         
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk3") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
           
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk2");
-            REQUIRE(blk->name != "bk3");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk2");
+            REQUIRE(sptest.names[blk] != "bk3");
           }
-          REQUIRE(value.aboveof.size() == 3);
+          REQUIRE(sptest.aboveof[value].size() == 3);
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
     
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk5");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk5");
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
     
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
       }
     }
@@ -807,52 +831,52 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 3 && pair_idx.second == 4) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
           }
-          REQUIRE(value.rightof.size() == 5);
+          REQUIRE(sptest.rightof[value].size() == 5);
         
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk2");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk2");
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
         
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk3") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk2");
-            REQUIRE(blk->name != "bk3");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk2");
+            REQUIRE(sptest.names[blk] != "bk3");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
     
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
           
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk5");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk5");
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
           
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
       }
     }
@@ -861,27 +885,27 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
   // positive sequence = [bk1, bk3, bk2, bk5, bk4]
   // negative sequence = [bk4, bk1, bk3, bk5, bk2]
   SUBCASE("SUB : case 2 with nomove") { 
-    sptest.positive_sequence[0] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_positive_sequence = 0;
-    sptest.positive_sequence[1] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_positive_sequence = 1;
-    sptest.positive_sequence[2] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_positive_sequence = 2;
-    sptest.positive_sequence[3] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_positive_sequence = 3;
-    sptest.positive_sequence[4] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_positive_sequence = 4;
+    sptest.positive_sequence[0] = sptest.map_blocks["bk1"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk1"]] = 0;
+    sptest.positive_sequence[1] = sptest.map_blocks["bk3"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk3"]] = 1;
+    sptest.positive_sequence[2] = sptest.map_blocks["bk2"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk2"]] = 2;
+    sptest.positive_sequence[3] = sptest.map_blocks["bk5"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk5"]] = 3;
+    sptest.positive_sequence[4] = sptest.map_blocks["bk4"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk4"]] = 4;
     
-    sptest.negative_sequence[0] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_negative_sequence = 0;
-    sptest.negative_sequence[1] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_negative_sequence = 1;
-    sptest.negative_sequence[2] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_negative_sequence = 2;
-    sptest.negative_sequence[3] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_negative_sequence = 3;
-    sptest.negative_sequence[4] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_negative_sequence = 4;
+    sptest.negative_sequence[0] = sptest.map_blocks["bk4"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk4"]] = 0;
+    sptest.negative_sequence[1] = sptest.map_blocks["bk1"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk1"]] = 1;
+    sptest.negative_sequence[2] = sptest.map_blocks["bk3"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk3"]] = 2;
+    sptest.negative_sequence[3] = sptest.map_blocks["bk5"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk5"]] = 3;
+    sptest.negative_sequence[4] = sptest.map_blocks["bk2"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk2"]] = 4;
 
     sptest.construct_relative_locations(0, 4, MoveType::nomove);
   
@@ -889,53 +913,53 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
       for (auto& [key2, value2] : sptest.map_blocks) {
         if (key1 != key2) {
           auto found1 = std::find(
-            value1.rightof.begin(),
-            value1.rightof.end(),
-            &value2);
+            sptest.rightof[value1].begin(),
+            sptest.rightof[value1].end(),
+            value2);
           
           auto found2 = std::find(
-            value1.aboveof.begin(),
-            value1.aboveof.end(),
-            &value2);
+            sptest.aboveof[value1].begin(),
+            sptest.aboveof[value1].end(),
+            value2);
           
           if (key1 == "bk1") {
-            REQUIRE(found2 == value1.aboveof.end());
+            REQUIRE(found2 == sptest.aboveof[value1].end());
             if (key2 == "bk4") {
-              REQUIRE(found1 == value1.rightof.end());
+              REQUIRE(found1 == sptest.rightof[value1].end());
             }
             else {
-              REQUIRE(found1 != value1.rightof.end());
+              REQUIRE(found1 != sptest.rightof[value1].end());
             }
           }
 
           else if (key1 == "bk2") {
-            REQUIRE(found2 == value1.aboveof.end());
-            REQUIRE(found1 == value1.rightof.end());
+            REQUIRE(found2 == sptest.aboveof[value1].end());
+            REQUIRE(found1 == sptest.rightof[value1].end());
           }
 
           else if (key1 == "bk3") {
-            REQUIRE(found2 == value1.aboveof.end());
+            REQUIRE(found2 == sptest.aboveof[value1].end());
             if (key2 == "bk2" || key2 == "bk5") {
-              REQUIRE(found1 != value1.rightof.end());
+              REQUIRE(found1 != sptest.rightof[value1].end());
             }
             else {
-              REQUIRE(found1 == value1.rightof.end());
+              REQUIRE(found1 == sptest.rightof[value1].end());
             }
           }
 
           else if (key1 == "bk4") {
-            REQUIRE(found1 == value1.rightof.end());
-            REQUIRE(found2 != value1.aboveof.end());
+            REQUIRE(found1 == sptest.rightof[value1].end());
+            REQUIRE(found2 != sptest.aboveof[value1].end());
           }
 
           else {
             if (key2 == "bk2") {
-              REQUIRE(found2 != value1.aboveof.end());
+              REQUIRE(found2 != sptest.aboveof[value1].end());
             }
             else {
-              REQUIRE(found2 == value1.aboveof.end());
+              REQUIRE(found2 == sptest.aboveof[value1].end());
             }
-            REQUIRE(found1 == value1.rightof.end());
+            REQUIRE(found1 == sptest.rightof[value1].end());
           }
         }
       }
@@ -943,60 +967,60 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     // check rightof and aboveof of source and teminus blocks
     for (auto& [key, value] : sptest.map_blocks) {
       auto found1 = std::find(
-        sptest.source.rightof.begin(),
-        sptest.source.rightof.end(),
-        &value
+        sptest.rightof[sptest.source].begin(),
+        sptest.rightof[sptest.source].end(),
+        value
       );
 
       auto found2 = std::find(
-        sptest.source.aboveof.begin(),
-        sptest.source.aboveof.end(),
-        &value
+        sptest.aboveof[sptest.source].begin(),
+        sptest.aboveof[sptest.source].end(),
+        value
       );
 
       auto found3 = std::find(
-        value.rightof.begin(),
-        value.rightof.end(),
-        &sptest.terminus
+        sptest.rightof[value].begin(),
+        sptest.rightof[value].end(),
+        sptest.terminus
       );
       
       auto found4 = std::find(
-        value.aboveof.begin(),
-        value.aboveof.end(),
-        &sptest.terminus
+        sptest.aboveof[value].begin(),
+        sptest.aboveof[value].end(),
+        sptest.terminus
       );
 
-      REQUIRE(found1 != sptest.source.rightof.end());
-      REQUIRE(found2 != sptest.source.aboveof.end());
-      REQUIRE(found3 != value.rightof.end());
-      REQUIRE(found4 != value.aboveof.end());
+      REQUIRE(found1 != sptest.rightof[sptest.source].end());
+      REQUIRE(found2 != sptest.aboveof[sptest.source].end());
+      REQUIRE(found3 != sptest.rightof[value].end());
+      REQUIRE(found4 != sptest.aboveof[value].end());
     }
-    REQUIRE(sptest.terminus.rightof.size() == 0);
-    REQUIRE(sptest.terminus.aboveof.size() == 0);
+    REQUIRE(sptest.rightof[sptest.terminus].size() == 0);
+    REQUIRE(sptest.aboveof[sptest.terminus].size() == 0);
   }
   
   SUBCASE("SUB : case 2 with move2") { 
-    sptest.positive_sequence[0] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_positive_sequence = 0;
-    sptest.positive_sequence[1] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_positive_sequence = 1;
-    sptest.positive_sequence[2] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_positive_sequence = 2;
-    sptest.positive_sequence[3] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_positive_sequence = 3;
-    sptest.positive_sequence[4] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_positive_sequence = 4;
+    sptest.positive_sequence[0] = sptest.map_blocks["bk1"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk1"]] = 0;
+    sptest.positive_sequence[1] = sptest.map_blocks["bk3"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk3"]] = 1;
+    sptest.positive_sequence[2] = sptest.map_blocks["bk2"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk2"]] = 2;
+    sptest.positive_sequence[3] = sptest.map_blocks["bk5"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk5"]] = 3;
+    sptest.positive_sequence[4] = sptest.map_blocks["bk4"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk4"]] = 4;
     
-    sptest.negative_sequence[0] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_negative_sequence = 0;
-    sptest.negative_sequence[1] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_negative_sequence = 1;
-    sptest.negative_sequence[2] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_negative_sequence = 2;
-    sptest.negative_sequence[3] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_negative_sequence = 3;
-    sptest.negative_sequence[4] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_negative_sequence = 4;
+    sptest.negative_sequence[0] = sptest.map_blocks["bk4"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk4"]] = 0;
+    sptest.negative_sequence[1] = sptest.map_blocks["bk1"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk1"]] = 1;
+    sptest.negative_sequence[2] = sptest.map_blocks["bk3"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk3"]] = 2;
+    sptest.negative_sequence[3] = sptest.map_blocks["bk5"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk5"]] = 3;
+    sptest.negative_sequence[4] = sptest.map_blocks["bk2"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk2"]] = 4;
 
     sptest.construct_relative_locations(0, 4, MoveType::nomove);
     auto pair_idx = sptest.move2();
@@ -1008,58 +1032,58 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
       MoveType::move2
     );
    
-    REQUIRE(sptest.source.rightof.size() == 5);
-    REQUIRE(sptest.source.aboveof.size() == 5);
+    REQUIRE(sptest.rightof[sptest.source].size() == 5);
+    REQUIRE(sptest.aboveof[sptest.source].size() == 5);
     
     if (pair_idx.first == 0 && pair_idx.second == 1) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
           }
-          REQUIRE(value.rightof.size() == 5);
+          REQUIRE(sptest.rightof[value].size() == 5);
         
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
           
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk3") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk3");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk3");
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
           
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.aboveof.size() == 4);
+          REQUIRE(sptest.aboveof[value].size() == 4);
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
           
-          REQUIRE(value.aboveof[0]->name == "bk2");
-          REQUIRE(value.aboveof.size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk2");
+          REQUIRE(sptest.aboveof[value].size() == 2);
         }
       }
     }
@@ -1067,53 +1091,53 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 0 && pair_idx.second == 2) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk3");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk3");
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
           
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk3") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk3");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk3");
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
          
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk1"); 
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk1"); 
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
          
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk3");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk3");
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.aboveof.size() == 3);
+          REQUIRE(sptest.aboveof[value].size() == 3);
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk2");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk2");
         }
       }
     }
@@ -1121,53 +1145,53 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 0 && pair_idx.second == 3) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk5");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk5");
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk3") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk3");
-            REQUIRE(blk->name != "bk5");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk3");
+            REQUIRE(sptest.names[blk] != "bk5");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
         
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof[0]->name == "bk2");
-          REQUIRE(value.aboveof.size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk2");
+          REQUIRE(sptest.aboveof[value].size() == 2);
         }
 
         else {
-          REQUIRE(value.rightof[0]->name == "bk4");
-          REQUIRE(value.rightof.size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk4");
+          REQUIRE(sptest.rightof[value].size() == 2);
 
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk4");
-            REQUIRE(blk->name != "bk5");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk4");
+            REQUIRE(sptest.names[blk] != "bk5");
           }
-          REQUIRE(value.aboveof.size() == 4);
+          REQUIRE(sptest.aboveof[value].size() == 4);
         }
       }
     }
@@ -1175,58 +1199,58 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 0 && pair_idx.second == 4) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk2");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk2");
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
         
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk2");
-            REQUIRE(blk->name != "bk3");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk2");
+            REQUIRE(sptest.names[blk] != "bk3");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
           
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk2");
-            REQUIRE(blk->name != "bk4");
-            REQUIRE(blk->name != "bk5");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk2");
+            REQUIRE(sptest.names[blk] != "bk4");
+            REQUIRE(sptest.names[blk] != "bk5");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
         }
 
         else if (key == "bk3") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk2");
-            REQUIRE(blk->name != "bk3");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk2");
+            REQUIRE(sptest.names[blk] != "bk3");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
          
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus"); 
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus"); 
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else {
-          REQUIRE(value.rightof.size() == 2);
-          REQUIRE(value.rightof[0]->name == "bk4");
+          REQUIRE(sptest.rightof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk4");
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
       }
     }
@@ -1234,53 +1258,53 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 1 && pair_idx.second == 2) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk3");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk3");
+            REQUIRE(sptest.names[blk] != "bk4");
           } 
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
         
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
         
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk3") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk3");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk3");
+            REQUIRE(sptest.names[blk] != "bk4");
           } 
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
          
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk1"); 
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk1"); 
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
  
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.aboveof.size() == 5);
+          REQUIRE(sptest.aboveof[value].size() == 5);
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk2");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk2");
         }
       }
     }
@@ -1288,48 +1312,48 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 1 && pair_idx.second == 3) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          REQUIRE(value.rightof.size() == 2);
-          REQUIRE(value.rightof[0]->name == "bk2");
+          REQUIRE(sptest.rightof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk2");
           
-          REQUIRE(value.aboveof.size() == 1); 
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1); 
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk3") {
-          REQUIRE(value.rightof.size() == 2);
-          REQUIRE(value.rightof[0]->name == "bk2");
+          REQUIRE(sptest.rightof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk2");
 
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk1");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk1");
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.aboveof.size() == 5);
+          REQUIRE(sptest.aboveof[value].size() == 5);
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk4");
-            REQUIRE(blk->name != "bk5");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk4");
+            REQUIRE(sptest.names[blk] != "bk5");
           }
-          REQUIRE(value.aboveof.size() == 4);
+          REQUIRE(sptest.aboveof[value].size() == 4);
         }
       }
     }
@@ -1337,49 +1361,49 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 1 && pair_idx.second == 4) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          REQUIRE(value.rightof.size() == 2);
-          REQUIRE(value.rightof[0]->name == "bk5");
+          REQUIRE(sptest.rightof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk5");
 
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk2");
-            REQUIRE(blk->name != "bk4");
-            REQUIRE(blk->name != "bk5");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk2");
+            REQUIRE(sptest.names[blk] != "bk4");
+            REQUIRE(sptest.names[blk] != "bk5");
           }
-          REQUIRE(value.aboveof.size() == 3);
+          REQUIRE(sptest.aboveof[value].size() == 3);
         }
 
         else if (key == "bk3") {
-          REQUIRE(value.rightof[0]->name == "bk5");
-          REQUIRE(value.rightof.size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk5");
+          REQUIRE(sptest.rightof[value].size() == 2);
 
-          REQUIRE(value.aboveof[0]->name == "bk1");
-          REQUIRE(value.aboveof.size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk1");
+          REQUIRE(sptest.aboveof[value].size() == 2);
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.aboveof.size() == 5);
+          REQUIRE(sptest.aboveof[value].size() == 5);
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk1");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk1");
         }
       }
     }
@@ -1387,52 +1411,52 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 2 && pair_idx.second == 3) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
           
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk3") {
-          REQUIRE(value.rightof[0]->name == "bk2");
-          REQUIRE(value.rightof.size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk2");
+          REQUIRE(sptest.rightof[value].size() == 2);
           
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.aboveof.size() == 5);
+          REQUIRE(sptest.aboveof[value].size() == 5);
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
         
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk4");
-            REQUIRE(blk->name != "bk5");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk4");
+            REQUIRE(sptest.names[blk] != "bk5");
           }
-          REQUIRE(value.aboveof.size() == 3);
+          REQUIRE(sptest.aboveof[value].size() == 3);
         }
       }
     }
@@ -1440,48 +1464,48 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 2 && pair_idx.second == 4) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          REQUIRE(value.rightof[0]->name == "bk5");
-          REQUIRE(value.rightof.size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk5");
+          REQUIRE(sptest.rightof[value].size() == 2);
 
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk3");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk3");
         }
 
         else if (key == "bk3") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
           
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != " bk4");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != " bk4");
           }
-          REQUIRE(value.aboveof.size() == 5);
+          REQUIRE(sptest.aboveof[value].size() == 5);
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk3");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk3");
         }
       }
     }
@@ -1489,79 +1513,79 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 3 && pair_idx.second) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          REQUIRE(value.rightof.size() == 2);
-          REQUIRE(value.rightof[0]->name == "bk5");
+          REQUIRE(sptest.rightof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "bk5");
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk3") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk3");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk3");
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.aboveof.size() == 5);
+          REQUIRE(sptest.aboveof[value].size() == 5);
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
       }
     }
   }
   
   SUBCASE("SUB : case 2 with move3") { 
-    sptest.positive_sequence[0] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_positive_sequence = 0;
-    sptest.positive_sequence[1] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_positive_sequence = 1;
-    sptest.positive_sequence[2] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_positive_sequence = 2;
-    sptest.positive_sequence[3] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_positive_sequence = 3;
-    sptest.positive_sequence[4] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_positive_sequence = 4;
+    sptest.positive_sequence[0] = sptest.map_blocks["bk1"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk1"]] = 0;
+    sptest.positive_sequence[1] = sptest.map_blocks["bk3"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk3"]] = 1;
+    sptest.positive_sequence[2] = sptest.map_blocks["bk2"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk2"]] = 2;
+    sptest.positive_sequence[3] = sptest.map_blocks["bk5"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk5"]] = 3;
+    sptest.positive_sequence[4] = sptest.map_blocks["bk4"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk4"]] = 4;
     
-    sptest.negative_sequence[0] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_negative_sequence = 0;
-    sptest.negative_sequence[1] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_negative_sequence = 1;
-    sptest.negative_sequence[2] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_negative_sequence = 2;
-    sptest.negative_sequence[3] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_negative_sequence = 3;
-    sptest.negative_sequence[4] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_negative_sequence = 4;
+    sptest.negative_sequence[0] = sptest.map_blocks["bk4"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk4"]] = 0;
+    sptest.negative_sequence[1] = sptest.map_blocks["bk1"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk1"]] = 1;
+    sptest.negative_sequence[2] = sptest.map_blocks["bk3"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk3"]] = 2;
+    sptest.negative_sequence[3] = sptest.map_blocks["bk5"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk5"]] = 3;
+    sptest.negative_sequence[4] = sptest.map_blocks["bk2"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk2"]] = 4;
 
     sptest.construct_relative_locations(0, 4, MoveType::nomove);
     auto pair_idx = sptest.move3();
@@ -1573,58 +1597,58 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
       MoveType::move3
     );
    
-    REQUIRE(sptest.source.rightof.size() == 5);
-    REQUIRE(sptest.source.aboveof.size() == 5);
+    REQUIRE(sptest.rightof[sptest.source].size() == 5);
+    REQUIRE(sptest.aboveof[sptest.source].size() == 5);
 
     if (pair_idx.first == 0 && pair_idx.second == 1) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk3");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk3");
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
           
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk3") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk3");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk3");
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.aboveof.size() == 5);
+          REQUIRE(sptest.aboveof[value].size() == 5);
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk2");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk2");
         }
       }
     }
@@ -1632,52 +1656,52 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 0 && pair_idx.second == 2) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
           
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk2");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk2");
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk3") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk2");
-            REQUIRE(blk->name != "bk3");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk2");
+            REQUIRE(sptest.names[blk] != "bk3");
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.aboveof.size() == 5);
+          REQUIRE(sptest.aboveof[value].size() == 5);
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk1");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk1");
         }
       }
     }
@@ -1685,52 +1709,52 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 0 && pair_idx.second == 3) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk2");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk2");
         }
 
         else if (key == "bk2") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
           
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk3") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk3");
-            REQUIRE(blk->name != "bk4");
-            REQUIRE(blk->name != "bk5");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk3");
+            REQUIRE(sptest.names[blk] != "bk4");
+            REQUIRE(sptest.names[blk] != "bk5");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != " bk4");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != " bk4");
           }
-          REQUIRE(value.aboveof.size() == 5);
+          REQUIRE(sptest.aboveof[value].size() == 5);
         }
 
         else {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != " bk4");
-            REQUIRE(blk->name != " bk5");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != " bk4");
+            REQUIRE(sptest.names[blk] != " bk5");
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
       }
     }
@@ -1738,52 +1762,52 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 0 && pair_idx.second == 4) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk1");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
           }
-          REQUIRE(value.aboveof.size() == 5);
+          REQUIRE(sptest.aboveof[value].size() == 5);
         }
 
         else if (key == "bk2") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
           
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk3") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk3");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk3");
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk4") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk2");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk2");
         }
       }
     }
@@ -1791,52 +1815,52 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 1 && pair_idx.second == 2) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk2");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk2");
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk3") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
        
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.aboveof.size() == 5);
+          REQUIRE(sptest.aboveof[value].size() == 5);
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
   
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk3");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk3");
         }
       }
     }
@@ -1844,52 +1868,52 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 1 && pair_idx.second == 3) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
           
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk3") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
           
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk2");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk2");
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
    
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.aboveof.size() == 5);
+          REQUIRE(sptest.aboveof[value].size() == 5);
         }
 
         else {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != " bk1");
-            REQUIRE(blk->name != " bk4");
-            REQUIRE(blk->name != " bk5");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != " bk1");
+            REQUIRE(sptest.names[blk] != " bk4");
+            REQUIRE(sptest.names[blk] != " bk5");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
       }
     }
@@ -1897,52 +1921,52 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 1 && pair_idx.second == 4) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk3");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk3");
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
           
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk3") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk3");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk3");
           }
-          REQUIRE(value.aboveof.size() == 5);
+          REQUIRE(sptest.aboveof[value].size() == 5);
         }
 
         else if (key == "bk4") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk3");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk3");
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk2");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk2");
         }
       }
     }
@@ -1950,52 +1974,52 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 2 && pair_idx.second == 3) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk5");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk5");
         }
 
         else if (key == "bk3") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk3");
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk3");
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk4");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk4");
           }
-          REQUIRE(value.aboveof.size() == 5);
+          REQUIRE(sptest.aboveof[value].size() == 5);
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
       }
     }
@@ -2003,52 +2027,52 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 2 && pair_idx.second == 4) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk2");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk2");
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk2");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk2");
           }
-          REQUIRE(value.aboveof.size() == 5);
+          REQUIRE(sptest.aboveof[value].size() == 5);
         }
 
         else if (key == "bk3") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk2");
-            REQUIRE(blk->name != "bk3");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk2");
+            REQUIRE(sptest.names[blk] != "bk3");
           }
-          REQUIRE(value.rightof.size());
+          REQUIRE(sptest.rightof[value].size());
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
           
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
         
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
           
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk4");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk4");
         }
       }
     }
@@ -2056,79 +2080,79 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
     else if (pair_idx.first == 3 && pair_idx.second == 4) {
       for (auto& [key, value] : sptest.map_blocks) {
         if (key == "bk1") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk5");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk5");
           }
-          REQUIRE(value.rightof.size() == 4);
+          REQUIRE(sptest.rightof[value].size() == 4);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk2") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk3") {
-          for (auto& blk : value.rightof) {
-            REQUIRE(blk->name != "bk1");
-            REQUIRE(blk->name != "bk3");
-            REQUIRE(blk->name != "bk5");
+          for (auto& blk : sptest.rightof[value]) {
+            REQUIRE(sptest.names[blk] != "bk1");
+            REQUIRE(sptest.names[blk] != "bk3");
+            REQUIRE(sptest.names[blk] != "bk5");
           }
-          REQUIRE(value.rightof.size() == 3);
+          REQUIRE(sptest.rightof[value].size() == 3);
 
-          REQUIRE(value.aboveof.size() == 1);
-          REQUIRE(value.aboveof[0]->name == "terminus");
+          REQUIRE(sptest.aboveof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
         }
 
         else if (key == "bk4") {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          REQUIRE(value.aboveof.size() == 2);
-          REQUIRE(value.aboveof[0]->name == "bk2");
+          REQUIRE(sptest.aboveof[value].size() == 2);
+          REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk2");
         }
 
         else {
-          REQUIRE(value.rightof.size() == 1);
-          REQUIRE(value.rightof[0]->name == "terminus");
+          REQUIRE(sptest.rightof[value].size() == 1);
+          REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-          for (auto& blk : value.aboveof) {
-            REQUIRE(blk->name != "bk5");
+          for (auto& blk : sptest.aboveof[value]) {
+            REQUIRE(sptest.names[blk] != "bk5");
           }
-          REQUIRE(value.aboveof.size() == 5);
+          REQUIRE(sptest.aboveof[value].size() == 5);
         }
       }
     }
   }
   
   SUBCASE("SUB : case 2 with move4") { 
-    sptest.positive_sequence[0] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_positive_sequence = 0;
-    sptest.positive_sequence[1] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_positive_sequence = 1;
-    sptest.positive_sequence[2] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_positive_sequence = 2;
-    sptest.positive_sequence[3] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_positive_sequence = 3;
-    sptest.positive_sequence[4] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_positive_sequence = 4;
+    sptest.positive_sequence[0] = sptest.map_blocks["bk1"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk1"]] = 0;
+    sptest.positive_sequence[1] = sptest.map_blocks["bk3"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk3"]] = 1;
+    sptest.positive_sequence[2] = sptest.map_blocks["bk2"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk2"]] = 2;
+    sptest.positive_sequence[3] = sptest.map_blocks["bk5"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk5"]] = 3;
+    sptest.positive_sequence[4] = sptest.map_blocks["bk4"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk4"]] = 4;
     
-    sptest.negative_sequence[0] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_negative_sequence = 0;
-    sptest.negative_sequence[1] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_negative_sequence = 1;
-    sptest.negative_sequence[2] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_negative_sequence = 2;
-    sptest.negative_sequence[3] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_negative_sequence = 3;
-    sptest.negative_sequence[4] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_negative_sequence = 4;
+    sptest.negative_sequence[0] = sptest.map_blocks["bk4"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk4"]] = 0;
+    sptest.negative_sequence[1] = sptest.map_blocks["bk1"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk1"]] = 1;
+    sptest.negative_sequence[2] = sptest.map_blocks["bk3"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk3"]] = 2;
+    sptest.negative_sequence[3] = sptest.map_blocks["bk5"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk5"]] = 3;
+    sptest.negative_sequence[4] = sptest.map_blocks["bk2"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk2"]] = 4;
 
     sptest.construct_relative_locations(0, 4, MoveType::nomove);
     auto pair_idx = sptest.move4();
@@ -2140,57 +2164,57 @@ TEST_CASE("verify_relative_locations" * doctest::timeout(600)) {
       MoveType::move4
     );
    
-    REQUIRE(sptest.source.rightof.size() == 5);
-    REQUIRE(sptest.source.aboveof.size() == 5);
+    REQUIRE(sptest.rightof[sptest.source].size() == 5);
+    REQUIRE(sptest.aboveof[sptest.source].size() == 5);
 
     for (auto& [key, value] : sptest.map_blocks) {
       if (key == "bk1") {
-        for (auto& blk : value.rightof) {
-          REQUIRE(blk->name != "bk1");
-          REQUIRE(blk->name != "bk4");
+        for (auto& blk : sptest.rightof[value]) {
+          REQUIRE(sptest.names[blk] != "bk1");
+          REQUIRE(sptest.names[blk] != "bk4");
         }
-        REQUIRE(value.rightof.size() == 4);
+        REQUIRE(sptest.rightof[value].size() == 4);
 
-        REQUIRE(value.aboveof.size() == 1);
-        REQUIRE(value.aboveof[0]->name == "terminus");
+        REQUIRE(sptest.aboveof[value].size() == 1);
+        REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
       }
 
       else if (key == "bk2") {
-        REQUIRE(value.rightof.size() == 1);
-        REQUIRE(value.rightof[0]->name == "terminus");
+        REQUIRE(sptest.rightof[value].size() == 1);
+        REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-        REQUIRE(value.aboveof.size() == 1);
-        REQUIRE(value.aboveof[0]->name == "terminus");
+        REQUIRE(sptest.aboveof[value].size() == 1);
+        REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
       }
 
       else if (key == "bk3") {
-        for (auto& blk : value.rightof) {
-          REQUIRE(blk->name != "bk1");
-          REQUIRE(blk->name != "bk3");
-          REQUIRE(blk->name != "bk4");
+        for (auto& blk : sptest.rightof[value]) {
+          REQUIRE(sptest.names[blk] != "bk1");
+          REQUIRE(sptest.names[blk] != "bk3");
+          REQUIRE(sptest.names[blk] != "bk4");
         }
-        REQUIRE(value.rightof.size() == 3);
+        REQUIRE(sptest.rightof[value].size() == 3);
 
-        REQUIRE(value.aboveof.size() == 1);
-        REQUIRE(value.aboveof[0]->name == "terminus");
+        REQUIRE(sptest.aboveof[value].size() == 1);
+        REQUIRE(sptest.names[sptest.aboveof[value][0]] == "terminus");
       }
 
       else if (key == "bk4") {
-        REQUIRE(value.rightof.size() == 1);
-        REQUIRE(value.rightof[0]->name == "terminus");
+        REQUIRE(sptest.rightof[value].size() == 1);
+        REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
         
-        for (auto& blk : value.aboveof) {
-          REQUIRE(blk->name != "bk4"); 
+        for (auto& blk : sptest.aboveof[value]) {
+          REQUIRE(sptest.names[blk] != "bk4"); 
         }
-        REQUIRE(value.aboveof.size() == 5);
+        REQUIRE(sptest.aboveof[value].size() == 5);
       }
 
       else {
-        REQUIRE(value.rightof.size() == 1);
-        REQUIRE(value.rightof[0]->name == "terminus");
+        REQUIRE(sptest.rightof[value].size() == 1);
+        REQUIRE(sptest.names[sptest.rightof[value][0]] == "terminus");
 
-        REQUIRE(value.aboveof.size() == 2);
-        REQUIRE(value.aboveof[0]->name == "bk2");
+        REQUIRE(sptest.aboveof[value].size() == 2);
+        REQUIRE(sptest.names[sptest.aboveof[value][0]] == "bk2");
       }
     }
   }
@@ -2202,46 +2226,46 @@ TEST_CASE("verify_compute_spfa" * doctest::timeout(600)) {
   SPTest sptest;
   sptest.initialize_sequence();
 
-  sptest.source.rightof.clear();
-  sptest.terminus.rightof.clear();
-  sptest.map_blocks["bk1"].rightof.clear();
-  sptest.map_blocks["bk2"].rightof.clear();
-  sptest.map_blocks["bk3"].rightof.clear();
-  sptest.map_blocks["bk4"].rightof.clear();
-  sptest.map_blocks["bk5"].rightof.clear();
-
-  sptest.source.aboveof.clear();
-  sptest.terminus.aboveof.clear();
-  sptest.map_blocks["bk1"].aboveof.clear();
-  sptest.map_blocks["bk2"].aboveof.clear();
-  sptest.map_blocks["bk3"].aboveof.clear();
-  sptest.map_blocks["bk4"].aboveof.clear();
-  sptest.map_blocks["bk5"].aboveof.clear();
+  sptest.rightof[sptest.source].clear();
+  sptest.rightof[sptest.terminus].clear();
+  sptest.rightof[sptest.map_blocks["bk1"]].clear();
+  sptest.rightof[sptest.map_blocks["bk2"]].clear();
+  sptest.rightof[sptest.map_blocks["bk3"]].clear();
+  sptest.rightof[sptest.map_blocks["bk4"]].clear();
+  sptest.rightof[sptest.map_blocks["bk5"]].clear();
+
+  sptest.aboveof[sptest.source].clear();
+  sptest.aboveof[sptest.terminus].clear();
+  sptest.aboveof[sptest.map_blocks["bk1"]].clear();
+  sptest.aboveof[sptest.map_blocks["bk2"]].clear();
+  sptest.aboveof[sptest.map_blocks["bk3"]].clear();
+  sptest.aboveof[sptest.map_blocks["bk4"]].clear();
+  sptest.aboveof[sptest.map_blocks["bk5"]].clear();
 
   // positive sequence = [bk1, bk2, bk3, bk4, bk5]
   // negative sequence = [bk1, bk2, bk3, bk4, bk5]
   SUBCASE("SUB : case 1") { 
-    sptest.positive_sequence[0] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_positive_sequence = 0;
-    sptest.positive_sequence[1] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_positive_sequence = 1;
-    sptest.positive_sequence[2] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_positive_sequence = 2;
-    sptest.positive_sequence[3] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_positive_sequence = 3;
-    sptest.positive_sequence[4] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_positive_sequence = 4;
+    sptest.positive_sequence[0] = sptest.map_blocks["bk1"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk1"]] = 0;
+    sptest.positive_sequence[1] = sptest.map_blocks["bk2"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk2"]] = 1;
+    sptest.positive_sequence[2] = sptest.map_blocks["bk3"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk3"]] = 2;
+    sptest.positive_sequence[3] = sptest.map_blocks["bk4"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk4"]] = 3;
+    sptest.positive_sequence[4] = sptest.map_blocks["bk5"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk5"]] = 4;
     
-    sptest.negative_sequence[0] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_negative_sequence = 0;
-    sptest.negative_sequence[1] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_negative_sequence = 1;
-    sptest.negative_sequence[2] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_negative_sequence = 2;
-    sptest.negative_sequence[3] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_negative_sequence = 3;
-    sptest.negative_sequence[4] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_negative_sequence = 4;
+    sptest.negative_sequence[0] = sptest.map_blocks["bk1"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk1"]] = 0;
+    sptest.negative_sequence[1] = sptest.map_blocks["bk2"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk2"]] = 1;
+    sptest.negative_sequence[2] = sptest.map_blocks["bk3"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk3"]] = 2;
+    sptest.negative_sequence[3] = sptest.map_blocks["bk4"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk4"]] = 3;
+    sptest.negative_sequence[4] = sptest.map_blocks["bk5"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk5"]] = 4;
 
     sptest.construct_relative_locations(0, 4, MoveType::nomove);
   
@@ -2270,27 +2294,27 @@ TEST_CASE("verify_compute_spfa" * doctest::timeout(600)) {
   // positive sequence = [bk1, bk3, bk2, bk5, bk4]
   // negative sequence = [bk4, bk1, bk3, bk5, bk2]
   SUBCASE("SUB : case 2") { 
-    sptest.positive_sequence[0] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_positive_sequence = 0;
-    sptest.positive_sequence[1] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_positive_sequence = 1;
-    sptest.positive_sequence[2] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_positive_sequence = 2;
-    sptest.positive_sequence[3] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_positive_sequence = 3;
-    sptest.positive_sequence[4] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_positive_sequence = 4;
+    sptest.positive_sequence[0] = sptest.map_blocks["bk1"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk1"]] = 0;
+    sptest.positive_sequence[1] = sptest.map_blocks["bk3"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk3"]] = 1;
+    sptest.positive_sequence[2] = sptest.map_blocks["bk2"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk2"]] = 2;
+    sptest.positive_sequence[3] = sptest.map_blocks["bk5"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk5"]] = 3;
+    sptest.positive_sequence[4] = sptest.map_blocks["bk4"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk4"]] = 4;
     
-    sptest.negative_sequence[0] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_negative_sequence = 0;
-    sptest.negative_sequence[1] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_negative_sequence = 1;
-    sptest.negative_sequence[2] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_negative_sequence = 2;
-    sptest.negative_sequence[3] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_negative_sequence = 3;
-    sptest.negative_sequence[4] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_negative_sequence = 4;
+    sptest.negative_sequence[0] = sptest.map_blocks["bk4"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk4"]] = 0;
+    sptest.negative_sequence[1] = sptest.map_blocks["bk1"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk1"]] = 1;
+    sptest.negative_sequence[2] = sptest.map_blocks["bk3"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk3"]] = 2;
+    sptest.negative_sequence[3] = sptest.map_blocks["bk5"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk5"]] = 3;
+    sptest.negative_sequence[4] = sptest.map_blocks["bk2"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk2"]] = 4;
 
     sptest.construct_relative_locations(0, 4, MoveType::nomove);
     
@@ -2323,46 +2347,46 @@ TEST_CASE("verify_compute_block_locations" * doctest::timeout(600)) {
   SPTest sptest;
   sptest.initialize_sequence();
 
-  sptest.source.rightof.clear();
-  sptest.terminus.rightof.clear();
-  sptest.map_blocks["bk1"].rightof.clear();
-  sptest.map_blocks["bk2"].rightof.clear();
-  sptest.map_blocks["bk3"].rightof.clear();
-  sptest.map_blocks["bk4"].rightof.clear();
-  sptest.map_blocks["bk5"].rightof.clear();
-
-  sptest.source.aboveof.clear();
-  sptest.terminus.aboveof.clear();
-  sptest.map_blocks["bk1"].aboveof.clear();
-  sptest.map_blocks["bk2"].aboveof.clear();
-  sptest.map_blocks["bk3"].aboveof.clear();
-  sptest.map_blocks["bk4"].aboveof.clear();
-  sptest.map_blocks["bk5"].aboveof.clear();
+  sptest.rightof[sptest.source].clear();
+  sptest.rightof[sptest.terminus].clear();
+  sptest.rightof[sptest.map_blocks["bk1"]].clear();
+  sptest.rightof[sptest.map_blocks["bk2"]].clear();
+  sptest.rightof[sptest.map_blocks["bk3"]].clear();
+  sptest.rightof[sptest.map_blocks["bk4"]].clear();
+  sptest.rightof[sptest.map_blocks["bk5"]].clear();
+
+  sptest.aboveof[sptest.source].clear();
+  sptest.aboveof[sptest.terminus].clear();
+  sptest.aboveof[sptest.map_blocks["bk1"]].clear();
+  sptest.aboveof[sptest.map_blocks["bk2"]].clear();
+  sptest.aboveof[sptest.map_blocks["bk3"]].clear();
+  sptest.aboveof[sptest.map_blocks["bk4"]].clear();
+  sptest.aboveof[sptest.map_blocks["bk5"]].clear();
 
   // positive sequence = [bk1, bk2, bk3, bk4, bk5]
   // negative sequence = [bk1, bk2, bk3, bk4, bk5]
   SUBCASE("SUB : case 1") { 
-    sptest.positive_sequence[0] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_positive_sequence = 0;
-    sptest.positive_sequence[1] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_positive_sequence = 1;
-    sptest.positive_sequence[2] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_positive_sequence = 2;
-    sptest.positive_sequence[3] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_positive_sequence = 3;
-    sptest.positive_sequence[4] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_positive_sequence = 4;
+    sptest.positive_sequence[0] = sptest.map_blocks["bk1"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk1"]] = 0;
+    sptest.positive_sequence[1] = sptest.map_blocks["bk2"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk2"]] = 1;
+    sptest.positive_sequence[2] = sptest.map_blocks["bk3"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk3"]] = 2;
+    sptest.positive_sequence[3] = sptest.map_blocks["bk4"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk4"]] = 3;
+    sptest.positive_sequence[4] = sptest.map_blocks["bk5"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk5"]] = 4;
     
-    sptest.negative_sequence[0] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_negative_sequence = 0;
-    sptest.negative_sequence[1] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_negative_sequence = 1;
-    sptest.negative_sequence[2] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_negative_sequence = 2;
-    sptest.negative_sequence[3] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_negative_sequence = 3;
-    sptest.negative_sequence[4] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_negative_sequence = 4;
+    sptest.negative_sequence[0] = sptest.map_blocks["bk1"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk1"]] = 0;
+    sptest.negative_sequence[1] = sptest.map_blocks["bk2"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk2"]] = 1;
+    sptest.negative_sequence[2] = sptest.map_blocks["bk3"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk3"]] = 2;
+    sptest.negative_sequence[3] = sptest.map_blocks["bk4"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk4"]] = 3;
+    sptest.negative_sequence[4] = sptest.map_blocks["bk5"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk5"]] = 4;
 
     sptest.construct_relative_locations(0, 4, MoveType::nomove);
   
@@ -2370,47 +2394,47 @@ TEST_CASE("verify_compute_block_locations" * doctest::timeout(600)) {
     sptest.compute_block_locations(distance, Orientation::Horizontal);
 
     // check x coordinate 
-    REQUIRE(sptest.map_blocks["bk1"].lower_left_x == 0);
-    REQUIRE(sptest.map_blocks["bk2"].lower_left_x == 200);
-    REQUIRE(sptest.map_blocks["bk3"].lower_left_x == 800);
-    REQUIRE(sptest.map_blocks["bk4"].lower_left_x == 1200);
-    REQUIRE(sptest.map_blocks["bk5"].lower_left_x == 1600);
+    REQUIRE(sptest.lower_left_x[sptest.map_blocks["bk1"]] == 0);
+    REQUIRE(sptest.lower_left_x[sptest.map_blocks["bk2"]] == 200);
+    REQUIRE(sptest.lower_left_x[sptest.map_blocks["bk3"]] == 800);
+    REQUIRE(sptest.lower_left_x[sptest.map_blocks["bk4"]] == 1200);
+    REQUIRE(sptest.lower_left_x[sptest.map_blocks["bk5"]] == 1600);
     
     // check y coordinate
     distance = sptest.spfa(Orientation::Vertical);
     sptest.compute_block_locations(distance, Orientation::Vertical);
     
-    REQUIRE(sptest.map_blocks["bk1"].lower_left_y == 0);
-    REQUIRE(sptest.map_blocks["bk2"].lower_left_y == 0);
-    REQUIRE(sptest.map_blocks["bk3"].lower_left_y == 0);
-    REQUIRE(sptest.map_blocks["bk4"].lower_left_y == 0);
-    REQUIRE(sptest.map_blocks["bk5"].lower_left_y == 0);
+    REQUIRE(sptest.lower_left_y[sptest.map_blocks["bk1"]] == 0);
+    REQUIRE(sptest.lower_left_y[sptest.map_blocks["bk2"]] == 0);
+    REQUIRE(sptest.lower_left_y[sptest.map_blocks["bk3"]] == 0);
+    REQUIRE(sptest.lower_left_y[sptest.map_blocks["bk4"]] == 0);
+    REQUIRE(sptest.lower_left_y[sptest.map_blocks["bk5"]] == 0);
   }
   
   // positive sequence = [bk1, bk3, bk2, bk5, bk4]
   // negative sequence = [bk4, bk1, bk3, bk5, bk2]
   SUBCASE("SUB : case 2") { 
-    sptest.positive_sequence[0] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_positive_sequence = 0;
-    sptest.positive_sequence[1] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_positive_sequence = 1;
-    sptest.positive_sequence[2] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_positive_sequence = 2;
-    sptest.positive_sequence[3] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_positive_sequence = 3;
-    sptest.positive_sequence[4] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_positive_sequence = 4;
+    sptest.positive_sequence[0] = sptest.map_blocks["bk1"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk1"]] = 0;
+    sptest.positive_sequence[1] = sptest.map_blocks["bk3"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk3"]] = 1;
+    sptest.positive_sequence[2] = sptest.map_blocks["bk2"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk2"]] = 2;
+    sptest.positive_sequence[3] = sptest.map_blocks["bk5"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk5"]] = 3;
+    sptest.positive_sequence[4] = sptest.map_blocks["bk4"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk4"]] = 4;
     
-    sptest.negative_sequence[0] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_negative_sequence = 0;
-    sptest.negative_sequence[1] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_negative_sequence = 1;
-    sptest.negative_sequence[2] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_negative_sequence = 2;
-    sptest.negative_sequence[3] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_negative_sequence = 3;
-    sptest.negative_sequence[4] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_negative_sequence = 4;
+    sptest.negative_sequence[0] = sptest.map_blocks["bk4"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk4"]] = 0;
+    sptest.negative_sequence[1] = sptest.map_blocks["bk1"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk1"]] = 1;
+    sptest.negative_sequence[2] = sptest.map_blocks["bk3"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk3"]] = 2;
+    sptest.negative_sequence[3] = sptest.map_blocks["bk5"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk5"]] = 3;
+    sptest.negative_sequence[4] = sptest.map_blocks["bk2"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk2"]] = 4;
 
     sptest.construct_relative_locations(0, 4, MoveType::nomove);
     
@@ -2418,20 +2442,20 @@ TEST_CASE("verify_compute_block_locations" * doctest::timeout(600)) {
     std::vector<int> distance = sptest.spfa(Orientation::Horizontal);
     sptest.compute_block_locations(distance, Orientation::Horizontal);
      
-    REQUIRE(sptest.map_blocks["bk1"].lower_left_x == 0);
-    REQUIRE(sptest.map_blocks["bk3"].lower_left_x == 200);
-    REQUIRE(sptest.map_blocks["bk2"].lower_left_x == 600);
-    REQUIRE(sptest.map_blocks["bk5"].lower_left_x == 600);
-    REQUIRE(sptest.map_blocks["bk4"].lower_left_x == 0);
+    REQUIRE(sptest.lower_left_x[sptest.map_blocks["bk1"]] == 0);
+    REQUIRE(sptest.lower_left_x[sptest.map_blocks["bk3"]] == 200);
+    REQUIRE(sptest.lower_left_x[sptest.map_blocks["bk2"]] == 600);
+    REQUIRE(sptest.lower_left_x[sptest.map_blocks["bk5"]] == 600);
+    REQUIRE(sptest.lower_left_x[sptest.map_blocks["bk4"]] == 0);
 
     // check y coordinate
     distance = sptest.spfa(Orientation::Vertical);
     sptest.compute_block_locations(distance, Orientation::Vertical);
-    REQUIRE(sptest.map_blocks["bk1"].lower_left_y == 400);
-    REQUIRE(sptest.map_blocks["bk3"].lower_left_y == 400);
-    REQUIRE(sptest.map_blocks["bk2"].lower_left_y == 800);
-    REQUIRE(sptest.map_blocks["bk5"].lower_left_y == 400);
-    REQUIRE(sptest.map_blocks["bk4"].lower_left_y == 0);
+    REQUIRE(sptest.lower_left_y[sptest.map_blocks["bk1"]] == 400);
+    REQUIRE(sptest.lower_left_y[sptest.map_blocks["bk3"]] == 400);
+    REQUIRE(sptest.lower_left_y[sptest.map_blocks["bk2"]] == 800);
+    REQUIRE(sptest.lower_left_y[sptest.map_blocks["bk5"]] == 400);
+    REQUIRE(sptest.lower_left_y[sptest.map_blocks["bk4"]] == 0);
   }
 }
 
@@ -2441,46 +2465,46 @@ TEST_CASE("verify_compute_hpwl" * doctest::timeout(600)) {
   SPTest sptest; 
   sptest.initialize_sequence();
   
-  sptest.source.rightof.clear();
-  sptest.terminus.rightof.clear();
-  sptest.map_blocks["bk1"].rightof.clear();
-  sptest.map_blocks["bk2"].rightof.clear();
-  sptest.map_blocks["bk3"].rightof.clear();
-  sptest.map_blocks["bk4"].rightof.clear();
-  sptest.map_blocks["bk5"].rightof.clear();
-
-  sptest.source.aboveof.clear();
-  sptest.terminus.aboveof.clear();
-  sptest.map_blocks["bk1"].aboveof.clear();
-  sptest.map_blocks["bk2"].aboveof.clear();
-  sptest.map_blocks["bk3"].aboveof.clear();
-  sptest.map_blocks["bk4"].aboveof.clear();
-  sptest.map_blocks["bk5"].aboveof.clear();
+  sptest.rightof[sptest.source].clear();
+  sptest.rightof[sptest.terminus].clear();
+  sptest.rightof[sptest.map_blocks["bk1"]].clear();
+  sptest.rightof[sptest.map_blocks["bk2"]].clear();
+  sptest.rightof[sptest.map_blocks["bk3"]].clear();
+  sptest.rightof[sptest.map_blocks["bk4"]].clear();
+  sptest.rightof[sptest.map_blocks["bk5"]].clear();
+
+  sptest.aboveof[sptest.source].clear();
+  sptest.aboveof[sptest.terminus].clear();
+  sptest.aboveof[sptest.map_blocks["bk1"]].clear();
+  sptest.aboveof[sptest.map_blocks["bk2"]].clear();
+  sptest.aboveof[sptest.map_blocks["bk3"]].clear();
+  sptest.aboveof[sptest.map_blocks["bk4"]].clear();
+  sptest.aboveof[sptest.map_blocks["bk5"]].clear();
 
   // positive sequence = [bk1, bk2, bk3, bk4, bk5]
   // negative sequence = [bk1, bk2, bk3, bk4, bk5]
   SUBCASE("SUB : case 1") { 
-    sptest.positive_sequence[0] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_positive_sequence = 0;
-    sptest.positive_sequence[1] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_positive_sequence = 1;
-    sptest.positive_sequence[2] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_positive_sequence = 2;
-    sptest.positive_sequence[3] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_positive_sequence = 3;
-    sptest.positive_sequence[4] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_positive_sequence = 4;
+    sptest.positive_sequence[0] = sptest.map_blocks["bk1"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk1"]] = 0;
+    sptest.positive_sequence[1] = sptest.map_blocks["bk2"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk2"]] = 1;
+    sptest.positive_sequence[2] = sptest.map_blocks["bk3"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk3"]] = 2;
+    sptest.positive_sequence[3] = sptest.map_blocks["bk4"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk4"]] = 3;
+    sptest.positive_sequence[4] = sptest.map_blocks["bk5"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk5"]] = 4;
     
-    sptest.negative_sequence[0] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_negative_sequence = 0;
-    sptest.negative_sequence[1] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_negative_sequence = 1;
-    sptest.negative_sequence[2] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_negative_sequence = 2;
-    sptest.negative_sequence[3] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_negative_sequence = 3;
-    sptest.negative_sequence[4] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_negative_sequence = 4;
+    sptest.negative_sequence[0] = sptest.map_blocks["bk1"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk1"]] = 0;
+    sptest.negative_sequence[1] = sptest.map_blocks["bk2"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk2"]] = 1;
+    sptest.negative_sequence[2] = sptest.map_blocks["bk3"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk3"]] = 2;
+    sptest.negative_sequence[3] = sptest.map_blocks["bk4"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk4"]] = 3;
+    sptest.negative_sequence[4] = sptest.map_blocks["bk5"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk5"]] = 4;
 
     sptest.construct_relative_locations(0, 4, MoveType::nomove);
   
@@ -2497,27 +2521,27 @@ TEST_CASE("verify_compute_hpwl" * doctest::timeout(600)) {
   // positive sequence = [bk1, bk3, bk2, bk5, bk4]
   // negative sequence = [bk4, bk1, bk3, bk5, bk2]
   SUBCASE("SUB : case 2") { 
-    sptest.positive_sequence[0] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_positive_sequence = 0;
-    sptest.positive_sequence[1] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_positive_sequence = 1;
-    sptest.positive_sequence[2] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_positive_sequence = 2;
-    sptest.positive_sequence[3] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_positive_sequence = 3;
-    sptest.positive_sequence[4] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_positive_sequence = 4;
+    sptest.positive_sequence[0] = sptest.map_blocks["bk1"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk1"]] = 0;
+    sptest.positive_sequence[1] = sptest.map_blocks["bk3"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk3"]] = 1;
+    sptest.positive_sequence[2] = sptest.map_blocks["bk2"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk2"]] = 2;
+    sptest.positive_sequence[3] = sptest.map_blocks["bk5"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk5"]] = 3;
+    sptest.positive_sequence[4] = sptest.map_blocks["bk4"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk4"]] = 4;
     
-    sptest.negative_sequence[0] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_negative_sequence = 0;
-    sptest.negative_sequence[1] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_negative_sequence = 1;
-    sptest.negative_sequence[2] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_negative_sequence = 2;
-    sptest.negative_sequence[3] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_negative_sequence = 3;
-    sptest.negative_sequence[4] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_negative_sequence = 4;
+    sptest.negative_sequence[0] = sptest.map_blocks["bk4"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk4"]] = 0;
+    sptest.negative_sequence[1] = sptest.map_blocks["bk1"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk1"]] = 1;
+    sptest.negative_sequence[2] = sptest.map_blocks["bk3"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk3"]] = 2;
+    sptest.negative_sequence[3] = sptest.map_blocks["bk5"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk5"]] = 3;
+    sptest.negative_sequence[4] = sptest.map_blocks["bk2"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk2"]] = 4;
 
     sptest.construct_relative_locations(0, 4, MoveType::nomove);
     
@@ -2533,34 +2557,35 @@ TEST_CASE("verify_compute_hpwl" * doctest::timeout(600)) {
 }
 
 
-// verify initialize_backup_data
+// verify initialize_backup_data, a move undone after it
+// leaves everything as it was
 TEST_CASE("verify_backup_data" * doctest::timeout(600)) {
   SPTest sptest;
   sptest.initialize_sequence();
 
   // positive sequence = [bk1, bk3, bk2, bk5, bk4]
   // negative sequence = [bk4, bk1, bk3, bk5, bk2]
-  sptest.positive_sequence[0] = &(sptest.map_blocks["bk1"]);
-  sptest.map_blocks["bk1"].idx_positive_sequence = 0;
-  sptest.positive_sequence[1] = &(sptest.map_blocks["bk3"]);
-  sptest.map_blocks["bk3"].idx_positive_sequence = 1;
-  sptest.positive_sequence[2] = &(sptest.map_blocks["bk2"]);
-  sptest.map_blocks["bk2"].idx_positive_sequence = 2;
-  sptest.positive_sequence[3] = &(sptest.map_blocks["bk5"]);
-  sptest.map_blocks["bk5"].idx_positive_sequence = 3;
-  sptest.positive_sequence[4] = &(sptest.map_blocks["bk4"]);
-  sptest.map_blocks["bk4"].idx_positive_sequence = 4;
+  sptest.positive_sequence[0] = sptest.map_blocks["bk1"];
+  sptest.idx_positive_sequence[sptest.map_blocks["bk1"]] = 0;
+  sptest.positive_sequence[1] = sptest.map_blocks["bk3"];
+  sptest.idx_positive_sequence[sptest.map_blocks["bk3"]] = 1;
+  sptest.positive_sequence[2] = sptest.map_blocks["bk2"];
+  sptest.idx_positive_sequence[sptest.map_blocks["bk2"]] = 2;
+  sptest.positive_sequence[3] = sptest.map_blocks["bk5"];
+  sptest.idx_positive_sequence[sptest.map_blocks["bk5"]] = 3;
+  sptest.positive_sequence[4] = sptest.map_blocks["bk4"];
+  sptest.idx_positive_sequence[sptest.map_blocks["bk4"]] = 4;
   
-  sptest.negative_sequence[0] = &(sptest.map_blocks["bk4"]);
-  sptest.map_blocks["bk4"].idx_negative_sequence = 0;
-  sptest.negative_sequence[1] = &(sptest.map_blocks["bk1"]);
-  sptest.map_blocks["bk1"].idx_negative_sequence = 1;
-  sptest.negative_sequence[2] = &(sptest.map_blocks["bk3"]);
-  sptest.map_blocks["bk3"].idx_negative_sequence = 2;
-  sptest.negative_sequence[3] = &(sptest.map_blocks["bk5"]);
-  sptest.map_blocks["bk5"].idx_negative_sequence = 3;
-  sptest.negative_sequence[4] = &(sptest.map_blocks["bk2"]);
-  sptest.map_blocks["bk2"].idx_negative_sequence = 4;
+  sptest.negative_sequence[0] = sptest.map_blocks["bk4"];
+  sptest.idx_negative_sequence[sptest.map_blocks["bk4"]] = 0;
+  sptest.negative_sequence[1] = sptest.map_blocks["bk1"];
+  sptest.idx_negative_sequence[sptest.map_blocks["bk1"]] = 1;
+  sptest.negative_sequence[2] = sptest.map_blocks["bk3"];
+  sptest.idx_negative_sequence[sptest.map_blocks["bk3"]] = 2;
+  sptest.negative_sequence[3] = sptest.map_blocks["bk5"];
+  sptest.idx_negative_sequence[sptest.map_blocks["bk5"]] = 3;
+  sptest.negative_sequence[4] = sptest.map_blocks["bk2"];
+  sptest.idx_negative_sequence[sptest.map_blocks["bk2"]] = 4;
 
   sptest.construct_relative_locations(0, 4, MoveType::nomove);
   
@@ -2571,16 +2596,18 @@ TEST_CASE("verify_backup_data" * doctest::timeout(600)) {
   sptest.compute_block_locations(distance, Orientation::Vertical);
 
   sptest.initialize_backup_data();
+  Backup backup(sptest);
+  undo_next_move(sptest);
 
   for (auto& [key, value] : sptest.map_blocks) {
-    REQUIRE(value.width == value.backup_width);
-    REQUIRE(value.height == value.backup_height);
-    REQUIRE(value.lower_left_x == value.backup_lower_left_x);
-    REQUIRE(value.lower_left_y == value.backup_lower_left_y);
-    REQUIRE(value.idx_positive_sequence == value.backup_idx_positive_sequence);
-    REQUIRE(value.idx_negative_sequence == value.backup_idx_negative_sequence);
-    REQUIRE(value.rightof == value.backup_rightof);
-    REQUIRE(value.aboveof == value.backup_aboveof);
+    REQUIRE(sptest.width[value] == backup.width[value]);
+    REQUIRE(sptest.height[value] == backup.height[value]);
+    REQUIRE(sptest.lower_left_x[value] == backup.lower_left_x[value]);
+    REQUIRE(sptest.lower_left_y[value] == backup.lower_left_y[value]);
+    REQUIRE(sptest.idx_positive_sequence[value] == backup.idx_positive_sequence[value]);
+    REQUIRE(sptest.idx_negative_sequence[value] == backup.idx_negative_sequence[value]);
+    REQUIRE(sptest.rightof[value] == backup.rightof[value]);
+    REQUIRE(sptest.aboveof[value] == backup.aboveof[value]);
   }
 }
 
@@ -2591,6 +2618,7 @@ TEST_CASE("verify move1" * doctest::timeout(600)) {
   sptest.initialize_sequence();
 
   sptest.initialize_backup_data();
+  Backup backup(sptest);
 
   std::pair<size_t, size_t> pair_idx = sptest.move1();
 
@@ -2598,71 +2626,71 @@ TEST_CASE("verify move1" * doctest::timeout(600)) {
  
   for (size_t i = 0; i < sptest.negative_sequence.size(); ++i) {
     REQUIRE(
-      sptest.backup_negative_sequence[i] == sptest.negative_sequence[i]);
+      backup.negative_sequence[i] == sptest.negative_sequence[i]);
     REQUIRE(
-      sptest.backup_negative_sequence[i]->idx_negative_sequence == i);
+      sptest.idx_negative_sequence[backup.negative_sequence[i]] == i);
     REQUIRE(
-      sptest.backup_negative_sequence[i]->backup_idx_negative_sequence == i);
+      backup.idx_negative_sequence[backup.negative_sequence[i]] == i);
     REQUIRE(
-      sptest.negative_sequence[i]->idx_negative_sequence == i);
+      sptest.idx_negative_sequence[sptest.negative_sequence[i]] == i);
     REQUIRE(
-      sptest.negative_sequence[i]->backup_idx_negative_sequence == i);
+      backup.idx_negative_sequence[sptest.negative_sequence[i]] == i);
   }
 
   REQUIRE(sptest.positive_sequence[pair_idx.first] == 
-          sptest.backup_positive_sequence[pair_idx.second]);
+          backup.positive_sequence[pair_idx.second]);
   
   REQUIRE(sptest.positive_sequence[pair_idx.second] ==
-          sptest.backup_positive_sequence[pair_idx.first]);
+          backup.positive_sequence[pair_idx.first]);
   
   for (size_t i = 0; i < sptest.positive_sequence.size(); ++i) {
     if (i != pair_idx.first && i != pair_idx.second) {
       REQUIRE(sptest.positive_sequence[i] == 
-              sptest.backup_positive_sequence[i]);
-      REQUIRE(sptest.positive_sequence[i]->idx_positive_sequence ==
-              sptest.positive_sequence[i]->backup_idx_positive_sequence);
-      REQUIRE(sptest.backup_positive_sequence[i]->idx_positive_sequence ==
-              sptest.backup_positive_sequence[i]->backup_idx_positive_sequence);
+              backup.positive_sequence[i]);
+      REQUIRE(sptest.idx_positive_sequence[sptest.positive_sequence[i]] ==
+              backup.idx_positive_sequence[sptest.positive_sequence[i]]);
+      REQUIRE(sptest.idx_positive_sequence[backup.positive_sequence[i]] ==
+              backup.idx_positive_sequence[backup.positive_sequence[i]]);
     }
 
-    REQUIRE(sptest.positive_sequence[i]->idx_positive_sequence == i);
+    REQUIRE(sptest.idx_positive_sequence[sptest.positive_sequence[i]] == i);
 
     REQUIRE(
-      sptest.positive_sequence[pair_idx.first]->backup_idx_positive_sequence ==
-      sptest.backup_positive_sequence[pair_idx.second]->backup_idx_positive_sequence);    
+      backup.idx_positive_sequence[sptest.positive_sequence[pair_idx.first]] ==
+      backup.idx_positive_sequence[backup.positive_sequence[pair_idx.second]]);    
     
     REQUIRE(
-      sptest.positive_sequence[pair_idx.second]->backup_idx_positive_sequence ==
-      sptest.backup_positive_sequence[pair_idx.first]->backup_idx_positive_sequence);    
+      backup.idx_positive_sequence[sptest.positive_sequence[pair_idx.second]] ==
+      backup.idx_positive_sequence[backup.positive_sequence[pair_idx.first]]);    
 
     REQUIRE(
-      sptest.positive_sequence[pair_idx.first]->idx_positive_sequence !=
-      sptest.positive_sequence[pair_idx.first]->backup_idx_positive_sequence);    
+      sptest.idx_positive_sequence[sptest.positive_sequence[pair_idx.first]] !=
+      backup.idx_positive_sequence[sptest.positive_sequence[pair_idx.first]]);    
     
     REQUIRE(
-      sptest.positive_sequence[pair_idx.second]->idx_positive_sequence !=
-      sptest.positive_sequence[pair_idx.second]->backup_idx_positive_sequence);    
+      sptest.idx_positive_sequence[sptest.positive_sequence[pair_idx.second]] !=
+      backup.idx_positive_sequence[sptest.positive_sequence[pair_idx.second]]);    
   }
 
   for (size_t i = 0; i < sptest.num_blocks; ++i) {
     REQUIRE(
-      sptest.negative_sequence[i]->lower_left_x ==
-      sptest.negative_sequence[i]->backup_lower_left_x);
+      sptest.lower_left_x[sptest.negative_sequence[i]] ==
+      backup.lower_left_x[sptest.negative_sequence[i]]);
     REQUIRE(
-      sptest.negative_sequence[i]->lower_left_y ==
-      sptest.negative_sequence[i]->backup_lower_left_y);
+      sptest.lower_left_y[sptest.negative_sequence[i]] ==
+      backup.lower_left_y[sptest.negative_sequence[i]]);
     REQUIRE(
-      sptest.negative_sequence[i]->width ==
-      sptest.negative_sequence[i]->backup_width);
+      sptest.width[sptest.negative_sequence[i]] ==
+      backup.width[sptest.negative_sequence[i]]);
     REQUIRE(
-      sptest.negative_sequence[i]->height ==
-      sptest.negative_sequence[i]->backup_height);
+      sptest.height[sptest.negative_sequence[i]] ==
+      backup.height[sptest.negative_sequence[i]]);
     REQUIRE(
-      sptest.negative_sequence[i]->rightof ==
-      sptest.negative_sequence[i]->backup_rightof);
+      sptest.rightof[sptest.negative_sequence[i]] ==
+      backup.rightof[sptest.negative_sequence[i]]);
     REQUIRE(
-      sptest.negative_sequence[i]->aboveof ==
-      sptest.negative_sequence[i]->backup_aboveof);
+      sptest.aboveof[sptest.negative_sequence[i]] ==
+      backup.aboveof[sptest.negative_sequence[i]]);
   }
 }
 
@@ -2673,6 +2701,7 @@ TEST_CASE("verify move2" * doctest::timeout(600)) {
   sptest.initialize_sequence();
 
   sptest.initialize_backup_data();
+  Backup backup(sptest);
 
   std::pair<size_t, size_t> pair_idx = sptest.move2();
 
@@ -2680,75 +2709,75 @@ TEST_CASE("verify move2" * doctest::timeout(600)) {
 
   for (size_t i = 0; i < sptest.positive_sequence.size(); ++i) {
     REQUIRE(
-      sptest.backup_positive_sequence[i] == sptest.positive_sequence[i]);
+      backup.positive_sequence[i] == sptest.positive_sequence[i]);
     REQUIRE(
-      sptest.backup_positive_sequence[i]->idx_positive_sequence == i);
+      sptest.idx_positive_sequence[backup.positive_sequence[i]] == i);
     REQUIRE(
-      sptest.backup_positive_sequence[i]->backup_idx_positive_sequence == i);
+      backup.idx_positive_sequence[backup.positive_sequence[i]] == i);
     REQUIRE(
-      sptest.positive_sequence[i]->idx_positive_sequence == i);
+      sptest.idx_positive_sequence[sptest.positive_sequence[i]] == i);
     REQUIRE(
-      sptest.positive_sequence[i]->backup_idx_positive_sequence == i);
+      backup.idx_positive_sequence[sptest.positive_sequence[i]] == i);
   }
 
   REQUIRE(sptest.negative_sequence[pair_idx.first] == 
-          sptest.backup_negative_sequence[pair_idx.second]);
+          backup.negative_sequence[pair_idx.second]);
   
   REQUIRE(sptest.negative_sequence[pair_idx.second] ==
-          sptest.backup_negative_sequence[pair_idx.first]);
+          backup.negative_sequence[pair_idx.first]);
   
   for (size_t i = 0; i < sptest.negative_sequence.size(); ++i) {
     if (i != pair_idx.first && i != pair_idx.second) {
       REQUIRE(
         sptest.negative_sequence[i] == 
-        sptest.backup_negative_sequence[i]);
+        backup.negative_sequence[i]);
       REQUIRE(
-        sptest.negative_sequence[i]->idx_negative_sequence ==
-        sptest.negative_sequence[i]->backup_idx_negative_sequence);
+        sptest.idx_negative_sequence[sptest.negative_sequence[i]] ==
+        backup.idx_negative_sequence[sptest.negative_sequence[i]]);
       REQUIRE(
-        sptest.backup_negative_sequence[i]->idx_negative_sequence ==
-        sptest.backup_negative_sequence[i]->backup_idx_negative_sequence);
+        sptest.idx_negative_sequence[backup.negative_sequence[i]] ==
+        backup.idx_negative_sequence[backup.negative_sequence[i]]);
     }
 
     REQUIRE(
-      sptest.negative_sequence[i]->idx_negative_sequence == i);
+      sptest.idx_negative_sequence[sptest.negative_sequence[i]] == i);
 
     REQUIRE(
-      sptest.negative_sequence[pair_idx.first]->backup_idx_negative_sequence ==
-      sptest.backup_negative_sequence[pair_idx.second]->backup_idx_negative_sequence);    
+      backup.idx_negative_sequence[sptest.negative_sequence[pair_idx.first]] ==
+      backup.idx_negative_sequence[backup.negative_sequence[pair_idx.second]]);    
     
     REQUIRE(
-      sptest.negative_sequence[pair_idx.second]->backup_idx_negative_sequence ==
-      sptest.backup_negative_sequence[pair_idx.first]->backup_idx_negative_sequence);    
+      backup.idx_negative_sequence[sptest.negative_sequence[pair_idx.second]] ==
+      backup.idx_negative_sequence[backup.negative_sequence[pair_idx.first]]);    
 
     REQUIRE(
-      sptest.negative_sequence[pair_idx.first]->idx_negative_sequence !=
-      sptest.negative_sequence[pair_idx.first]->backup_idx_negative_sequence);    
+      sptest.idx_negative_sequence[sptest.negative_sequence[pair_idx.first]] !=
+      backup.idx_negative_sequence[sptest.negative_sequence[pair_idx.first]]);    
     
     REQUIRE(
-      sptest.negative_sequence[pair_idx.second]->idx_negative_sequence !=
-      sptest.negative_sequence[pair_idx.second]->backup_idx_negative_sequence);    
+      sptest.idx_negative_sequence[sptest.negative_sequence[pair_idx.second]] !=
+      backup.idx_negative_sequence[sptest.negative_sequence[pair_idx.second]]);    
   }
   
   for (size_t i = 0; i < sptest.num_blocks; ++i) {
     REQUIRE(
-      sptest.positive_sequence[i]->lower_left_x ==
-      sptest.positive_sequence[i]->backup_lower_left_x);
+      sptest.lower_left_x[sptest.positive_sequence[i]] ==
+      backup.lower_left_x[sptest.positive_sequence[i]]);
     REQUIRE(
-      sptest.positive_sequence[i]->lower_left_y ==
-      sptest.positive_sequence[i]->backup_lower_left_y);
+      sptest.lower_left_y[sptest.positive_sequence[i]] ==
+      backup.lower_left_y[sptest.positive_sequence[i]]);
     REQUIRE(
-      sptest.positive_sequence[i]->width ==
-      sptest.positive_sequence[i]->backup_width);
+      sptest.width[sptest.positive_sequence[i]] ==
+      backup.width[sptest.positive_sequence[i]]);
     REQUIRE(
-      sptest.positive_sequence[i]->height ==
-      sptest.positive_sequence[i]->backup_height);
+      sptest.height[sptest.positive_sequence[i]] ==
+      backup.height[sptest.positive_sequence[i]]);
     REQUIRE(
-      sptest.positive_sequence[i]->rightof ==
-      sptest.positive_sequence[i]->backup_rightof);
+      sptest.rightof[sptest.positive_sequence[i]] ==
+      backup.rightof[sptest.positive_sequence[i]]);
     REQUIRE(
-      sptest.positive_sequence[i]->aboveof ==
-      sptest.positive_sequence[i]->backup_aboveof);
+      sptest.aboveof[sptest.positive_sequence[i]] ==
+      backup.aboveof[sptest.positive_sequence[i]]);
   }
 }
 
@@ -2758,131 +2787,132 @@ TEST_CASE("verify move3" * doctest::timeout(600)) {
   SPTest sptest;
   sptest.initialize_sequence();
   sptest.initialize_backup_data();
+  Backup backup(sptest);
 
   std::pair<size_t, size_t> pair_idx = sptest.move3();
   REQUIRE(pair_idx.first < pair_idx.second);
 
   REQUIRE(sptest.positive_sequence[pair_idx.first] == 
-          sptest.backup_positive_sequence[pair_idx.second]);
+          backup.positive_sequence[pair_idx.second]);
   
   REQUIRE(sptest.positive_sequence[pair_idx.second] ==
-          sptest.backup_positive_sequence[pair_idx.first]);
+          backup.positive_sequence[pair_idx.first]);
   
   for (size_t i = 0; i < sptest.positive_sequence.size(); ++i) {
     if (i != pair_idx.first && i != pair_idx.second) {
       REQUIRE(sptest.positive_sequence[i] == 
-              sptest.backup_positive_sequence[i]);
-      REQUIRE(sptest.positive_sequence[i]->idx_positive_sequence ==
-              sptest.positive_sequence[i]->backup_idx_positive_sequence);
-      REQUIRE(sptest.backup_positive_sequence[i]->idx_positive_sequence ==
-              sptest.backup_positive_sequence[i]->backup_idx_positive_sequence);
+              backup.positive_sequence[i]);
+      REQUIRE(sptest.idx_positive_sequence[sptest.positive_sequence[i]] ==
+              backup.idx_positive_sequence[sptest.positive_sequence[i]]);
+      REQUIRE(sptest.idx_positive_sequence[backup.positive_sequence[i]] ==
+              backup.idx_positive_sequence[backup.positive_sequence[i]]);
     }
 
-    REQUIRE(sptest.positive_sequence[i]->idx_positive_sequence == i);
+    REQUIRE(sptest.idx_positive_sequence[sptest.positive_sequence[i]] == i);
 
     REQUIRE(
-      sptest.positive_sequence[pair_idx.first]->backup_idx_positive_sequence ==
-      sptest.backup_positive_sequence[pair_idx.second]->backup_idx_positive_sequence);    
+      backup.idx_positive_sequence[sptest.positive_sequence[pair_idx.first]] ==
+      backup.idx_positive_sequence[backup.positive_sequence[pair_idx.second]]);    
     
     REQUIRE(
-      sptest.positive_sequence[pair_idx.second]->backup_idx_positive_sequence ==
-      sptest.backup_positive_sequence[pair_idx.first]->backup_idx_positive_sequence);    
+      backup.idx_positive_sequence[sptest.positive_sequence[pair_idx.second]] ==
+      backup.idx_positive_sequence[backup.positive_sequence[pair_idx.first]]);    
 
     REQUIRE(
-      sptest.positive_sequence[pair_idx.first]->idx_positive_sequence !=
-      sptest.positive_sequence[pair_idx.first]->backup_idx_positive_sequence);    
+      sptest.idx_positive_sequence[sptest.positive_sequence[pair_idx.first]] !=
+      backup.idx_positive_sequence[sptest.positive_sequence[pair_idx.first]]);    
     
     REQUIRE(
-      sptest.positive_sequence[pair_idx.second]->idx_positive_sequence !=
-      sptest.positive_sequence[pair_idx.second]->backup_idx_positive_sequence);    
+      sptest.idx_positive_sequence[sptest.positive_sequence[pair_idx.second]] !=
+      backup.idx_positive_sequence[sptest.positive_sequence[pair_idx.second]]);    
   }
   
   
-  size_t nid1 = sptest.positive_sequence[pair_idx.first]->idx_negative_sequence;
-  size_t nid2 = sptest.positive_sequence[pair_idx.second]->idx_negative_sequence; 
+  size_t nid1 = sptest.idx_negative_sequence[sptest.positive_sequence[pair_idx.first]];
+  size_t nid2 = sptest.idx_negative_sequence[sptest.positive_sequence[pair_idx.second]]; 
   
   if (nid1 > nid2) {
     std::swap(nid1, nid2);
   }
   REQUIRE(sptest.negative_sequence[nid1] == 
-          sptest.backup_negative_sequence[nid2]);
+          backup.negative_sequence[nid2]);
   
   REQUIRE(sptest.negative_sequence[nid2] ==
-          sptest.backup_negative_sequence[nid1]);
+          backup.negative_sequence[nid1]);
   
   for (size_t i = 0; i < sptest.negative_sequence.size(); ++i) {
     if (i != nid1 && i != nid2) {
       REQUIRE(
         sptest.negative_sequence[i] == 
-        sptest.backup_negative_sequence[i]);
+        backup.negative_sequence[i]);
       REQUIRE(
-        sptest.negative_sequence[i]->idx_negative_sequence ==
-        sptest.negative_sequence[i]->backup_idx_negative_sequence);
+        sptest.idx_negative_sequence[sptest.negative_sequence[i]] ==
+        backup.idx_negative_sequence[sptest.negative_sequence[i]]);
       REQUIRE(
-        sptest.backup_negative_sequence[i]->idx_negative_sequence ==
-        sptest.backup_negative_sequence[i]->backup_idx_negative_sequence);
+        sptest.idx_negative_sequence[backup.negative_sequence[i]] ==
+        backup.idx_negative_sequence[backup.negative_sequence[i]]);
     }
 
     REQUIRE(
-      sptest.negative_sequence[i]->idx_negative_sequence == i);
+      sptest.idx_negative_sequence[sptest.negative_sequence[i]] == i);
 
     REQUIRE(
-      sptest.negative_sequence[nid1]->backup_idx_negative_sequence ==
-      sptest.backup_negative_sequence[nid2]->backup_idx_negative_sequence);    
+      backup.idx_negative_sequence[sptest.negative_sequence[nid1]] ==
+      backup.idx_negative_sequence[backup.negative_sequence[nid2]]);    
     
     REQUIRE(
-      sptest.negative_sequence[nid2]->backup_idx_negative_sequence ==
-      sptest.backup_negative_sequence[nid1]->backup_idx_negative_sequence);    
+      backup.idx_negative_sequence[sptest.negative_sequence[nid2]] ==
+      backup.idx_negative_sequence[backup.negative_sequence[nid1]]);    
 
     REQUIRE(
-      sptest.negative_sequence[nid1]->idx_negative_sequence !=
-      sptest.negative_sequence[nid1]->backup_idx_negative_sequence);    
+      sptest.idx_negative_sequence[sptest.negative_sequence[nid1]] !=
+      backup.idx_negative_sequence[sptest.negative_sequence[nid1]]);    
     
     REQUIRE(
-      sptest.negative_sequence[nid2]->idx_negative_sequence !=
-      sptest.negative_sequence[nid2]->backup_idx_negative_sequence);    
+      sptest.idx_negative_sequence[sptest.negative_sequence[nid2]] !=
+      backup.idx_negative_sequence[sptest.negative_sequence[nid2]]);    
   }
 
   for (size_t i = 0; i < sptest.num_blocks; ++i) {
     REQUIRE(
-      sptest.positive_sequence[i]->lower_left_x ==
-      sptest.positive_sequence[i]->backup_lower_left_x);
+      sptest.lower_left_x[sptest.positive_sequence[i]] ==
+      backup.lower_left_x[sptest.positive_sequence[i]]);
     REQUIRE(
-      sptest.positive_sequence[i]->lower_left_y ==
-      sptest.positive_sequence[i]->backup_lower_left_y);
+      sptest.lower_left_y[sptest.positive_sequence[i]] ==
+      backup.lower_left_y[sptest.positive_sequence[i]]);
     REQUIRE(
-      sptest.positive_sequence[i]->width ==
-      sptest.positive_sequence[i]->backup_width);
+      sptest.width[sptest.positive_sequence[i]] ==
+      backup.width[sptest.positive_sequence[i]]);
     REQUIRE(
-      sptest.positive_sequence[i]->height ==
-      sptest.positive_sequence[i]->backup_height);
+      sptest.height[sptest.positive_sequence[i]] ==
+      backup.height[sptest.positive_sequence[i]]);
     REQUIRE(
-      sptest.positive_sequence[i]->rightof ==
-      sptest.positive_sequence[i]->backup_rightof);
+      sptest.rightof[sptest.positive_sequence[i]] ==
+      backup.rightof[sptest.positive_sequence[i]]);
     REQUIRE(
-      sptest.positive_sequence[i]->aboveof ==
-      sptest.positive_sequence[i]->backup_aboveof);
+      sptest.aboveof[sptest.positive_sequence[i]] ==
+      backup.aboveof[sptest.positive_sequence[i]]);
   }
 
   for (size_t i = 0; i < sptest.num_blocks; ++i) {
     REQUIRE(
-      sptest.negative_sequence[i]->lower_left_x ==
-      sptest.negative_sequence[i]->backup_lower_left_x);
+      sptest.lower_left_x[sptest.negative_sequence[i]] ==
+      backup.lower_left_x[sptest.negative_sequence[i]]);
     REQUIRE(
-      sptest.negative_sequence[i]->lower_left_y ==
-      sptest.negative_sequence[i]->backup_lower_left_y);
+      sptest.lower_left_y[sptest.negative_sequence[i]] ==
+      backup.lower_left_y[sptest.negative_sequence[i]]);
     REQUIRE(
-      sptest.negative_sequence[i]->width ==
-      sptest.negative_sequence[i]->backup_width);
+      sptest.width[sptest.negative_sequence[i]] ==
+      backup.width[sptest.negative_sequence[i]]);
     REQUIRE(
-      sptest.negative_sequence[i]->height ==
-      sptest.negative_sequence[i]->backup_height);
+      sptest.height[sptest.negative_sequence[i]] ==
+      backup.height[sptest.negative_sequence[i]]);
     REQUIRE(
-      sptest.negative_sequence[i]->rightof ==
-      sptest.negative_sequence[i]->backup_rightof);
+      sptest.rightof[sptest.negative_sequence[i]] ==
+      backup.rightof[sptest.negative_sequence[i]]);
     REQUIRE(
-      sptest.negative_sequence[i]->aboveof ==
-      sptest.negative_sequence[i]->backup_aboveof);
+      sptest.aboveof[sptest.negative_sequence[i]] ==
+      backup.aboveof[sptest.negative_sequence[i]]);
   }
 }  
 
@@ -2892,16 +2922,17 @@ TEST_CASE("verify move4" * doctest::timeout(600)) {
   SPTest sptest;
   sptest.initialize_sequence();
   sptest.initialize_backup_data();
+  Backup backup(sptest);
 
   std::vector<std::pair<size_t, size_t>> old_positive_sequence;
   std::vector<std::pair<size_t, size_t>> old_negative_sequence; 
 
   for (auto& ps : sptest.positive_sequence) {
-    old_positive_sequence.push_back(std::make_pair(ps->width, ps->height));
+    old_positive_sequence.push_back(std::make_pair(sptest.width[ps], sptest.height[ps]));
   }
 
   for (auto& ns : sptest.negative_sequence) {
-    old_negative_sequence.push_back(std::make_pair(ns->width, ns->height));
+    old_negative_sequence.push_back(std::make_pair(sptest.width[ns], sptest.height[ns]));
   }
 
   sptest.move4();
@@ -2909,8 +2940,8 @@ TEST_CASE("verify move4" * doctest::timeout(600)) {
   size_t changes = 0;
   
   for (size_t i = 0; i < old_positive_sequence.size(); ++i) {
-    if (old_positive_sequence[i].first == sptest.positive_sequence[i]->width &&
-        old_positive_sequence[i].second == sptest.positive_sequence[i]->height) {
+    if (old_positive_sequence[i].first == sptest.width[sptest.positive_sequence[i]] &&
+        old_positive_sequence[i].second == sptest.height[sptest.positive_sequence[i]]) {
       continue;
     }
     ++changes;
@@ -2918,8 +2949,8 @@ TEST_CASE("verify move4" * doctest::timeout(600)) {
   REQUIRE(changes == 1);
 
   for (size_t i = 0; i < old_negative_sequence.size(); ++i) {
-    if (old_negative_sequence[i].first == sptest.negative_sequence[i]->width &&
-        old_negative_sequence[i].second == sptest.negative_sequence[i]->height) {
+    if (old_negative_sequence[i].first == sptest.width[sptest.negative_sequence[i]] &&
+        old_negative_sequence[i].second == sptest.height[sptest.negative_sequence[i]]) {
       continue;
     }
     ++changes;
@@ -2927,57 +2958,58 @@ TEST_CASE("verify move4" * doctest::timeout(600)) {
   REQUIRE(changes == 2);
 
   for (size_t i = 0; i < sptest.positive_sequence.size(); ++i) {
-    REQUIRE(sptest.positive_sequence[i] == sptest.backup_positive_sequence[i]); 
-    REQUIRE(sptest.negative_sequence[i] == sptest.backup_negative_sequence[i]); 
+    REQUIRE(sptest.positive_sequence[i] == backup.positive_sequence[i]); 
+    REQUIRE(sptest.negative_sequence[i] == backup.negative_sequence[i]); 
     REQUIRE(
-      sptest.positive_sequence[i]->lower_left_x == 
-      sptest.positive_sequence[i]->backup_lower_left_x);
+      sptest.lower_left_x[sptest.positive_sequence[i]] == 
+      backup.lower_left_x[sptest.positive_sequence[i]]);
     REQUIRE(
-      sptest.positive_sequence[i]->lower_left_y == 
-      sptest.positive_sequence[i]->backup_lower_left_y);
-    REQUIRE(sptest.positive_sequence[i]->idx_positive_sequence == i);
-    REQUIRE(sptest.positive_sequence[i]->backup_idx_positive_sequence == i);
+      sptest.lower_left_y[sptest.positive_sequence[i]] == 
+      backup.lower_left_y[sptest.positive_sequence[i]]);
+    REQUIRE(sptest.idx_positive_sequence[sptest.positive_sequence[i]] == i);
+    REQUIRE(backup.idx_positive_sequence[sptest.positive_sequence[i]] == i);
     REQUIRE(
-      sptest.positive_sequence[i]->idx_negative_sequence ==
-      sptest.positive_sequence[i]->backup_idx_negative_sequence);
+      sptest.idx_negative_sequence[sptest.positive_sequence[i]] ==
+      backup.idx_negative_sequence[sptest.positive_sequence[i]]);
     REQUIRE(
-      sptest.positive_sequence[i]->rightof == 
-      sptest.positive_sequence[i]->backup_rightof);
+      sptest.rightof[sptest.positive_sequence[i]] == 
+      backup.rightof[sptest.positive_sequence[i]]);
     REQUIRE(
-      sptest.positive_sequence[i]->aboveof == 
-      sptest.positive_sequence[i]->backup_aboveof);
+      sptest.aboveof[sptest.positive_sequence[i]] == 
+      backup.aboveof[sptest.positive_sequence[i]]);
   }
 }
 
 
-// verify update_backup_data
+// verify update_backup_data, a move undone after it
+// returns to the kept one
 TEST_CASE("verify update_backup_data" * doctest::timeout(600)) {
   SPTest sptest;
   sptest.initialize_sequence();
   
   // positive sequence = [bk1, bk3, bk2, bk5, bk4]
   // negative sequence = [bk4, bk1, bk3, bk5, bk2]
-  sptest.positive_sequence[0] = &(sptest.map_blocks["bk1"]);
-  sptest.map_blocks["bk1"].idx_positive_sequence = 0;
-  sptest.positive_sequence[1] = &(sptest.map_blocks["bk3"]);
-  sptest.map_blocks["bk3"].idx_positive_sequence = 1;
-  sptest.positive_sequence[2] = &(sptest.map_blocks["bk2"]);
-  sptest.map_blocks["bk2"].idx_positive_sequence = 2;
-  sptest.positive_sequence[3] = &(sptest.map_blocks["bk5"]);
-  sptest.map_blocks["bk5"].idx_positive_sequence = 3;
-  sptest.positive_sequence[4] = &(sptest.map_blocks["bk4"]);
-  sptest.map_blocks["bk4"].idx_positive_sequence = 4;
+  sptest.positive_sequence[0] = sptest.map_blocks["bk1"];
+  sptest.idx_positive_sequence[sptest.map_blocks["bk1"]] = 0;
+  sptest.positive_sequence[1] = sptest.map_blocks["bk3"];
+  sptest.idx_positive_sequence[sptest.map_blocks["bk3"]] = 1;
+  sptest.positive_sequence[2] = sptest.map_blocks["bk2"];
+  sptest.idx_positive_sequence[sptest.map_blocks["bk2"]] = 2;
+  sptest.positive_sequence[3] = sptest.map_blocks["bk5"];
+  sptest.idx_positive_sequence[sptest.map_blocks["bk5"]] = 3;
+  sptest.positive_sequence[4] = sptest.map_blocks["bk4"];
+  sptest.idx_positive_sequence[sptest.map_blocks["bk4"]] = 4;
   
-  sptest.negative_sequence[0] = &(sptest.map_blocks["bk4"]);
-  sptest.map_blocks["bk4"].idx_negative_sequence = 0;
-  sptest.negative_sequence[1] = &(sptest.map_blocks["bk1"]);
-  sptest.map_blocks["bk1"].idx_negative_sequence = 1;
-  sptest.negative_sequence[2] = &(sptest.map_blocks["bk3"]);
-  sptest.map_blocks["bk3"].idx_negative_sequence = 2;
-  sptest.negative_sequence[3] = &(sptest.map_blocks["bk5"]);
-  sptest.map_blocks["bk5"].idx_negative_sequence = 3;
-  sptest.negative_sequence[4] = &(sptest.map_blocks["bk2"]);
-  sptest.map_blocks["bk2"].idx_negative_sequence = 4;
+  sptest.negative_sequence[0] = sptest.map_blocks["bk4"];
+  sptest.idx_negative_sequence[sptest.map_blocks["bk4"]] = 0;
+  sptest.negative_sequence[1] = sptest.map_blocks["bk1"];
+  sptest.idx_negative_sequence[sptest.map_blocks["bk1"]] = 1;
+  sptest.negative_sequence[2] = sptest.map_blocks["bk3"];
+  sptest.idx_negative_sequence[sptest.map_blocks["bk3"]] = 2;
+  sptest.negative_sequence[3] = sptest.map_blocks["bk5"];
+  sptest.idx_negative_sequence[sptest.map_blocks["bk5"]] = 3;
+  sptest.negative_sequence[4] = sptest.map_blocks["bk2"];
+  sptest.idx_negative_sequence[sptest.map_blocks["bk2"]] = 4;
 
   sptest.construct_relative_locations(0, 4, MoveType::nomove);
   
@@ -2991,209 +3023,217 @@ TEST_CASE("verify update_backup_data" * doctest::timeout(600)) {
 
   SUBCASE("SUB : update after move1") {
     std::pair<size_t, size_t> pair_idx = sptest.move1();
+    Backup backup(sptest);
     sptest.update_backup_data(pair_idx.first, pair_idx.second, MoveType::move1);
+    undo_next_move(sptest);
 
     for (size_t i = 0; i < sptest.num_blocks; ++i) {
       REQUIRE(
         sptest.positive_sequence[i] ==
-        sptest.backup_positive_sequence[i]);
+        backup.positive_sequence[i]);
       REQUIRE(
         sptest.negative_sequence[i] ==
-        sptest.backup_negative_sequence[i]);
+        backup.negative_sequence[i]);
 
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence == i);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] == i);
       
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence ==
-        sptest.positive_sequence[i]->backup_idx_positive_sequence);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] ==
+        backup.idx_positive_sequence[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->idx_negative_sequence ==
-        sptest.positive_sequence[i]->backup_idx_negative_sequence);
+        sptest.idx_negative_sequence[sptest.positive_sequence[i]] ==
+        backup.idx_negative_sequence[sptest.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence ==
-        sptest.backup_positive_sequence[i]->idx_positive_sequence);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] ==
+        sptest.idx_positive_sequence[backup.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->idx_negative_sequence ==
-        sptest.backup_positive_sequence[i]->idx_negative_sequence);
+        sptest.idx_negative_sequence[sptest.positive_sequence[i]] ==
+        sptest.idx_negative_sequence[backup.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.backup_positive_sequence[i]->idx_positive_sequence ==
-        sptest.backup_positive_sequence[i]->backup_idx_positive_sequence);
+        sptest.idx_positive_sequence[backup.positive_sequence[i]] ==
+        backup.idx_positive_sequence[backup.positive_sequence[i]]);
       REQUIRE(
-        sptest.backup_positive_sequence[i]->idx_negative_sequence ==
-        sptest.backup_positive_sequence[i]->backup_idx_negative_sequence);
+        sptest.idx_negative_sequence[backup.positive_sequence[i]] ==
+        backup.idx_negative_sequence[backup.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.positive_sequence[i]->width ==
-        sptest.positive_sequence[i]->backup_width);
+        sptest.width[sptest.positive_sequence[i]] ==
+        backup.width[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->height ==
-        sptest.positive_sequence[i]->backup_height);
+        sptest.height[sptest.positive_sequence[i]] ==
+        backup.height[sptest.positive_sequence[i]]);
     
       REQUIRE(
-        sptest.positive_sequence[i]->rightof ==
-        sptest.positive_sequence[i]->backup_rightof);
+        sptest.rightof[sptest.positive_sequence[i]] ==
+        backup.rightof[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->aboveof ==
-        sptest.positive_sequence[i]->backup_aboveof);
+        sptest.aboveof[sptest.positive_sequence[i]] ==
+        backup.aboveof[sptest.positive_sequence[i]]);
     }
   }
   
   SUBCASE("SUB : update after move2") {
     std::pair<size_t, size_t> pair_idx = sptest.move2();
+    Backup backup(sptest);
     sptest.update_backup_data(pair_idx.first, pair_idx.second, MoveType::move2);
+    undo_next_move(sptest);
 
     for (size_t i = 0; i < sptest.num_blocks; ++i) {
       REQUIRE(
         sptest.positive_sequence[i] ==
-        sptest.backup_positive_sequence[i]);
+        backup.positive_sequence[i]);
       REQUIRE(
         sptest.negative_sequence[i] ==
-        sptest.backup_negative_sequence[i]);
+        backup.negative_sequence[i]);
 
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence == i);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] == i);
       
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence ==
-        sptest.positive_sequence[i]->backup_idx_positive_sequence);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] ==
+        backup.idx_positive_sequence[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->idx_negative_sequence ==
-        sptest.positive_sequence[i]->backup_idx_negative_sequence);
+        sptest.idx_negative_sequence[sptest.positive_sequence[i]] ==
+        backup.idx_negative_sequence[sptest.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence ==
-        sptest.backup_positive_sequence[i]->idx_positive_sequence);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] ==
+        sptest.idx_positive_sequence[backup.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->idx_negative_sequence ==
-        sptest.backup_positive_sequence[i]->idx_negative_sequence);
+        sptest.idx_negative_sequence[sptest.positive_sequence[i]] ==
+        sptest.idx_negative_sequence[backup.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.backup_positive_sequence[i]->idx_positive_sequence ==
-        sptest.backup_positive_sequence[i]->backup_idx_positive_sequence);
+        sptest.idx_positive_sequence[backup.positive_sequence[i]] ==
+        backup.idx_positive_sequence[backup.positive_sequence[i]]);
       REQUIRE(
-        sptest.backup_positive_sequence[i]->idx_negative_sequence ==
-        sptest.backup_positive_sequence[i]->backup_idx_negative_sequence);
+        sptest.idx_negative_sequence[backup.positive_sequence[i]] ==
+        backup.idx_negative_sequence[backup.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.positive_sequence[i]->width ==
-        sptest.positive_sequence[i]->backup_width);
+        sptest.width[sptest.positive_sequence[i]] ==
+        backup.width[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->height ==
-        sptest.positive_sequence[i]->backup_height);
+        sptest.height[sptest.positive_sequence[i]] ==
+        backup.height[sptest.positive_sequence[i]]);
     
       REQUIRE(
-        sptest.positive_sequence[i]->rightof ==
-        sptest.positive_sequence[i]->backup_rightof);
+        sptest.rightof[sptest.positive_sequence[i]] ==
+        backup.rightof[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->aboveof ==
-        sptest.positive_sequence[i]->backup_aboveof);
+        sptest.aboveof[sptest.positive_sequence[i]] ==
+        backup.aboveof[sptest.positive_sequence[i]]);
     }
   }
 
   SUBCASE("SUB : update after move3") {
     std::pair<size_t, size_t> pair_idx = sptest.move3();
+    Backup backup(sptest);
     sptest.update_backup_data(pair_idx.first, pair_idx.second, MoveType::move3);
+    undo_next_move(sptest);
 
     for (size_t i = 0; i < sptest.num_blocks; ++i) {
       REQUIRE(
         sptest.positive_sequence[i] ==
-        sptest.backup_positive_sequence[i]);
+        backup.positive_sequence[i]);
       REQUIRE(
         sptest.negative_sequence[i] ==
-        sptest.backup_negative_sequence[i]);
+        backup.negative_sequence[i]);
 
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence == i);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] == i);
       
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence ==
-        sptest.positive_sequence[i]->backup_idx_positive_sequence);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] ==
+        backup.idx_positive_sequence[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->idx_negative_sequence ==
-        sptest.positive_sequence[i]->backup_idx_negative_sequence);
+        sptest.idx_negative_sequence[sptest.positive_sequence[i]] ==
+        backup.idx_negative_sequence[sptest.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence ==
-        sptest.backup_positive_sequence[i]->idx_positive_sequence);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] ==
+        sptest.idx_positive_sequence[backup.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->idx_negative_sequence ==
-        sptest.backup_positive_sequence[i]->idx_negative_sequence);
+        sptest.idx_negative_sequence[sptest.positive_sequence[i]] ==
+        sptest.idx_negative_sequence[backup.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.backup_positive_sequence[i]->idx_positive_sequence ==
-        sptest.backup_positive_sequence[i]->backup_idx_positive_sequence);
+        sptest.idx_positive_sequence[backup.positive_sequence[i]] ==
+        backup.idx_positive_sequence[backup.positive_sequence[i]]);
       REQUIRE(
-        sptest.backup_positive_sequence[i]->idx_negative_sequence ==
-        sptest.backup_positive_sequence[i]->backup_idx_negative_sequence);
+        sptest.idx_negative_sequence[backup.positive_sequence[i]] ==
+        backup.idx_negative_sequence[backup.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.positive_sequence[i]->width ==
-        sptest.positive_sequence[i]->backup_width);
+        sptest.width[sptest.positive_sequence[i]] ==
+        backup.width[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->height ==
-        sptest.positive_sequence[i]->backup_height);
+        sptest.height[sptest.positive_sequence[i]] ==
+        backup.height[sptest.positive_sequence[i]]);
     
       REQUIRE(
-        sptest.positive_sequence[i]->rightof ==
-        sptest.positive_sequence[i]->backup_rightof);
+        sptest.rightof[sptest.positive_sequence[i]] ==
+        backup.rightof[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->aboveof ==
-        sptest.positive_sequence[i]->backup_aboveof);
+        sptest.aboveof[sptest.positive_sequence[i]] ==
+        backup.aboveof[sptest.positive_sequence[i]]);
     }
   }
   
   SUBCASE("SUB : update after move4") {
     std::pair<size_t, size_t> pair_idx = sptest.move4();
+    Backup backup(sptest);
     sptest.update_backup_data(pair_idx.first, pair_idx.second, MoveType::move4);
+    undo_next_move(sptest);
 
     for (size_t i = 0; i < sptest.num_blocks; ++i) {
       REQUIRE(
         sptest.positive_sequence[i] ==
-        sptest.backup_positive_sequence[i]);
+        backup.positive_sequence[i]);
       REQUIRE(
         sptest.negative_sequence[i] ==
-        sptest.backup_negative_sequence[i]);
+        backup.negative_sequence[i]);
 
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence == i);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] == i);
       
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence ==
-        sptest.positive_sequence[i]->backup_idx_positive_sequence);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] ==
+        backup.idx_positive_sequence[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->idx_negative_sequence ==
-        sptest.positive_sequence[i]->backup_idx_negative_sequence);
+        sptest.idx_negative_sequence[sptest.positive_sequence[i]] ==
+        backup.idx_negative_sequence[sptest.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence ==
-        sptest.backup_positive_sequence[i]->idx_positive_sequence);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] ==
+        sptest.idx_positive_sequence[backup.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->idx_negative_sequence ==
-        sptest.backup_positive_sequence[i]->idx_negative_sequence);
+        sptest.idx_negative_sequence[sptest.positive_sequence[i]] ==
+        sptest.idx_negative_sequence[backup.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.backup_positive_sequence[i]->idx_positive_sequence ==
-        sptest.backup_positive_sequence[i]->backup_idx_positive_sequence);
+        sptest.idx_positive_sequence[backup.positive_sequence[i]] ==
+        backup.idx_positive_sequence[backup.positive_sequence[i]]);
       REQUIRE(
-        sptest.backup_positive_sequence[i]->idx_negative_sequence ==
-        sptest.backup_positive_sequence[i]->backup_idx_negative_sequence);
+        sptest.idx_negative_sequence[backup.positive_sequence[i]] ==
+        backup.idx_negative_sequence[backup.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.positive_sequence[i]->width ==
-        sptest.positive_sequence[i]->backup_width);
+        sptest.width[sptest.positive_sequence[i]] ==
+        backup.width[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->height ==
-        sptest.positive_sequence[i]->backup_height);
+        sptest.height[sptest.positive_sequence[i]] ==
+        backup.height[sptest.positive_sequence[i]]);
     
       REQUIRE(
-        sptest.positive_sequence[i]->rightof ==
-        sptest.positive_sequence[i]->backup_rightof);
+        sptest.rightof[sptest.positive_sequence[i]] ==
+        backup.rightof[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->aboveof ==
-        sptest.positive_sequence[i]->backup_aboveof);
+        sptest.aboveof[sptest.positive_sequence[i]] ==
+        backup.aboveof[sptest.positive_sequence[i]]);
     }
   }
 }
@@ -3206,27 +3246,27 @@ TEST_CASE("verify_resume_backup_data" * doctest::timeout(600)) {
   
   // positive sequence = [bk1, bk3, bk2, bk5, bk4]
   // negative sequence = [bk4, bk1, bk3, bk5, bk2]
-  sptest.positive_sequence[0] = &(sptest.map_blocks["bk1"]);
-  sptest.map_blocks["bk1"].idx_positive_sequence = 0;
-  sptest.positive_sequence[1] = &(sptest.map_blocks["bk3"]);
-  sptest.map_blocks["bk3"].idx_positive_sequence = 1;
-  sptest.positive_sequence[2] = &(sptest.map_blocks["bk2"]);
-  sptest.map_blocks["bk2"].idx_positive_sequence = 2;
-  sptest.positive_sequence[3] = &(sptest.map_blocks["bk5"]);
-  sptest.map_blocks["bk5"].idx_positive_sequence = 3;
-  sptest.positive_sequence[4] = &(sptest.map_blocks["bk4"]);
-  sptest.map_blocks["bk4"].idx_positive_sequence = 4;
+  sptest.positive_sequence[0] = sptest.map_blocks["bk1"];
+  sptest.idx_positive_sequence[sptest.map_blocks["bk1"]] = 0;
+  sptest.positive_sequence[1] = sptest.map_blocks["bk3"];
+  sptest.idx_positive_sequence[sptest.map_blocks["bk3"]] = 1;
+  sptest.positive_sequence[2] = sptest.map_blocks["bk2"];
+  sptest.idx_positive_sequence[sptest.map_blocks["bk2"]] = 2;
+  sptest.positive_sequence[3] = sptest.map_blocks["bk5"];
+  sptest.idx_positive_sequence[sptest.map_blocks["bk5"]] = 3;
+  sptest.positive_sequence[4] = sptest.map_blocks["bk4"];
+  sptest.idx_positive_sequence[sptest.map_blocks["bk4"]] = 4;
   
-  sptest.negative_sequence[0] = &(sptest.map_blocks["bk4"]);
-  sptest.map_blocks["bk4"].idx_negative_sequence = 0;
-  sptest.negative_sequence[1] = &(sptest.map_blocks["bk1"]);
-  sptest.map_blocks["bk1"].idx_negative_sequence = 1;
-  sptest.negative_sequence[2] = &(sptest.map_blocks["bk3"]);
-  sptest.map_blocks["bk3"].idx_negative_sequence = 2;
-  sptest.negative_sequence[3] = &(sptest.map_blocks["bk5"]);
-  sptest.map_blocks["bk5"].idx_negative_sequence = 3;
-  sptest.negative_sequence[4] = &(sptest.map_blocks["bk2"]);
-  sptest.map_blocks["bk2"].idx_negative_sequence = 4;
+  sptest.negative_sequence[0] = sptest.map_blocks["bk4"];
+  sptest.idx_negative_sequence[sptest.map_blocks["bk4"]] = 0;
+  sptest.negative_sequence[1] = sptest.map_blocks["bk1"];
+  sptest.idx_negative_sequence[sptest.map_blocks["bk1"]] = 1;
+  sptest.negative_sequence[2] = sptest.map_blocks["bk3"];
+  sptest.idx_negative_sequence[sptest.map_blocks["bk3"]] = 2;
+  sptest.negative_sequence[3] = sptest.map_blocks["bk5"];
+  sptest.idx_negative_sequence[sptest.map_blocks["bk5"]] = 3;
+  sptest.negative_sequence[4] = sptest.map_blocks["bk2"];
+  sptest.idx_negative_sequence[sptest.map_blocks["bk2"]] = 4;
 
   sptest.construct_relative_locations(0, 4, MoveType::nomove);
   
@@ -3239,6 +3279,7 @@ TEST_CASE("verify_resume_backup_data" * doctest::timeout(600)) {
   sptest.compute_hpwl();
 
   sptest.initialize_backup_data();
+  Backup backup(sptest);
 
   SUBCASE("SUB : resume after move1") {
     std::pair<size_t, size_t> pair_idx = sptest.move1();
@@ -3247,48 +3288,48 @@ TEST_CASE("verify_resume_backup_data" * doctest::timeout(600)) {
     for (size_t i = 0; i < sptest.num_blocks; ++i) {
       REQUIRE(
         sptest.positive_sequence[i] ==
-        sptest.backup_positive_sequence[i]);
+        backup.positive_sequence[i]);
       REQUIRE(
         sptest.negative_sequence[i] ==
-        sptest.backup_negative_sequence[i]);
+        backup.negative_sequence[i]);
 
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence == i);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] == i);
       
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence ==
-        sptest.positive_sequence[i]->backup_idx_positive_sequence);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] ==
+        backup.idx_positive_sequence[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->idx_negative_sequence ==
-        sptest.positive_sequence[i]->backup_idx_negative_sequence);
+        sptest.idx_negative_sequence[sptest.positive_sequence[i]] ==
+        backup.idx_negative_sequence[sptest.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence ==
-        sptest.backup_positive_sequence[i]->idx_positive_sequence);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] ==
+        sptest.idx_positive_sequence[backup.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->idx_negative_sequence ==
-        sptest.backup_positive_sequence[i]->idx_negative_sequence);
+        sptest.idx_negative_sequence[sptest.positive_sequence[i]] ==
+        sptest.idx_negative_sequence[backup.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.backup_positive_sequence[i]->idx_positive_sequence ==
-        sptest.backup_positive_sequence[i]->backup_idx_positive_sequence);
+        sptest.idx_positive_sequence[backup.positive_sequence[i]] ==
+        backup.idx_positive_sequence[backup.positive_sequence[i]]);
       REQUIRE(
-        sptest.backup_positive_sequence[i]->idx_negative_sequence ==
-        sptest.backup_positive_sequence[i]->backup_idx_negative_sequence);
+        sptest.idx_negative_sequence[backup.positive_sequence[i]] ==
+        backup.idx_negative_sequence[backup.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.positive_sequence[i]->width ==
-        sptest.positive_sequence[i]->backup_width);
+        sptest.width[sptest.positive_sequence[i]] ==
+        backup.width[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->height ==
-        sptest.positive_sequence[i]->backup_height);
+        sptest.height[sptest.positive_sequence[i]] ==
+        backup.height[sptest.positive_sequence[i]]);
     
       REQUIRE(
-        sptest.positive_sequence[i]->rightof ==
-        sptest.positive_sequence[i]->backup_rightof);
+        sptest.rightof[sptest.positive_sequence[i]] ==
+        backup.rightof[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->aboveof ==
-        sptest.positive_sequence[i]->backup_aboveof);
+        sptest.aboveof[sptest.positive_sequence[i]] ==
+        backup.aboveof[sptest.positive_sequence[i]]);
     }
   }
   
@@ -3299,48 +3340,48 @@ TEST_CASE("verify_resume_backup_data" * doctest::timeout(600)) {
     for (size_t i = 0; i < sptest.num_blocks; ++i) {
       REQUIRE(
         sptest.positive_sequence[i] ==
-        sptest.backup_positive_sequence[i]);
+        backup.positive_sequence[i]);
       REQUIRE(
         sptest.negative_sequence[i] ==
-        sptest.backup_negative_sequence[i]);
+        backup.negative_sequence[i]);
 
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence == i);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] == i);
       
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence ==
-        sptest.positive_sequence[i]->backup_idx_positive_sequence);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] ==
+        backup.idx_positive_sequence[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->idx_negative_sequence ==
-        sptest.positive_sequence[i]->backup_idx_negative_sequence);
+        sptest.idx_negative_sequence[sptest.positive_sequence[i]] ==
+        backup.idx_negative_sequence[sptest.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence ==
-        sptest.backup_positive_sequence[i]->idx_positive_sequence);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] ==
+        sptest.idx_positive_sequence[backup.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->idx_negative_sequence ==
-        sptest.backup_positive_sequence[i]->idx_negative_sequence);
+        sptest.idx_negative_sequence[sptest.positive_sequence[i]] ==
+        sptest.idx_negative_sequence[backup.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.backup_positive_sequence[i]->idx_positive_sequence ==
-        sptest.backup_positive_sequence[i]->backup_idx_positive_sequence);
+        sptest.idx_positive_sequence[backup.positive_sequence[i]] ==
+        backup.idx_positive_sequence[backup.positive_sequence[i]]);
       REQUIRE(
-        sptest.backup_positive_sequence[i]->idx_negative_sequence ==
-        sptest.backup_positive_sequence[i]->backup_idx_negative_sequence);
+        sptest.idx_negative_sequence[backup.positive_sequence[i]] ==
+        backup.idx_negative_sequence[backup.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.positive_sequence[i]->width ==
-        sptest.positive_sequence[i]->backup_width);
+        sptest.width[sptest.positive_sequence[i]] ==
+        backup.width[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->height ==
-        sptest.positive_sequence[i]->backup_height);
+        sptest.height[sptest.positive_sequence[i]] ==
+        backup.height[sptest.positive_sequence[i]]);
     
       REQUIRE(
-        sptest.positive_sequence[i]->rightof ==
-        sptest.positive_sequence[i]->backup_rightof);
+        sptest.rightof[sptest.positive_sequence[i]] ==
+        backup.rightof[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->aboveof ==
-        sptest.positive_sequence[i]->backup_aboveof);
+        sptest.aboveof[sptest.positive_sequence[i]] ==
+        backup.aboveof[sptest.positive_sequence[i]]);
     }
   }
   
@@ -3351,48 +3392,48 @@ TEST_CASE("verify_resume_backup_data" * doctest::timeout(600)) {
     for (size_t i = 0; i < sptest.num_blocks; ++i) {
       REQUIRE(
         sptest.positive_sequence[i] ==
-        sptest.backup_positive_sequence[i]);
+        backup.positive_sequence[i]);
       REQUIRE(
         sptest.negative_sequence[i] ==
-        sptest.backup_negative_sequence[i]);
+        backup.negative_sequence[i]);
 
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence == i);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] == i);
       
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence ==
-        sptest.positive_sequence[i]->backup_idx_positive_sequence);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] ==
+        backup.idx_positive_sequence[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->idx_negative_sequence ==
-        sptest.positive_sequence[i]->backup_idx_negative_sequence);
+        sptest.idx_negative_sequence[sptest.positive_sequence[i]] ==
+        backup.idx_negative_sequence[sptest.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence ==
-        sptest.backup_positive_sequence[i]->idx_positive_sequence);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] ==
+        sptest.idx_positive_sequence[backup.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->idx_negative_sequence ==
-        sptest.backup_positive_sequence[i]->idx_negative_sequence);
+        sptest.idx_negative_sequence[sptest.positive_sequence[i]] ==
+        sptest.idx_negative_sequence[backup.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.backup_positive_sequence[i]->idx_positive_sequence ==
-        sptest.backup_positive_sequence[i]->backup_idx_positive_sequence);
+        sptest.idx_positive_sequence[backup.positive_sequence[i]] ==
+        backup.idx_positive_sequence[backup.positive_sequence[i]]);
       REQUIRE(
-        sptest.backup_positive_sequence[i]->idx_negative_sequence ==
-        sptest.backup_positive_sequence[i]->backup_idx_negative_sequence);
+        sptest.idx_negative_sequence[backup.positive_sequence[i]] ==
+        backup.idx_negative_sequence[backup.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.positive_sequence[i]->width ==
-        sptest.positive_sequence[i]->backup_width);
+        sptest.width[sptest.positive_sequence[i]] ==
+        backup.width[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->height ==
-        sptest.positive_sequence[i]->backup_height);
+        sptest.height[sptest.positive_sequence[i]] ==
+        backup.height[sptest.positive_sequence[i]]);
     
       REQUIRE(
-        sptest.positive_sequence[i]->rightof ==
-        sptest.positive_sequence[i]->backup_rightof);
+        sptest.rightof[sptest.positive_sequence[i]] ==
+        backup.rightof[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->aboveof ==
-        sptest.positive_sequence[i]->backup_aboveof);
+        sptest.aboveof[sptest.positive_sequence[i]] ==
+        backup.aboveof[sptest.positive_sequence[i]]);
     }
   }
   
@@ -3403,50 +3444,520 @@ TEST_CASE("verify_resume_backup_data" * doctest::timeout(600)) {
     for (size_t i = 0; i < sptest.num_blocks; ++i) {
       REQUIRE(
         sptest.positive_sequence[i] ==
-        sptest.backup_positive_sequence[i]);
+        backup.positive_sequence[i]);
       REQUIRE(
         sptest.negative_sequence[i] ==
-        sptest.backup_negative_sequence[i]);
+        backup.negative_sequence[i]);
 
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence == i);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] == i);
       
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence ==
-        sptest.positive_sequence[i]->backup_idx_positive_sequence);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] ==
+        backup.idx_positive_sequence[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->idx_negative_sequence ==
-        sptest.positive_sequence[i]->backup_idx_negative_sequence);
+        sptest.idx_negative_sequence[sptest.positive_sequence[i]] ==
+        backup.idx_negative_sequence[sptest.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.positive_sequence[i]->idx_positive_sequence ==
-        sptest.backup_positive_sequence[i]->idx_positive_sequence);
+        sptest.idx_positive_sequence[sptest.positive_sequence[i]] ==
+        sptest.idx_positive_sequence[backup.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->idx_negative_sequence ==
-        sptest.backup_positive_sequence[i]->idx_negative_sequence);
+        sptest.idx_negative_sequence[sptest.positive_sequence[i]] ==
+        sptest.idx_negative_sequence[backup.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.backup_positive_sequence[i]->idx_positive_sequence ==
-        sptest.backup_positive_sequence[i]->backup_idx_positive_sequence);
+        sptest.idx_positive_sequence[backup.positive_sequence[i]] ==
+        backup.idx_positive_sequence[backup.positive_sequence[i]]);
       REQUIRE(
-        sptest.backup_positive_sequence[i]->idx_negative_sequence ==
-        sptest.backup_positive_sequence[i]->backup_idx_negative_sequence);
+        sptest.idx_negative_sequence[backup.positive_sequence[i]] ==
+        backup.idx_negative_sequence[backup.positive_sequence[i]]);
       
       REQUIRE(
-        sptest.positive_sequence[i]->width ==
-        sptest.positive_sequence[i]->backup_width);
+        sptest.width[sptest.positive_sequence[i]] ==
+        backup.width[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->height ==
-        sptest.positive_sequence[i]->backup_height);
+        sptest.height[sptest.positive_sequence[i]] ==
+        backup.height[sptest.positive_sequence[i]]);
     
       REQUIRE(
-        sptest.positive_sequence[i]->rightof ==
-        sptest.positive_sequence[i]->backup_rightof);
+        sptest.rightof[sptest.positive_sequence[i]] ==
+        backup.rightof[sptest.positive_sequence[i]]);
       REQUIRE(
-        sptest.positive_sequence[i]->aboveof ==
-        sptest.positive_sequence[i]->backup_aboveof);
+        sptest.aboveof[sptest.positive_sequence[i]] ==
+        backup.aboveof[sptest.positive_sequence[i]]);
+    }
+  }
+}
+
+// verify weighted_lcs against spfa
+TEST_CASE("verify_weighted_lcs" * doctest::timeout(600)) {
+  SPTest sptest;
+
+  for (size_t trial = 0; trial < 200; ++trial) {
+    sptest.positive_sequence.clear();
+    sptest.negative_sequence.clear();
+    sptest.initialize_sequence();
+
+    // rotate some of the blocks
+    for (auto& [key, value] : sptest.map_blocks) {
+      if (fp::random_value()%2) {
+        std::swap(sptest.width[value], sptest.height[value]);
+      }
+    }
+
+    sptest.rightof[sptest.source].clear();
+    sptest.aboveof[sptest.source].clear();
+    sptest.construct_relative_locations(0, 4, MoveType::nomove);
+
+    REQUIRE(sptest.weighted_lcs(Orientation::Horizontal) ==
+            sptest.spfa(Orientation::Horizontal));
+    REQUIRE(sptest.weighted_lcs(Orientation::Vertical) ==
+            sptest.spfa(Orientation::Vertical));
+  }
+
+  // both engines pack to the same cost
+  sptest.pack_engine = PackEngine::SPFA;
+  sptest.num_iterations = 1;
+  double cost = sptest.pack();
+  int bb_width = sptest.bb_width;
+  int bb_height = sptest.bb_height;
+  int hpwl = sptest.hpwl;
+
+  sptest.pack_engine = PackEngine::LCS;
+  sptest.average_area = 0.0;
+  sptest.average_length = 0.0;
+  REQUIRE(sptest.pack() == cost);
+  REQUIRE(sptest.bb_width == bb_width);
+  REQUIRE(sptest.bb_height == bb_height);
+  REQUIRE(sptest.hpwl == hpwl);
+}
+
+// verify dag_longest_path against spfa, also after moves
+// that only rebuild the relative locations of a range
+TEST_CASE("verify_dag_longest_path" * doctest::timeout(600)) {
+  SPTest sptest;
+  sptest.initialize_sequence();
+  sptest.initialize_graph_rows();
+  sptest.construct_relative_locations(0, 4, MoveType::nomove);
+
+  for (size_t trial = 0; trial < 200; ++trial) {
+    REQUIRE(sptest.dag_longest_path(Orientation::Horizontal) ==
+            sptest.spfa(Orientation::Horizontal));
+    REQUIRE(sptest.dag_longest_path(Orientation::Vertical) ==
+            sptest.spfa(Orientation::Vertical));
+    REQUIRE(sptest.dag_longest_path(Orientation::Horizontal) ==
+            sptest.weighted_lcs(Orientation::Horizontal));
+    REQUIRE(sptest.dag_longest_path(Orientation::Vertical) ==
+            sptest.weighted_lcs(Orientation::Vertical));
+
+    std::pair<size_t, size_t> pair_idx;
+    MoveType move_type = static_cast<MoveType>(trial%4+1);
+    switch (move_type) {
+      case 1: pair_idx = sptest.move1(); break;
+      case 2: pair_idx = sptest.move2(); break;
+      case 3: pair_idx = sptest.move3(); break;
+      default: pair_idx = sptest.move4(); break;
+    }
+    sptest.construct_relative_locations(
+      pair_idx.first, pair_idx.second, move_type);
+  }
+
+  // undo puts the rows of the moved blocks back too
+  SPTest sprun;
+  sprun.initialize_sequence();
+  sprun.outline_width = 800;
+  sprun.outline_height = 600;
+  sprun.pack_engine = PackEngine::DAG;
+  sprun.incremental = false;
+  sprun.start();
+  for (size_t trial = 0; trial < 200; ++trial) {
+    Move move = sprun.propose();
+    sprun.try_move(move);
+    sprun.undo(move);
+    REQUIRE(sprun.dag_longest_path(Orientation::Horizontal) ==
+            sprun.spfa(Orientation::Horizontal));
+    REQUIRE(sprun.dag_longest_path(Orientation::Vertical) ==
+            sprun.spfa(Orientation::Vertical));
+  }
+
+  // the other engines never allocate the rows
+  SPTest splcs;
+  splcs.initialize_sequence();
+  splcs.outline_width = 800;
+  splcs.outline_height = 600;
+  splcs.start();
+  REQUIRE(splcs.graph_edges[Orientation::Horizontal].empty());
+  REQUIRE(splcs.graph_edges[Orientation::Vertical].empty());
+}
+
+// verify repack against pack after random moves,
+// and that resume_backup_data undoes it
+TEST_CASE("verify_repack" * doctest::timeout(600)) {
+  SPTest sptest;
+  sptest.initialize_sequence();
+  sptest.outline_width = 800;
+  sptest.outline_height = 600;
+  
+  sptest.num_iterations = 1;
+  sptest.pack();
+  sptest.initialize_backup_data();
+
+  SPTest reference;
+  reference.outline_width = sptest.outline_width;
+  reference.outline_height = sptest.outline_height;
+
+  for (size_t trial = 0; trial < 1000; ++trial) {
+    Backup backup(sptest);
+    std::pair<size_t, size_t> pair_idx;
+    MoveType move_type = static_cast<MoveType>(trial%4+1);
+    switch (move_type) {
+      case 1: pair_idx = sptest.move1(); break;
+      case 2: pair_idx = sptest.move2(); break;
+      case 3: pair_idx = sptest.move3(); break;
+      default: pair_idx = sptest.move4(); break;
     }
+
+    ++sptest.num_iterations;
+    sptest.repack(pair_idx.first, pair_idx.second, move_type);
+    Backup moved(sptest);
+
+    // the same sequence pair packed from scratch
+    reference.positive_sequence = sptest.positive_sequence;
+    reference.negative_sequence = sptest.negative_sequence;
+    reference.idx_positive_sequence = sptest.idx_positive_sequence;
+    reference.idx_negative_sequence = sptest.idx_negative_sequence;
+    reference.width = sptest.width;
+    reference.height = sptest.height;
+    reference.num_iterations = 1;
+    reference.pack();
+
+    REQUIRE(sptest.lower_left_x == reference.lower_left_x);
+    REQUIRE(sptest.lower_left_y == reference.lower_left_y);
+    REQUIRE(sptest.bb_width == reference.bb_width);
+    REQUIRE(sptest.bb_height == reference.bb_height);
+    REQUIRE(sptest.excess_width == reference.excess_width);
+    REQUIRE(sptest.excess_height == reference.excess_height);
+    REQUIRE(sptest.overshoot_length == reference.overshoot_length);
+    REQUIRE(sptest.hpwl == reference.hpwl);
+
+    // accept every other move, undo the rest
+    if (trial%2) {
+      sptest.update_backup_data(pair_idx.first, pair_idx.second, move_type);
+    }
+    else {
+      sptest.resume_backup_data(pair_idx.first, pair_idx.second, move_type);
+    }
+    const Backup& expected = trial%2 ? moved : backup;
+    for (auto& [key, value] : sptest.map_blocks) {
+      REQUIRE(sptest.lower_left_x[value] == expected.lower_left_x[value]);
+      REQUIRE(sptest.lower_left_y[value] == expected.lower_left_y[value]);
+      REQUIRE(sptest.width[value] == expected.width[value]);
+    }
+    REQUIRE(sptest.bb_width == expected.bb_width);
+    REQUIRE(sptest.bb_height == expected.bb_height);
+    REQUIRE(sptest.hpwl == expected.hpwl);
+  }
+}
+
+// verify ParallelTempering finds a legal floorplan of benchmarks/1
+TEST_CASE("verify_parallel_tempering" * doctest::timeout(600)) {
+  std::string block_file = scratch("verify_tempering.block");
+  std::string net_file = scratch("verify_tempering.nets");
+  std::ofstream blk(block_file);
+  blk << "Outline: 600 1200\nNumBlocks: 5\nNumTerminals: 3\n"
+      << "bk1 200 200\nbk2 600 600\nbk3 400 200\nbk4 400 400\n"
+      << "bk5 200 400\n\nVSS terminal 1281 1463\nVDD terminal 1687 0\n"
+      << "P9 terminal 266 0\n";
+  blk.close();
+  std::ofstream nets(net_file);
+  nets << "NumNets: 1\nNetDegree: 4\nbk1\nbk2\nbk3\nbk4\n";
+  nets.close();
+
+  SP sp(0.6, block_file, net_file, "");
+
+  ParallelTempering tempering(0.6, block_file, net_file);
+  tempering.num_replicas = 4;
+  tempering.num_threads = 2;
+  tempering.iterations_per_round = 200;
+  tempering.patience = 5;
+  REQUIRE(tempering.run(sp) == true);
+  REQUIRE(tempering.num_rounds >= 5);
+  REQUIRE(tempering.seconds_to_legal >= 0.0);
+
+  // the blocks keep their sizes, do not overlap and fit the outline
+  REQUIRE(sp.fits_outline());
+  SPTest sptest;
+  size_t area = 0;
+  for (size_t blk = 0; blk < sp.num_blocks; ++blk) {
+    REQUIRE(std::min(sp.width[blk], sp.height[blk]) == 
+            std::min(sptest.width[blk], sptest.height[blk]));
+    REQUIRE(sp.lower_left_x[blk] + sp.width[blk] <= sp.bb_width);
+    REQUIRE(sp.lower_left_y[blk] + sp.height[blk] <= sp.bb_height);
+    for (size_t other = 0; other < blk; ++other) {
+      bool apart = 
+        sp.lower_left_x[blk] >= sp.lower_left_x[other] + sp.width[other] ||
+        sp.lower_left_x[other] >= sp.lower_left_x[blk] + sp.width[blk] ||
+        sp.lower_left_y[blk] >= sp.lower_left_y[other] + sp.height[other] ||
+        sp.lower_left_y[other] >= sp.lower_left_y[blk] + sp.height[blk];
+      REQUIRE(apart);
+    }
+    area += sp.width[blk] * sp.height[blk];
+  }
+  REQUIRE(area <= static_cast<size_t>(sp.bb_width*sp.bb_height));
+  REQUIRE(sp.hpwl == sp.compute_hpwl()/2);
+
+  // the workers are started again for another run, one per replica
+  tempering.num_threads = 4;
+  REQUIRE(tempering.run(sp) == true);
+  REQUIRE(tempering.num_threads == 4);
+  REQUIRE(sp.fits_outline());
+
+  std::remove(block_file.c_str());
+  std::remove(net_file.c_str());
+}
+
+// verify SpeculativeAnnealer leaves the chain as SP::anneal would
+TEST_CASE("verify_speculative_anneal" * doctest::timeout(600)) {
+  std::string block_file = scratch("verify_speculative.block");
+  std::string net_file = scratch("verify_speculative.nets");
+  std::ofstream blk(block_file);
+  blk << "Outline: 600 1200\nNumBlocks: 5\nNumTerminals: 3\n"
+      << "bk1 200 200\nbk2 600 600\nbk3 400 200\nbk4 400 400\n"
+      << "bk5 200 400\n\nVSS terminal 1281 1463\nVDD terminal 1687 0\n"
+      << "P9 terminal 266 0\n";
+  blk.close();
+  std::ofstream nets(net_file);
+  nets << "NumNets: 1\nNetDegree: 4\nbk1\nbk2\nbk3\nbk4\n";
+  nets.close();
+
+  SP sp(0.6, block_file, net_file, "");
+  sp.start();
+
+  SpeculativeAnnealer annealer(sp, block_file, net_file);
+  annealer.num_threads = 3;
+  annealer.max_acceptance = 1.0;
+
+  // hot temperatures commit most batches, cold ones few
+  for (double temperature : {100.0, 10.0, 1.0, 0.1}) {
+    annealer.anneal(temperature, 300);
+  }
+  REQUIRE(annealer.num_batches > 0);
+  REQUIRE(annealer.num_wasted > 0);
+
+  // only the kept moves count
+  REQUIRE(sp.num_iterations == 1 + sp.num_accepted);
+
+  // the floorplan is the packed sequence pair and costs backup_cost
+  SP reference(0.6, block_file, net_file, "");
+  reference.positive_sequence = sp.positive_sequence;
+  reference.negative_sequence = sp.negative_sequence;
+  reference.idx_positive_sequence = sp.idx_positive_sequence;
+  reference.idx_negative_sequence = sp.idx_negative_sequence;
+  reference.width = sp.width;
+  reference.height = sp.height;
+  reference.penalty_ratio = sp.penalty_ratio;
+  reference.num_iterations = 1;
+  reference.pack();
+
+  REQUIRE(sp.lower_left_x == reference.lower_left_x);
+  REQUIRE(sp.lower_left_y == reference.lower_left_y);
+  REQUIRE(sp.bb_width == reference.bb_width);
+  REQUIRE(sp.bb_height == reference.bb_height);
+  REQUIRE(sp.hpwl == reference.hpwl);
+
+  int overshoot_length = sp.penalty_ratio*(sp.excess_width + sp.excess_height);
+  double cost = 0.6*sp.bb_width*sp.bb_height/sp.average_area +
+                0.4*(sp.hpwl+overshoot_length)/sp.average_length;
+  REQUIRE(sp.backup_cost == doctest::Approx(cost));
+
+  std::remove(block_file.c_str());
+  std::remove(net_file.c_str());
+}
+
+// verify the net boxes repack updates, and undo restores, match
+// the boxes computed from scratch
+TEST_CASE("verify_net_boxes" * doctest::timeout(600)) {
+  SPTest sptest;
+
+  // more nets, sharing blocks, some with terminals
+  sptest.add_net({"bk5", "P9"});
+  sptest.add_net({"bk5", "P9", "bk1", "bk5"});
+  sptest.add_net({"bk3", "bk2"});
+
+  // many nets of bk1, so that moves of the other blocks update
+  // only their nets and moves of bk1 update every net
+  std::vector<std::string> terminals;
+  for (auto& [name, terminal] : sptest.map_terminals) {
+    terminals.push_back(name);
+  }
+  for (auto& name : terminals) {
+    for (size_t i = 0; i < 6; ++i) {
+      sptest.add_net({"bk1", name});
+    }
+  }
+  sptest.num_nets = sptest.net_boxes.size();
+
+  REQUIRE(sptest.block_nets[sptest.map_blocks["bk5"]] ==
+          std::vector<size_t>{1, 2});
+  REQUIRE(sptest.block_nets[sptest.map_blocks["bk4"]] ==
+          std::vector<size_t>{0});
+  REQUIRE(sptest.block_nets[sptest.map_blocks["bk1"]].size() == 20);
+
+  sptest.initialize_sequence();
+  sptest.start();
+
+  auto check = [&sptest]() {
+    for (size_t i = 0; i < sptest.net_boxes.size(); ++i) {
+      REQUIRE(sptest.net_boxes[i] == sptest.net_box(i));
+    }
+    REQUIRE(sptest.wirelength == sptest.compute_hpwl());
+    REQUIRE(sptest.hpwl == sptest.wirelength/2);
+  };
+  check();
+
+  for (size_t trial = 0; trial < 1000; ++trial) {
+    Move move = sptest.propose();
+    double cost = sptest.try_move(move);
+    check();
+
+    if (trial%3) {
+      sptest.undo(move);
+    }
+    else {
+      sptest.keep(move, cost);
+    }
+    check();
+  }
+}
+
+// verify the pins add_net stores and the box net_box computes from
+// them against the pins themselves
+TEST_CASE("verify_add_net" * doctest::timeout(600)) {
+  SPTest sptest;
+
+  std::vector<std::vector<std::string>> nets = {
+    {"bk5", "P9"},
+    {"VDD", "bk1", "VSS", "bk2", "bk3", "bk4", "bk5", "P9"},
+    {"VSS", "P9"},
+    {"bk2", "bk2", "bk4"}
+  };
+  for (auto& net : nets) {
+    sptest.add_net(net);
+  }
+
+  // the net of the fixture comes first
+  REQUIRE(sptest.net_offset == std::vector<size_t>{0, 4, 5, 10, 10, 13});
+  REQUIRE(sptest.net_pins[4] == sptest.map_blocks["bk5"]);
+  REQUIRE(sptest.net_pins[9] == sptest.map_blocks["bk5"]);
+  REQUIRE(sptest.net_pins[12] == sptest.map_blocks["bk4"]);
+  REQUIRE(sptest.terminal_boxes[0] ==
+          std::array<int, 4>{INT_MAX, 0, INT_MAX, 0});
+  REQUIRE(sptest.terminal_boxes[2] ==
+          std::array<int, 4>{2*266, 2*1687, 0, 2*1463});
+  REQUIRE(sptest.block_nets[sptest.map_blocks["bk2"]] ==
+          std::vector<size_t>{0, 2, 4});
+
+  nets.insert(nets.begin(), {"bk1", "bk2", "bk3", "bk4"});
+
+  sptest.initialize_sequence();
+  for (size_t trial = 0; trial < 100; ++trial) {
+    sptest.pack();
+
+    int wirelength = 0;
+    for (size_t n = 0; n < nets.size(); ++n) {
+      int min_x = INT_MAX, max_x = 0, min_y = INT_MAX, max_y = 0;
+      for (auto& pin : nets[n]) {
+        int x = 0, y = 0;
+        if (sptest.map_blocks.count(pin)) {
+          size_t blk = sptest.map_blocks[pin];
+          x = 2*sptest.lower_left_x[blk] + sptest.width[blk];
+          y = 2*sptest.lower_left_y[blk] + sptest.height[blk];
+        }
+        else {
+          x = 2*sptest.map_terminals[pin].pos_x;
+          y = 2*sptest.map_terminals[pin].pos_y;
+        }
+        min_x = std::min(min_x, x);
+        max_x = std::max(max_x, x);
+        min_y = std::min(min_y, y);
+        max_y = std::max(max_y, y);
+      }
+      REQUIRE(sptest.net_box(n) == std::array<int, 4>{min_x, max_x, min_y, max_y});
+      wirelength += (max_x-min_x) + (max_y-min_y);
+    }
+    REQUIRE(sptest.wirelength == wirelength);
+    REQUIRE(sptest.compute_hpwl() == wirelength);
+
+    sptest.move1();
+  }
+}
+
+// verify the adaptive schedule starts from sampled moves without
+// changing the floorplan, and stops once the cost is stable
+TEST_CASE("verify_adaptive_schedule" * doctest::timeout(600)) {
+  SPTest sptest;
+  sptest.initialize_sequence();
+  sptest.start();
+
+  auto positive_sequence = sptest.positive_sequence;
+  auto negative_sequence = sptest.negative_sequence;
+  auto width = sptest.width;
+  auto height = sptest.height;
+  double backup_cost = sptest.backup_cost;
+  size_t num_iterations = sptest.num_iterations;
+
+  double temperature = sptest.start_schedule();
+  double start_temperature = temperature;
+  REQUIRE(temperature > 0.0);
+  REQUIRE(sptest.schedule_iterations == sptest.moves_per_block*5);
+  REQUIRE(sptest.schedule_decay == sptest.min_decay);
+
+  // every sampled move was undone
+  REQUIRE(sptest.positive_sequence == positive_sequence);
+  REQUIRE(sptest.negative_sequence == negative_sequence);
+  REQUIRE(sptest.width == width);
+  REQUIRE(sptest.height == height);
+  REQUIRE(sptest.backup_cost == backup_cost);
+  REQUIRE(sptest.num_iterations == num_iterations);
+  REQUIRE(sptest.schedule_area == sptest.average_area);
+  REQUIRE(sptest.schedule_length == sptest.average_length);
+  REQUIRE(sptest.schedule_cost() == doctest::Approx(backup_cost));
+
+  // most moves accepted, cool fast
+  sptest.frozen_temperature = 0.0;
+  REQUIRE(sptest.next_temperature(temperature, 0.9) == true);
+  REQUIRE(temperature == doctest::Approx(start_temperature*sptest.min_decay));
+  REQUIRE(sptest.lowest_cost == sptest.schedule_cost());
+
+  // few moves accepted and the floorplan unchanged, cool slowly and
+  // stop, even while the running averages drift up
+  size_t num_temperatures = 1;
+  while (sptest.next_temperature(temperature, 0.0)) {
+    sptest.average_area *= 2;
+    sptest.average_length *= 2;
+    ++num_temperatures;
   }
+  REQUIRE(num_temperatures == sptest.num_stable_temperatures);
+  REQUIRE(sptest.schedule_decay == sptest.max_decay);
+
+  // the fixed schedule is untouched by the adaptive one,
+  // and runs until frozen_temperature
+  sptest.adaptive = false;
+  sptest.frozen_temperature = 0.1;
+  REQUIRE(sptest.start_schedule() == 1000.0);
+  REQUIRE(sptest.schedule_decay == 0.95);
+  REQUIRE(sptest.schedule_iterations == 3000);
+  temperature = 0.11;
+  REQUIRE(sptest.next_temperature(temperature, 0.0) == true);
+  REQUIRE(sptest.next_temperature(temperature, 0.0) == false);
+  REQUIRE(temperature == doctest::Approx(0.11*0.95*0.95));
+
+  // a whole run ends in the outline
+  SPTest sprun;
+  sprun.initialize_sequence();
+  sprun.run();
+  REQUIRE(sprun.fits_outline());
 }
 
 /*
@@ -3458,27 +3969,27 @@ TEST_CASE("verify_pack" * doctest::timeout(600)) {
   // positive sequence = [bk1, bk2, bk3, bk4, bk5]
   // negative sequence = [bk1, bk2, bk3, bk4, bk5]
   SUBCASE("SUB : case 1") { 
-    sptest.positive_sequence[0] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_positive_sequence = 0;
-    sptest.positive_sequence[1] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_positive_sequence = 1;
-    sptest.positive_sequence[2] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_positive_sequence = 2;
-    sptest.positive_sequence[3] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_positive_sequence = 3;
-    sptest.positive_sequence[4] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_positive_sequence = 4;
+    sptest.positive_sequence[0] = sptest.map_blocks["bk1"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk1"]] = 0;
+    sptest.positive_sequence[1] = sptest.map_blocks["bk2"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk2"]] = 1;
+    sptest.positive_sequence[2] = sptest.map_blocks["bk3"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk3"]] = 2;
+    sptest.positive_sequence[3] = sptest.map_blocks["bk4"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk4"]] = 3;
+    sptest.positive_sequence[4] = sptest.map_blocks["bk5"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk5"]] = 4;
     
-    sptest.negative_sequence[0] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_negative_sequence = 0;
-    sptest.negative_sequence[1] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_negative_sequence = 1;
-    sptest.negative_sequence[2] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_negative_sequence = 2;
-    sptest.negative_sequence[3] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_negative_sequence = 3;
-    sptest.negative_sequence[4] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_negative_sequence = 4;
+    sptest.negative_sequence[0] = sptest.map_blocks["bk1"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk1"]] = 0;
+    sptest.negative_sequence[1] = sptest.map_blocks["bk2"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk2"]] = 1;
+    sptest.negative_sequence[2] = sptest.map_blocks["bk3"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk3"]] = 2;
+    sptest.negative_sequence[3] = sptest.map_blocks["bk4"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk4"]] = 3;
+    sptest.negative_sequence[4] = sptest.map_blocks["bk5"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk5"]] = 4;
 
     sptest.construct_relative_locations(0, 4, MoveType::nomove);
 
@@ -3490,27 +4001,27 @@ TEST_CASE("verify_pack" * doctest::timeout(600)) {
   }
   
   SUBCASE("SUB : case 2") { 
-    sptest.positive_sequence[0] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_positive_sequence = 0;
-    sptest.positive_sequence[1] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_positive_sequence = 1;
-    sptest.positive_sequence[2] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_positive_sequence = 2;
-    sptest.positive_sequence[3] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_positive_sequence = 3;
-    sptest.positive_sequence[4] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_positive_sequence = 4;
+    sptest.positive_sequence[0] = sptest.map_blocks["bk1"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk1"]] = 0;
+    sptest.positive_sequence[1] = sptest.map_blocks["bk3"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk3"]] = 1;
+    sptest.positive_sequence[2] = sptest.map_blocks["bk2"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk2"]] = 2;
+    sptest.positive_sequence[3] = sptest.map_blocks["bk5"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk5"]] = 3;
+    sptest.positive_sequence[4] = sptest.map_blocks["bk4"];
+    sptest.idx_positive_sequence[sptest.map_blocks["bk4"]] = 4;
     
-    sptest.negative_sequence[0] = &(sptest.map_blocks["bk4"]);
-    sptest.map_blocks["bk4"].idx_negative_sequence = 0;
-    sptest.negative_sequence[1] = &(sptest.map_blocks["bk1"]);
-    sptest.map_blocks["bk1"].idx_negative_sequence = 1;
-    sptest.negative_sequence[2] = &(sptest.map_blocks["bk3"]);
-    sptest.map_blocks["bk3"].idx_negative_sequence = 2;
-    sptest.negative_sequence[3] = &(sptest.map_blocks["bk5"]);
-    sptest.map_blocks["bk5"].idx_negative_sequence = 3;
-    sptest.negative_sequence[4] = &(sptest.map_blocks["bk2"]);
-    sptest.map_blocks["bk2"].idx_negative_sequence = 4;
+    sptest.negative_sequence[0] = sptest.map_blocks["bk4"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk4"]] = 0;
+    sptest.negative_sequence[1] = sptest.map_blocks["bk1"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk1"]] = 1;
+    sptest.negative_sequence[2] = sptest.map_blocks["bk3"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk3"]] = 2;
+    sptest.negative_sequence[3] = sptest.map_blocks["bk5"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk5"]] = 3;
+    sptest.negative_sequence[4] = sptest.map_blocks["bk2"];
+    sptest.idx_negative_sequence[sptest.map_blocks["bk2"]] = 4;
 
     sptest.construct_relative_locations(0, 4, MoveType::nomove);
     